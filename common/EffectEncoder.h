@@ -0,0 +1,329 @@
+#ifndef EFFECT_ENCODER_H
+#define EFFECT_ENCODER_H
+
+#include <stdio.h>
+#include <string.h>
+#include "EffectKeywords.h"
+#include "Protocol.h"
+
+// ============================================================================
+// EFFEKT-ENCODER (Gegenstück zu EffectParser.h)
+// ============================================================================
+//
+// Schreibt einen Effekt-Befehl als JSON in einen festen Buffer – kein
+// JsonDocument, kein Heap. Es werden immer alle Felder geschrieben, damit
+// decodeEffect() auf der Gegenseite exakt denselben Effekt erhält,
+// unabhängig von deren Defaults.
+//
+//   char buffer[EFFECT_JSON_SIZE];
+//   size_t length = encodeEffect(effect, buffer, sizeof(buffer));   // 0 = zu klein
+
+// Reicht für alle Felder inkl. vier voller Automationskurven (max. ~1650 Bytes)
+#define EFFECT_JSON_SIZE      2048
+
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t size) :
+        buffer(buffer),
+        size(size),
+        length(0),
+        overflow(size == 0) {
+        if (size) buffer[0] = 0;
+    }
+
+    // Länge ohne Nullbyte, 0 wenn der Buffer nicht gereicht hat
+    size_t finish() const { return overflow ? 0 : length; }
+
+    void raw(const char* text) { append("%s", text); }
+    void key(const char* name) { append("\"%s\":", name); }
+    void string(const char* value) { append("\"%s\"", value); }
+    void number(long value) { append("%ld", value); }
+    void unsignedNumber(unsigned long value) { append("%lu", value); }
+
+    void color(const Color& color) {
+        append("[%u,%u,%u]", color.r, color.g, color.b);
+    }
+
+    void colorValue(uint32_t rgb) {
+        append("[%lu,%lu,%lu]", (unsigned long)(rgb >> 16) & 0xFF,
+               (unsigned long)(rgb >> 8) & 0xFF, (unsigned long)rgb & 0xFF);
+    }
+
+    // Eingebettetes Objekt eines anderen Encoders: encode(ziel, platz) → Länge (0 = zu klein)
+    template <typename Encode>
+    void nested(Encode encode) {
+        if (overflow) return;
+        size_t written = encode(buffer + length, size - length);
+        if (written == 0) {
+            overflow = true;
+            return;
+        }
+        length += written;
+    }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+
+    template <typename... Args>
+    void append(const char* format, Args... args) {
+        if (overflow) return;
+        int written = snprintf(buffer + length, size - length, format, args...);
+        if (written < 0 || (size_t)written >= size - length) {
+            overflow = true;
+            return;
+        }
+        length += written;
+    }
+};
+
+inline void writeCurve(JsonWriter& out, AutomationField field, const Automation& curve,
+                       bool isColor, bool& first) {
+    if (!first) out.raw(",");
+    first = false;
+
+    out.key(AUTOMATION_FIELD_NAMES[field]);
+    out.raw("{");
+    out.key(CURVE_FIELD_NAMES[CURVE_LOOP]);
+    out.raw(curve.loop ? "true" : "false");
+    out.raw(",");
+    out.key(CURVE_FIELD_NAMES[CURVE_KEYS]);
+    out.raw("[");
+    for (uint8_t i = 0; i < curve.count; i++) {
+        const Keyframe& kf = curve.keys[i];
+        if (i > 0) out.raw(",");
+        out.raw("[");
+        out.unsignedNumber(kf.time);
+        out.raw(",");
+        if (isColor) out.colorValue(kf.value);
+        else out.unsignedNumber(kf.value);
+        out.raw(",");
+        out.string(EASING_NAMES[kf.easing <= EASING_IN_OUT ? kf.easing : EASING_LINEAR]);
+        out.raw("]");
+    }
+    out.raw("]}");
+}
+
+inline void writeRotation(JsonWriter& out, const RotationParams& rotation) {
+    out.raw("{");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_ACTIVE_COLOR]);
+    out.color(rotation.activeColor);
+    out.raw(",");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_INACTIVE_COLOR]);
+    out.color(rotation.inactiveColor);
+    out.raw(",");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_SPEED]);
+    out.number(rotation.speed);
+    out.raw(",");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_DIRECTION]);
+    out.string(DIRECTION_NAMES[rotation.direction]);
+    out.raw(",");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_PATTERN]);
+    out.string(PATTERN_NAMES[rotation.pattern]);
+    out.raw(",");
+    out.key(ROTATION_FIELD_NAMES[ROTATION_TRAIL_LENGTH]);
+    out.number(rotation.trailLength);
+    out.raw("}");
+}
+
+inline size_t encodeEffect(const Effect& effect, char* buffer, size_t size) {
+    JsonWriter out(buffer, size);
+
+    out.raw("{");
+    out.key(EFFECT_FIELD_NAMES[FIELD_VERSION]);
+    out.number(PROTOCOL_VERSION);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_RING]);
+    out.string(RING_NAMES[effect.ring]);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_EFFECT]);
+    out.string(EFFECT_NAMES[effect.type]);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_COLOR]);
+    out.color(effect.color);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_COLOR2]);
+    out.color(effect.color2);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_BRIGHTNESS]);
+    out.number(effect.brightness);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_SPEED]);
+    out.number(effect.speed);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_DURATION]);
+    out.number(effect.duration);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_TRANSITION_MS]);
+    out.number(effect.transitionMs);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_START_TIME]);
+    out.unsignedNumber(effect.startTime);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_TRACE]);
+    out.unsignedNumber(effect.traceId);
+    out.raw(",");
+
+    // Ziel-Segmente als Index-Liste
+    out.key(EFFECT_FIELD_NAMES[FIELD_SEGMENTS]);
+    out.raw("[");
+    bool first = true;
+    for (uint8_t i = 0; i < MAX_SEGMENTS; i++) {
+        if (!(effect.segments & (1 << i))) continue;
+        if (!first) out.raw(",");
+        out.number(i);
+        first = false;
+    }
+    out.raw("],");
+
+    out.key(EFFECT_FIELD_NAMES[FIELD_PALETTE]);
+    out.number(effect.palette);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_PROGRAM]);
+    out.number(effect.program);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_PROGRAM_PARAMS]);
+    out.raw("[");
+    for (uint8_t i = 0; i < NUM_PROGRAM_PARAMS; i++) {
+        if (i > 0) out.raw(",");
+        out.number(effect.programParams[i]);
+    }
+    out.raw("],");
+
+    out.key(EFFECT_FIELD_NAMES[FIELD_ROTATION]);
+    writeRotation(out, effect.rotation);
+
+    // Automationskurven (leere Kurve = keine Automation)
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_AUTOMATION]);
+    out.raw("{");
+    first = true;
+    writeCurve(out, AUTOMATION_BRIGHTNESS, effect.automation.brightness, false, first);
+    writeCurve(out, AUTOMATION_COLOR, effect.automation.color, true, first);
+    writeCurve(out, AUTOMATION_SPEED, effect.automation.speed, false, first);
+    writeCurve(out, AUTOMATION_TRAIL_LENGTH, effect.automation.trailLength, false, first);
+    out.raw("}}");
+
+    return out.finish();
+}
+
+// Delta (POST /effect/delta): nur die Felder, in denen `effect` von `base`
+// abweicht. Der Scheinwerfer dekodiert sie auf seinen letzten Effekt dieses
+// Rings – Ring, Typ, Startzeit und Trace stehen immer drin, Rotation und
+// Automation nur ganz. Segment-Effekte gehen nie als Delta.
+inline size_t encodeEffectDelta(const Effect& base, const Effect& effect, char* buffer, size_t size) {
+    JsonWriter out(buffer, size);
+
+    out.raw("{");
+    out.key(EFFECT_FIELD_NAMES[FIELD_VERSION]);
+    out.number(PROTOCOL_VERSION);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_RING]);
+    out.string(RING_NAMES[effect.ring]);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_EFFECT]);
+    out.string(EFFECT_NAMES[effect.type]);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_START_TIME]);
+    out.unsignedNumber(effect.startTime);
+    out.raw(",");
+    out.key(EFFECT_FIELD_NAMES[FIELD_TRACE]);
+    out.unsignedNumber(effect.traceId);
+
+    if (effect.color != base.color) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_COLOR]);
+        out.color(effect.color);
+    }
+    if (effect.color2 != base.color2) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_COLOR2]);
+        out.color(effect.color2);
+    }
+    if (effect.brightness != base.brightness) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_BRIGHTNESS]);
+        out.number(effect.brightness);
+    }
+    if (effect.speed != base.speed) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_SPEED]);
+        out.number(effect.speed);
+    }
+    if (effect.duration != base.duration) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_DURATION]);
+        out.number(effect.duration);
+    }
+    if (effect.transitionMs != base.transitionMs) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_TRANSITION_MS]);
+        out.number(effect.transitionMs);
+    }
+    if (effect.palette != base.palette) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_PALETTE]);
+        out.number(effect.palette);
+    }
+    if (effect.program != base.program) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_PROGRAM]);
+        out.number(effect.program);
+    }
+    if (memcmp(effect.programParams, base.programParams, sizeof(effect.programParams)) != 0) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_PROGRAM_PARAMS]);
+        out.raw("[");
+        for (uint8_t i = 0; i < NUM_PROGRAM_PARAMS; i++) {
+            if (i > 0) out.raw(",");
+            out.number(effect.programParams[i]);
+        }
+        out.raw("]");
+    }
+    if (effect.rotation != base.rotation) {
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_ROTATION]);
+        writeRotation(out, effect.rotation);
+    }
+    if (effect.automation != base.automation) {
+        bool first = true;
+        out.raw(",");
+        out.key(EFFECT_FIELD_NAMES[FIELD_AUTOMATION]);
+        out.raw("{");
+        writeCurve(out, AUTOMATION_BRIGHTNESS, effect.automation.brightness, false, first);
+        writeCurve(out, AUTOMATION_COLOR, effect.automation.color, true, first);
+        writeCurve(out, AUTOMATION_SPEED, effect.automation.speed, false, first);
+        writeCurve(out, AUTOMATION_TRAIL_LENGTH, effect.automation.trailLength, false, first);
+        out.raw("}");
+    }
+    out.raw("}");
+
+    return out.finish();
+}
+
+// Batch (POST /batch): alle Effekte gelten im selben Frame, sobald die
+// Show-Uhr `at` erreicht (0 = sobald alle angekommen sind)
+inline size_t encodeBatch(unsigned long at, const Effect* effects, uint8_t count, char* buffer, size_t size) {
+    JsonWriter out(buffer, size);
+
+    out.raw("{");
+    out.key(BATCH_FIELD_NAMES[BATCH_VERSION]);
+    out.number(PROTOCOL_VERSION);
+    out.raw(",");
+    out.key(BATCH_FIELD_NAMES[BATCH_AT]);
+    out.unsignedNumber(at);
+    out.raw(",");
+    out.key(BATCH_FIELD_NAMES[BATCH_EFFECTS]);
+    out.raw("[");
+    for (uint8_t i = 0; i < count; i++) {
+        if (i > 0) out.raw(",");
+        out.nested([&](char* target, size_t space) { return encodeEffect(effects[i], target, space); });
+    }
+    out.raw("]}");
+
+    return out.finish();
+}
+
+#endif // EFFECT_ENCODER_H
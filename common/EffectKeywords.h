@@ -0,0 +1,126 @@
+#ifndef EFFECT_KEYWORDS_H
+#define EFFECT_KEYWORDS_H
+
+#include "KeywordTable.h"
+#include "Protocol.h"
+
+// ============================================================================
+// SCHLÜSSELWÖRTER DES EFFEKT-PROTOKOLLS (Commander ↔ Scheinwerfer)
+// ============================================================================
+//
+// Reihenfolge der Namen = Enum-Wert aus Protocol.h (RingType, EffectType,
+// RotationPattern, RotationDirection, Easing). Die Tabellen dienen in beide
+// Richtungen: NAMES[wert] zum Schreiben, KEYWORDS.find() zum Lesen. Sie
+// werden zur Compile-Zeit perfekt gehasht, siehe KeywordTable.h.
+
+// Werte
+constexpr const char* RING_NAMES[] = { "inner", "outer", "both" };
+constexpr const char* EFFECT_NAMES[] = {
+    "static", "fade", "strobe", "pulse", "rotation", "rainbow", "chase", "program", "off"
+};
+constexpr const char* PATTERN_NAMES[] = { "single", "trail", "opposite", "wave", "rainbow_chase" };
+constexpr const char* DIRECTION_NAMES[] = { "clockwise", "counterclockwise" };
+constexpr const char* EASING_NAMES[] = { "linear", "step", "inOut" };
+
+constexpr auto RING_KEYWORDS = makeKeywordTable<8>(RING_NAMES);
+constexpr auto EFFECT_KEYWORDS = makeKeywordTable<32>(EFFECT_NAMES);
+constexpr auto PATTERN_KEYWORDS = makeKeywordTable<16>(PATTERN_NAMES);
+constexpr auto DIRECTION_KEYWORDS = makeKeywordTable<4>(DIRECTION_NAMES);
+constexpr auto EASING_KEYWORDS = makeKeywordTable<8>(EASING_NAMES);
+
+// Felder eines Effekt-Befehls
+enum EffectField : int8_t {
+    FIELD_RING,
+    FIELD_EFFECT,
+    FIELD_COLOR,
+    FIELD_COLOR2,
+    FIELD_BRIGHTNESS,
+    FIELD_SPEED,
+    FIELD_DURATION,
+    FIELD_TRANSITION_MS,
+    FIELD_SEGMENTS,
+    FIELD_PALETTE,
+    FIELD_START_TIME,
+    FIELD_AUTOMATION,
+    FIELD_PROGRAM,
+    FIELD_PROGRAM_PARAMS,
+    FIELD_ROTATION,
+    FIELD_TRACE,
+    FIELD_VERSION,          // PROTOCOL_VERSION
+    FIELD_TARGETS           // Nur Commander-API
+};
+
+constexpr const char* EFFECT_FIELD_NAMES[] = {
+    "ring", "effect", "color", "color2", "brightness", "speed", "duration",
+    "transitionMs", "segments", "palette", "startTime", "automation",
+    "program", "programParams", "rotation", "trace", "v", "targets"
+};
+
+// Felder von "rotation"
+enum RotationField : int8_t {
+    ROTATION_ACTIVE_COLOR,
+    ROTATION_INACTIVE_COLOR,
+    ROTATION_SPEED,
+    ROTATION_DIRECTION,
+    ROTATION_PATTERN,
+    ROTATION_TRAIL_LENGTH
+};
+
+constexpr const char* ROTATION_FIELD_NAMES[] = {
+    "activeColor", "inactiveColor", "speed", "direction", "pattern", "trailLength"
+};
+
+// Kurven in "automation" und deren Felder
+enum AutomationField : int8_t {
+    AUTOMATION_BRIGHTNESS,
+    AUTOMATION_COLOR,
+    AUTOMATION_SPEED,
+    AUTOMATION_TRAIL_LENGTH
+};
+
+constexpr const char* AUTOMATION_FIELD_NAMES[] = { "brightness", "color", "speed", "trailLength" };
+
+enum CurveField : int8_t {
+    CURVE_KEYS,
+    CURVE_LOOP
+};
+
+constexpr const char* CURVE_FIELD_NAMES[] = { "keys", "loop" };
+
+// Felder einer Batch-Nachricht (POST /batch)
+enum BatchField : int8_t {
+    BATCH_VERSION,
+    BATCH_AT,
+    BATCH_EFFECTS
+};
+
+constexpr const char* BATCH_FIELD_NAMES[] = { "v", "at", "effects" };
+
+constexpr auto EFFECT_FIELDS = makeKeywordTable<64>(EFFECT_FIELD_NAMES);
+constexpr auto ROTATION_FIELDS = makeKeywordTable<16>(ROTATION_FIELD_NAMES);
+constexpr auto AUTOMATION_FIELDS = makeKeywordTable<8>(AUTOMATION_FIELD_NAMES);
+constexpr auto CURVE_FIELDS = makeKeywordTable<4>(CURVE_FIELD_NAMES);
+constexpr auto BATCH_FIELDS = makeKeywordTable<4>(BATCH_FIELD_NAMES);
+
+// Jeder Enum-Wert braucht genau einen Namen
+#define KEYWORD_COUNT(names) (sizeof(names) / sizeof(names[0]))
+static_assert(KEYWORD_COUNT(RING_NAMES) == RING_BOTH + 1, "RING_NAMES passt nicht zu RingType");
+static_assert(KEYWORD_COUNT(EFFECT_NAMES) == EFFECT_OFF + 1, "EFFECT_NAMES passt nicht zu EffectType");
+static_assert(KEYWORD_COUNT(PATTERN_NAMES) == PATTERN_RAINBOW_CHASE + 1, "PATTERN_NAMES passt nicht zu RotationPattern");
+static_assert(KEYWORD_COUNT(DIRECTION_NAMES) == DIRECTION_COUNTERCLOCKWISE + 1, "DIRECTION_NAMES passt nicht zu RotationDirection");
+static_assert(KEYWORD_COUNT(EASING_NAMES) == EASING_IN_OUT + 1, "EASING_NAMES passt nicht zu Easing");
+static_assert(KEYWORD_COUNT(EFFECT_FIELD_NAMES) == FIELD_TARGETS + 1, "EFFECT_FIELD_NAMES passt nicht zu EffectField");
+static_assert(KEYWORD_COUNT(ROTATION_FIELD_NAMES) == ROTATION_TRAIL_LENGTH + 1, "ROTATION_FIELD_NAMES passt nicht zu RotationField");
+static_assert(KEYWORD_COUNT(AUTOMATION_FIELD_NAMES) == AUTOMATION_TRAIL_LENGTH + 1, "AUTOMATION_FIELD_NAMES passt nicht zu AutomationField");
+static_assert(KEYWORD_COUNT(CURVE_FIELD_NAMES) == CURVE_LOOP + 1, "CURVE_FIELD_NAMES passt nicht zu CurveField");
+static_assert(KEYWORD_COUNT(BATCH_FIELD_NAMES) == BATCH_EFFECTS + 1, "BATCH_FIELD_NAMES passt nicht zu BatchField");
+#undef KEYWORD_COUNT
+
+static_assert(RING_KEYWORDS.seed && EFFECT_KEYWORDS.seed && PATTERN_KEYWORDS.seed &&
+              DIRECTION_KEYWORDS.seed && EASING_KEYWORDS.seed,
+              "Kein perfekter Hash für Werte – Slots vergrößern");
+static_assert(EFFECT_FIELDS.seed && ROTATION_FIELDS.seed &&
+              AUTOMATION_FIELDS.seed && CURVE_FIELDS.seed && BATCH_FIELDS.seed,
+              "Kein perfekter Hash für Felder – Slots vergrößern");
+
+#endif // EFFECT_KEYWORDS_H
@@ -0,0 +1,333 @@
+#ifndef EFFECT_PARSER_H
+#define EFFECT_PARSER_H
+
+#include "JsonCursor.h"
+#include "EffectKeywords.h"
+#include "Protocol.h"
+
+// ============================================================================
+// EFFEKT-PARSER (gemeinsame Bausteine für Commander und Scheinwerfer)
+// ============================================================================
+//
+// Liest Effekt-Befehle direkt aus dem Request-Buffer in die Structs aus
+// Protocol.h – kein JsonDocument, keine String-Temporaries, kein Heap.
+// Gegenstück zu EffectEncoder.h: alles, was encodeEffect() schreibt, kommt
+// hier unverändert wieder heraus.
+
+// Zahl in ein beliebiges Ganzzahl-Feld
+template <typename T>
+bool readValue(JsonCursor& json, T& value) {
+    long number;
+    if (!json.readNumber(number)) return false;
+    value = (T)number;
+    return true;
+}
+
+// Bis zu maxCount Zahlen aus einem Array, Rest wird übersprungen
+template <typename T>
+void readValues(JsonCursor& json, T* values, uint8_t maxCount) {
+    if (json.skipNull() || !json.enterArray()) return;
+
+    uint8_t count = 0;
+    while (json.nextElement()) {
+        if (count < maxCount) readValue(json, values[count++]);
+        else json.skipValue();
+    }
+}
+
+// Schlüsselwort → Enum-Index, unbekannt → fallback
+template <typename Table>
+int8_t readKeyword(JsonCursor& json, const Table& table, int8_t fallback) {
+    const char* str;
+    size_t length;
+    if (!json.readString(str, length)) return fallback;
+    return table.find(str, length, fallback);
+}
+
+// [r, g, b]
+inline void readColor(JsonCursor& json, Color& color) {
+    uint8_t rgb[3] = { color.r, color.g, color.b };
+    readValues(json, rgb, 3);
+    color.r = rgb[0];
+    color.g = rgb[1];
+    color.b = rgb[2];
+}
+
+// [0, 2, 5] → Bitmaske, Indizes ab MAX_SEGMENTS werden ignoriert
+inline uint8_t readSegmentMask(JsonCursor& json) {
+    uint8_t mask = 0;
+    if (json.skipNull() || !json.enterArray()) return mask;
+
+    while (json.nextElement()) {
+        long index;
+        if (readValue(json, index) && index >= 0 && index < MAX_SEGMENTS) mask |= (1 << index);
+    }
+    return mask;
+}
+
+// "rotation": { ... }
+inline void readRotation(JsonCursor& json, RotationParams& rotation) {
+    const char* key;
+    size_t keyLength;
+    if (json.skipNull() || !json.enterObject()) return;
+
+    while (json.nextKey(key, keyLength)) {
+        switch (ROTATION_FIELDS.find(key, keyLength)) {
+            case ROTATION_ACTIVE_COLOR:
+                readColor(json, rotation.activeColor);
+                break;
+            case ROTATION_INACTIVE_COLOR:
+                readColor(json, rotation.inactiveColor);
+                break;
+            case ROTATION_SPEED:
+                readValue(json, rotation.speed);
+                break;
+            case ROTATION_DIRECTION:
+                rotation.direction = (RotationDirection)readKeyword(json, DIRECTION_KEYWORDS, 0);
+                break;
+            case ROTATION_PATTERN:
+                rotation.pattern = (RotationPattern)readKeyword(json, PATTERN_KEYWORDS, 0);
+                break;
+            case ROTATION_TRAIL_LENGTH:
+                readValue(json, rotation.trailLength);
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+}
+
+// Keyframe: [time, value, easing?] bzw. [time, [r, g, b], easing?]
+inline bool readKeyframe(JsonCursor& json, Keyframe& kf, bool isColor) {
+    if (!json.enterArray()) return false;
+
+    uint32_t time = 0;
+    uint32_t value = 0;
+    int8_t easing = 0;
+
+    for (uint8_t i = 0; json.nextElement(); i++) {
+        if (i == 0) {
+            readValue(json, time);
+        } else if (i == 1 && isColor) {
+            uint8_t rgb[3] = { 0, 0, 0 };
+            readValues(json, rgb, 3);
+            value = ((uint32_t)rgb[0] << 16) | ((uint32_t)rgb[1] << 8) | rgb[2];
+        } else if (i == 1) {
+            readValue(json, value);
+        } else if (i == 2) {
+            easing = readKeyword(json, EASING_KEYWORDS, 0);
+        } else {
+            json.skipValue();
+        }
+    }
+
+    kf.time = time;
+    kf.value = value;
+    kf.easing = easing;
+    return json.ok();
+}
+
+// { "keys": [...], "loop": true }
+inline void readCurve(JsonCursor& json, Automation& curve, bool isColor) {
+    const char* key;
+    size_t keyLength;
+    curve.count = 0;
+    if (json.skipNull() || !json.enterObject()) return;
+
+    while (json.nextKey(key, keyLength)) {
+        switch (CURVE_FIELDS.find(key, keyLength)) {
+            case CURVE_LOOP:
+                json.readBool(curve.loop);
+                break;
+            case CURVE_KEYS:
+                if (!json.enterArray()) break;
+                while (json.nextElement()) {
+                    if (curve.count >= MAX_KEYFRAMES) {
+                        json.skipValue();
+                        continue;
+                    }
+                    Keyframe& kf = curve.keys[curve.count];
+                    if (!readKeyframe(json, kf, isColor)) break;
+
+                    // Keyframes müssen zeitlich sortiert sein
+                    if (curve.count == 0 || kf.time >= curve.keys[curve.count - 1].time) {
+                        curve.count++;
+                    }
+                }
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+}
+
+// "automation": { "brightness": {...}, "color": {...}, ... }
+inline void readAutomation(JsonCursor& json, EffectAutomation& automation) {
+    const char* key;
+    size_t keyLength;
+    if (json.skipNull() || !json.enterObject()) return;
+
+    while (json.nextKey(key, keyLength)) {
+        switch (AUTOMATION_FIELDS.find(key, keyLength)) {
+            case AUTOMATION_BRIGHTNESS:
+                readCurve(json, automation.brightness, false);
+                break;
+            case AUTOMATION_COLOR:
+                readCurve(json, automation.color, true);
+                break;
+            case AUTOMATION_SPEED:
+                readCurve(json, automation.speed, false);
+                break;
+            case AUTOMATION_TRAIL_LENGTH:
+                readCurve(json, automation.trailLength, false);
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+}
+
+// ============================================================================
+// EFFEKT-BEFEHL
+// ============================================================================
+
+enum DecodeResult : uint8_t {
+    DECODE_OK,
+    DECODE_INVALID_JSON,
+    DECODE_UNSUPPORTED_VERSION
+};
+
+// Ein Feld eines Effekt-Befehls lesen; false = kein Effekt-Feld (Wert ist
+// noch nicht gelesen, der Aufrufer muss ihn auswerten oder überspringen)
+inline bool readEffectField(JsonCursor& json, int8_t field, Effect& effect) {
+    switch (field) {
+        case FIELD_RING:
+            effect.ring = (RingType)readKeyword(json, RING_KEYWORDS, RING_BOTH);
+            break;
+        case FIELD_EFFECT:
+            effect.type = (EffectType)readKeyword(json, EFFECT_KEYWORDS, EFFECT_OFF);
+            break;
+        case FIELD_COLOR:
+            readColor(json, effect.color);
+            break;
+        case FIELD_COLOR2:
+            readColor(json, effect.color2);
+            break;
+        case FIELD_BRIGHTNESS:
+            readValue(json, effect.brightness);
+            break;
+        case FIELD_SPEED:
+            readValue(json, effect.speed);
+            break;
+        case FIELD_DURATION:
+            readValue(json, effect.duration);
+            break;
+        case FIELD_TRANSITION_MS:
+            readValue(json, effect.transitionMs);
+            break;
+        case FIELD_SEGMENTS:
+            effect.segments = readSegmentMask(json);
+            break;
+        case FIELD_PALETTE:
+            readValue(json, effect.palette);
+            break;
+        case FIELD_START_TIME:
+            readValue(json, effect.startTime);
+            break;
+        case FIELD_AUTOMATION:
+            readAutomation(json, effect.automation);
+            break;
+        case FIELD_PROGRAM:
+            readValue(json, effect.program);
+            break;
+        case FIELD_PROGRAM_PARAMS:
+            readValues(json, effect.programParams, NUM_PROGRAM_PARAMS);
+            break;
+        case FIELD_ROTATION:
+            readRotation(json, effect.rotation);
+            break;
+        case FIELD_TRACE:
+            readValue(json, effect.traceId);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+// Effekt-Objekt an der Cursor-Position. Ohne "effect" → static, unbekannter
+// Name → off. Felder, die nicht zum Effekt gehören, gehen an
+// `other(json, field)` – der muss den Wert lesen oder überspringen.
+template <typename OtherField>
+DecodeResult decodeEffect(JsonCursor& json, Effect& effect, OtherField other) {
+    const char* key;
+    size_t keyLength;
+    long version = 0;
+
+    if (!json.enterObject()) return DECODE_INVALID_JSON;
+
+    effect.type = EFFECT_STATIC;
+
+    while (json.nextKey(key, keyLength)) {
+        int8_t field = EFFECT_FIELDS.find(key, keyLength);
+        if (field == FIELD_VERSION) {
+            json.readNumber(version);
+        } else if (!readEffectField(json, field, effect)) {
+            other(json, field);
+        }
+    }
+
+    if (!json.ok()) return DECODE_INVALID_JSON;
+    return version > PROTOCOL_VERSION ? DECODE_UNSUPPORTED_VERSION : DECODE_OK;
+}
+
+inline DecodeResult decodeEffect(const char* body, size_t length, Effect& effect) {
+    JsonCursor json(body, length);
+    return decodeEffect(json, effect, [](JsonCursor& json, int8_t) { json.skipValue(); });
+}
+
+// Batch-Nachricht {"v":1,"at":T,"effects":[{…},…]}: jeder Effekt geht
+// einzeln an `each(effect)`, nichts wird gepuffert. `at` steht erst nach
+// dem Aufruf fest (Feldreihenfolge ist frei) – wer beides braucht, liest
+// zweimal.
+template <typename EachEffect>
+DecodeResult decodeBatch(const char* body, size_t length, unsigned long& at, EachEffect each) {
+    JsonCursor json(body, length);
+    const char* key;
+    size_t keyLength;
+    long version = 0;
+
+    at = 0;
+    if (!json.enterObject()) return DECODE_INVALID_JSON;
+
+    while (json.nextKey(key, keyLength)) {
+        switch (BATCH_FIELDS.find(key, keyLength)) {
+            case BATCH_VERSION:
+                json.readNumber(version);
+                break;
+            case BATCH_AT:
+                readValue(json, at);
+                break;
+            case BATCH_EFFECTS:
+                if (json.skipNull() || !json.enterArray()) break;
+                while (json.nextElement()) {
+                    Effect effect;
+                    DecodeResult result = decodeEffect(json, effect, [](JsonCursor& json, int8_t) { json.skipValue(); });
+                    if (result != DECODE_OK) return result;
+                    each(effect);
+                }
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+
+    if (!json.ok()) return DECODE_INVALID_JSON;
+    return version > PROTOCOL_VERSION ? DECODE_UNSUPPORTED_VERSION : DECODE_OK;
+}
+
+#endif // EFFECT_PARSER_H
@@ -0,0 +1,85 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// HISTOGRAMM (feste Buckets für Laufzeiten)
+// ============================================================================
+//
+// Bucket-Grenzen sind Zweierpotenzen ab 16: ≤16, ≤32, … ≤2^22, letzter Bucket
+// = alles darüber. Die Einheit legt der Aufrufer fest – der Commander misst
+// in µs (bis ~4.2 s), die Frame-Telemetrie des Scheinwerfers in CPU-Takten
+// (bei 240 MHz bis ~17 ms). record() kostet ein clz, ein Inkrement und
+// zwei Vergleiche – kein Float, keine Schleife. Nicht thread-sicher: bei
+// mehreren Schreibern muss der Aufrufer sperren (Commander: metricsMux).
+//
+//   Histogram latency;
+//   latency.record(micros() - start);
+//   latency.percentile(99);   // Obergrenze des Buckets mit dem p99
+
+#define HISTOGRAM_BUCKETS     20
+#define HISTOGRAM_MIN_SHIFT   4       // Erster Bucket: ≤ 2^4
+
+struct Histogram {
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+
+    Histogram() { reset(); }
+
+    void reset() {
+        memset(buckets, 0, sizeof(buckets));
+        count = 0;
+        sum = 0;
+        min = UINT32_MAX;
+        max = 0;
+    }
+
+    void record(uint32_t value) {
+        buckets[bucketFor(value)]++;
+        count++;
+        sum += value;
+        if (value < min) min = value;
+        if (value > max) max = value;
+    }
+
+    // Obergrenze von Bucket b (letzter Bucket: UINT32_MAX = +Inf)
+    static uint32_t upperBound(uint8_t b) {
+        return b < HISTOGRAM_BUCKETS - 1 ? (1u << (b + HISTOGRAM_MIN_SHIFT)) : UINT32_MAX;
+    }
+
+    static uint8_t bucketFor(uint32_t value) {
+        if (value <= (1u << HISTOGRAM_MIN_SHIFT)) return 0;
+        // ceil(log2(value)) - MIN_SHIFT
+        uint8_t b = 32 - __builtin_clz(value - 1) - HISTOGRAM_MIN_SHIFT;
+        return b < HISTOGRAM_BUCKETS ? b : HISTOGRAM_BUCKETS - 1;
+    }
+
+    uint32_t average() const {
+        return count ? (uint32_t)(sum / count) : 0;
+    }
+
+    // Perzentil (0..100) als Bucket-Obergrenze, gedeckelt auf max
+    uint32_t percentile(uint8_t p) const {
+        if (count == 0) return 0;
+
+        uint32_t rank = ((uint64_t)count * p + 99) / 100;
+        if (rank == 0) rank = 1;
+
+        uint32_t seen = 0;
+        for (uint8_t b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                uint32_t bound = upperBound(b);
+                return bound < max ? bound : max;
+            }
+        }
+        return max;
+    }
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,240 @@
+#ifndef JSON_CURSOR_H
+#define JSON_CURSOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// JSON CURSOR (Pull-Parser direkt auf dem Request-Buffer)
+// ============================================================================
+//
+// Liest JSON Token für Token, ohne Kopie und ohne Heap. Strings werden als
+// Zeiger + Länge in den Buffer zurückgegeben (Escapes bleiben roh – für
+// Schlüsselwörter und Zahlen reicht das). Fehler sind klebrig: nach dem
+// ersten Fehler liefert jede Methode false, Schleifen brechen von selbst ab.
+//
+//   JsonCursor json(body, length);
+//   const char* key; size_t keyLength;
+//   if (json.enterObject()) {
+//       while (json.nextKey(key, keyLength)) {
+//           ... json.readNumber(v) / json.readString(s, len) / json.skipValue()
+//       }
+//   }
+//   if (!json.ok()) → 400
+
+#define JSON_MAX_DEPTH        32      // Verschachtelung in skipValue() (Bits in uint32_t)
+
+class JsonCursor {
+public:
+    JsonCursor(const char* data, size_t length) :
+        pos(data),
+        end(data + length),
+        error(false),
+        first(false) {}
+
+    bool ok() const { return !error; }
+
+    // Nächstes Zeichen ohne Whitespace, 0 am Ende
+    char peek() {
+        skipWhitespace();
+        return pos < end ? *pos : 0;
+    }
+
+    bool enterObject() { return enterContainer('{'); }
+    bool enterArray() { return enterContainer('['); }
+
+    // Nächster Schlüssel; false am Objektende oder bei Fehler
+    bool nextKey(const char*& key, size_t& length) {
+        if (!nextMember('}')) return false;
+        return readString(key, length) && consume(':');
+    }
+
+    // Nächstes Element; false am Arrayende oder bei Fehler
+    bool nextElement() {
+        return nextMember(']');
+    }
+
+    bool readString(const char*& str, size_t& length) {
+        if (!consume('"')) return false;
+
+        const char* start = pos;
+        skipStringBody();
+        if (pos >= end) return fail();
+
+        str = start;
+        length = pos - start;
+        pos++;
+        return true;
+    }
+
+    // Ganzzahl; Nachkommastellen und Exponent werden abgeschnitten
+    bool readNumber(long& value) {
+        if (error) return false;
+        skipWhitespace();
+
+        bool negative = false;
+        if (pos < end && *pos == '-') {
+            negative = true;
+            pos++;
+        }
+        if (pos >= end || *pos < '0' || *pos > '9') return fail();
+
+        unsigned long result = 0;
+        while (pos < end && *pos >= '0' && *pos <= '9') {
+            result = result * 10 + (*pos - '0');
+            pos++;
+        }
+        if (pos < end && *pos == '.') {
+            pos++;
+            while (pos < end && *pos >= '0' && *pos <= '9') pos++;
+        }
+        if (pos < end && (*pos == 'e' || *pos == 'E')) {
+            pos++;
+            if (pos < end && (*pos == '+' || *pos == '-')) pos++;
+            while (pos < end && *pos >= '0' && *pos <= '9') pos++;
+        }
+
+        value = negative ? -(long)result : (long)result;
+        return true;
+    }
+
+    bool readBool(bool& value) {
+        if (peek() == 't') {
+            value = true;
+            return literal("true");
+        }
+        value = false;
+        return literal("false");
+    }
+
+    // null überspringen, falls vorhanden
+    bool skipNull() {
+        return peek() == 'n' && literal("null");
+    }
+
+    // Beliebigen Wert überspringen (auch verschachtelt). Container werden
+    // ohne Rekursion, aber genauso streng gelesen wie von Hand: Kommas,
+    // Doppelpunkte, Schlüssel – nur die Tiefe ist auf JSON_MAX_DEPTH begrenzt.
+    bool skipValue() {
+        if (error) return false;
+        char c = peek();
+        if (c == '"') {
+            const char* str;
+            size_t length;
+            return readString(str, length);
+        }
+        if (c == 't' || c == 'f') {
+            bool value;
+            return readBool(value);
+        }
+        if (c == 'n') return literal("null");
+        if (c != '{' && c != '[') {
+            long value;
+            return readNumber(value);
+        }
+
+        // Offene Container als Bitstapel: 1 = Objekt, 0 = Array
+        uint32_t objects = 0;
+        uint8_t depth = 0;
+        for (;;) {
+            c = peek();
+            if (c == '{' || c == '[') {
+                if (depth == JSON_MAX_DEPTH) return fail();
+                enterContainer(c);
+                objects = (objects << 1) | (c == '{');
+                depth++;
+            } else if (!skipValue()) {
+                return false;
+            }
+
+            // Nächster Member; geschlossene Container abbauen
+            for (;;) {
+                bool isObject = objects & 1;
+                if (nextMember(isObject ? '}' : ']')) {
+                    if (isObject) {
+                        const char* key;
+                        size_t keyLength;
+                        if (!readString(key, keyLength) || !consume(':')) return false;
+                    }
+                    break;
+                }
+                if (error) return false;
+                objects >>= 1;
+                if (--depth == 0) return true;
+            }
+        }
+    }
+
+private:
+    const char* pos;
+    const char* end;
+    bool error;
+    bool first;             // Direkt nach '{' bzw. '[': kein Komma vor dem Member
+
+    bool fail() {
+        error = true;
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) {
+            pos++;
+        }
+    }
+
+    // Bis zum schließenden Anführungszeichen (bleibt darauf stehen)
+    void skipStringBody() {
+        while (pos < end && *pos != '"') {
+            if (*pos == '\\' && pos + 1 < end) pos++;
+            pos++;
+        }
+    }
+
+    bool consume(char c) {
+        if (error) return false;
+        skipWhitespace();
+        if (pos >= end || *pos != c) return fail();
+        pos++;
+        return true;
+    }
+
+    bool literal(const char* word) {
+        if (error) return false;
+        skipWhitespace();
+        while (*word) {
+            if (pos >= end || *pos != *word) return fail();
+            pos++;
+            word++;
+        }
+        return true;
+    }
+
+    bool enterContainer(char open) {
+        if (!consume(open)) return false;
+        first = true;
+        return true;
+    }
+
+    // Trennzeichen zwischen Members; false (ohne Fehler) an der schließenden
+    // Klammer. Komma genau zwischen zwei Members – fehlend, doppelt oder
+    // führend ist ein Fehler (ein Flag reicht: verschachtelte Container
+    // werden vollständig gelesen, bevor es im äußeren weitergeht).
+    bool nextMember(char close) {
+        if (error) return false;
+        char c = peek();
+        if (c == close) {
+            pos++;
+            first = false;
+            return false;
+        }
+        if (!first) {
+            if (c != ',') return fail();
+            pos++;
+        }
+        first = false;
+        if (pos >= end) return fail();
+        return true;
+    }
+};
+
+#endif // JSON_CURSOR_H
@@ -0,0 +1,91 @@
+#ifndef KEYWORD_TABLE_H
+#define KEYWORD_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// PERFEKTES HASHING FÜR SCHLÜSSELWÖRTER
+// ============================================================================
+//
+// Die Tabelle wird vom Compiler gebaut: makeKeywordTable() sucht einen Seed,
+// bei dem alle Wörter auf verschiedene Slots fallen. Zur Laufzeit kostet ein
+// Lookup einen Hash über das Wort, einen Tabellenzugriff und ein memcmp –
+// keine String-Objekte, kein Heap.
+//
+//   constexpr const char* NAMES[] = { "inner", "outer", "both" };
+//   constexpr auto RINGS = makeKeywordTable<8>(NAMES);
+//   static_assert(RINGS.seed != 0, "kein perfekter Hash gefunden");
+//   int8_t index = RINGS.find(str, len);   // -1 = unbekannt
+
+// FNV-1a mit Seed, letzte Runde mischt die hohen Bits nach unten
+constexpr uint32_t keywordHash(const char* str, size_t length, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+constexpr size_t keywordLength(const char* str) {
+    size_t length = 0;
+    while (str[length]) length++;
+    return length;
+}
+
+template <uint8_t N, uint16_t SLOTS>
+struct KeywordTable {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS muss eine Zweierpotenz sein");
+    static_assert(SLOTS >= N, "zu wenige Slots");
+
+    const char* words[N];
+    uint8_t lengths[N];
+    int8_t slots[SLOTS];    // Index in words, -1 = leer
+    uint32_t seed;          // 0 = kein perfekter Hash gefunden
+
+    // Index des Worts oder -1
+    int8_t find(const char* str, size_t length) const {
+        int8_t index = slots[keywordHash(str, length, seed) & (SLOTS - 1)];
+        if (index < 0 || lengths[index] != length) return -1;
+        return memcmp(words[index], str, length) == 0 ? index : -1;
+    }
+
+    // Wie find(), aber mit Standardwert für unbekannte Wörter
+    int8_t find(const char* str, size_t length, int8_t fallback) const {
+        int8_t index = find(str, length);
+        return index < 0 ? fallback : index;
+    }
+};
+
+template <uint16_t SLOTS, uint8_t N>
+constexpr KeywordTable<N, SLOTS> makeKeywordTable(const char* const (&words)[N]) {
+    KeywordTable<N, SLOTS> table{};
+
+    for (uint8_t i = 0; i < N; i++) {
+        table.words[i] = words[i];
+        table.lengths[i] = keywordLength(words[i]);
+    }
+
+    for (uint32_t seed = 1; seed < 4096; seed++) {
+        for (uint16_t s = 0; s < SLOTS; s++) table.slots[s] = -1;
+
+        bool perfect = true;
+        for (uint8_t i = 0; i < N && perfect; i++) {
+            uint16_t slot = keywordHash(words[i], table.lengths[i], seed) & (SLOTS - 1);
+            if (table.slots[slot] >= 0) perfect = false;
+            else table.slots[slot] = i;
+        }
+
+        if (perfect) {
+            table.seed = seed;
+            return table;
+        }
+    }
+
+    table.seed = 0;
+    return table;
+}
+
+#endif // KEYWORD_TABLE_H
@@ -0,0 +1,281 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// ============================================================================
+// LOGGING (binärer Ringpuffer statt Serial im heißen Pfad)
+// ============================================================================
+//
+// Ein Log-Aufruf schreibt nur einen Record (Zeit, Level, Format-Zeiger, bis
+// zu vier 32-Bit-Werte, optional ein kurzer Tag) in einen Ringpuffer im RAM.
+// Formatiert wird erst beim Auslesen: vom Drain-Task mit niedriger Priorität
+// auf Serial oder per HTTP (/api/logs bzw. /logs). Bei 115200 Baud blockiert
+// ein 1-KB-Body sonst ~90 ms.
+//
+//   LOG_INFO("Program %u loaded (%u bytes)", slot, size);
+//   LOG_WARN_TAG(ip.c_str(), "HTTP error %d", httpCode);
+//
+// Regeln:
+//   - format muss ein Literal sein (es wird nur der Zeiger gespeichert)
+//   - Argumente: nur Ganzzahlen/Enums (32 Bit) → im Format nur %d, %u, %x
+//   - Dynamische Texte (IP, ID, Name) als Tag, gekürzt auf LOG_TAG_LEN - 1
+//
+// Levels unter LOG_LEVEL werden nicht übersetzt (kein Code, kein Format-
+// String im Flash). Voreinstellung INFO, per -DLOG_LEVEL=... änderbar.
+
+#define LOG_LEVEL_NONE        0
+#define LOG_LEVEL_ERROR       1
+#define LOG_LEVEL_WARN        2
+#define LOG_LEVEL_INFO        3
+#define LOG_LEVEL_DEBUG       4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL             LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE       128     // Records, Zweierpotenz
+#endif
+
+#define LOG_DRAIN_INTERVAL    20      // ms zwischen zwei Drain-Durchläufen
+#define LOG_DRAIN_BATCH       16      // Zeilen pro Durchlauf
+
+#define LOG_MAX_ARGS          4
+#define LOG_TAG_LEN           16
+#define LOG_LINE_LEN          160     // Formatierte Zeile inkl. Zeit und Tag
+
+static_assert((LOG_BUFFER_SIZE & (LOG_BUFFER_SIZE - 1)) == 0, "LOG_BUFFER_SIZE muss eine Zweierpotenz sein");
+
+struct LogRecord {
+    uint32_t time;                  // µs seit Start
+    const char* format;
+    uint32_t args[LOG_MAX_ARGS];
+    char tag[LOG_TAG_LEN];          // "" = kein Tag
+    uint8_t level;
+};
+
+// Ringpuffer für mehrere Schreiber (Loop, Netzwerk-Task, Worker) ohne Lock:
+// jeder Schreiber zieht eine Ticketnummer, der Slot trägt eine Sequenz-
+// nummer (ungerade = wird gerade beschrieben). Leser prüfen die Nummer vor
+// und nach dem Kopieren; überschriebene Records werden als verloren gezählt.
+// Bei vollem Puffer gewinnt immer der neueste Record.
+class LogBuffer {
+public:
+    LogBuffer() : head(0), drained(0), lost(0) {
+        for (uint32_t i = 0; i < LOG_BUFFER_SIZE; i++) slots[i].seq.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void write(uint8_t level, const char* tag, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Zu viele Log-Argumente");
+        static_assert(allIntegral<Args...>(), "Log-Argumente: nur Ganzzahlen/Enums (Texte als Tag)");
+
+        uint32_t ticket = head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots[ticket & (LOG_BUFFER_SIZE - 1)];
+
+        slot.seq.store(ticket * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        LogRecord& record = slot.record;
+        record.time = now();
+        record.format = format;
+        record.level = level;
+        uint32_t values[LOG_MAX_ARGS] = { (uint32_t)args... };
+        memcpy(record.args, values, sizeof(values));
+        if (tag) {
+            strncpy(record.tag, tag, LOG_TAG_LEN - 1);
+            record.tag[LOG_TAG_LEN - 1] = 0;
+        } else {
+            record.tag[0] = 0;
+        }
+
+        slot.seq.store(ticket * 2 + 2, std::memory_order_release);
+    }
+
+    // Record mit Ticket `ticket` kopieren; false = noch nicht fertig oder
+    // schon überschrieben
+    bool read(uint32_t ticket, LogRecord& record) const {
+        const Slot& slot = slots[ticket & (LOG_BUFFER_SIZE - 1)];
+        uint32_t expected = ticket * 2 + 2;
+
+        if (slot.seq.load(std::memory_order_acquire) != expected) return false;
+        record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == expected;
+    }
+
+    // Eine Zeile: "[   12.345678] I tag: text"
+    static size_t format(const LogRecord& record, char* line, size_t size) {
+        static const char levels[] = "-EWID";
+
+        int length = snprintf(line, size, "[%5u.%06u] %c ",
+                              (unsigned)(record.time / 1000000), (unsigned)(record.time % 1000000),
+                              levels[record.level < sizeof(levels) - 1 ? record.level : 0]);
+        if (length < 0 || (size_t)length >= size) return size ? size - 1 : 0;
+
+        if (record.tag[0]) {
+            int tagLength = snprintf(line + length, size - length, "%s: ", record.tag);
+            if (tagLength > 0) length = min(size - 1, (size_t)(length + tagLength));
+        }
+
+        // Format ist ein Literal aus LOG_*, Argumente sind immer 32 Bit
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+        int textLength = snprintf(line + length, size - length, record.format,
+                                  record.args[0], record.args[1], record.args[2], record.args[3]);
+#pragma GCC diagnostic pop
+        if (textLength > 0) length = min(size - 1, (size_t)(length + textLength));
+        return length;
+    }
+
+    // Neue Records formatieren und an sink(const char* line) geben (Drain-Task).
+    // Rückgabe: Anzahl ausgegebener Zeilen.
+    template <typename Sink>
+    uint16_t drain(Sink sink, uint16_t maxRecords) {
+        uint32_t newest = head.load(std::memory_order_acquire);
+        uint16_t count = 0;
+
+        // Zu weit zurück → überschrieben, überspringen
+        if (newest - drained > LOG_BUFFER_SIZE) {
+            lost += newest - drained - LOG_BUFFER_SIZE;
+            drained = newest - LOG_BUFFER_SIZE;
+        }
+
+        while (drained != newest && count < maxRecords) {
+            LogRecord record;
+            if (!read(drained, record)) {
+                // Schreiber noch dabei → beim nächsten Mal; sonst überschrieben
+                const Slot& slot = slots[drained & (LOG_BUFFER_SIZE - 1)];
+                if (slot.seq.load(std::memory_order_relaxed) < drained * 2 + 2) break;
+                lost++;
+                drained++;
+                continue;
+            }
+
+            char line[LOG_LINE_LEN];
+            format(record, line, sizeof(line));
+            sink(line);
+            drained++;
+            count++;
+        }
+        return count;
+    }
+
+    // Die letzten `count` Records (für HTTP), ohne den Drain zu verschieben
+    template <typename Sink>
+    void recent(Sink sink, uint16_t count) const {
+        uint32_t newest = head.load(std::memory_order_acquire);
+        if (count > LOG_BUFFER_SIZE) count = LOG_BUFFER_SIZE;
+        uint32_t ticket = newest > count ? newest - count : 0;
+
+        for (; ticket != newest; ticket++) {
+            LogRecord record;
+            if (!read(ticket, record)) continue;
+
+            char line[LOG_LINE_LEN];
+            format(record, line, sizeof(line));
+            sink(line);
+        }
+    }
+
+    uint32_t written() const { return head.load(std::memory_order_relaxed); }
+    uint32_t lostRecords() const { return lost; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        LogRecord record;
+    };
+
+    std::atomic<uint32_t> head;     // Nächstes Ticket
+    uint32_t drained;               // Nächstes Ticket für den Drain (nur Drain-Task)
+    uint32_t lost;
+    Slot slots[LOG_BUFFER_SIZE];
+
+    template <typename... Args>
+    static constexpr bool allIntegral() {
+        return (true && ... && (std::is_integral<Args>::value || std::is_enum<Args>::value));
+    }
+
+    static size_t min(size_t a, size_t b) { return a < b ? a : b; }
+
+    static uint32_t now() {
+#ifdef ARDUINO
+        return micros();
+#else
+        using namespace std::chrono;
+        static const steady_clock::time_point start = steady_clock::now();
+        return (uint32_t)duration_cast<microseconds>(steady_clock::now() - start).count();
+#endif
+    }
+};
+
+// Eine Instanz pro Firmware
+inline LogBuffer logBuffer;
+
+#define LOG_WRITE(level, tag, format, ...) logBuffer.write(level, tag, format, ##__VA_ARGS__)
+#define LOG_NOTHING() do {} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...)          LOG_WRITE(LOG_LEVEL_ERROR, nullptr, format, ##__VA_ARGS__)
+#define LOG_ERROR_TAG(tag, format, ...) LOG_WRITE(LOG_LEVEL_ERROR, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...)          LOG_NOTHING()
+#define LOG_ERROR_TAG(tag, format, ...) LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...)           LOG_WRITE(LOG_LEVEL_WARN, nullptr, format, ##__VA_ARGS__)
+#define LOG_WARN_TAG(tag, format, ...)  LOG_WRITE(LOG_LEVEL_WARN, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...)           LOG_NOTHING()
+#define LOG_WARN_TAG(tag, format, ...)  LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...)           LOG_WRITE(LOG_LEVEL_INFO, nullptr, format, ##__VA_ARGS__)
+#define LOG_INFO_TAG(tag, format, ...)  LOG_WRITE(LOG_LEVEL_INFO, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...)           LOG_NOTHING()
+#define LOG_INFO_TAG(tag, format, ...)  LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...)          LOG_WRITE(LOG_LEVEL_DEBUG, nullptr, format, ##__VA_ARGS__)
+#define LOG_DEBUG_TAG(tag, format, ...) LOG_WRITE(LOG_LEVEL_DEBUG, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...)          LOG_NOTHING()
+#define LOG_DEBUG_TAG(tag, format, ...) LOG_NOTHING()
+#endif
+
+#ifdef ARDUINO
+// Drain-Task: formatiert im Hintergrund auf Serial. Läuft auf Core 0 mit
+// Priorität 1 – Render-Loop, Playback und Netzwerk warten nie auf die UART.
+inline void logDrainTask(void*) {
+    for (;;) {
+        logBuffer.drain([](const char* line) { Serial.println(line); }, LOG_DRAIN_BATCH);
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL));
+    }
+}
+
+inline TaskHandle_t logDrainHandle = nullptr;     // Für Stack-Reserve (common/MemoryStats.h)
+
+inline void startLogDrain() {
+    xTaskCreatePinnedToCore(logDrainTask, "log", 3072, nullptr, 1, &logDrainHandle, 0);
+}
+#endif
+
+#endif // LOG_H
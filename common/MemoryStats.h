@@ -0,0 +1,259 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <Arduino.h>
+#include "EffectEncoder.h"
+
+// ============================================================================
+// SPEICHER-TELEMETRIE (Heap, Stacks, Allokationen pro Subsystem)
+// ============================================================================
+//
+// Heap-Zahlen und Stack-Reserven liefert das System (ESP, FreeRTOS). Die
+// Allokationen zählt ein Hook um malloc/calloc/realloc: beide Firmwares
+// linken mit -Wl,--wrap=malloc usw. (platformio.ini, host/Makefile) und
+// definieren die Wrapper genau einmal mit MEMORY_ALLOCATION_HOOKS().
+// Zugeordnet wird über den aufrufenden Task: jeder Task meldet sich einmal
+// an und setzt per Scope, wofür er gerade Speicher holt.
+//
+//   memoryStats.registerTask("loop");
+//   MemoryScope scope(MEMORY_HTTP);        // bis zum Ende des Blocks
+//
+//   MemorySnapshot snapshot;
+//   memoryStats.snapshot(snapshot);
+//   encodeMemoryStats(snapshot, buffer, sizeof(buffer));
+//
+// Der Hook läuft bei jedem malloc, auch im Netzwerk-Stack: kein Lock, keine
+// Allokation, nur Atomics und ein Durchlauf über höchstens MEMORY_MAX_TASKS
+// Einträge. Nicht angemeldete Tasks und Code ohne Scope zählen als "other".
+
+#define MEMORY_MAX_TASKS      8
+#define MEMORY_JSON_SIZE      1024    // GET /api/memory bzw. /memory
+
+enum MemorySubsystem : uint8_t {
+    MEMORY_OTHER,           // Ohne Scope (Framework, WiFi, Start)
+    MEMORY_JSON,            // Request-Bodies, JsonDocument, Antworten der API
+    MEMORY_HTTP,            // Requests an andere Geräte: Adresse, URL, HTTPClient, Antwort
+    MEMORY_SEQUENCE,        // Sequenzen laden und abspielen
+    NUM_MEMORY_SUBSYSTEMS
+};
+
+static const char* const MEMORY_SUBSYSTEM_NAMES[NUM_MEMORY_SUBSYSTEMS] = {
+    "other", "json", "http", "sequence"
+};
+
+struct MemoryTask {
+    std::atomic<TaskHandle_t> handle;   // Zuletzt gesetzt: danach ist der Eintrag gültig
+    const char* name;
+    uint8_t subsystem;                  // Nur der Task selbst liest und schreibt
+    std::atomic<uint32_t> allocations;
+};
+
+struct MemoryCounter {
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> bytes;        // Angefordert, läuft nach 4 GB über
+};
+
+struct MemorySnapshot {
+    uint32_t heapSize;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;               // Tiefststand seit dem Start
+    uint32_t largestFreeBlock;          // Fragmentierung: größtes malloc, das noch geht
+    uint8_t taskCount;
+    struct {
+        const char* name;
+        uint32_t stackFree;             // Bytes, Tiefststand (Host: 0)
+        uint32_t allocations;
+    } tasks[MEMORY_MAX_TASKS];
+    uint32_t allocations[NUM_MEMORY_SUBSYSTEMS];
+    uint32_t bytes[NUM_MEMORY_SUBSYSTEMS];
+};
+
+class MemoryStats {
+public:
+    // Idempotent. Ohne Handle: der aufrufende Task
+    void registerTask(const char* name, TaskHandle_t handle = xTaskGetCurrentTaskHandle()) {
+        if (!handle || find(handle)) return;
+        uint8_t slot = claimed.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= MEMORY_MAX_TASKS) return;
+        tasks[slot].name = name;
+        tasks[slot].subsystem = MEMORY_OTHER;
+        tasks[slot].handle.store(handle, std::memory_order_release);
+    }
+
+    // Liefert das vorherige Subsystem für leave() (Scopes schachteln)
+    MemorySubsystem enter(MemorySubsystem subsystem) {
+        MemoryTask* task = current();
+        if (!task) return MEMORY_OTHER;
+        MemorySubsystem previous = (MemorySubsystem)task->subsystem;
+        task->subsystem = subsystem;
+        return previous;
+    }
+
+    void leave(MemorySubsystem previous) {
+        MemoryTask* task = current();
+        if (task) task->subsystem = previous;
+    }
+
+    // Aus dem malloc-Hook
+    void countAllocation(size_t bytes) {
+        uint8_t subsystem = MEMORY_OTHER;
+        MemoryTask* task = current();
+        if (task) {
+            subsystem = task->subsystem;
+            task->allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        counters[subsystem].count.fetch_add(1, std::memory_order_relaxed);
+        counters[subsystem].bytes.fetch_add((uint32_t)bytes, std::memory_order_relaxed);
+    }
+
+    uint32_t allocations(MemorySubsystem subsystem) const {
+        return counters[subsystem].count.load(std::memory_order_relaxed);
+    }
+
+    void snapshot(MemorySnapshot& out) const {
+        out.heapSize = ESP.getHeapSize();
+        out.freeHeap = ESP.getFreeHeap();
+        out.minFreeHeap = ESP.getMinFreeHeap();
+        out.largestFreeBlock = ESP.getMaxAllocHeap();
+
+        out.taskCount = 0;
+        for (uint8_t i = 0; i < registered(); i++) {
+            TaskHandle_t handle = tasks[i].handle.load(std::memory_order_acquire);
+            if (!handle) continue;
+            auto& entry = out.tasks[out.taskCount++];
+            entry.name = tasks[i].name;
+            entry.stackFree = uxTaskGetStackHighWaterMark(handle);
+            entry.allocations = tasks[i].allocations.load(std::memory_order_relaxed);
+        }
+
+        for (uint8_t s = 0; s < NUM_MEMORY_SUBSYSTEMS; s++) {
+            out.allocations[s] = counters[s].count.load(std::memory_order_relaxed);
+            out.bytes[s] = counters[s].bytes.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Nur Nullen, kein Konstruktor: steht fest, bevor das erste malloc läuft
+    MemoryTask tasks[MEMORY_MAX_TASKS];
+    std::atomic<uint8_t> claimed;
+    MemoryCounter counters[NUM_MEMORY_SUBSYSTEMS];
+
+    uint8_t registered() const {
+        uint8_t count = claimed.load(std::memory_order_relaxed);
+        return count < MEMORY_MAX_TASKS ? count : MEMORY_MAX_TASKS;
+    }
+
+    MemoryTask* find(TaskHandle_t handle) {
+        for (uint8_t i = 0; i < registered(); i++) {
+            if (tasks[i].handle.load(std::memory_order_acquire) == handle) return &tasks[i];
+        }
+        return nullptr;
+    }
+
+    // Vor der ersten Anmeldung nicht einmal den Task fragen (Start, statische Objekte)
+    MemoryTask* current() {
+        if (registered() == 0) return nullptr;
+        TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+        return handle ? find(handle) : nullptr;
+    }
+};
+
+inline MemoryStats memoryStats;
+
+// Subsystem für den Rest des Blocks (nur für den aufrufenden Task)
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem) : previous(memoryStats.enter(subsystem)) {}
+    ~MemoryScope() { memoryStats.leave(previous); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemorySubsystem previous;
+};
+
+// Einmal pro Firmware (in genau einer .cpp), dazu die --wrap-Flags beim Linken
+#define MEMORY_ALLOCATION_HOOKS()                                               \
+    extern "C" void* __real_malloc(size_t size);                                \
+    extern "C" void* __real_calloc(size_t count, size_t size);                  \
+    extern "C" void* __real_realloc(void* memory, size_t size);                 \
+    extern "C" void* __wrap_malloc(size_t size) {                               \
+        memoryStats.countAllocation(size);                                      \
+        return __real_malloc(size);                                             \
+    }                                                                           \
+    extern "C" void* __wrap_calloc(size_t count, size_t size) {                 \
+        memoryStats.countAllocation(count * size);                              \
+        return __real_calloc(count, size);                                      \
+    }                                                                           \
+    extern "C" void* __wrap_realloc(void* memory, size_t size) {                \
+        if (size) memoryStats.countAllocation(size);    /* 0 = free */          \
+        return __real_realloc(memory, size);                                    \
+    }
+
+// ============================================================================
+// JSON (GET /api/memory bzw. /memory)
+// ============================================================================
+//
+//   {"heap":{"size":327680,"free":204800,"minFree":184320,"largestFreeBlock":112640},
+//    "tasks":[{"name":"loop","stackFree":3120,"allocations":12},...],
+//    "allocations":{"other":{"count":210,"bytes":18342},"json":{...},...}}
+
+inline size_t encodeMemoryStats(const MemorySnapshot& snapshot, char* buffer, size_t size) {
+    JsonWriter out(buffer, size);
+
+    out.raw("{");
+    out.key("heap");
+    out.raw("{");
+    out.key("size");
+    out.unsignedNumber(snapshot.heapSize);
+    out.raw(",");
+    out.key("free");
+    out.unsignedNumber(snapshot.freeHeap);
+    out.raw(",");
+    out.key("minFree");
+    out.unsignedNumber(snapshot.minFreeHeap);
+    out.raw(",");
+    out.key("largestFreeBlock");
+    out.unsignedNumber(snapshot.largestFreeBlock);
+    out.raw("},");
+
+    out.key("tasks");
+    out.raw("[");
+    for (uint8_t i = 0; i < snapshot.taskCount; i++) {
+        if (i) out.raw(",");
+        out.raw("{");
+        out.key("name");
+        out.string(snapshot.tasks[i].name);
+        out.raw(",");
+        out.key("stackFree");
+        out.unsignedNumber(snapshot.tasks[i].stackFree);
+        out.raw(",");
+        out.key("allocations");
+        out.unsignedNumber(snapshot.tasks[i].allocations);
+        out.raw("}");
+    }
+    out.raw("],");
+
+    out.key("allocations");
+    out.raw("{");
+    for (uint8_t s = 0; s < NUM_MEMORY_SUBSYSTEMS; s++) {
+        if (s) out.raw(",");
+        out.key(MEMORY_SUBSYSTEM_NAMES[s]);
+        out.raw("{");
+        out.key("count");
+        out.unsignedNumber(snapshot.allocations[s]);
+        out.raw(",");
+        out.key("bytes");
+        out.unsignedNumber(snapshot.bytes[s]);
+        out.raw("}");
+    }
+    out.raw("}}");
+
+    return out.finish();
+}
+
+#endif // MEMORY_STATS_H
@@ -0,0 +1,199 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+// ============================================================================
+// EFFEKT-PROTOKOLL (Commander ↔ Scheinwerfer)
+// ============================================================================
+//
+// Einzige Definition der Typen, die über das Netz gehen. Beide Firmwares
+// binden diesen Header ein – Änderungen am Protokoll passieren nur hier,
+// in EffectKeywords.h (Namen), EffectParser.h und EffectEncoder.h (JSON).
+//
+// PROTOCOL_VERSION wird als "v" mitgeschickt. Bei inkompatiblen Änderungen
+// hochzählen; Scheinwerfer lehnen neuere Versionen mit 400 ab, Befehle ohne
+// "v" (ältere Commander, Handarbeit mit curl) gelten als Version 0.
+
+#define PROTOCOL_VERSION      1
+
+#define MAX_KEYFRAMES         8       // Keyframes pro Automationskurve
+#define NUM_PROGRAM_PARAMS    4       // Parameter p0..p3 für Pixel-Programme
+#define MAX_SEGMENTS          8       // Segmente pro Scheinwerfer (Bitmaske in uint8_t)
+#define MAX_BATCH_EFFECTS     8       // Effekte pro Scheinwerfer in einer /batch-Nachricht
+#define BATCH_JSON_SIZE       8192    // Obergrenze einer /batch-Nachricht (Effekt ohne Automation ~400 Bytes)
+
+// Ring-Typ
+enum RingType {
+    RING_INNER,
+    RING_OUTER,
+    RING_BOTH
+};
+
+// Effekt-Typen
+enum EffectType {
+    EFFECT_STATIC,
+    EFFECT_FADE,
+    EFFECT_STROBE,
+    EFFECT_PULSE,
+    EFFECT_ROTATION,
+    EFFECT_RAINBOW,
+    EFFECT_CHASE,
+    EFFECT_PROGRAM,         // Bytecode-Programm (PixelProgram)
+    EFFECT_OFF
+};
+
+// Rotations-Pattern
+enum RotationPattern {
+    PATTERN_SINGLE,
+    PATTERN_TRAIL,
+    PATTERN_OPPOSITE,
+    PATTERN_WAVE,
+    PATTERN_RAINBOW_CHASE
+};
+
+// Rotations-Richtung
+enum RotationDirection {
+    DIRECTION_CLOCKWISE,
+    DIRECTION_COUNTERCLOCKWISE
+};
+
+// Keyframe-Easing (Verlauf vom vorherigen Keyframe zum nächsten)
+enum Easing {
+    EASING_LINEAR,
+    EASING_STEP,            // Alten Wert halten, am Keyframe springen
+    EASING_IN_OUT
+};
+
+// Farb-Struktur
+struct Color {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    Color() : r(0), g(0), b(0) {}
+    Color(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+};
+
+// Rotation-Parameter
+struct RotationParams {
+    Color activeColor;
+    Color inactiveColor;
+    uint16_t speed;
+    RotationDirection direction;
+    RotationPattern pattern;
+    uint8_t trailLength;
+
+    RotationParams() :
+        activeColor(255, 0, 0),
+        inactiveColor(0, 0, 0),
+        speed(100),
+        direction(DIRECTION_CLOCKWISE),
+        pattern(PATTERN_SINGLE),
+        trailLength(3) {}
+};
+
+// Keyframe: Wert zu einem Zeitpunkt (ms ab Effektstart)
+struct Keyframe {
+    uint32_t time;
+    uint32_t value : 24;    // Farbe als 0xRRGGBB
+    uint32_t easing : 8;    // Easing
+};
+
+// Automationskurve für einen Parameter
+struct Automation {
+    uint8_t count;          // 0 = keine Automation
+    bool loop;              // Wiederholen, Periode = Zeit des letzten Keyframes
+    Keyframe keys[MAX_KEYFRAMES];
+
+    Automation() : count(0), loop(false) {}
+};
+
+// Automationskurven eines Effekts (auf dem Scheinwerfer pro Frame ausgewertet)
+struct EffectAutomation {
+    Automation brightness;
+    Automation color;       // color bzw. rotation.activeColor
+    Automation speed;       // speed bzw. rotation.speed
+    Automation trailLength;
+};
+
+// Effekt-Befehl, so wie er übertragen wird
+struct Effect {
+    EffectType type;
+    RingType ring;
+    Color color;
+    Color color2;
+    uint8_t brightness;
+    uint16_t speed;
+    uint16_t duration;
+    uint16_t transitionMs;  // Überblendzeit vom vorherigen Effekt (0 = harter Schnitt)
+    unsigned long startTime; // Start in der Show-Uhr (0 = sofort)
+    RotationParams rotation;
+    EffectAutomation automation;
+    uint8_t segments;       // Bitmaske der Ziel-Segmente (0 = alle Segmente von `ring`)
+    uint8_t palette;        // Paletten-ID (0 = feste Farben)
+    uint8_t program;        // Programm-Slot (EFFECT_PROGRAM)
+    int16_t programParams[NUM_PROGRAM_PARAMS];
+    uint32_t traceId;       // Latenz-Tracing (0 = nicht verfolgt), siehe Trace.h
+
+    Effect() :
+        type(EFFECT_OFF),
+        ring(RING_BOTH),
+        color(0, 0, 0),
+        color2(0, 0, 0),
+        brightness(255),
+        speed(100),
+        duration(0),
+        transitionMs(0),
+        startTime(0),
+        segments(0),
+        palette(0),
+        program(0),
+        programParams(),
+        traceId(0) {}
+};
+
+// ============================================================================
+// VERGLEICH (Schattenzustand im Commander, Delta-Updates)
+// ============================================================================
+
+inline bool operator==(const Color& a, const Color& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+inline bool operator!=(const Color& a, const Color& b) { return !(a == b); }
+
+inline bool operator==(const RotationParams& a, const RotationParams& b) {
+    return a.activeColor == b.activeColor && a.inactiveColor == b.inactiveColor &&
+           a.speed == b.speed && a.direction == b.direction &&
+           a.pattern == b.pattern && a.trailLength == b.trailLength;
+}
+inline bool operator!=(const RotationParams& a, const RotationParams& b) { return !(a == b); }
+
+inline bool operator==(const Automation& a, const Automation& b) {
+    if (a.count != b.count || (a.count && a.loop != b.loop)) return false;
+    for (uint8_t i = 0; i < a.count; i++) {
+        if (a.keys[i].time != b.keys[i].time || a.keys[i].value != b.keys[i].value ||
+            a.keys[i].easing != b.keys[i].easing) return false;
+    }
+    return true;
+}
+
+inline bool operator==(const EffectAutomation& a, const EffectAutomation& b) {
+    return a.brightness == b.brightness && a.color == b.color &&
+           a.speed == b.speed && a.trailLength == b.trailLength;
+}
+inline bool operator!=(const EffectAutomation& a, const EffectAutomation& b) { return !(a == b); }
+
+// Gleiches Bild: alles außer Ring, Startzeit, Überblendung und Trace
+inline bool sameEffectState(const Effect& a, const Effect& b) {
+    if (a.type != b.type || a.color != b.color || a.color2 != b.color2 ||
+        a.brightness != b.brightness || a.speed != b.speed || a.duration != b.duration ||
+        a.segments != b.segments || a.palette != b.palette || a.program != b.program ||
+        a.rotation != b.rotation || a.automation != b.automation) return false;
+    for (uint8_t i = 0; i < NUM_PROGRAM_PARAMS; i++) {
+        if (a.programParams[i] != b.programParams[i]) return false;
+    }
+    return true;
+}
+
+#endif // PROTOCOL_H
@@ -0,0 +1,106 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Histogram.h"
+#include "Protocol.h"
+
+// ============================================================================
+// FRAME-TELEMETRIE (Scheinwerfer → Commander, binär)
+// ============================================================================
+//
+// Der Scheinwerfer misst jeden Loop-Durchlauf mit dem CPU-Taktzähler und
+// liefert auf GET /telemetry einen Header und pro Messstelle einen Eintrag:
+// Zusammenfassung des letzten Fensters (ns) und das Histogramm seit dem
+// Einschalten (CPU-Takte, Umrechnung über cpuMhz). Beide Seiten sind ESP32,
+// die Structs gehen daher unverändert (little-endian, packed) über das Netz.
+//
+//   TelemetryHeader header;
+//   TelemetryEntry entry;
+//   if (readTelemetryHeader(data, length, header))
+//       for (uint8_t i = 0; readTelemetryEntry(data, length, header, i, entry); i++) ...
+
+#define TELEMETRY_VERSION     1
+#define TELEMETRY_WINDOW_MS   1000    // Fenster für min/avg/p99/max
+#define TELEMETRY_ANY         0xFF    // ring/effect eines Eintrags ohne Ring-Bezug
+
+#define NUM_EFFECT_TYPES      (EFFECT_OFF + 1)
+#define NUM_RENDER_RINGS      2       // RING_INNER, RING_OUTER
+
+// Messstellen in loop()
+enum TelemetryStage : uint8_t {
+    STAGE_NETWORK,          // UDP-Empfang + Befehls-Queue (inkl. Warten auf den State-Lock)
+    STAGE_RENDER,           // updateEffects() gesamt; pro Ring/Effekt mit ring/effect
+    STAGE_SHOW,             // FastLED.show()
+    STAGE_PERIOD,           // Abstand zweier Loop-Starts
+    NUM_TELEMETRY_STAGES
+};
+
+static const char* const TELEMETRY_STAGE_NAMES[NUM_TELEMETRY_STAGES] = {
+    "network", "render", "show", "period"
+};
+
+// Flags im Header
+#define TELEMETRY_FLAG_ENABLED  0x01
+
+struct __attribute__((packed)) TelemetrySummary {
+    uint32_t count;
+    uint32_t minNs;
+    uint32_t avgNs;
+    uint32_t p99Ns;         // Obergrenze des p99-Buckets, gedeckelt auf max
+    uint32_t maxNs;
+};
+
+struct __attribute__((packed)) TelemetryHeader {
+    uint8_t version;
+    uint8_t flags;
+    uint16_t cpuMhz;
+    uint16_t windowMs;
+    uint8_t entries;
+    uint8_t buckets;        // HISTOGRAM_BUCKETS des Senders
+    uint32_t uptime;        // ms
+};
+
+struct __attribute__((packed)) TelemetryEntry {
+    uint8_t stage;          // TelemetryStage
+    uint8_t ring;           // RingType oder TELEMETRY_ANY
+    uint8_t effect;         // EffectType oder TELEMETRY_ANY
+    uint8_t reserved;
+    TelemetrySummary window;                // Letztes abgeschlossenes Fenster
+    uint32_t buckets[HISTOGRAM_BUCKETS];    // Seit dem Einschalten, CPU-Takte
+};
+
+// Takte → ns (64 Bit, sonst läuft es ab ~18 ms über)
+inline uint32_t cyclesToNs(uint32_t cycles, uint16_t cpuMhz) {
+    uint64_t ns = (uint64_t)cycles * 1000 / (cpuMhz ? cpuMhz : 1);
+    return ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+inline void summarize(const Histogram& histogram, uint16_t cpuMhz, TelemetrySummary& summary) {
+    summary.count = histogram.count;
+    summary.minNs = histogram.count ? cyclesToNs(histogram.min, cpuMhz) : 0;
+    summary.avgNs = cyclesToNs(histogram.average(), cpuMhz);
+    summary.p99Ns = cyclesToNs(histogram.percentile(99), cpuMhz);
+    summary.maxNs = cyclesToNs(histogram.max, cpuMhz);
+}
+
+inline bool readTelemetryHeader(const uint8_t* data, size_t length, TelemetryHeader& header) {
+    if (length < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    return header.version == TELEMETRY_VERSION && header.buckets == HISTOGRAM_BUCKETS &&
+           length >= sizeof(header) + (size_t)header.entries * sizeof(TelemetryEntry);
+}
+
+// Eintrag `index` kopieren (Buffer ist nicht ausgerichtet)
+inline bool readTelemetryEntry(const uint8_t* data, size_t length, const TelemetryHeader& header,
+                               uint8_t index, TelemetryEntry& entry) {
+    if (index >= header.entries) return false;
+    size_t offset = sizeof(header) + (size_t)index * sizeof(entry);
+    if (offset + sizeof(entry) > length) return false;
+    memcpy(&entry, data + offset, sizeof(entry));
+    return true;
+}
+
+#endif // TELEMETRY_H
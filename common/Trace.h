@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// LATENZ-TRACING (API-Aufruf → erster Frame mit dem neuen Effekt)
+// ============================================================================
+//
+// Der Commander vergibt pro Effekt-Befehl eine Trace-ID und schickt sie als
+// "trace" im Effekt mit. Zeitpunkte (µs, Show-Uhr = micros() des Commanders):
+//
+//   started   Commander: Request angenommen bzw. Soll-Zeit des Sequenz-Events
+//   sent      Commander: POST an den Scheinwerfer beginnt
+//   received  Scheinwerfer: /effect dekodiert (Netzwerk-Task)
+//   applied   Scheinwerfer: setEffect() in der Render-Loop fertig
+//   shown     Scheinwerfer: erstes FastLED.show() danach fertig
+//
+// Der Scheinwerfer schickt received/applied/shown als TraceSpan per UDP an
+// den Absender des Befehls zurück. Scheinwerfer-Zeiten sind über /clock auf
+// etwa eine halbe RTT genau – der Abschnitt "wire" enthält diesen Fehler.
+
+#define TRACE_VERSION         1
+#define TRACE_PORT            4049    // UDP, Scheinwerfer → Commander
+
+// Abschnitte zwischen zwei Zeitpunkten
+enum TraceStage : uint8_t {
+    TRACE_DISPATCH,         // started → sent (Job-Queue, vorherige Ziele)
+    TRACE_WIRE,             // sent → received (Verbindung, HTTP, Parsen)
+    TRACE_QUEUE,            // received → applied (Befehls-Queue bis zum nächsten Frame)
+    TRACE_RENDER,           // applied → shown (Rendern + FastLED.show())
+    NUM_TRACE_STAGES
+};
+
+static const char* const TRACE_STAGE_NAMES[NUM_TRACE_STAGES] = {
+    "dispatch", "wire", "queue", "render"
+};
+
+// UDP-Paket eines Scheinwerfers (packed, little-endian wie beide ESP32)
+struct __attribute__((packed)) TraceSpan {
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t traceId;
+    uint32_t received;
+    uint32_t applied;
+    uint32_t shown;
+    char spotlight[16];     // ID des Scheinwerfers, nullterminiert
+};
+
+// Abstand zweier Zeitpunkte; negativ (Uhrenfehler) → 0
+inline uint32_t traceSpan(uint32_t from, uint32_t to) {
+    int32_t delta = (int32_t)(to - from);
+    return delta > 0 ? (uint32_t)delta : 0;
+}
+
+#endif // TRACE_H
@@ -0,0 +1,52 @@
+#include <stdlib.h>
+#include <string>
+#include "LightCommander.h"
+
+// ============================================================================
+// COMMANDER AUF DEM HOST (Echtzeit)
+// ============================================================================
+//
+// Der echte LightCommander als Linux-Prozess: REST-API auf 127.0.0.1,
+// HTTP zu den Scheinwerfern über echte TCP-Verbindungen (HostRuntime.h,
+// hostUseRealTime()). Gegenstück zu commander-load, geht aber genauso mit
+// curl oder echten Scheinwerfern im Netz:
+//
+//   commander --port 8080
+//   curl -d '{"id":"a","name":"a","ip":"127.0.0.1:18000"}' localhost:8080/api/spotlight/add
+//
+// Der Loop-Task ruft loop() jede Millisekunde (ESP32: so oft es geht) –
+// Sequenz-Events laufen also mit bis zu 1 ms Verspätung los.
+
+#define HOST_LOOP_TICK_MS     1
+
+static void usage() {
+    fprintf(stderr, "Usage: commander [--port N] [--logs]\n");
+}
+
+int main(int argc, char** argv) {
+    uint16_t port = 8080;
+    bool logs = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) port = atoi(argv[++i]);
+        else if (arg == "--logs") logs = true;
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    hostUseRealTime();
+    hostSetWebServerPort(port);
+    if (!logs) hostSetSerial(nullptr);
+
+    static LightCommander commander;
+    commander.begin("host", "", false);
+    fprintf(stderr, "commander: http://127.0.0.1:%u\n", port);
+
+    while (true) {
+        commander.loop();
+        delay(HOST_LOOP_TICK_MS);
+    }
+}
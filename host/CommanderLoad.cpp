@@ -0,0 +1,766 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "EffectParser.h"
+#include "shim/HostNet.h"
+
+// ============================================================================
+// LASTTEST FÜR DEN COMMANDER (Host, Echtzeit)
+// ============================================================================
+//
+// Treibt einen echten Commander-Prozess (build/commander) über seine REST-API
+// gegen viele simulierte Scheinwerfer, alles auf einem Linux-Rechner:
+//
+//   commander-load                                      # 1,4,8,16,32,48,64 Scheinwerfer
+//   commander-load --spotlights 8,32 --effect-rate 50 --latency 5 --jitter 2
+//   commander-load --play-rate 10 --effect-rate 0       # Nur Sequenz-Starts
+//   commander-load --effect-rate 0 --status-rate 200 --max-lateness 20
+//   commander-load --commander 127.0.0.1:8080           # Laufenden Commander nehmen
+//
+// Die Scheinwerfer sind HTTP-Server auf 127.0.0.1:BASE+i (ein epoll-Thread
+// für alle) mit /effect, /stop, /status, /clock und einstellbarer
+// Antwortzeit. Jeder Effekt trägt eine Kennung in der Farbe, so lässt sich
+// jede Ankunft ihrem API-Aufruf zuordnen.
+//
+// Last ist "open loop": Aufrufe haben feste Soll-Zeitpunkte (Rate), alle
+// Zeiten zählen ab dem Soll-Zeitpunkt – ein gestauter Commander verschiebt
+// also nicht die Last, sondern zeigt sich in der Latenz.
+//
+//   API       Soll-Zeitpunkt → Antwort des Commanders
+//   Dispatch  Soll-Zeitpunkt → Ankunft des Effekts beim Scheinwerfer
+//   Fehler    API: Antwort nicht 2xx; Zustellung: angenommen, aber der
+//             Effekt kam bei einem Ziel nie an
+//
+// Mit --status-rate läuft dazu eine Show (Sequenz "load-show" in Schleife)
+// und /api/status wird mit fester Rate abgefragt. Am Ende zeigt die Zeile
+// "playback" playback.maxLateness – die Status-Abfragen dürfen das Timing
+// der Show nicht verschieben (--max-lateness: sonst Exit-Code 1).
+//
+// Nimmt der Commander nicht alle Scheinwerfer an (MAX_SPOTLIGHTS), ist das
+// ein Ergebnis: Zeile "spotlight/add" mit der Anzahl registrierter, weiter
+// mit der nächsten Anzahl.
+
+#define LOAD_MAX_SPOTLIGHTS   256
+#define LOAD_PLAY_SEQUENCES   64        // Sequenzen "load-K" für --play-rate
+#define LOAD_PLAY_MARK        0x800000  // Kennung eines Sequenz-Effekts (Bit in Rot)
+#define LOAD_SHOW_TAG         (LOAD_PLAY_MARK | 0xFFFF)     // Show-Events, nicht zugeordnet
+#define LOAD_SHOW_EVENTS      20        // Events pro Durchlauf der Show …
+#define LOAD_SHOW_STEP_MS     50        // … in diesem Abstand (1 s, Schleife)
+#define LOAD_HTTP_TIMEOUT_MS  10000
+#define LOAD_DRAIN_TIMEOUT_S  30        // Warten auf den Abbau der Job-Queue
+#define LOAD_STARTUP_MS       5000      // Commander-Prozess muss antworten
+
+struct LoadOptions {
+    std::vector<uint32_t> counts = { 1, 4, 8, 16, 32, 48, 64 };
+    double durationS = 10;
+    double effectRate = 20;     // /api/effect/send pro Sekunde
+    double playRate = 0;        // /api/sequence/play pro Sekunde
+    double statusRate = 0;      // /api/status pro Sekunde, dazu die Show
+    double maxLatenessMs = -1;  // Grenze für playback.maxLateness (< 0 = keine)
+    double latencyMs = 2;       // Antwortzeit der Scheinwerfer
+    double jitterMs = 1;        // Gleichverteilt ±
+    uint32_t clients = 8;       // Parallele API-Verbindungen
+    uint16_t basePort = 18000;
+    uint16_t commanderPort = 18080;
+    std::string commander;      // "ip:port" eines laufenden Commanders
+    std::string binary;         // build/commander
+    bool logs = false;
+};
+
+static LoadOptions options;
+
+static uint64_t nowUs() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void sleepUntil(uint64_t us) {
+    uint64_t now = nowUs();
+    if (us > now) std::this_thread::sleep_for(std::chrono::microseconds(us - now));
+}
+
+// Exakte Perzentile wie im Commander-Simulator
+struct Samples {
+    std::vector<uint64_t> values;
+
+    void add(uint64_t value) { values.push_back(value); }
+
+    double percentileMs(uint8_t p) const {
+        if (values.empty()) return 0;
+        std::vector<uint64_t> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (sorted.size() * p + 99) / 100;
+        return sorted[rank ? rank - 1 : 0] / 1000.0;
+    }
+};
+
+// ============================================================================
+// SIMULIERTE SCHEINWERFER
+// ============================================================================
+
+struct Arrival {
+    uint32_t tag;               // Kennung aus der Effekt-Farbe
+    uint16_t spot;              // 0-basiert
+    uint64_t atUs;
+};
+
+struct FakeConnection {
+    uint16_t spot;
+    std::string data;
+    std::string response;
+    uint64_t respondAt = 0;     // 0 = Request noch unvollständig
+};
+
+class FakeSpotlights {
+public:
+    bool start(uint32_t count);
+    void stop();
+
+    // Ankünfte seit dem letzten Aufruf
+    std::vector<Arrival> takeArrivals();
+
+private:
+    int epollFd = -1;
+    std::map<int, uint16_t> listeners;
+    std::unordered_map<int, FakeConnection> connections;
+    std::vector<Arrival> arrivals;
+    std::mutex arrivalsLock;
+    std::atomic<bool> running{false};
+    std::thread thread;
+    std::mt19937 random;
+
+    void serve();
+    void accept(int listener, uint16_t spot);
+    void receive(int fd, FakeConnection& connection);
+    std::string respond(FakeConnection& connection, const std::string& head, const std::string& body);
+    uint64_t responseDelayUs();
+};
+
+bool FakeSpotlights::start(uint32_t count) {
+    epollFd = epoll_create1(0);
+    for (uint32_t i = 0; i < count; i++) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in local = {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        local.sin_port = htons(options.basePort + i);
+        if (bind(fd, (sockaddr*)&local, sizeof(local)) < 0 || listen(fd, 128) < 0) {
+            fprintf(stderr, "Scheinwerfer-Port %u: %s\n", options.basePort + i, strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        listeners[fd] = i;
+    }
+
+    running = true;
+    thread = std::thread([this] { serve(); });
+    return true;
+}
+
+void FakeSpotlights::stop() {
+    running = false;
+    if (thread.joinable()) thread.join();
+    for (auto& entry : connections) close(entry.first);
+    for (auto& entry : listeners) close(entry.first);
+    connections.clear();
+    listeners.clear();
+    close(epollFd);
+}
+
+std::vector<Arrival> FakeSpotlights::takeArrivals() {
+    std::lock_guard<std::mutex> lock(arrivalsLock);
+    std::vector<Arrival> taken;
+    taken.swap(arrivals);
+    return taken;
+}
+
+uint64_t FakeSpotlights::responseDelayUs() {
+    std::uniform_real_distribution<double> jitter(-options.jitterMs, options.jitterMs);
+    return (uint64_t)(std::max(0.0, options.latencyMs + jitter(random)) * 1000);
+}
+
+// Ein Thread für alle Scheinwerfer: Antworten warten in den Verbindungen
+// bis respondAt, epoll_wait schläft bis zur nächsten fälligen Antwort
+void FakeSpotlights::serve() {
+    epoll_event events[64];
+
+    while (running) {
+        uint64_t now = nowUs();
+        uint64_t next = now + 50000;
+        for (auto it = connections.begin(); it != connections.end();) {
+            FakeConnection& connection = it->second;
+            if (connection.respondAt && connection.respondAt <= now) {
+                // Klein genug für den Socket-Puffer, danach schließt der Server
+                send(it->first, connection.response.data(), connection.response.size(), MSG_NOSIGNAL);
+                close(it->first);
+                it = connections.erase(it);
+                continue;
+            }
+            if (connection.respondAt) next = std::min(next, connection.respondAt);
+            ++it;
+        }
+
+        int timeoutMs = (int)((next - now + 999) / 1000);
+        int count = epoll_wait(epollFd, events, 64, timeoutMs);
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            auto listener = listeners.find(fd);
+            if (listener != listeners.end()) {
+                accept(fd, listener->second);
+                continue;
+            }
+            auto connection = connections.find(fd);
+            if (connection != connections.end()) receive(fd, connection->second);
+        }
+    }
+}
+
+void FakeSpotlights::accept(int listener, uint16_t spot) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd < 0) return;
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        connections[fd].spot = spot;
+    }
+}
+
+void FakeSpotlights::receive(int fd, FakeConnection& connection) {
+    char buffer[4096];
+    ssize_t count;
+    while ((count = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        connection.data.append(buffer, count);
+    }
+    if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+        return;
+    }
+
+    // Vollständig? Kopf bis zur Leerzeile, dann Content-Length Bytes
+    size_t headEnd = connection.data.find("\r\n\r\n");
+    if (headEnd == std::string::npos) return;
+    std::string head = connection.data.substr(0, headEnd + 2);
+    size_t length = 0;
+    for (size_t pos = head.find("\r\n"); pos != std::string::npos; pos = head.find("\r\n", pos + 2)) {
+        if (strncasecmp(head.c_str() + pos + 2, "Content-Length:", 15) == 0) {
+            length = strtoul(head.c_str() + pos + 17, nullptr, 10);
+        }
+    }
+    if (connection.data.size() < headEnd + 4 + length) return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    connection.response = respond(connection, head, connection.data.substr(headEnd + 4, length));
+    connection.respondAt = nowUs() + responseDelayUs();
+}
+
+std::string FakeSpotlights::respond(FakeConnection& connection, const std::string& head,
+                                    const std::string& body) {
+    size_t pathStart = head.find(' ') + 1;
+    std::string path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+
+    int code = 200;
+    std::string content = "{\"success\":true}";
+    if (path == "/effect" || path == "/effect/delta") {
+        // Ankunft zählt, nicht die (simulierte) Antwort. Ein Delta enthält die
+        // Farbe immer, weil jede Kennung eine neue Farbe ist.
+        Effect effect;
+        if (decodeEffect(body.data(), body.size(), effect) == DECODE_OK) {
+            uint32_t tag = ((uint32_t)effect.color.r << 16) | (effect.color.g << 8) | effect.color.b;
+            std::lock_guard<std::mutex> lock(arrivalsLock);
+            arrivals.push_back({ tag, connection.spot, nowUs() });
+        } else {
+            code = 400;
+            content = "{\"error\":\"Invalid JSON\"}";
+        }
+    } else if (path == "/status") {
+        content = "{\"id\":\"spot-" + std::to_string(connection.spot + 1) + "\",\"effect\":\"off\"}";
+    } else if (path != "/stop" && path != "/clock") {
+        code = 404;     // /telemetry usw.: Commander kommt ohne aus
+        content = "{\"error\":\"Not found\"}";
+    }
+
+    return "HTTP/1.1 " + std::to_string(code) + (code == 200 ? " OK" : " Error") + "\r\n" +
+           "Content-Type: application/json\r\n" +
+           "Content-Length: " + std::to_string(content.size()) + "\r\n" +
+           "Connection: close\r\n\r\n" + content;
+}
+
+// ============================================================================
+// REST-CLIENT
+// ============================================================================
+
+static std::string commanderHost;   // "ip:port"
+
+// Status-Code, -1 = keine Verbindung / Timeout
+static int callCommander(const char* method, const std::string& path, const std::string& body,
+                         std::string* response = nullptr) {
+    size_t colon = commanderHost.find(':');
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(atoi(commanderHost.c_str() + colon + 1));
+    inet_pton(AF_INET, commanderHost.substr(0, colon).c_str(), &remote.sin_addr);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*)&remote, sizeof(remote)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    std::string message = std::string(method) + " " + path + " HTTP/1.1\r\n" +
+                          "Host: " + commanderHost + "\r\n" +
+                          "Content-Type: application/json\r\n" +
+                          "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                          "Connection: close\r\n\r\n" + body;
+
+    int code = -1;
+    std::string head, content;
+    if (hostWriteAll(fd, message, LOAD_HTTP_TIMEOUT_MS) &&
+        hostReadHttp(fd, head, content, LOAD_HTTP_TIMEOUT_MS, true)) {
+        size_t space = head.find(' ');
+        if (space != std::string::npos) code = atoi(head.c_str() + space + 1);
+    }
+    close(fd);
+    if (response) *response = content;
+    return code;
+}
+
+// Zahl aus /api/status ("key":N), -1 = Commander antwortet nicht
+static long statusValue(const char* key) {
+    std::string status;
+    if (callCommander("GET", "/api/status", "", &status) != 200) return -1;
+    std::string quoted = std::string("\"") + key + "\":";
+    size_t pos = status.find(quoted);
+    return pos == std::string::npos ? 0 : atol(status.c_str() + pos + quoted.size());
+}
+
+static int jobsPending() {
+    return statusValue("jobsPending");
+}
+
+// Bis die Job-Queue leer ist (false = Timeout oder Commander weg)
+static bool drainJobs() {
+    uint64_t deadline = nowUs() + LOAD_DRAIN_TIMEOUT_S * 1000000ull;
+    while (nowUs() < deadline) {
+        int pending = jobsPending();
+        if (pending < 0) return false;
+        if (pending == 0) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+// Aufträge über die Job-Queue: bei 503 (Queue voll) nochmal
+static bool submitWithRetry(const std::string& path, const std::string& body) {
+    for (int attempt = 0; attempt < 500; attempt++) {
+        int code = callCommander("POST", path, body);
+        if (code >= 200 && code < 300) return true;
+        if (code != 503) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static std::string targetList(uint32_t count) {
+    std::string list = "[";
+    for (uint32_t i = 1; i <= count; i++) {
+        if (i > 1) list += ",";
+        list += "\"spot-" + std::to_string(i) + "\"";
+    }
+    return list + "]";
+}
+
+static std::string colorOf(uint32_t tag) {
+    return "[" + std::to_string(tag >> 16) + "," + std::to_string((tag >> 8) & 0xFF) + "," +
+           std::to_string(tag & 0xFF) + "]";
+}
+
+// ============================================================================
+// COMMANDER-PROZESS
+// ============================================================================
+
+static pid_t startCommander() {
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (!options.logs) {
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDERR_FILENO);
+        }
+        std::string port = std::to_string(options.commanderPort);
+        if (options.logs) {
+            execl(options.binary.c_str(), options.binary.c_str(), "--port", port.c_str(), "--logs", (char*)nullptr);
+        } else {
+            execl(options.binary.c_str(), options.binary.c_str(), "--port", port.c_str(), (char*)nullptr);
+        }
+        perror(options.binary.c_str());
+        _exit(127);
+    }
+
+    uint64_t deadline = nowUs() + LOAD_STARTUP_MS * 1000ull;
+    while (nowUs() < deadline) {
+        if (jobsPending() >= 0) return pid;
+        if (waitpid(pid, nullptr, WNOHANG) == pid) return -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    return -1;
+}
+
+static void stopCommander(pid_t pid) {
+    if (pid <= 0) return;
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+// ============================================================================
+// LAST
+// ============================================================================
+
+enum LoadPath { PATH_EFFECT, PATH_PLAY, PATH_STATUS, NUM_LOAD_PATHS };
+
+static const char* const LOAD_PATH_NAMES[NUM_LOAD_PATHS] = { "effect/send", "sequence/play", "status" };
+
+struct Call {
+    LoadPath path;
+    uint32_t tag;
+    uint64_t slotUs;            // Soll-Zeitpunkt
+    uint64_t doneUs;
+    int code;
+};
+
+struct Row {
+    uint32_t calls = 0;
+    uint32_t apiFailed = 0;
+    uint32_t expected = 0;      // Angenommene Aufrufe × Ziele
+    uint32_t delivered = 0;
+    Samples api;
+    Samples dispatch;
+};
+
+// Soll-Zeitpunkte beider Pfade zusammengeführt, nach Zeit sortiert
+static std::vector<Call> schedule(uint64_t startUs) {
+    std::vector<Call> calls;
+    const double rates[NUM_LOAD_PATHS] = { options.effectRate, options.playRate, options.statusRate };
+    for (int path = 0; path < NUM_LOAD_PATHS; path++) {
+        if (rates[path] <= 0) continue;
+        uint32_t total = (uint32_t)(options.durationS * rates[path]);
+        for (uint32_t i = 0; i < total; i++) {
+            Call call = {};
+            call.path = (LoadPath)path;
+            call.tag = path == PATH_EFFECT ? i + 1 : LOAD_PLAY_MARK | (i % LOAD_PLAY_SEQUENCES);
+            call.slotUs = startUs + (uint64_t)(i * 1e6 / rates[path]);
+            calls.push_back(call);
+        }
+    }
+    std::sort(calls.begin(), calls.end(), [](const Call& a, const Call& b) { return a.slotUs < b.slotUs; });
+    return calls;
+}
+
+static void runCalls(std::vector<Call>& calls, uint32_t spotlights) {
+    std::string targets = targetList(spotlights);
+    std::atomic<size_t> next{0};
+
+    std::vector<std::thread> clients;
+    for (uint32_t c = 0; c < options.clients; c++) {
+        clients.emplace_back([&] {
+            size_t index;
+            while ((index = next++) < calls.size()) {
+                Call& call = calls[index];
+                sleepUntil(call.slotUs);
+                if (call.path == PATH_EFFECT) {
+                    call.code = callCommander("POST", "/api/effect/send",
+                        "{\"targets\":" + targets + ",\"effect\":\"static\",\"color\":" + colorOf(call.tag) + "}");
+                } else if (call.path == PATH_STATUS) {
+                    call.code = callCommander("GET", "/api/status", "");
+                } else {
+                    uint32_t sequence = call.tag & ~LOAD_PLAY_MARK;
+                    call.code = callCommander("POST", "/api/sequence/play",
+                        "{\"sequenceId\":\"load-" + std::to_string(sequence) + "\"}");
+                }
+                call.doneUs = nowUs();
+            }
+        });
+    }
+    for (std::thread& client : clients) client.join();
+}
+
+// Scheinwerfer spot-1..N anmelden. Anzahl angenommener, beim ersten
+// abgelehnten ist Schluss (rejected = Status-Code, 0 = alle angenommen)
+static uint32_t registerSpotlights(uint32_t spotlights, int& rejected) {
+    rejected = 0;
+    for (uint32_t i = 1; i <= spotlights; i++) {
+        std::string body = "{\"id\":\"spot-" + std::to_string(i) + "\",\"name\":\"spot-" + std::to_string(i) +
+                           "\",\"ip\":\"127.0.0.1:" + std::to_string(options.basePort + i - 1) + "\"}";
+        int code = callCommander("POST", "/api/spotlight/add", body);
+        if (code != 200) {
+            rejected = code;
+            return i - 1;
+        }
+    }
+    return spotlights;
+}
+
+static bool prepare(uint32_t spotlights) {
+
+    // Je Sequenz ein Event an alle: Kennung in der Farbe
+    if (options.playRate > 0) {
+        std::string targets = targetList(spotlights);
+        for (uint32_t k = 0; k < LOAD_PLAY_SEQUENCES; k++) {
+            std::string body = "{\"id\":\"load-" + std::to_string(k) + "\",\"name\":\"load-" + std::to_string(k) +
+                               "\",\"duration\":1000,\"events\":[{\"timestamp\":0,\"targets\":" + targets +
+                               ",\"effect\":\"static\",\"params\":{\"color\":" + colorOf(LOAD_PLAY_MARK | k) + "}}]}";
+            if (!submitWithRetry("/api/sequence/load", body)) return false;
+        }
+    }
+
+    // Show für --status-rate: Events an alle im festen Abstand, in Schleife
+    if (options.statusRate > 0) {
+        std::string targets = targetList(spotlights);
+        std::string events;
+        for (uint32_t e = 0; e < LOAD_SHOW_EVENTS; e++) {
+            if (e) events += ",";
+            events += "{\"timestamp\":" + std::to_string(e * LOAD_SHOW_STEP_MS) + ",\"targets\":" + targets +
+                      ",\"effect\":\"static\",\"params\":{\"color\":" + colorOf(LOAD_SHOW_TAG) + "}}";
+        }
+        std::string body = "{\"id\":\"load-show\",\"name\":\"load-show\",\"duration\":" +
+                           std::to_string(LOAD_SHOW_EVENTS * LOAD_SHOW_STEP_MS) +
+                           ",\"loop\":true,\"events\":[" + events + "]}";
+        if (!submitWithRetry("/api/sequence/load", body)) return false;
+    }
+    
+    // Health-Checks der neuen Scheinwerfer und Sequenzen abwarten
+    return drainJobs();
+}
+
+// Ankünfte den Aufrufen zuordnen. Effekte: Kennung eindeutig. Sequenzen:
+// letzter angenommener Start derselben Sequenz vor der Ankunft – ein
+// Neustart vor dem Senden ersetzt den vorigen (zählt dort als nicht zugestellt)
+static void evaluate(const std::vector<Call>& calls, const std::vector<Arrival>& arrivals,
+                     uint32_t spotlights, Row rows[NUM_LOAD_PATHS]) {
+    std::unordered_map<uint32_t, const Call*> effects;
+    std::vector<std::vector<const Call*>> plays(LOAD_PLAY_SEQUENCES);
+
+    for (const Call& call : calls) {
+        Row& row = rows[call.path];
+        row.calls++;
+        row.api.add(call.doneUs - call.slotUs);
+        if (call.code < 200 || call.code >= 300) {
+            row.apiFailed++;
+            continue;
+        }
+        if (call.path == PATH_STATUS) continue;
+        row.expected += spotlights;
+        if (call.path == PATH_EFFECT) effects[call.tag] = &call;
+        else plays[call.tag & ~LOAD_PLAY_MARK].push_back(&call);
+    }
+
+    std::map<std::pair<const Call*, uint16_t>, bool> seen;
+    for (const Arrival& arrival : arrivals) {
+        const Call* call = nullptr;
+        if (arrival.tag & LOAD_PLAY_MARK) {
+            uint32_t sequence = arrival.tag & ~LOAD_PLAY_MARK;
+            if (sequence >= LOAD_PLAY_SEQUENCES) continue;
+            for (const Call* candidate : plays[sequence]) {
+                if (candidate->slotUs <= arrival.atUs && (!call || candidate->slotUs > call->slotUs)) call = candidate;
+            }
+        } else {
+            auto it = effects.find(arrival.tag);
+            if (it != effects.end()) call = it->second;
+        }
+        if (!call || seen[{ call, arrival.spot }]) continue;
+
+        seen[{ call, arrival.spot }] = true;
+        Row& row = rows[call->path];
+        row.delivered++;
+        row.dispatch.add(arrival.atUs - call->slotUs);
+    }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage() {
+    fprintf(stderr,
+        "Usage: commander-load [--spotlights N,N,...] [--duration S] [--effect-rate R] [--play-rate R]\n"
+        "                      [--status-rate R] [--max-lateness MS]\n"
+        "                      [--latency MS] [--jitter MS] [--clients N] [--base-port P]\n"
+        "                      [--commander IP:PORT | --binary PATH --port P] [--logs]\n");
+}
+
+static bool parseOptions(int argc, char** argv) {
+    std::string self = argv[0];
+    size_t slash = self.rfind('/');
+    options.binary = (slash == std::string::npos ? std::string(".") : self.substr(0, slash)) + "/commander";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--spotlights" && hasValue) {
+            options.counts.clear();
+            for (char* part = strtok(argv[++i], ","); part; part = strtok(nullptr, ",")) {
+                options.counts.push_back(atoi(part));
+            }
+        }
+        else if (arg == "--duration" && hasValue) options.durationS = atof(argv[++i]);
+        else if (arg == "--effect-rate" && hasValue) options.effectRate = atof(argv[++i]);
+        else if (arg == "--play-rate" && hasValue) options.playRate = atof(argv[++i]);
+        else if (arg == "--status-rate" && hasValue) options.statusRate = atof(argv[++i]);
+        else if (arg == "--max-lateness" && hasValue) options.maxLatenessMs = atof(argv[++i]);
+        else if (arg == "--latency" && hasValue) options.latencyMs = atof(argv[++i]);
+        else if (arg == "--jitter" && hasValue) options.jitterMs = atof(argv[++i]);
+        else if (arg == "--clients" && hasValue) options.clients = atoi(argv[++i]);
+        else if (arg == "--base-port" && hasValue) options.basePort = atoi(argv[++i]);
+        else if (arg == "--port" && hasValue) options.commanderPort = atoi(argv[++i]);
+        else if (arg == "--binary" && hasValue) options.binary = argv[++i];
+        else if (arg == "--commander" && hasValue) options.commander = argv[++i];
+        else if (arg == "--logs") options.logs = true;
+        else return false;
+    }
+
+    for (uint32_t count : options.counts) {
+        if (count == 0 || count > LOAD_MAX_SPOTLIGHTS) return false;
+    }
+    return !options.counts.empty() && options.clients > 0 && options.durationS > 0 &&
+           (options.effectRate > 0 || options.playRate > 0 || options.statusRate > 0) &&
+           (options.commander.empty() || options.commander.find(':') != std::string::npos);
+}
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv)) {
+        usage();
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    FakeSpotlights spotlights;
+    if (!spotlights.start(*std::max_element(options.counts.begin(), options.counts.end()))) return 1;
+
+    commanderHost = options.commander.empty() ? "127.0.0.1:" + std::to_string(options.commanderPort)
+                                              : options.commander;
+
+    printf("Commander-Lasttest: %.0f s je Zeile, effect/send %.1f/s, sequence/play %.1f/s, status %.1f/s, "
+           "Scheinwerfer %.1f±%.1f ms, %u Clients\n\n",
+           options.durationS, options.effectRate, options.playRate, options.statusRate, options.latencyMs,
+           options.jitterMs, options.clients);
+    printf("%-14s %6s %8s %9s %9s %10s %10s %8s %9s %10s\n", "Pfad", "Ziele", "API/s", "API p50", "API p99",
+           "Disp. p50", "Disp. p99", "API-Feh.", "Zust.-F.", "Effekte/s");
+
+    int status = 0;
+    for (uint32_t count : options.counts) {
+        // Pro Zeile ein frischer Commander (sonst: Scheinwerfer sammeln sich an)
+        pid_t pid = options.commander.empty() ? startCommander() : 0;
+        if (pid < 0) {
+            fprintf(stderr, "Commander startet nicht: %s\n", options.binary.c_str());
+            status = 1;
+            break;
+        }
+
+        int rejected;
+        uint32_t registered = registerSpotlights(count, rejected);
+        if (registered < count) {
+            // Eine Grenze des Commanders ist ein Ergebnis, kein Abbruch
+            printf("%-14s %6u   registriert: %u, Scheinwerfer %u abgelehnt (HTTP %d)\n",
+                   "spotlight/add", count, registered, registered + 1, rejected);
+            fflush(stdout);
+            stopCommander(pid);
+            if (rejected < 0) {
+                status = 1;
+                break;
+            }
+            continue;
+        }
+
+        if (!prepare(count)) {
+            fprintf(stderr, "%u Scheinwerfer: Vorbereitung fehlgeschlagen\n", count);
+            stopCommander(pid);
+            status = 1;
+            break;
+        }
+        spotlights.takeArrivals();
+
+        // Show zu den Status-Abfragen (maxLateness beginnt mit dem Start bei 0)
+        if (options.statusRate > 0 && !submitWithRetry("/api/sequence/play", "{\"sequenceId\":\"load-show\"}")) {
+            fprintf(stderr, "%u Scheinwerfer: Show startet nicht\n", count);
+            stopCommander(pid);
+            status = 1;
+            break;
+        }
+
+        uint64_t startUs = nowUs() + 100000;
+        std::vector<Call> calls = schedule(startUs);
+        runCalls(calls, count);
+        uint64_t endUs = nowUs();
+
+        long lateness = -1;
+        if (options.statusRate > 0) {
+            lateness = statusValue("maxLateness");
+            callCommander("POST", "/api/sequence/stop", "{}");
+        }
+
+        // Angenommene Jobs noch ausliefern lassen
+        drainJobs();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        std::vector<Arrival> arrivals = spotlights.takeArrivals();
+        stopCommander(pid);
+
+        Row rows[NUM_LOAD_PATHS];
+        evaluate(calls, arrivals, count, rows);
+
+        double elapsedS = (endUs - startUs) / 1e6;
+        for (int path = 0; path < NUM_LOAD_PATHS; path++) {
+            const Row& row = rows[path];
+            if (row.calls == 0) continue;
+            printf("%-14s %6u %8.1f %9.2f %9.2f %10.2f %10.2f %7.1f%% %8.1f%% %10.1f\n",
+                   LOAD_PATH_NAMES[path], count, row.calls / elapsedS,
+                   row.api.percentileMs(50), row.api.percentileMs(99),
+                   row.dispatch.percentileMs(50), row.dispatch.percentileMs(99),
+                   100.0 * row.apiFailed / row.calls,
+                   row.expected ? 100.0 * (row.expected - std::min(row.delivered, row.expected)) / row.expected : 0.0,
+                   row.delivered / elapsedS);
+        }
+        if (lateness >= 0) {
+            bool late = options.maxLatenessMs >= 0 && lateness > options.maxLatenessMs;
+            printf("%-14s %6u   maxLateness %ld ms%s\n", "playback", count, lateness,
+                   late ? "  (über --max-lateness)" : "");
+            if (late) status = 1;
+        }
+        fflush(stdout);
+    }
+
+    spotlights.stop();
+    printf("\nZeiten in ms ab Soll-Zeitpunkt des Aufrufs; Zust.-F. = angenommen, aber nie angekommen\n");
+    return status;
+}
@@ -0,0 +1,602 @@
+#include <malloc.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "LightCommander.h"
+
+// ============================================================================
+// COMMANDER-SIMULATOR (Host)
+// ============================================================================
+//
+// Spielt eine Show mit dem echten LightCommander in virtueller Zeit gegen
+// simulierte Scheinwerfer. Loop- und Worker-Task laufen wie auf dem ESP32
+// nebeneinander (HostRtos.cpp), jeder HTTP-Request des Commanders landet in
+// simulateRequest() und kostet dort Latenz, Verlust oder Ausfall:
+//
+//   commander-sim                                       # Demo-Show, 4 Scheinwerfer
+//   commander-sim --spotlights 8 --latency 20 --jitter 10
+//   commander-sim --latency 3:150 --loss 0.02           # Scheinwerfer 3 langsam
+//   commander-sim --outage 2:20-35                      # Scheinwerfer 2 fällt aus
+//   commander-sim --sequence show.json --events         # Eigene Show, jedes Event
+//   commander-sim --sequence show.json --memory         # Heap der Show, Playback ohne malloc
+//   commander-sim --sequence show.json --play 1:hits.json:5:outer:1+2
+//                                                       # Zweite Timeline (Priorität 5, Außenringe, Spot 1 und 2)
+//
+// Gemessen wird beim Empfänger: Verspätung = Ankunft - Soll-Zeit des Events
+// (startTime im Effekt), Versatz = erste bis letzte Ankunft desselben Events
+// über alle Scheinwerfer.
+
+#define SIM_MAX_SPOTLIGHTS    64
+#define SIM_LOOP_TICK_US      1000      // Abstand der loop()-Aufrufe
+#define SIM_CONNECT_TIMEOUT   5000      // ms, HTTPClient-Verbindungsaufbau (Ausfall)
+#define SIM_MAX_RETRANSMITS   6         // Danach gilt der Request als verloren
+#define SIM_WARMUP_US         2000000   // --memory: Allokationen erst danach (Playback eingeschwungen)
+
+// Netz zu einem Scheinwerfer
+struct LinkConfig {
+    double rttMs = 8;
+    double jitterMs = 4;        // Gleichverteilt ±
+    double loss = 0;            // Pro Paket (Request und Antwort getrennt)
+};
+
+struct Outage {
+    uint64_t fromUs;
+    uint64_t toUs;
+};
+
+// --play TIMELINE:FILE[:PRIORITY[:RING[:SPOTS]]] – startet mit der Show
+struct PlaySpec {
+    uint8_t timeline = 0;
+    std::string file;
+    uint8_t priority = 0;       // Standard = timeline (wie /api/sequence/play)
+    RingType ring = RING_BOTH;
+    std::vector<uint32_t> spots;    // 1-basiert, leer = alle
+    String sequenceId;              // Nach dem Laden
+};
+
+struct SimOptions {
+    uint32_t spotlights = 4;
+    LinkConfig link;
+    std::map<uint32_t, LinkConfig> links;   // Abweichungen pro Scheinwerfer (1-basiert)
+    std::map<uint32_t, std::vector<Outage>> outages;
+    double rtoMs = 1000;
+    double durationS = 0;       // 0 = Showlänge + 5 s
+    double pauseAtS = -1;
+    double pauseForS = 0;
+    bool loop = false;
+    bool events = false;
+    bool logs = false;
+    bool memory = false;
+    uint32_t seed = 1;
+    const char* sequenceFile = nullptr;
+    std::vector<PlaySpec> plays;
+};
+
+// Exakte Perzentile (der Host hat den Speicher, common/Histogram.h rundet
+// auf Zweierpotenzen)
+struct Samples {
+    std::vector<uint64_t> values;
+
+    void add(uint64_t value) { values.push_back(value); }
+
+    double percentileMs(uint8_t p) const {
+        if (values.empty()) return 0;
+        std::vector<uint64_t> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (sorted.size() * p + 99) / 100;
+        return sorted[rank ? rank - 1 : 0] / 1000.0;
+    }
+};
+
+struct SimSpotlight {
+    String id;
+    String ip;
+    LinkConfig link;
+    std::vector<Outage> outages;
+
+    uint32_t effects = 0;       // Angekommene /effect
+    Effect received[2];         // Basis für Deltas, wie auf dem Scheinwerfer
+    uint32_t failed = 0;        // Fehlgeschlagene Requests (alle Pfade)
+    Samples sendLateness;       // Sendebeginn - Soll-Zeit (µs)
+    Samples arrivalLateness;    // Ankunft - Soll-Zeit (µs)
+
+    bool down(uint64_t now) const {
+        for (const Outage& outage : outages) {
+            if (now >= outage.fromUs && now < outage.toUs) return true;
+        }
+        return false;
+    }
+};
+
+// Ankünfte eines Events (gleiche startTime) über alle Scheinwerfer
+struct EventArrivals {
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    uint32_t count = 0;
+};
+
+struct PathCount {
+    uint32_t sent = 0;
+    uint32_t failed = 0;
+};
+
+// Heap, den loadSequence() behält (glibc, inkl. Verwaltungs-Overhead)
+struct HeapUsage {
+    size_t bytes = 0;
+    uint32_t allocations = 0;   // malloc-Aufrufe beim Laden (common/MemoryStats.h)
+};
+
+static SimOptions options;
+static HeapUsage sequenceHeap;
+static MemorySnapshot steadyFrom;   // Zähler nach dem Aufwärmen (--memory)
+static MemorySnapshot steadyTo;
+static std::vector<SimSpotlight> simSpotlights;
+static std::map<unsigned long, EventArrivals> arrivals;
+static std::map<std::string, PathCount> paths;
+static std::mt19937 network;
+
+// ============================================================================
+// HEAP (--memory)
+// ============================================================================
+
+static HeapUsage heapNow() {
+    HeapUsage usage;
+    usage.bytes = mallinfo2().uordblks;
+    usage.allocations = memoryStats.allocations(MEMORY_SEQUENCE);
+    return usage;
+}
+
+// ============================================================================
+// NETZ & SCHEINWERFER
+// ============================================================================
+
+static SimSpotlight* findSimSpotlight(const std::string& ip) {
+    for (SimSpotlight& spot : simSpotlights) {
+        if (ip == spot.ip.c_str()) return &spot;
+    }
+    return nullptr;
+}
+
+// Eine Strecke (Request oder Antwort): halbe RTT, jedes verlorene Paket
+// kostet einen Retransmit-Timeout
+static uint64_t pathDelayUs(const LinkConfig& link, bool& lost) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    double ms = link.rttMs / 2 + (uniform(network) * 2 - 1) * link.jitterMs / 2;
+    uint32_t attempts = 0;
+    while (uniform(network) < link.loss) {
+        ms += options.rtoMs;
+        if (++attempts >= SIM_MAX_RETRANSMITS) {
+            lost = true;
+            break;
+        }
+    }
+    return (uint64_t)(std::max(ms, 0.0) * 1000);
+}
+
+static void receiveEffect(SimSpotlight& spot, const std::string& path, const std::string& body,
+                          uint64_t sentAt, uint64_t arrivedAt) {
+    // Delta auf den zuletzt empfangenen Effekt des Rings (den Ring nennt jedes Delta)
+    Effect effect;
+    if (decodeEffect(body.c_str(), body.size(), effect) != DECODE_OK) return;
+    if (path == "/effect/delta") {
+        RingType ring = effect.ring;
+        effect = spot.received[ring == RING_BOTH ? RING_INNER : ring];
+        decodeEffect(body.c_str(), body.size(), effect);
+    }
+    for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+        if (effect.ring == RING_BOTH || effect.ring == ring) spot.received[ring] = effect;
+    }
+
+    uint64_t due = (uint64_t)effect.startTime * 1000;
+    spot.effects++;
+    spot.sendLateness.add(sentAt > due ? sentAt - due : 0);
+    spot.arrivalLateness.add(arrivedAt > due ? arrivedAt - due : 0);
+
+    EventArrivals& event = arrivals[effect.startTime];
+    event.first = std::min(event.first, arrivedAt);
+    event.last = std::max(event.last, arrivedAt);
+    event.count++;
+
+    if (options.events) {
+        printf("%9.3f s  %-8s event @%lu ms  +%.1f ms  %-5s %s %02x%02x%02x\n", arrivedAt / 1e6,
+               spot.id.c_str(), effect.startTime, (arrivedAt - std::min(arrivedAt, due)) / 1000.0,
+               RING_NAMES[effect.ring], EFFECT_NAMES[effect.type], effect.color.r, effect.color.g, effect.color.b);
+    }
+}
+
+static HostHttpResponse simulateRequest(const HostHttpRequest& request) {
+    uint64_t now = hostMicros();
+    PathCount& count = paths[request.path];
+    count.sent++;
+
+    SimSpotlight* spot = findSimSpotlight(request.host);
+    if (!spot || spot->down(now)) {
+        count.failed++;
+        if (spot) spot->failed++;
+        return { HTTPC_ERROR_CONNECTION_REFUSED, "", (uint64_t)SIM_CONNECT_TIMEOUT * 1000 };
+    }
+
+    bool lost = false;
+    uint64_t timeoutUs = (uint64_t)request.timeoutMs * 1000;
+    uint64_t uplink = pathDelayUs(spot->link, lost);
+    bool arrived = !lost && uplink < timeoutUs;
+    uint64_t downlink = lost ? 0 : pathDelayUs(spot->link, lost);
+
+    // Angekommen ist der Request auch, wenn die Antwort zu spät kommt
+    if (arrived && (request.path == "/effect" || request.path == "/effect/delta")) {
+        receiveEffect(*spot, request.path, request.body, now, now + uplink);
+    }
+
+    if (lost || uplink + downlink > timeoutUs) {
+        count.failed++;
+        spot->failed++;
+        return { HTTPC_ERROR_READ_TIMEOUT, "", timeoutUs };
+    }
+
+    // Telemetrie ist optional (alte Firmware) → 404 wie ohne Endpoint
+    int code = request.path == "/telemetry" ? 404 : 200;
+    return { code, code == 200 ? "{\"success\":true}" : "", uplink + downlink };
+}
+
+// ============================================================================
+// SHOW
+// ============================================================================
+
+// Demo: jeder Takt (500 ms) an alle, dazwischen ein Akzent an einen
+// Scheinwerfer reihum
+static String demoSequence(uint32_t spotlights) {
+    static const char* BEATS[] = {
+        "\"effect\":\"static\",\"params\":{\"color\":[255,0,0]}",
+        "\"effect\":\"pulse\",\"params\":{\"color\":[0,80,255],\"duration\":500}",
+        "\"effect\":\"strobe\",\"params\":{\"color\":[255,255,255],\"speed\":20}",
+        "\"effect\":\"rotation\",\"params\":{\"rotation\":{\"pattern\":\"trail\",\"speed\":80}}"
+    };
+    const uint32_t durationMs = 60000;
+
+    String all;
+    for (uint32_t i = 1; i <= spotlights; i++) {
+        all += String(i > 1 ? "," : "") + "\"spot-" + String(i) + "\"";
+    }
+
+    String json = "{\"id\":\"demo\",\"name\":\"Demo\",\"duration\":" + String(durationMs) +
+                  ",\"loop\":false,\"events\":[";
+    for (uint32_t t = 0, beat = 0; t < durationMs; t += 500, beat++) {
+        if (beat) json += ",";
+        json += "{\"timestamp\":" + String(t) + ",\"targets\":[" + all + "]," + BEATS[beat % 4] + "}";
+        json += ",{\"timestamp\":" + String(t + 250) + ",\"targets\":[\"spot-" +
+                String(beat % spotlights + 1) + "\"],\"effect\":\"static\",\"params\":{\"color\":[255,160,0]}}";
+    }
+    json += "]}";
+    return json;
+}
+
+static bool readFile(const char* path, String& content) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    content = String(buffer.str());
+    return true;
+}
+
+// "id" der Sequenz – unter der spielt sie der Commander ab
+static String sequenceIdOf(const String& json) {
+    JsonCursor cursor(json.c_str(), json.length());
+    const char* key;
+    size_t keyLength;
+    const char* id;
+    size_t idLength;
+    if (!cursor.enterObject()) return "";
+    while (cursor.nextKey(key, keyLength)) {
+        if (keyLength == 2 && memcmp(key, "id", 2) == 0 && cursor.readString(id, idLength)) {
+            return String(id, idLength);
+        }
+        cursor.skipValue();
+    }
+    return "";
+}
+
+// ============================================================================
+// TIMELINES (--events)
+// ============================================================================
+
+// Zustand jeder Timeline wie in /api/status: playing, paused, draining
+// (Events durch, Makros laufen noch) oder done. Jede Änderung eine Zeile.
+static void printTimelineChanges(LightCommander& commander, std::string states[MAX_TIMELINES]) {
+    DynamicJsonDocument doc(4096);
+    if (deserializeJson(doc, commander.getStatusJson())) return;
+
+    std::string current[MAX_TIMELINES];
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) current[i] = states[i].empty() ? "" : "done";
+    for (JsonObject t : doc["playback"]["timelines"].as<JsonArray>()) {
+        uint8_t index = t["timeline"];
+        if (index >= MAX_TIMELINES) continue;
+        current[index] = t["paused"] ? "paused" : t["draining"] ? "draining" : "playing";
+    }
+
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        if (current[i] == states[i]) continue;
+        states[i] = current[i];
+        printf("%9.3f s  timeline %u %s\n", hostMicros() / 1e6, i, states[i].c_str());
+    }
+}
+
+// ============================================================================
+// BERICHT
+// ============================================================================
+
+static void printReport(const Sequence& sequence, LightCommander& commander, uint64_t elapsedUs) {
+    printf("\nShow \"%s\": %u events, %.1f s virtual, %u spotlights\n",
+           sequence.name.c_str(), (unsigned)sequence.eventCount, elapsedUs / 1e6,
+           (unsigned)simSpotlights.size());
+    for (const PlaySpec& play : options.plays) {
+        const Sequence* other = commander.getSequence(play.sequenceId);
+        if (!other) continue;
+        printf("  timeline %u \"%s\": %u events, priority %u, ring %s\n", play.timeline, other->name.c_str(),
+               (unsigned)other->eventCount, play.priority, RING_NAMES[play.ring]);
+    }
+
+    printf("\nlateness (ms, against event time)\n");
+    printf("%-10s %8s %8s %10s %10s %10s %10s\n",
+           "spotlight", "effects", "failed", "send p99", "arrive p50", "arrive p99", "arrive max");
+    Samples allArrivals;
+    for (const SimSpotlight& spot : simSpotlights) {
+        printf("%-10s %8u %8u %10.1f %10.1f %10.1f %10.1f\n", spot.id.c_str(), spot.effects, spot.failed,
+               spot.sendLateness.percentileMs(99), spot.arrivalLateness.percentileMs(50),
+               spot.arrivalLateness.percentileMs(99), spot.arrivalLateness.percentileMs(100));
+        allArrivals.values.insert(allArrivals.values.end(), spot.arrivalLateness.values.begin(),
+                                  spot.arrivalLateness.values.end());
+    }
+    printf("%-10s %8u %8s %10s %10.1f %10.1f %10.1f\n", "all", (unsigned)allArrivals.values.size(), "", "",
+           allArrivals.percentileMs(50), allArrivals.percentileMs(99), allArrivals.percentileMs(100));
+
+    Samples skew;
+    for (const auto& pair : arrivals) {
+        if (pair.second.count > 1) skew.add(pair.second.last - pair.second.first);
+    }
+    printf("\nskew (ms, first to last spotlight of the same event)\n");
+    printf("%-10s %8u %8s %10s %10.1f %10.1f %10.1f\n", "events", (unsigned)skew.values.size(), "", "",
+           skew.percentileMs(50), skew.percentileMs(99), skew.percentileMs(100));
+
+    printf("\nmessages\n");
+    printf("%-14s %8s %8s\n", "path", "sent", "failed");
+    PathCount total;
+    for (const auto& pair : paths) {
+        printf("%-14s %8u %8u\n", pair.first.c_str(), pair.second.sent, pair.second.failed);
+        total.sent += pair.second.sent;
+        total.failed += pair.second.failed;
+    }
+    printf("%-14s %8u %8u\n", "total", total.sent, total.failed);
+
+    if (!options.memory) return;
+    size_t events = std::max<size_t>(sequence.eventCount, 1);
+    printf("\nmemory (heap kept by loadSequence, mallocs while loading, sizeof without heap)\n");
+    printf("%-14s %8s %8s %10s %10s\n", "", "bytes", "allocs", "per event", "sizeof");
+    printf("%-14s %8zu %8u %10.1f %10zu\n", "sequence", sequenceHeap.bytes, sequenceHeap.allocations,
+           (double)sequenceHeap.bytes / events, sizeof(SequenceEvent));
+    
+    printf("\nallocations during playback (after %.0f s warm-up)\n", SIM_WARMUP_US / 1e6);
+    printf("%-14s %8s %8s\n", "subsystem", "allocs", "bytes");
+    for (uint8_t s = 0; s < NUM_MEMORY_SUBSYSTEMS; s++) {
+        printf("%-14s %8u %8u\n", MEMORY_SUBSYSTEM_NAMES[s], steadyTo.allocations[s] - steadyFrom.allocations[s],
+               steadyTo.bytes[s] - steadyFrom.bytes[s]);
+    }
+}
+
+// Eingeschwungenes Playback holt keinen Heap: Sequenz und Kodierung nicht.
+// "http" ist ausgenommen – HTTPClient allokiert pro Request selbst.
+static bool steadyStateAllocates() {
+    return steadyTo.allocations[MEMORY_SEQUENCE] != steadyFrom.allocations[MEMORY_SEQUENCE] ||
+           steadyTo.allocations[MEMORY_JSON] != steadyFrom.allocations[MEMORY_JSON];
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage() {
+    fprintf(stderr,
+        "Usage: commander-sim [--spotlights N] [--sequence FILE] [--duration S] [--loop]\n"
+        "                     [--latency [SPOT:]MS] [--jitter [SPOT:]MS] [--loss [SPOT:]P] [--rto MS]\n"
+        "                     [--outage SPOT:FROM-TO] [--pause AT:SECONDS] [--seed N] [--events] [--logs]\n"
+        "                     [--memory] [--play TIMELINE:FILE[:PRIORITY[:RING[:SPOT+SPOT…]]]]\n");
+}
+
+// TIMELINE:FILE[:PRIORITY[:RING[:SPOT+SPOT…]]], Priorität wie bei
+// /api/sequence/play standardmäßig = Timeline
+static bool parsePlay(const char* arg, PlaySpec& play) {
+    std::vector<std::string> parts;
+    std::stringstream stream(arg);
+    std::string part;
+    while (std::getline(stream, part, ':')) parts.push_back(part);
+    if (parts.size() < 2 || parts.size() > 5 || parts[1].empty()) return false;
+
+    play.timeline = atoi(parts[0].c_str());
+    play.file = parts[1];
+    play.priority = parts.size() > 2 ? atoi(parts[2].c_str()) : play.timeline;
+    if (parts.size() > 3) {
+        int8_t ring = RING_KEYWORDS.find(parts[3].c_str(), parts[3].size());
+        if (ring < 0) return false;
+        play.ring = (RingType)ring;
+    }
+    if (parts.size() > 4) {
+        std::stringstream spots(parts[4]);
+        while (std::getline(spots, part, '+')) play.spots.push_back(atoi(part.c_str()));
+    }
+    return play.timeline > 0 && play.timeline < MAX_TIMELINES;
+}
+
+// "--latency [SPOT:]WERT" usw. – ohne SPOT die Vorgabe für alle
+static void applyLink(const std::string& option, const char* arg) {
+    const char* colon = strchr(arg, ':');
+    LinkConfig* link = &options.link;
+    if (colon) {
+        uint32_t spot = atoi(arg);
+        if (!options.links.count(spot)) options.links[spot] = options.link;
+        link = &options.links[spot];
+    }
+
+    double value = atof(colon ? colon + 1 : arg);
+    if (option == "--latency") link->rttMs = value;
+    else if (option == "--jitter") link->jitterMs = value;
+    else link->loss = value;
+}
+
+static bool parseOptions(int argc, char** argv) {
+    std::vector<std::pair<std::string, std::string>> links;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--spotlights" && hasValue) options.spotlights = atoi(argv[++i]);
+        else if (arg == "--sequence" && hasValue) options.sequenceFile = argv[++i];
+        else if (arg == "--duration" && hasValue) options.durationS = atof(argv[++i]);
+        else if (arg == "--rto" && hasValue) options.rtoMs = atof(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.seed = atoi(argv[++i]);
+        else if ((arg == "--latency" || arg == "--jitter" || arg == "--loss") && hasValue) {
+            links.push_back({ arg, argv[++i] });
+        } else if (arg == "--outage" && hasValue) {
+            uint32_t spot;
+            double from, to;
+            if (sscanf(argv[++i], "%u:%lf-%lf", &spot, &from, &to) != 3 || to <= from) return false;
+            options.outages[spot].push_back({ (uint64_t)(from * 1e6), (uint64_t)(to * 1e6) });
+        } else if (arg == "--play" && hasValue) {
+            PlaySpec play;
+            if (!parsePlay(argv[++i], play)) return false;
+            options.plays.push_back(play);
+        } else if (arg == "--pause" && hasValue) {
+            if (sscanf(argv[++i], "%lf:%lf", &options.pauseAtS, &options.pauseForS) != 2) return false;
+        }
+        else if (arg == "--loop") options.loop = true;
+        else if (arg == "--events") options.events = true;
+        else if (arg == "--logs") options.logs = true;
+        else if (arg == "--memory") options.memory = true;
+        else return false;
+    }
+
+    // Vorgaben zuerst, dann die Abweichungen pro Scheinwerfer
+    for (int pass = 0; pass < 2; pass++) {
+        for (const auto& entry : links) {
+            bool perSpotlight = strchr(entry.second.c_str(), ':') != nullptr;
+            if (perSpotlight == (pass == 1)) applyLink(entry.first, entry.second.c_str());
+        }
+    }
+    return options.spotlights > 0 && options.spotlights <= SIM_MAX_SPOTLIGHTS;
+}
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv)) {
+        usage();
+        return 2;
+    }
+
+    String json;
+    if (options.sequenceFile && !readFile(options.sequenceFile, json)) {
+        perror(options.sequenceFile);
+        return 1;
+    }
+    if (!options.sequenceFile) json = demoSequence(options.spotlights);
+
+    network.seed(options.seed);
+    hostSetHttpTransport(simulateRequest);
+    if (!options.logs) hostSetSerial(nullptr);
+
+    static LightCommander commander;
+    commander.begin("host", "", false);
+
+    for (uint32_t i = 1; i <= options.spotlights; i++) {
+        SimSpotlight spot;
+        spot.id = "spot-" + String(i);
+        spot.ip = "10.0.0." + String(i + 10);
+        auto link = options.links.find(i);
+        spot.link = link != options.links.end() ? link->second : options.link;
+        spot.outages = options.outages[i];
+        simSpotlights.push_back(spot);
+        commander.addSpotlight(spot.id, spot.id, spot.ip);
+    }
+
+    HeapUsage before = heapNow();
+    if (!commander.loadSequence(json)) {
+        fprintf(stderr, "Sequenz ungültig\n");
+        return 1;
+    }
+    HeapUsage after = heapNow();
+    sequenceHeap.bytes = after.bytes - before.bytes;
+    sequenceHeap.allocations = after.allocations - before.allocations;
+    String sequenceId = sequenceIdOf(json);
+    Sequence* sequence = commander.getSequence(sequenceId);
+    sequence->loop = sequence->loop || options.loop;
+
+    // Weitere Timelines (--play), Dauer der Simulation nach der längsten
+    unsigned long showMs = sequence->duration;
+    for (PlaySpec& play : options.plays) {
+        String other;
+        if (!readFile(play.file.c_str(), other)) {
+            perror(play.file.c_str());
+            return 1;
+        }
+        if (!commander.loadSequence(other)) {
+            fprintf(stderr, "Sequenz ungültig: %s\n", play.file.c_str());
+            return 1;
+        }
+        play.sequenceId = sequenceIdOf(other);
+        showMs = std::max(showMs, commander.getSequence(play.sequenceId)->duration);
+    }
+
+    // Show startet nach dem ersten Health-Check (Worker-Task, parallel)
+    uint64_t startUs = hostMicros();
+    double durationS = options.durationS > 0 ? options.durationS : showMs / 1000.0 + 5;
+    uint64_t endUs = startUs + (uint64_t)(durationS * 1e6);
+    uint64_t pauseUs = options.pauseAtS >= 0 ? startUs + (uint64_t)(options.pauseAtS * 1e6) : UINT64_MAX;
+    uint64_t resumeUs = pauseUs + (uint64_t)(options.pauseForS * 1e6);
+    uint64_t steadyUs = startUs + SIM_WARMUP_US;
+
+    // Nur ein Task läuft zur Zeit und keiner wartet mit dem State-Lock –
+    // Aufrufe aus dem Loop-Task wie in den Request-Handlern, nur ohne Lock
+    commander.playSequence(sequenceId);
+    for (const PlaySpec& play : options.plays) {
+        TargetMask scope = play.spots.empty() ? ALL_TARGETS : 0;
+        for (uint32_t spot : play.spots) {
+            Spotlight* target = commander.getSpotlight("spot-" + String(spot));
+            if (target) scope |= (TargetMask)1 << target->index;
+        }
+        commander.playSequence(play.sequenceId, play.timeline, play.priority, scope, play.ring);
+    }
+    std::string timelineStates[MAX_TIMELINES];
+    if (options.events) printTimelineChanges(commander, timelineStates);
+
+    while (hostMicros() < endUs) {
+        if (hostMicros() >= pauseUs) {
+            commander.pauseSequence();
+            pauseUs = UINT64_MAX;
+        }
+        if (hostMicros() >= resumeUs && pauseUs == UINT64_MAX) {
+            commander.resumeSequence();
+            resumeUs = UINT64_MAX;
+        }
+        if (hostMicros() >= steadyUs) {
+            memoryStats.snapshot(steadyFrom);
+            steadyUs = UINT64_MAX;
+        }
+        commander.loop();
+        if (options.events) printTimelineChanges(commander, timelineStates);
+        hostAdvanceMicros(SIM_LOOP_TICK_US);
+    }
+    memoryStats.snapshot(steadyTo);
+    if (steadyUs != UINT64_MAX) steadyFrom = steadyTo;     // Kürzer als das Aufwärmen
+
+    printReport(*sequence, commander, hostMicros() - startUs);
+    fflush(stdout);
+    
+    if (options.memory && steadyStateAllocates()) {
+        fprintf(stderr, "Playback allokiert nach dem Aufwärmen (sequence/json)\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef HOST_CORPUS_H
+#define HOST_CORPUS_H
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "EffectParser.h"
+
+// ============================================================================
+// PARSER-KORPUS (tests/corpus/*.json)
+// ============================================================================
+//
+// Beispiel-Bodies aus den READMEs, ein Request pro Datei. "batch*.json" geht
+// an decodeBatch(), alles andere an decodeEffect() – wie /batch bzw. /effect
+// auf dem Scheinwerfer. Genutzt von parse-fuzz und spotlight-bench.
+
+#define CORPUS_DIR            "tests/corpus"
+
+struct CorpusFile {
+    std::string name;
+    std::string body;
+    bool batch;
+};
+
+// Sortiert nach Name, damit Fuzzing und Benchmark reproduzierbar sind
+inline bool loadCorpus(const char* dir, std::vector<CorpusFile>& files) {
+    DIR* handle = opendir(dir);
+    if (!handle) return false;
+
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.size() < 6 || name.compare(name.size() - 5, 5, ".json") != 0) continue;
+
+        FILE* file = fopen((std::string(dir) + "/" + name).c_str(), "rb");
+        if (!file) continue;
+        CorpusFile entryFile;
+        entryFile.name = name.substr(0, name.size() - 5);
+        entryFile.batch = name.compare(0, 5, "batch") == 0;
+        char chunk[4096];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) entryFile.body.append(chunk, read);
+        fclose(file);
+        files.push_back(entryFile);
+    }
+    closedir(handle);
+
+    std::sort(files.begin(), files.end(),
+              [](const CorpusFile& a, const CorpusFile& b) { return a.name < b.name; });
+    return !files.empty();
+}
+
+inline DecodeResult decodeCorpusBody(const char* body, size_t length, bool batch) {
+    if (!batch) {
+        Effect effect;
+        return decodeEffect(body, length, effect);
+    }
+    unsigned long at;
+    return decodeBatch(body, length, at, [](const Effect&) {});
+}
+
+#endif // HOST_CORPUS_H
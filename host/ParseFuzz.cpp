@@ -0,0 +1,320 @@
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Corpus.h"
+
+// ============================================================================
+// PARSER-FUZZER (Host): JsonCursor/decodeEffect gegen kaputte Requests
+// ============================================================================
+//
+// Nimmt die README-Beispiele aus tests/corpus/ und verändert sie: jede
+// Kürzung, jedes einzelne Byte entfernt, dazu zufällige Mutationen aus
+// JSON-Zeichen. Jede Variante liegt in einem Heap-Buffer ohne Nullbyte
+// (ASan meldet jedes Lesen dahinter). Geprüft wird:
+//
+//   - jede Korpus-Datei dekodiert fehlerfrei
+//   - strukturell kaputtes JSON (Klammern, Kommas, Doppelpunkte, Schlüssel)
+//     wird immer abgelehnt – auch in übersprungenen Feldern
+//   - gleiche Eingabe, gleiches Ergebnis
+//
+//   parse-fuzz                                  # tests/corpus, 5000 Mutationen pro Datei
+//   parse-fuzz --mutations 200000 --seed 7 --corpus DIR
+
+#define FUZZ_SEED             0xF022
+#define FUZZ_MUTATIONS        5000
+#define FUZZ_MAX_EDITS        4
+
+struct FuzzOptions {
+    const char* corpus = CORPUS_DIR;
+    uint32_t seed = FUZZ_SEED;
+    uint32_t mutations = FUZZ_MUTATIONS;
+};
+
+static uint32_t failures = 0;
+
+// ============================================================================
+// ZUFALL (xorshift32, reproduzierbar über --seed)
+// ============================================================================
+
+static uint32_t rngState = FUZZ_SEED;
+
+static uint32_t rnd() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint32_t rnd(uint32_t limit) { return limit ? rnd() % limit : 0; }
+
+// Bevorzugt Zeichen, die die Struktur treffen
+static char randomJsonChar() {
+    static const char ALPHABET[] = "{}[],:\"\\ -.0123456789eEtrufalsn\n";
+    return rnd(8) == 0 ? (char)rnd(256) : ALPHABET[rnd(sizeof(ALPHABET) - 1)];
+}
+
+// ============================================================================
+// STRUKTUR-ORAKEL
+// ============================================================================
+//
+// Strenges JSON für Container, Skalare so großzügig wie JsonCursor (Zahlen
+// mit abgeschnittenem Bruch/Exponent, Strings mit rohen Escapes). Was hier
+// durchfällt, muss auch der Parser ablehnen. Umgekehrt nicht: der Parser
+// lehnt zusätzlich falsche Typen in bekannten Feldern ab.
+
+class StructureCheck {
+public:
+    StructureCheck(const char* data, size_t length) : pos(data), end(data + length) {}
+
+    // Ein Objekt am Anfang; was danach kommt, liest auch decodeEffect() nicht
+    bool document() {
+        whitespace();
+        return pos < end && *pos == '{' && value();
+    }
+
+private:
+    const char* pos;
+    const char* end;
+
+    void whitespace() {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) pos++;
+    }
+
+    bool take(char c) {
+        whitespace();
+        if (pos >= end || *pos != c) return false;
+        pos++;
+        return true;
+    }
+
+    bool digits() {
+        const char* start = pos;
+        while (pos < end && *pos >= '0' && *pos <= '9') pos++;
+        return pos > start;
+    }
+
+    bool string() {
+        if (!take('"')) return false;
+        while (pos < end && *pos != '"') {
+            if (*pos == '\\' && pos + 1 < end) pos++;
+            pos++;
+        }
+        if (pos >= end) return false;
+        pos++;
+        return true;
+    }
+
+    bool number() {
+        if (pos < end && *pos == '-') pos++;
+        if (!digits()) return false;
+        if (pos < end && *pos == '.') {
+            pos++;
+            digits();
+        }
+        if (pos < end && (*pos == 'e' || *pos == 'E')) {
+            pos++;
+            if (pos < end && (*pos == '+' || *pos == '-')) pos++;
+            digits();
+        }
+        return true;
+    }
+
+    bool literal(const char* word) {
+        size_t length = strlen(word);
+        if ((size_t)(end - pos) < length || memcmp(pos, word, length) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    bool members(char close, bool object) {
+        pos++;
+        if (take(close)) return true;
+        do {
+            if (object && (!string() || !take(':'))) return false;
+            if (!value()) return false;
+        } while (take(','));
+        return take(close);
+    }
+
+    bool value() {
+        whitespace();
+        if (pos >= end) return false;
+        switch (*pos) {
+            case '{': return members('}', true);
+            case '[': return members(']', false);
+            case '"': return string();
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return number();
+        }
+    }
+};
+
+// ============================================================================
+// PRÜFUNG EINER EINGABE
+// ============================================================================
+
+struct FuzzStats {
+    uint32_t inputs = 0;
+    uint32_t accepted = 0;
+};
+
+static void report(const char* file, const char* problem, const std::string& input) {
+    failures++;
+    if (failures > 10) return;
+    printf("  FAIL  %s: %s\n        %s\n", file, problem, input.c_str());
+}
+
+// Eingabe in einen exakt großen Heap-Buffer ohne Nullbyte
+static DecodeResult decodeExact(const std::string& input, bool batch) {
+    char* buffer = (char*)malloc(input.size() ? input.size() : 1);
+    memcpy(buffer, input.data(), input.size());
+    DecodeResult result = decodeCorpusBody(buffer, input.size(), batch);
+    free(buffer);
+    return result;
+}
+
+static void fuzzInput(const char* file, const std::string& input, bool batch, FuzzStats& stats) {
+    stats.inputs++;
+    DecodeResult result = decodeExact(input, batch);
+    if (decodeExact(input, batch) != result) report(file, "nicht deterministisch", input);
+    if (result != DECODE_INVALID_JSON) stats.accepted++;
+
+    StructureCheck structure(input.data(), input.size());
+    if (!structure.document() && result != DECODE_INVALID_JSON) {
+        report(file, "kaputte Struktur angenommen", input);
+    }
+}
+
+static std::string mutate(const std::string& body) {
+    std::string input = body;
+    uint32_t edits = 1 + rnd(FUZZ_MAX_EDITS);
+    for (uint32_t e = 0; e < edits; e++) {
+        size_t at = rnd(input.size() + 1);
+        switch (rnd(5)) {
+            case 0:
+                if (at < input.size()) input[at] = randomJsonChar();
+                break;
+            case 1:
+                input.insert(at, 1, randomJsonChar());
+                break;
+            case 2:
+                if (at < input.size()) input.erase(at, 1);
+                break;
+            case 3:
+                // Stück verdoppeln (verschachtelt Container, verdoppelt Kommas)
+                input.insert(at, input.substr(at, 1 + rnd(16)));
+                break;
+            default:
+                if (at < input.size()) input.erase(at, 1 + rnd(16));
+                break;
+        }
+    }
+    return input;
+}
+
+static void fuzzFile(const CorpusFile& file, uint32_t mutations) {
+    const char* name = file.name.c_str();
+    const std::string& body = file.body;
+    FuzzStats stats;
+
+    if (decodeExact(body, file.batch) != DECODE_OK) report(name, "Korpus-Datei abgelehnt", body);
+
+    // Jede Kürzung vor der schließenden Klammer ist unvollständig
+    size_t close = body.find_last_of('}');
+    for (size_t length = 0; length < body.size(); length++) {
+        std::string prefix = body.substr(0, length);
+        fuzzInput(name, prefix, file.batch, stats);
+        if (length <= close && decodeExact(prefix, file.batch) != DECODE_INVALID_JSON) {
+            report(name, "gekürzte Eingabe angenommen", prefix);
+        }
+    }
+
+    // Jedes Byte einzeln weg
+    for (size_t at = 0; at < body.size(); at++) {
+        std::string input = body;
+        input.erase(at, 1);
+        fuzzInput(name, input, file.batch, stats);
+    }
+
+    for (uint32_t i = 0; i < mutations; i++) fuzzInput(name, mutate(body), file.batch, stats);
+
+    printf("%-24s %6zu bytes %8u inputs %8u accepted\n", name, body.size(), stats.inputs, stats.accepted);
+}
+
+// ============================================================================
+// FESTE FÄLLE (Trennzeichen, Verschachtelung)
+// ============================================================================
+
+static void fixedCases() {
+    struct Case {
+        const char* json;
+        bool valid;
+    };
+    std::string deep = "{\"x\":" + std::string(JSON_MAX_DEPTH, '[') + std::string(JSON_MAX_DEPTH, ']') + "}";
+    std::string tooDeep = "{\"x\":" + std::string(JSON_MAX_DEPTH + 1, '[') + std::string(JSON_MAX_DEPTH + 1, ']') + "}";
+
+    const Case CASES[] = {
+        { "{}", true },
+        { " { \"effect\" : \"static\" , \"color\" : [ 1 , 2 , 3 ] } ", true },
+        { "{\"x\":[[1],[2],{\"a\":{\"b\":[]}},\"]\"]}", true },
+        { "{\"effect\":\"static\" \"color\":[1,2,3]}", false },       // Komma fehlt
+        { "{,\"effect\":\"static\"}", false },                        // führendes Komma
+        { "{\"effect\":\"static\",,\"brightness\":1}", false },       // doppeltes Komma
+        { "{\"effect\":\"static\",}", false },                        // Komma am Ende
+        { "{\"color\":[1 2 3]}", false },
+        { "{\"color\":[,1,2,3]}", false },
+        { "{\"color\":[1,2,3,]}", false },
+        { "{\"x\":[\"a\" \"b\"]}", false },                           // übersprungenes Feld
+        { "{\"x\":{\"a\":1 \"b\":2}}", false },
+        { "{\"x\":{\"a\" 1}}", false },
+        { "{\"x\":{1:2}}", false },
+        { "{\"x\":[[1],,[2]]}", false },
+        { "{\"x\":[1}", false },
+        { "{\"x\":{\"a\":1]}", false },
+        { deep.c_str(), true },
+        { tooDeep.c_str(), false },
+    };
+
+    for (const Case& test : CASES) {
+        bool accepted = decodeExact(test.json, false) != DECODE_INVALID_JSON;
+        if (accepted != test.valid) report("fixed", test.valid ? "abgelehnt" : "angenommen", test.json);
+    }
+    printf("%-24s %6zu cases\n", "fixed", sizeof(CASES) / sizeof(CASES[0]));
+}
+
+static bool parseOptions(int argc, char** argv, FuzzOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--corpus" && hasValue) options.corpus = argv[++i];
+        else if (arg == "--seed" && hasValue) options.seed = strtoul(argv[++i], nullptr, 0);
+        else if (arg == "--mutations" && hasValue) options.mutations = atoi(argv[++i]);
+        else return false;
+    }
+    return options.seed != 0;
+}
+
+int main(int argc, char** argv) {
+    FuzzOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "Usage: parse-fuzz [--corpus DIR] [--mutations N] [--seed N]\n");
+        return 2;
+    }
+    rngState = options.seed;
+
+    std::vector<CorpusFile> files;
+    if (!loadCorpus(options.corpus, files)) {
+        fprintf(stderr, "No corpus in %s\n", options.corpus);
+        return 2;
+    }
+
+    fixedCases();
+    for (const CorpusFile& file : files) fuzzFile(file, options.mutations);
+
+    printf("%u failed\n", failures);
+    return failures ? 1 : 0;
+}
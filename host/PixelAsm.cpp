@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "PixelProgram.h"
+
+// ============================================================================
+// PIXEL-ASSEMBLER (Host)
+// ============================================================================
+//
+// Übersetzt Pixel-Programme mit demselben Assembler und Verifier wie der
+// Scheinwerfer (PixelProgram::assemble) und gibt den Body für
+// POST /program mit fertigem Bytecode aus – Fehler fallen so schon vor dem
+// Upload auf, und der Scheinwerfer muss nichts übersetzen.
+//
+//   pixel-asm show.pxl                                  # {"slot":0,"code":[…]}
+//   pixel-asm --slot 2 - < show.pxl
+//   pixel-asm --list -e "i 32 mul t 4 shr add  255 p0 hsv"
+//   curl -X POST http://192.168.4.101/program -d "$(pixel-asm show.pxl)"
+//
+// Format des Bytecodes: siehe led-spotlight/README.md ("Bytecode-Format").
+
+struct AsmOptions {
+    const char* file = nullptr;
+    const char* source = nullptr;
+    int slot = 0;
+    bool list = false;
+};
+
+static void usage() {
+    fprintf(stderr, "Usage: pixel-asm [--slot N] [--list] (FILE | - | -e SOURCE)\n");
+}
+
+static bool parseOptions(int argc, char** argv, AsmOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--slot" && hasValue) options.slot = atoi(argv[++i]);
+        else if (arg == "-e" && hasValue) options.source = argv[++i];
+        else if (arg == "--list") options.list = true;
+        else if (!options.file && (arg == "-" || arg[0] != '-')) options.file = argv[i];
+        else return false;
+    }
+    return (options.file != nullptr) != (options.source != nullptr) &&
+           options.slot >= 0 && options.slot < MAX_PROGRAMS;
+}
+
+static bool readSource(const char* file, std::string& source) {
+    FILE* in = strcmp(file, "-") == 0 ? stdin : fopen(file, "rb");
+    if (!in) return false;
+
+    char chunk[1024];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0) source.append(chunk, read);
+    if (in != stdin) fclose(in);
+    return true;
+}
+
+// Eine Zeile pro Befehl: Adresse, Bytes, Mnemonic mit Operand
+static void printListing(const PixelProgram& program) {
+    const uint8_t* code = program.bytecode();
+    uint8_t pc = 0;
+
+    while (pc < program.size()) {
+        uint8_t op = code[pc];
+        uint8_t next = pc + 1 + PixelProgram::immediateSize(op);
+
+        std::string bytes;
+        for (uint8_t b = pc; b < next; b++) {
+            char hex[4];
+            snprintf(hex, sizeof(hex), "%02x ", code[b]);
+            bytes += hex;
+        }
+        printf("%3u  %-9s %s", pc, bytes.c_str(), PixelProgram::opcodeName(op));
+
+        switch (op) {
+            case OP_PUSH8:
+                printf(" %u", code[pc + 1]);
+                break;
+            case OP_PUSH16:
+                printf(" %d", (int16_t)(code[pc + 1] | (code[pc + 2] << 8)));
+                break;
+            case OP_PARAM:
+                printf(" p%u", code[pc + 1]);
+                break;
+            case OP_JZ:
+            case OP_JMP:
+                printf(" +%u (-> %u)", code[pc + 1], next + code[pc + 1]);
+                break;
+        }
+        printf("\n");
+        pc = next;
+    }
+    printf("%u bytes\n", program.size());
+}
+
+int main(int argc, char** argv) {
+    AsmOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::string source;
+    if (options.source) {
+        source = options.source;
+    } else if (!readSource(options.file, source)) {
+        fprintf(stderr, "pixel-asm: cannot read %s\n", options.file);
+        return 2;
+    }
+
+    PixelProgram program;
+    const char* error = program.assemble(source.c_str());
+    if (error) {
+        fprintf(stderr, "pixel-asm: %s\n", error);
+        return 1;
+    }
+
+    if (options.list) {
+        printListing(program);
+        return 0;
+    }
+
+    printf("{\"slot\":%d,\"code\":[", options.slot);
+    for (uint8_t i = 0; i < program.size(); i++) {
+        printf(i ? ",%u" : "%u", program.bytecode()[i]);
+    }
+    printf("]}\n");
+    return 0;
+}
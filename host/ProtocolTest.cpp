@@ -0,0 +1,390 @@
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "EffectEncoder.h"
+#include "EffectParser.h"
+
+// ============================================================================
+// PROTOKOLL-TEST (Host): Commander-Encoder → Scheinwerfer-Parser
+// ============================================================================
+//
+// Alles, was encodeEffect() schreibt, muss decodeEffect() Bit für Bit
+// wieder herausgeben – jedes Feld von Effect, alle vier Automationskurven,
+// Segmente, Batch und Delta. Geprüft wird doppelt: Feld für Feld und über
+// eine zweite Kodierung, die byte-gleich zur ersten sein muss.
+//
+//   protocol-test                      # feste Fälle + 2000 Zufallseffekte
+//   protocol-test --random 100000 --seed 7
+
+#define TEST_SEED             0x5EED
+#define TEST_RANDOM_EFFECTS   2000
+
+struct TestOptions {
+    uint32_t seed = TEST_SEED;
+    uint32_t randomEffects = TEST_RANDOM_EFFECTS;
+};
+
+static uint32_t checks = 0;
+static uint32_t failures = 0;
+
+// ============================================================================
+// ZUFALL (xorshift32, reproduzierbar über --seed)
+// ============================================================================
+
+static uint32_t rngState = TEST_SEED;
+
+static uint32_t rnd() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint32_t rnd(uint32_t limit) { return rnd() % limit; }
+static bool chance(uint32_t percent) { return rnd(100) < percent; }
+static Color randomColor() { return Color(rnd(256), rnd(256), rnd(256)); }
+
+static void randomCurve(Automation& curve, bool isColor, uint8_t count) {
+    curve.count = count;
+    curve.loop = count && chance(50);
+    uint32_t time = rnd(100);
+    for (uint8_t i = 0; i < count; i++) {
+        // Zeiten aufsteigend (gleiche Zeit erlaubt), sonst verwirft der Parser
+        time += rnd(4) == 0 ? 0 : rnd(60000);
+        curve.keys[i].time = time;
+        curve.keys[i].value = isColor ? rnd(1 << 24) : rnd(chance(20) ? 1 << 24 : 256);
+        curve.keys[i].easing = rnd(EASING_IN_OUT + 1);
+    }
+}
+
+static uint8_t randomCurveLength(uint8_t maxCount) {
+    if (chance(40)) return 0;
+    return chance(20) ? maxCount : 1 + rnd(maxCount);
+}
+
+// maxKeys begrenzt die Kurven (Batch: alle Effekte müssen in BATCH_JSON_SIZE passen)
+static Effect randomEffect(uint8_t maxKeys = MAX_KEYFRAMES) {
+    Effect effect;
+    effect.type = (EffectType)rnd(EFFECT_OFF + 1);
+    effect.ring = (RingType)rnd(RING_BOTH + 1);
+    effect.color = randomColor();
+    effect.color2 = randomColor();
+    effect.brightness = rnd(256);
+    effect.speed = rnd(65536);
+    effect.duration = rnd(65536);
+    effect.transitionMs = rnd(65536);
+    effect.startTime = chance(30) ? 0 : rnd();
+    effect.rotation.activeColor = randomColor();
+    effect.rotation.inactiveColor = randomColor();
+    effect.rotation.speed = rnd(65536);
+    effect.rotation.direction = (RotationDirection)rnd(DIRECTION_COUNTERCLOCKWISE + 1);
+    effect.rotation.pattern = (RotationPattern)rnd(PATTERN_RAINBOW_CHASE + 1);
+    effect.rotation.trailLength = rnd(256);
+    randomCurve(effect.automation.brightness, false, randomCurveLength(maxKeys));
+    randomCurve(effect.automation.color, true, randomCurveLength(maxKeys));
+    randomCurve(effect.automation.speed, false, randomCurveLength(maxKeys));
+    randomCurve(effect.automation.trailLength, false, randomCurveLength(maxKeys));
+    effect.segments = chance(50) ? 0 : rnd(256);
+    effect.palette = rnd(256);
+    effect.program = rnd(256);
+    for (uint8_t i = 0; i < NUM_PROGRAM_PARAMS; i++) effect.programParams[i] = (int16_t)rnd(65536);
+    effect.traceId = chance(50) ? 0 : rnd();
+    return effect;
+}
+
+// ============================================================================
+// VERGLEICH
+// ============================================================================
+
+static const char* curveDifference(const Automation& a, const Automation& b) {
+    if (a.count != b.count) return "count";
+    if (a.loop != b.loop) return "loop";
+    for (uint8_t i = 0; i < a.count; i++) {
+        if (a.keys[i].time != b.keys[i].time) return "keys.time";
+        if (a.keys[i].value != b.keys[i].value) return "keys.value";
+        if (a.keys[i].easing != b.keys[i].easing) return "keys.easing";
+    }
+    return nullptr;
+}
+
+// Erstes abweichendes Feld, leer = identisch. Strenger als sameEffectState():
+// auch Ring, Startzeit, Überblendung, Trace und "loop" leerer Kurven.
+static std::string effectDifference(const Effect& a, const Effect& b) {
+    if (a.type != b.type) return "effect";
+    if (a.ring != b.ring) return "ring";
+    if (a.color != b.color) return "color";
+    if (a.color2 != b.color2) return "color2";
+    if (a.brightness != b.brightness) return "brightness";
+    if (a.speed != b.speed) return "speed";
+    if (a.duration != b.duration) return "duration";
+    if (a.transitionMs != b.transitionMs) return "transitionMs";
+    if (a.startTime != b.startTime) return "startTime";
+    if (a.rotation.activeColor != b.rotation.activeColor) return "rotation.activeColor";
+    if (a.rotation.inactiveColor != b.rotation.inactiveColor) return "rotation.inactiveColor";
+    if (a.rotation.speed != b.rotation.speed) return "rotation.speed";
+    if (a.rotation.direction != b.rotation.direction) return "rotation.direction";
+    if (a.rotation.pattern != b.rotation.pattern) return "rotation.pattern";
+    if (a.rotation.trailLength != b.rotation.trailLength) return "rotation.trailLength";
+
+    const Automation* curvesA[] = { &a.automation.brightness, &a.automation.color,
+                                    &a.automation.speed, &a.automation.trailLength };
+    const Automation* curvesB[] = { &b.automation.brightness, &b.automation.color,
+                                    &b.automation.speed, &b.automation.trailLength };
+    for (uint8_t i = 0; i < 4; i++) {
+        const char* field = curveDifference(*curvesA[i], *curvesB[i]);
+        if (field) return std::string("automation.") + AUTOMATION_FIELD_NAMES[i] + "." + field;
+    }
+
+    if (a.segments != b.segments) return "segments";
+    if (a.palette != b.palette) return "palette";
+    if (a.program != b.program) return "program";
+    for (uint8_t i = 0; i < NUM_PROGRAM_PARAMS; i++) {
+        if (a.programParams[i] != b.programParams[i]) return "programParams";
+    }
+    if (a.traceId != b.traceId) return "trace";
+
+    // Gegenprobe: die Vergleichsfunktionen des Commanders sehen es genauso
+    if (!sameEffectState(a, b)) return "sameEffectState";
+    return "";
+}
+
+static void report(const char* test, const std::string& problem, const char* json) {
+    failures++;
+    if (failures > 10) return;
+    printf("  FAIL  %s: %s\n", test, problem.c_str());
+    if (json) printf("        %s\n", json);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+// encode → decode → Feldvergleich → encode → Byte-Vergleich
+static void roundTrip(const char* test, const Effect& effect) {
+    char json[EFFECT_JSON_SIZE];
+    char again[EFFECT_JSON_SIZE];
+    checks++;
+
+    size_t length = encodeEffect(effect, json, sizeof(json));
+    if (length == 0) return report(test, "encodeEffect: EFFECT_JSON_SIZE zu klein", nullptr);
+
+    Effect decoded;
+    DecodeResult result = decodeEffect(json, length, decoded);
+    if (result != DECODE_OK) return report(test, "decodeEffect: Ergebnis " + std::to_string(result), json);
+
+    std::string field = effectDifference(effect, decoded);
+    if (!field.empty()) return report(test, "Feld " + field, json);
+
+    size_t againLength = encodeEffect(decoded, again, sizeof(again));
+    if (againLength != length || memcmp(json, again, length) != 0) {
+        return report(test, "zweite Kodierung weicht ab", again);
+    }
+
+    // Jeder kleinere Buffer muss sauber scheitern (0), nie abgeschnittenes JSON liefern
+    if (encodeEffect(effect, again, length) != 0) report(test, "Buffer ohne Platz für Nullbyte akzeptiert", nullptr);
+    if (encodeEffect(effect, again, length + 1) != length) report(test, "exakt passender Buffer abgelehnt", nullptr);
+}
+
+static void fixedEffects() {
+    Effect defaults;
+    roundTrip("defaults", defaults);
+
+    // Alle Enum-Werte einmal
+    for (int type = 0; type <= EFFECT_OFF; type++) {
+        for (int ring = 0; ring <= RING_BOTH; ring++) {
+            Effect effect;
+            effect.type = (EffectType)type;
+            effect.ring = (RingType)ring;
+            roundTrip("effect/ring", effect);
+        }
+    }
+    for (int pattern = 0; pattern <= PATTERN_RAINBOW_CHASE; pattern++) {
+        for (int direction = 0; direction <= DIRECTION_COUNTERCLOCKWISE; direction++) {
+            Effect effect;
+            effect.type = EFFECT_ROTATION;
+            effect.rotation.pattern = (RotationPattern)pattern;
+            effect.rotation.direction = (RotationDirection)direction;
+            roundTrip("rotation", effect);
+        }
+    }
+    for (int segment = 0; segment < MAX_SEGMENTS; segment++) {
+        Effect effect;
+        effect.segments = 1 << segment;
+        roundTrip("segments", effect);
+    }
+
+    // Grenzwerte: alle Felder voll, alle Kurven mit MAX_KEYFRAMES (größte Nachricht)
+    Effect full;
+    full.type = EFFECT_PROGRAM;
+    full.ring = RING_OUTER;
+    full.color = Color(255, 255, 255);
+    full.color2 = Color(255, 255, 255);
+    full.brightness = 255;
+    full.speed = 65535;
+    full.duration = 65535;
+    full.transitionMs = 65535;
+    full.startTime = 4294967295UL;
+    full.rotation.activeColor = Color(255, 255, 255);
+    full.rotation.inactiveColor = Color(255, 255, 255);
+    full.rotation.speed = 65535;
+    full.rotation.direction = DIRECTION_COUNTERCLOCKWISE;
+    full.rotation.pattern = PATTERN_RAINBOW_CHASE;
+    full.rotation.trailLength = 255;
+    Automation* curves[] = { &full.automation.brightness, &full.automation.color,
+                             &full.automation.speed, &full.automation.trailLength };
+    for (Automation* curve : curves) {
+        curve->count = MAX_KEYFRAMES;
+        curve->loop = true;
+        for (uint8_t i = 0; i < MAX_KEYFRAMES; i++) {
+            curve->keys[i].time = 4294967295UL - (MAX_KEYFRAMES - 1 - i);
+            curve->keys[i].value = 0xFFFFFF;
+            curve->keys[i].easing = i % (EASING_IN_OUT + 1);
+        }
+    }
+    full.segments = 0xFF;
+    full.palette = 255;
+    full.program = 255;
+    full.programParams[0] = -32768;
+    full.programParams[1] = 32767;
+    full.programParams[2] = -1;
+    full.programParams[3] = 0;
+    full.traceId = 4294967295UL;
+    roundTrip("limits", full);
+}
+
+// Delta auf die Basis dekodiert (wie handleEffectDelta) = Ziel-Effekt
+static void deltaTrip(const Effect& base, const Effect& effect) {
+    char json[EFFECT_JSON_SIZE];
+    checks++;
+
+    size_t length = encodeEffectDelta(base, effect, json, sizeof(json));
+    if (length == 0) return report("delta", "encodeEffectDelta: EFFECT_JSON_SIZE zu klein", nullptr);
+
+    Effect decoded = base;
+    DecodeResult result = decodeEffect(json, length, decoded);
+    if (result != DECODE_OK) return report("delta", "decodeEffect: Ergebnis " + std::to_string(result), json);
+
+    std::string field = effectDifference(effect, decoded);
+    if (!field.empty()) report("delta", "Feld " + field, json);
+}
+
+static void deltas(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        // Segment-Effekte gehen nie als Delta, der Ring bestimmt die Basis
+        Effect base = randomEffect();
+        base.segments = 0;
+
+        // Ziel: zufällige Teilmenge der Felder geändert
+        Effect other = randomEffect();
+        Effect effect = base;
+        effect.type = other.type;
+        effect.startTime = other.startTime;
+        effect.traceId = other.traceId;
+        if (chance(30)) effect.color = other.color;
+        if (chance(30)) effect.color2 = other.color2;
+        if (chance(30)) effect.brightness = other.brightness;
+        if (chance(30)) effect.speed = other.speed;
+        if (chance(30)) effect.duration = other.duration;
+        if (chance(30)) effect.transitionMs = other.transitionMs;
+        if (chance(30)) effect.palette = other.palette;
+        if (chance(30)) effect.program = other.program;
+        if (chance(30)) memcpy(effect.programParams, other.programParams, sizeof(effect.programParams));
+        if (chance(30)) effect.rotation = other.rotation;
+        if (chance(30)) effect.automation.brightness = other.automation.brightness;
+        if (chance(30)) effect.automation.color = other.automation.color;
+        if (chance(30)) effect.automation.speed = other.automation.speed;
+        if (chance(30)) effect.automation.trailLength = other.automation.trailLength;
+
+        deltaTrip(base, effect);
+    }
+}
+
+static void batches(uint32_t count) {
+    static char json[BATCH_JSON_SIZE];
+    Effect effects[MAX_BATCH_EFFECTS];
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t effectCount = rnd(MAX_BATCH_EFFECTS + 1);
+        unsigned long at = chance(20) ? 0 : rnd();
+        for (uint8_t e = 0; e < effectCount; e++) effects[e] = randomEffect(2);
+        checks++;
+
+        size_t length = encodeBatch(at, effects, effectCount, json, sizeof(json));
+        if (length == 0) {
+            report("batch", "encodeBatch: BATCH_JSON_SIZE zu klein", nullptr);
+            continue;
+        }
+
+        uint8_t decodedCount = 0;
+        std::string problem;
+        unsigned long decodedAt;
+        DecodeResult result = decodeBatch(json, length, decodedAt, [&](const Effect& decoded) {
+            if (!problem.empty()) return;
+            if (decodedCount >= effectCount) {
+                problem = "mehr Effekte als kodiert";
+                return;
+            }
+            std::string field = effectDifference(effects[decodedCount], decoded);
+            if (!field.empty()) problem = "Effekt " + std::to_string(decodedCount) + " Feld " + field;
+            decodedCount++;
+        });
+
+        if (result != DECODE_OK) problem = "decodeBatch: Ergebnis " + std::to_string(result);
+        else if (problem.empty() && decodedCount != effectCount) problem = "Anzahl " + std::to_string(decodedCount);
+        else if (problem.empty() && decodedAt != at) problem = "at";
+        if (!problem.empty()) report("batch", problem, json);
+    }
+
+    // Zu groß für den Buffer: 0 statt abgeschnittener Nachricht
+    Effect full;
+    for (uint8_t e = 0; e < MAX_BATCH_EFFECTS; e++) {
+        effects[e] = full;
+        randomCurve(effects[e].automation.color, true, MAX_KEYFRAMES);
+        randomCurve(effects[e].automation.brightness, false, MAX_KEYFRAMES);
+    }
+    checks++;
+    if (encodeBatch(0, effects, MAX_BATCH_EFFECTS, json, 1024) != 0) {
+        report("batch", "Überlauf nicht erkannt", nullptr);
+    }
+}
+
+static void randomEffects(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) roundTrip("random", randomEffect());
+}
+
+template <typename Step>
+static void runStep(const char* name, Step step) {
+    uint32_t checksBefore = checks;
+    uint32_t failuresBefore = failures;
+    step();
+    printf("%-8s %6u checks  %s\n", name, checks - checksBefore, failures == failuresBefore ? "ok" : "FAIL");
+}
+
+static bool parseOptions(int argc, char** argv, TestOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--seed" && hasValue) options.seed = strtoul(argv[++i], nullptr, 0);
+        else if (arg == "--random" && hasValue) options.randomEffects = atoi(argv[++i]);
+        else return false;
+    }
+    return options.seed != 0;
+}
+
+int main(int argc, char** argv) {
+    TestOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "Usage: protocol-test [--random N] [--seed N]\n");
+        return 2;
+    }
+    rngState = options.seed;
+
+    runStep("fixed", [] { fixedEffects(); });
+    runStep("random", [&] { randomEffects(options.randomEffects); });
+    runStep("delta", [&] { deltas(options.randomEffects); });
+    runStep("batch", [&] { batches(options.randomEffects / 10); });
+
+    printf("%u checks, %u failed\n", checks, failures);
+    return failures ? 1 : 0;
+}
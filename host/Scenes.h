@@ -0,0 +1,184 @@
+#ifndef HOST_SCENES_H
+#define HOST_SCENES_H
+
+#include <stdio.h>
+#include <string.h>
+#include "LEDSpotlight.h"
+#include "EffectParser.h"
+
+// ============================================================================
+// SZENEN (gemeinsam für Simulator und Benchmarks)
+// ============================================================================
+//
+// Eine Szene ist eine kurze Folge von Effekt-Befehlen im JSON-Format von
+// POST /effect, jeweils mit Zeitpunkt relativ zum Szenenstart. Zusammen
+// decken sie jeden Effekt und jedes Rotations-Pattern ab, dazu Paletten,
+// Übergänge, Automation und Segmente.
+
+#define SCENE_MAX_STEPS       4
+#define SCENE_PALETTE         1       // Von loadSceneAssets() geladen
+#define SCENE_PROGRAM         0
+#define SCENE_PROGRAM_WORST   1       // Längster erlaubter Pfad: 64 Befehle pro Pixel
+
+// Jedes der 64 Bytes ein Befehl, keine Sprünge – mehr lässt der Verifier
+// pro Pixel nicht zu (Maßstab für das Budget in spotlight-bench)
+#define SCENE_WORST_SOURCE \
+    "t i add tri8" \
+    " dup sin8 add dup sin8 add dup sin8 add dup sin8 add dup sin8 add" \
+    " dup sin8 add dup sin8 add dup sin8 add dup sin8 add dup sin8 add" \
+    " dup sin8 add dup sin8 add dup sin8 add dup sin8 add dup sin8 add" \
+    " dup sin8 add dup sin8 add dup sin8 add dup sin8 add" \
+    " dup dup hsv"
+
+struct SceneStep {
+    uint32_t atMs;
+    const char* effect;     // JSON wie POST /effect
+};
+
+struct Scene {
+    const char* name;
+    bool segments;          // Außenring in drei Segmente teilen (Segmente 1..3)
+    SceneStep steps[SCENE_MAX_STEPS];
+};
+
+static const Scene SCENES[] = {
+    { "idle", false, {} },
+    { "static", false, {
+        { 0, "{\"effect\":\"static\",\"color\":[255,80,0]}" } } },
+    { "fade", false, {
+        { 0, "{\"effect\":\"fade\",\"color\":[255,0,0],\"color2\":[0,0,255],\"duration\":2000}" } } },
+    { "strobe", false, {
+        { 0, "{\"effect\":\"strobe\",\"color\":[255,255,255],\"speed\":10}" } } },
+    { "pulse", false, {
+        { 0, "{\"effect\":\"pulse\",\"color\":[0,128,255],\"duration\":1500}" } } },
+    { "pulse-palette", false, {
+        { 0, "{\"effect\":\"pulse\",\"palette\":1,\"duration\":1500}" } } },
+    { "rotation-single", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"single\",\"speed\":50}}" } } },
+    { "rotation-trail", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"trail\",\"speed\":50,\"trailLength\":6}}" } } },
+    { "rotation-opposite", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"opposite\",\"speed\":50,"
+             "\"direction\":\"counterclockwise\"}}" } } },
+    { "rotation-wave", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"wave\",\"speed\":50,"
+             "\"activeColor\":[0,255,80],\"inactiveColor\":[0,0,40]}}" } } },
+    { "rotation-rainbow_chase", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"rainbow_chase\",\"speed\":50}}" } } },
+    { "rotation-palette", false, {
+        { 0, "{\"effect\":\"rotation\",\"palette\":1,\"rotation\":{\"pattern\":\"trail\",\"speed\":50,"
+             "\"trailLength\":6}}" } } },
+    { "rainbow", false, {
+        { 0, "{\"effect\":\"rainbow\"}" } } },
+    { "rainbow-palette", false, {
+        { 0, "{\"effect\":\"rainbow\",\"palette\":1}" } } },
+    { "chase", false, {
+        { 0, "{\"effect\":\"chase\",\"color\":[0,0,255],\"speed\":60}" } } },
+    { "program", false, {
+        { 0, "{\"effect\":\"program\",\"program\":0,\"programParams\":[200,0,0,0]}" } } },
+    { "program-worst", false, {
+        { 0, "{\"effect\":\"program\",\"program\":1}" } } },
+    { "automation", false, {
+        { 0, "{\"effect\":\"rotation\",\"rotation\":{\"pattern\":\"trail\"},\"automation\":{"
+             "\"brightness\":{\"keys\":[[0,0],[1000,255,\"inOut\"]]},"
+             "\"color\":{\"keys\":[[0,[255,0,0]],[2000,[0,0,255]]],\"loop\":true},"
+             "\"speed\":{\"keys\":[[0,200],[1000,30],[2000,200]],\"loop\":true},"
+             "\"trailLength\":{\"keys\":[[0,1],[1500,8,\"step\"]]}}}" } } },
+    { "transition", false, {
+        { 0, "{\"effect\":\"static\",\"color\":[255,0,0]}" },
+        { 500, "{\"effect\":\"rainbow\",\"transitionMs\":1000}" } } },
+    { "segments", true, {
+        { 0, "{\"effect\":\"pulse\",\"ring\":\"inner\",\"color\":[255,0,80]}" },
+        { 0, "{\"effect\":\"chase\",\"segments\":[1],\"color\":[0,0,255],\"speed\":60}" },
+        { 0, "{\"effect\":\"rotation\",\"segments\":[2],\"rotation\":{\"pattern\":\"trail\",\"speed\":40}}" },
+        { 0, "{\"effect\":\"rainbow\",\"segments\":[3]}" } } },
+};
+
+#define NUM_SCENES (sizeof(SCENES) / sizeof(SCENES[0]))
+
+inline const Scene* findScene(const char* name) {
+    for (size_t i = 0; i < NUM_SCENES; i++) {
+        if (strcmp(SCENES[i].name, name) == 0) return &SCENES[i];
+    }
+    return nullptr;
+}
+
+// Palette und Programm für die Szenen (sonst per POST /palette bzw. /program)
+inline void loadSceneAssets(LEDSpotlight& spotlight) {
+    static const CRGB sunset[] = { CRGB(255, 0, 0), CRGB(255, 128, 0), CRGB(80, 0, 120) };
+    spotlight.setPalette(SCENE_PALETTE, sunset, 3, "sunset");
+
+    PixelProgram program;
+    const char* error = program.assemble("i 32 mul t 4 shr add  255 p0 hsv");
+    if (error) fprintf(stderr, "Szenen-Programm: %s\n", error);
+    spotlight.setProgram(SCENE_PROGRAM, program);
+
+    error = program.assemble(SCENE_WORST_SOURCE);
+    if (error) fprintf(stderr, "Szenen-Programm (worst): %s\n", error);
+    else if (program.size() != MAX_PROGRAM_LENGTH) fprintf(stderr, "Szenen-Programm (worst): nur %u Bytes\n", program.size());
+    spotlight.setProgram(SCENE_PROGRAM_WORST, program);
+}
+
+// Spielt eine Szene ab: Schritte werden fällig, sobald die virtuelle Zeit
+// ihren Zeitpunkt erreicht (Zeit vor dem Frame vorstellen, dann frame())
+//
+// phaseLocked: wie vom Commander – jeder Schritt trägt seinen Soll-Zeitpunkt
+// als startTime in der Show-Uhr (braucht setShowClock()), statt zu starten,
+// wann ihn der Frame gerade abholt
+class SceneRunner {
+public:
+    SceneRunner(LEDSpotlight& spotlight, const Scene& scene, bool phaseLocked = false) :
+        spotlight(spotlight),
+        scene(scene),
+        startMs(millis()),
+        startShow(spotlight.showClock()),
+        phaseLocked(phaseLocked),
+        nextStep(0) {
+        if (scene.segments) {
+            static const SegmentLayout layout[] = {
+                { RING_INNER, 0, NUM_LEDS_INNER },
+                { RING_OUTER, 0, NUM_LEDS_OUTER / 3 },
+                { RING_OUTER, NUM_LEDS_OUTER / 3, NUM_LEDS_OUTER / 3 },
+                { RING_OUTER, 2 * (NUM_LEDS_OUTER / 3), NUM_LEDS_OUTER - 2 * (NUM_LEDS_OUTER / 3) },
+            };
+            spotlight.configureSegments(layout, 4);
+        } else {
+            spotlight.resetSegments();
+        }
+        spotlight.stopAllEffects();
+    }
+
+    // true, wenn vor dem Frame ein Schritt angewandt wurde
+    bool frame() {
+        unsigned long elapsed = millis() - startMs;
+        bool stepped = false;
+        while (nextStep < SCENE_MAX_STEPS && scene.steps[nextStep].effect &&
+               scene.steps[nextStep].atMs <= elapsed) {
+            apply(scene.steps[nextStep]);
+            nextStep++;
+            stepped = true;
+        }
+        spotlight.loop();
+        return stepped;
+    }
+
+private:
+    LEDSpotlight& spotlight;
+    const Scene& scene;
+    unsigned long startMs;
+    unsigned long startShow;
+    bool phaseLocked;
+    uint8_t nextStep;
+
+    void apply(const SceneStep& step) {
+        Effect effect;
+        if (decodeEffect(step.effect, strlen(step.effect), effect) != DECODE_OK) {
+            fprintf(stderr, "Szene %s: ungültiger Effekt %s\n", scene.name, step.effect);
+            return;
+        }
+        if (phaseLocked) effect.startTime = startShow + step.atMs;
+        spotlight.setEffect(effect);
+    }
+};
+
+#endif // HOST_SCENES_H
@@ -0,0 +1,312 @@
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Corpus.h"
+#include "Histogram.h"
+#include "Scenes.h"
+#include "shim/HostNet.h"
+
+// ============================================================================
+// RENDER-BENCHMARKS (Host)
+// ============================================================================
+//
+// Misst LEDSpotlight::loop() pro Szene mit der Host-Uhr, virtuelle Zeit
+// läuft mit 60 fps. "idle" ist die Loop ohne Effekt (UDP-Abfrage, Queue,
+// Lock) – die Spalte "render" zieht sie ab. Absolute Zahlen sind Host-Zeiten,
+// aussagekräftig ist der Vergleich zwischen Szenen und vor/nach Änderungen.
+//
+// Pixel-Programme ("program*") müssen ins Frame-Budget passen: p99 der
+// Loop, mit TARGET_SLOWDOWN auf den ESP32 hochgerechnet, höchstens
+// PROGRAM_BUDGET_SHARE der Frame-Zeit bei --fps – sonst Exit-Code 1.
+// "program-worst" ist das längste Programm, das der Verifier zulässt.
+//
+// Danach der Parser: decodeEffect()/decodeBatch() über die README-Beispiele
+// aus tests/corpus, ohne HTTP und Queue (Szene "parse").
+//
+//   spotlight-bench                    # alle Szenen + Parser
+//   spotlight-bench --frames 100000 --scene rainbow
+//   spotlight-bench --scene parse --corpus tests/corpus
+//   spotlight-bench --scene program-worst --fps 120 --slowdown 60
+//   spotlight-bench --flood --clients 8 --duration 5
+//
+// --flood läuft in Echtzeit: der Scheinwerfer an einem echten Port, die
+// Render-Loop mit --fps im Haupt-Thread, --clients Verbindungen schicken
+// /effect so schnell es geht. Ergebnis: Effekt-Befehle pro Sekunde
+// (angenommen, 503 bei voller Queue) und die Dauer von loop() – keine
+// darf länger als ein Frame sein, sonst Exit-Code 1. Dazu ein Body über
+// MAX_REQUEST_BODY, der 413 bekommen muss.
+
+#define BENCH_FPS             60
+#define BENCH_WARMUP_FRAMES   500
+#define PROGRAM_BUDGET_SHARE  50      // % der Frame-Zeit für Loop inkl. Programm (Rest: show(), Netz)
+#define TARGET_SLOWDOWN       40      // ESP32 (240 MHz) gegenüber Host, grob und eher vorsichtig
+#define FLOOD_PORT            18300
+#define FLOOD_CLIENTS         4
+#define FLOOD_DURATION_S      3
+#define FLOOD_TIMEOUT_MS      5000
+
+struct BenchResult {
+    double avgNs;
+    uint32_t p50Ns;
+    uint32_t p99Ns;
+    uint32_t maxNs;
+};
+
+static BenchResult runScene(LEDSpotlight& spotlight, const Scene& scene, uint32_t frames, uint32_t fps) {
+    using namespace std::chrono;
+
+    SceneRunner runner(spotlight, scene);
+    Histogram histogram;
+    uint64_t totalNs = 0;
+
+    for (uint32_t frame = 0; frame < BENCH_WARMUP_FRAMES + frames; frame++) {
+        hostAdvanceMicros(1000000 / fps);
+
+        steady_clock::time_point start = steady_clock::now();
+        runner.frame();
+        uint64_t ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+        if (frame < BENCH_WARMUP_FRAMES) continue;
+        histogram.record(ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns);
+        totalNs += ns;
+    }
+
+    BenchResult result;
+    result.avgNs = (double)totalNs / frames;
+    result.p50Ns = histogram.percentile(50);
+    result.p99Ns = histogram.percentile(99);
+    result.maxNs = histogram.max;
+    return result;
+}
+
+// Durchsatz des Parsers pro Korpus-Datei, ein Request = ein Durchlauf
+static void runParse(const std::vector<CorpusFile>& files, uint32_t iterations) {
+    using namespace std::chrono;
+
+    printf("%-24s %10s %10s %10s\n", "parse", "bytes", "ns/parse", "MB/s");
+    for (const CorpusFile& file : files) {
+        const char* body = file.body.data();
+        size_t length = file.body.size();
+        uint32_t rejected = 0;
+
+        steady_clock::time_point start = steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            if (decodeCorpusBody(body, length, file.batch) != DECODE_OK) rejected++;
+        }
+        double ns = (double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / iterations;
+
+        printf("%-24s %10zu %10.0f %10.0f%s\n", file.name.c_str(), length, ns,
+               length * 1000.0 / ns, rejected ? "  (rejected!)" : "");
+    }
+}
+
+// ============================================================================
+// FLUT (--flood, Echtzeit)
+// ============================================================================
+
+// Status-Code, Antwort-Body in response; -1 = keine Verbindung / Timeout
+static int callSpotlight(uint16_t port, const char* method, const char* path, const std::string& body,
+                         std::string* response = nullptr) {
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(port);
+    remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*)&remote, sizeof(remote)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    std::string message = std::string(method) + " " + path + " HTTP/1.1\r\n" +
+                          "Host: 127.0.0.1\r\n" +
+                          "Content-Type: application/json\r\n" +
+                          "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                          "Connection: close\r\n\r\n" + body;
+
+    int code = -1;
+    std::string head, content;
+    if (hostWriteAll(fd, message, FLOOD_TIMEOUT_MS) && hostReadHttp(fd, head, content, FLOOD_TIMEOUT_MS, true)) {
+        size_t space = head.find(' ');
+        if (space != std::string::npos) code = atoi(head.c_str() + space + 1);
+    }
+    close(fd);
+    if (response) *response = content;
+    return code;
+}
+
+// Effekte abwechselnd (Farbe pro Request neu, damit kein Befehl dem vorigen gleicht)
+static std::string floodEffect(uint32_t n) {
+    static const char* const effects[] = { "static", "pulse", "chase", "rainbow" };
+    return "{\"effect\":\"" + std::string(effects[n % 4]) + "\",\"color\":[" + std::to_string(n & 0xFF) + "," +
+           std::to_string((n >> 8) & 0xFF) + ",200],\"speed\":" + std::to_string(20 + n % 60) + "}";
+}
+
+static int runFlood(uint32_t fps, uint32_t clients, double durationS, uint16_t port) {
+    using namespace std::chrono;
+
+    hostUseRealTime();
+    hostSetWebServerPort(port);
+    hostSetSerial(nullptr);
+    static LEDSpotlight spotlight;
+    spotlight.begin("host", "", "flood");
+
+    std::atomic<bool> running{true};
+    std::atomic<uint32_t> accepted{0}, rejected{0}, failed{0};
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0; c < clients; c++) {
+        threads.emplace_back([&, c] {
+            for (uint32_t n = c; running; n += clients) {
+                int code = callSpotlight(port, "POST", "/effect", floodEffect(n));
+                if (code == 200) accepted++;
+                else if (code == 503) rejected++;
+                else failed++;
+            }
+        });
+    }
+
+    // Render-Loop im Frame-Takt, gemessen wird nur loop() selbst
+    Histogram loopNs;
+    const nanoseconds frame(1000000000ull / fps);
+    steady_clock::time_point start = steady_clock::now();
+    steady_clock::time_point end = start + duration_cast<nanoseconds>(duration<double>(durationS));
+    uint32_t frames = 0;
+    for (steady_clock::time_point next = start; next < end; next += frame) {
+        std::this_thread::sleep_until(next);
+        steady_clock::time_point before = steady_clock::now();
+        spotlight.loop();
+        uint64_t ns = duration_cast<nanoseconds>(steady_clock::now() - before).count();
+        loopNs.record(ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns);
+        frames++;
+    }
+    double elapsedS = duration<double>(steady_clock::now() - start).count();
+    running = false;
+    for (std::thread& thread : threads) thread.join();
+
+    // Zu großer Body: 413 statt 400 "No body"
+    int oversized = callSpotlight(port, "POST", "/effect", std::string(MAX_REQUEST_BODY + 1, ' '));
+
+    uint32_t total = accepted + rejected + failed;
+    printf("flood: %u clients, %.1f s, %u frames at %u fps\n\n", clients, elapsedS, frames, fps);
+    printf("%-14s %10s %10s %10s %10s\n", "effect", "requests/s", "accepted/s", "503/s", "failed");
+    printf("%-14s %10.0f %10.0f %10.0f %10u\n", "/effect", total / elapsedS, accepted / elapsedS,
+           rejected / elapsedS, failed.load());
+    printf("%-14s %10s %10s %10s %10s\n", "loop", "p50<=", "p99<=", "max", "frame");
+    printf("%-14s %10u %10u %10u %10llu\n", "ns", loopNs.percentile(50), loopNs.percentile(99), loopNs.max,
+           (unsigned long long)frame.count());
+
+    bool ok = true;
+    if (loopNs.max > (uint64_t)frame.count()) {
+        printf("FAIL: loop() took %u ns, longer than one frame\n", loopNs.max);
+        ok = false;
+    }
+    if (accepted == 0 || failed) {
+        printf("FAIL: %u effect commands accepted, %u failed\n", accepted.load(), failed.load());
+        ok = false;
+    }
+    if (oversized != 413) {
+        printf("FAIL: body over MAX_REQUEST_BODY answered %d, expected 413\n", oversized);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+// Hochgerechnete Zeit auf dem Ziel gegen das Budget, true = passt
+static bool checkBudget(const char* name, const BenchResult& result, uint32_t fps, uint32_t slowdown) {
+    double budgetUs = 1000000.0 / fps * PROGRAM_BUDGET_SHARE / 100;
+    double targetUs = result.p99Ns / 1000.0 * slowdown;
+    bool fits = targetUs <= budgetUs;
+    printf("budget %-17s p99 %u ns x %u = %.0f us of %.0f us (%u fps)  %s\n", name,
+           result.p99Ns, slowdown, targetUs, budgetUs, fps, fits ? "ok" : "OVER BUDGET");
+    return fits;
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = 20000;
+    uint32_t fps = BENCH_FPS;
+    uint32_t slowdown = TARGET_SLOWDOWN;
+    const char* only = nullptr;
+    const char* corpus = CORPUS_DIR;
+    bool flood = false;
+    uint32_t clients = FLOOD_CLIENTS;
+    double durationS = FLOOD_DURATION_S;
+    uint16_t port = FLOOD_PORT;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (arg == "--scene" && i + 1 < argc) only = argv[++i];
+        else if (arg == "--corpus" && i + 1 < argc) corpus = argv[++i];
+        else if (arg == "--fps" && i + 1 < argc) fps = atoi(argv[++i]);
+        else if (arg == "--slowdown" && i + 1 < argc) slowdown = atoi(argv[++i]);
+        else if (arg == "--flood") flood = true;
+        else if (arg == "--clients" && i + 1 < argc) clients = atoi(argv[++i]);
+        else if (arg == "--duration" && i + 1 < argc) durationS = atof(argv[++i]);
+        else if (arg == "--port" && i + 1 < argc) port = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: spotlight-bench [--frames N] [--scene NAME] [--corpus DIR]\n"
+                            "                       [--fps N] [--slowdown N]\n"
+                            "       spotlight-bench --flood [--clients N] [--duration S] [--fps N] [--port P]\n");
+            return 2;
+        }
+    }
+    if (frames == 0) frames = 1;
+    if (fps == 0) fps = 1;
+    if (flood) return runFlood(fps, clients ? clients : 1, durationS > 0 ? durationS : 1, port);
+
+    hostSetSerial(nullptr);
+    static LEDSpotlight spotlight;
+    spotlight.begin("host", "", "bench");
+    loadSceneAssets(spotlight);
+
+    bool parseOnly = only && strcmp(only, "parse") == 0;
+
+    // Percentile sind Bucket-Obergrenzen (Zweierpotenzen, siehe Histogram.h)
+    if (!parseOnly) {
+        printf("%-24s %10s %10s %10s %10s %10s\n", "scene", "ns/frame", "render", "p50<=", "p99<=", "max");
+    }
+
+    // Budget-Zeilen erst nach der Tabelle
+    BenchResult programs[NUM_SCENES];
+    const char* programNames[NUM_SCENES];
+    size_t numPrograms = 0;
+
+    double idleNs = parseOnly ? 0 : runScene(spotlight, SCENES[0], frames, fps).avgNs;
+    for (size_t s = 0; s < NUM_SCENES && !parseOnly; s++) {
+        if (only && strcmp(only, SCENES[s].name) != 0) continue;
+
+        BenchResult result = runScene(spotlight, SCENES[s], frames, fps);
+        double renderNs = result.avgNs > idleNs ? result.avgNs - idleNs : 0;
+        printf("%-24s %10.0f %10.0f %10u %10u %10u\n", SCENES[s].name,
+               result.avgNs, renderNs, result.p50Ns, result.p99Ns, result.maxNs);
+
+        if (strncmp(SCENES[s].name, "program", 7) == 0) {
+            programs[numPrograms] = result;
+            programNames[numPrograms++] = SCENES[s].name;
+        }
+    }
+
+    bool withinBudget = true;
+    if (numPrograms) printf("\n");
+    for (size_t p = 0; p < numPrograms; p++) {
+        withinBudget &= checkBudget(programNames[p], programs[p], fps, slowdown);
+    }
+    int status = withinBudget ? 0 : 1;
+
+    if (only && !parseOnly) return status;
+    std::vector<CorpusFile> files;
+    if (!loadCorpus(corpus, files)) {
+        fprintf(stderr, "No corpus in %s (run from host/ or pass --corpus)\n", corpus);
+        return 1;
+    }
+    if (!parseOnly) printf("\n");
+    runParse(files, frames);
+    return status;
+}
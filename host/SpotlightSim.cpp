@@ -0,0 +1,278 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "Scenes.h"
+
+// ============================================================================
+// SPOTLIGHT-SIMULATOR (Host)
+// ============================================================================
+//
+// Treibt LEDSpotlight in virtueller Zeit und gibt die Frames aus:
+//
+//   spotlight-sim --scene rotation-trail --ascii
+//   spotlight-sim --effect '{"effect":"chase","speed":40}' --ppm frames/
+//   spotlight-sim --scene transition --hash     # Prüfsumme über alle Frames
+//   spotlight-sim --scene transition --memory   # Rendern ohne malloc?
+//   spotlight-sim --scene chase --identity 47   # 60 fps und 47 fps: gleiche Frames?
+//
+// Die Frames kommen direkt aus den Arrays, die LEDSpotlight bei FastLED
+// registriert (0 = innerer, 1 = äußerer Ring), mit globaler Helligkeit.
+
+#define PPM_SIZE              160     // Kantenlänge eines Frames in Pixeln
+#define PPM_LED_RADIUS        7
+#define IDENTITY_SHOW_START   100000  // Show-Uhr zu Beginn jedes --identity-Laufs (ms)
+
+struct SimOptions {
+    const char* scene = "rotation-trail";
+    const char* effect = nullptr;
+    const char* ppmDir = nullptr;
+    uint32_t frames = 120;
+    uint32_t fps = 60;
+    uint32_t identityFps = 0;   // Zweite Loop-Rate für --identity (0 = aus)
+    bool ascii = false;
+    bool color = false;
+    bool hash = false;
+    bool logs = false;
+    bool memory = false;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "Usage: spotlight-sim [--scene NAME | --effect JSON] [--frames N] [--fps N]\n"
+        "                     [--ascii [--color]] [--ppm DIR] [--hash] [--logs] [--memory] [--list]\n"
+        "                     [--identity FPS]\n");
+}
+
+// Ein Ring-LED mit angewandter globaler Helligkeit (wie beim Treiber)
+static CRGB output(const CRGB& led) {
+    CRGB scaled = led;
+    return scaled.nscale8_video(FastLED.getBrightness());
+}
+
+// ============================================================================
+// ASCII
+// ============================================================================
+
+static void printLed(const CRGB& led, bool color) {
+    if (color) {
+        printf("\x1b[48;2;%u;%u;%um  \x1b[0m", led.r, led.g, led.b);
+        return;
+    }
+    static const char ramp[] = " .:-=+*#%@";
+    uint16_t luma = (led.r * 54 + led.g * 183 + led.b * 19) >> 8;
+    putchar(ramp[luma * (sizeof(ramp) - 2) / 255]);
+}
+
+static void printFrame(uint32_t frame, bool color) {
+    printf("%5u %7lums ", frame, millis());
+    for (int c = 0; c < FastLED.count(); c++) {
+        printf(c == 0 ? "inner [" : "] outer [");
+        for (int i = 0; i < FastLED[c].size(); i++) printLed(output(FastLED[c].leds()[i]), color);
+    }
+    printf("]\n");
+}
+
+// ============================================================================
+// PPM (Ringe als Kreise, außen = erster Ring-Radius)
+// ============================================================================
+
+static bool writePpm(const char* dir, uint32_t frame) {
+    static uint8_t image[PPM_SIZE][PPM_SIZE][3];
+    memset(image, 0x10, sizeof(image));
+
+    const float center = PPM_SIZE / 2.0f;
+    const float radii[] = { PPM_SIZE * 0.18f, PPM_SIZE * 0.42f };
+
+    for (int c = 0; c < FastLED.count() && c < 2; c++) {
+        int count = FastLED[c].size();
+        for (int i = 0; i < count; i++) {
+            CRGB led = output(FastLED[c].leds()[i]);
+            float angle = 2.0f * (float)PI * i / count - (float)PI / 2.0f;
+            int cx = center + radii[c] * cosf(angle);
+            int cy = center + radii[c] * sinf(angle);
+
+            for (int y = cy - PPM_LED_RADIUS; y <= cy + PPM_LED_RADIUS; y++) {
+                for (int x = cx - PPM_LED_RADIUS; x <= cx + PPM_LED_RADIUS; x++) {
+                    if (x < 0 || y < 0 || x >= PPM_SIZE || y >= PPM_SIZE) continue;
+                    if ((x - cx) * (x - cx) + (y - cy) * (y - cy) > PPM_LED_RADIUS * PPM_LED_RADIUS) continue;
+                    image[y][x][0] = led.r;
+                    image[y][x][1] = led.g;
+                    image[y][x][2] = led.b;
+                }
+            }
+        }
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05u.ppm", dir, frame);
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", PPM_SIZE, PPM_SIZE);
+    fwrite(image, 1, sizeof(image), file);
+    fclose(file);
+    return true;
+}
+
+// ============================================================================
+// PRÜFSUMME (FNV-1a über alle Frames)
+// ============================================================================
+
+static uint32_t hashFrame(uint32_t hash) {
+    for (int c = 0; c < FastLED.count(); c++) {
+        for (int i = 0; i < FastLED[c].size(); i++) {
+            CRGB led = output(FastLED[c].leds()[i]);
+            for (uint8_t k = 0; k < 3; k++) {
+                hash ^= led.raw[k];
+                hash *= 16777619u;
+            }
+        }
+    }
+    return hash;
+}
+
+// ============================================================================
+// FRAME-IDENTITÄT (--identity)
+// ============================================================================
+//
+// Dieselbe Szene mit zwei Loop-Raten, beide Male phasengleich gestartet
+// (Show-Uhr synchronisiert, Schritte mit startTime wie vom Commander).
+// Effekte sind reine Funktionen der Show-Uhr – wo beide Läufe einen Frame
+// zur selben Millisekunde haben, müssen die Frames gleich sein.
+
+struct TimedFrame {
+    unsigned long showMs;
+    uint32_t hash;
+};
+
+static void recordFrames(LEDSpotlight& spotlight, const Scene& scene, uint32_t fps,
+                         uint32_t durationMs, std::vector<TimedFrame>& frames) {
+    spotlight.setShowClock(IDENTITY_SHOW_START);
+    SceneRunner runner(spotlight, scene, true);
+    uint64_t frameUs = 1000000 / fps;
+
+    while (spotlight.showClock() - IDENTITY_SHOW_START < durationMs) {
+        hostAdvanceMicros(frameUs);
+        runner.frame();
+        frames.push_back({ spotlight.showClock(), hashFrame(2166136261u) });
+    }
+}
+
+// Exit-Code: 0 = alle gemeinsamen Zeitpunkte gleich
+static int compareFrameRates(LEDSpotlight& spotlight, const Scene& scene, const SimOptions& options) {
+    uint32_t durationMs = (uint64_t)options.frames * 1000 / options.fps;
+    std::vector<TimedFrame> a;
+    std::vector<TimedFrame> b;
+    recordFrames(spotlight, scene, options.fps, durationMs, a);
+    recordFrames(spotlight, scene, options.identityFps, durationMs, b);
+
+    uint32_t shared = 0;
+    uint32_t mismatches = 0;
+    size_t j = 0;
+    for (const TimedFrame& frame : a) {
+        while (j < b.size() && b[j].showMs < frame.showMs) j++;
+        if (j == b.size() || b[j].showMs != frame.showMs) continue;
+
+        shared++;
+        if (b[j].hash == frame.hash) continue;
+        if (mismatches++ == 0) {
+            printf("%s: first mismatch at show time %lu ms (+%lu ms)\n", scene.name, frame.showMs,
+                   frame.showMs - IDENTITY_SHOW_START);
+        }
+    }
+
+    printf("%s fps=%u/%u shared=%u mismatches=%u\n", scene.name, options.fps, options.identityFps,
+           shared, mismatches);
+    return (mismatches || shared == 0) ? 1 : 0;
+}
+
+// ============================================================================
+// HEAP (--memory)
+// ============================================================================
+
+// Allokationen des Loop-Tasks bisher (common/MemoryStats.h)
+static uint32_t loopAllocations() {
+    MemorySnapshot snapshot;
+    memoryStats.snapshot(snapshot);
+    for (uint8_t i = 0; i < snapshot.taskCount; i++) {
+        if (strcmp(snapshot.tasks[i].name, "loop") == 0) return snapshot.tasks[i].allocations;
+    }
+    return 0;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static bool parseOptions(int argc, char** argv, SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--scene" && hasValue) options.scene = argv[++i];
+        else if (arg == "--effect" && hasValue) options.effect = argv[++i];
+        else if (arg == "--ppm" && hasValue) options.ppmDir = argv[++i];
+        else if (arg == "--frames" && hasValue) options.frames = atoi(argv[++i]);
+        else if (arg == "--fps" && hasValue) options.fps = atoi(argv[++i]);
+        else if (arg == "--identity" && hasValue) options.identityFps = atoi(argv[++i]);
+        else if (arg == "--ascii") options.ascii = true;
+        else if (arg == "--color") options.color = true;
+        else if (arg == "--hash") options.hash = true;
+        else if (arg == "--logs") options.logs = true;
+        else if (arg == "--memory") options.memory = true;
+        else if (arg == "--list") {
+            for (size_t s = 0; s < NUM_SCENES; s++) printf("%s\n", SCENES[s].name);
+            exit(0);
+        } else {
+            return false;
+        }
+    }
+    return options.fps > 0;
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    Scene custom = { "custom", false, { { 0, options.effect } } };
+    const Scene* scene = options.effect ? &custom : findScene(options.scene);
+    if (!scene) {
+        fprintf(stderr, "Unbekannte Szene: %s (--list)\n", options.scene);
+        return 2;
+    }
+
+    if (!options.logs) hostSetSerial(nullptr);
+    static LEDSpotlight spotlight;
+    spotlight.begin("host", "", "sim");
+    loadSceneAssets(spotlight);
+
+    if (options.identityFps) return compareFrameRates(spotlight, *scene, options);
+
+    SceneRunner runner(spotlight, *scene);
+    uint32_t hash = 2166136261u;
+    uint64_t frameUs = 1000000 / options.fps;
+    uint32_t steadyAllocations = 0;    // In Frames ohne neuen Szenen-Schritt
+
+    for (uint32_t frame = 0; frame < options.frames; frame++) {
+        hostAdvanceMicros(frameUs);
+        uint32_t before = loopAllocations();
+        if (!runner.frame()) steadyAllocations += loopAllocations() - before;
+
+        if (options.ascii) printFrame(frame, options.color);
+        if (options.ppmDir && !writePpm(options.ppmDir, frame)) return 1;
+        if (options.hash) hash = hashFrame(hash);
+    }
+
+    if (options.hash) printf("%s frames=%u fps=%u hash=%08x\n", scene->name, options.frames, options.fps, hash);
+    if (options.memory) {
+        printf("%s frames=%u allocations=%u\n", scene->name, options.frames, steadyAllocations);
+        if (steadyAllocations) return 1;    // Rendern darf keinen Heap holen
+    }
+    return 0;
+}
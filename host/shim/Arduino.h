@@ -0,0 +1,166 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+#include "HostRuntime.h"
+
+// ============================================================================
+// ARDUINO-STAND-IN (Host)
+// ============================================================================
+//
+// Nur was die beiden Firmwares benutzen: Zeit (virtuell, siehe
+// HostRuntime.h), String, Serial, ESP. Kein Anspruch auf Vollständigkeit.
+
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    String(const char* text, unsigned int length) : value(text ? std::string(text, length) : "") {}
+    String(char c) : value(1, c) {}
+    String(int number) : value(std::to_string(number)) {}
+    String(unsigned int number) : value(std::to_string(number)) {}
+    String(long number) : value(std::to_string(number)) {}
+    String(unsigned long number) : value(std::to_string(number)) {}
+    String(long long number) : value(std::to_string(number)) {}
+    String(unsigned long long number) : value(std::to_string(number)) {}
+    String(double number, unsigned int decimals = 2) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, number);
+        value = buffer;
+    }
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    void reserve(unsigned int size) { value.reserve(size); }
+    void clear() { value.clear(); }
+
+    char operator[](unsigned int index) const { return index < value.size() ? value[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == (other ? other : ""); }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return value < other.value; }
+    bool equals(const String& other) const { return value == other.value; }
+    bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = value.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return from < value.size() ? value.substr(from) : ""; }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < value.size() && to > from ? value.substr(from, to - from) : "";
+    }
+    long toInt() const { return atol(value.c_str()); }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { if (other) value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    template <typename T>
+    String& operator+=(T number) { value += String(number).value; return *this; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+    friend String operator+(const String& a, const char* b) { return String(a.value + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.value); }
+
+private:
+    std::string value;
+};
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    template <typename T>
+    size_t print(const T& value) { return print(toString(value)); }
+
+    size_t println() { return print("\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    // Zahlen direkt, alles andere (IPAddress) über toString()
+    template <typename T>
+    static String toString(const T& value) {
+        if constexpr (std::is_floating_point<T>::value) return String((double)value);
+        else if constexpr (std::is_integral<T>::value) return String((long long)value);
+        else return value.toString();
+    }
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    void flush();
+    size_t write(const uint8_t* data, size_t length) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+class EspClass {
+public:
+    uint32_t getCycleCount();       // Echte Zeit in Takten bei getCpuFreqMHz()
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getHeapSize() { return 320 * 1024; }
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    uint32_t getMinFreeHeap() { return 180 * 1024; }
+    uint32_t getMaxAllocHeap() { return 110 * 1024; }
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
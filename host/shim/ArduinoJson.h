@@ -0,0 +1,298 @@
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// ============================================================================
+// ARDUINOJSON-STAND-IN (Host)
+// ============================================================================
+//
+// Kleiner Baum mit der Oberfläche von ArduinoJson 6, soweit die Handler sie
+// benutzen: Lesen (operator[], |, as<T>(), Iteration), Schreiben
+// (Zuweisung, createNested*, add, remove) und (De-)Serialisieren. Kapazität
+// wird nicht geprüft. Wie bei ArduinoJson legt Lesen keinen Schlüssel an –
+// hier entsteht zwar ein Knoten, er bleibt aber unsichtbar, bis ihm etwas
+// zugewiesen wird.
+
+// Kapazität wie ArduinoJson 6 auf dem ESP32 (ein VariantSlot = 16 Bytes),
+// damit Größenrechnungen der Firmware übersetzen
+#define JSON_ARRAY_SIZE(n)    ((n) * 16)
+#define JSON_OBJECT_SIZE(n)   ((n) * 16)
+
+struct JsonNode {
+    enum Type { NUL, BOOLEAN, INTEGER, REAL, TEXT, ARRAY, OBJECT };
+
+    Type type = NUL;
+    bool implicit = false;      // Nur gelesen, nie geschrieben
+    bool boolean = false;
+    int64_t integer = 0;
+    double real = 0;
+    std::string text;
+    std::vector<std::string> keys;                  // OBJECT: parallel zu items
+    std::vector<std::unique_ptr<JsonNode>> items;
+    JsonNode* parent = nullptr;
+
+    void reset(Type next);
+    JsonNode* child(const char* key, bool create);
+    JsonNode* append();
+    void materialize();         // Knoten und Eltern sichtbar machen
+    size_t visibleSize() const;
+};
+
+class JsonVariant;
+class JsonObject;
+class JsonArray;
+
+template <typename T>
+struct IsJsonHandle : std::is_base_of<JsonVariant, T> {};
+
+class JsonIterator {
+public:
+    JsonIterator(JsonNode* node, size_t index) : node(node), index(index) { skipImplicit(); }
+    JsonVariant operator*() const;
+    JsonIterator& operator++() { index++; skipImplicit(); return *this; }
+    bool operator!=(const JsonIterator& other) const { return node != other.node || index != other.index; }
+
+private:
+    JsonNode* node;
+    size_t index;
+
+    void skipImplicit() {
+        while (node && index < node->items.size() && node->items[index]->implicit) index++;
+    }
+};
+
+class JsonVariant {
+public:
+    JsonVariant() : node(nullptr) {}
+    explicit JsonVariant(JsonNode* node) : node(node) {}
+
+    JsonVariant operator[](const char* key) const { return JsonVariant(node ? node->child(key, true) : nullptr); }
+    JsonVariant operator[](const String& key) const { return (*this)[key.c_str()]; }
+    JsonVariant operator[](int index) const { return at(index); }
+    JsonVariant operator[](size_t index) const { return at(index); }
+
+    template <typename T, typename = typename std::enable_if<!IsJsonHandle<T>::value>::type>
+    operator T() const { return as<T>(); }
+
+    template <typename T>
+    JsonVariant& operator=(const T& value) { set(value); return *this; }
+
+    template <typename T> T as() const;
+    template <typename T> bool is() const;
+    template <typename T> T to() const;
+
+    template <typename T>
+    T operator|(const T& fallback) const { return is<T>() ? as<T>() : fallback; }
+    const char* operator|(const char* fallback) const { return is<const char*>() ? as<const char*>() : fallback; }
+
+    bool containsKey(const char* key) const;
+    bool containsKey(const String& key) const { return containsKey(key.c_str()); }
+    bool isNull() const { return !node || node->type == JsonNode::NUL; }
+    size_t size() const { return node ? node->visibleSize() : 0; }
+
+    JsonObject createNestedObject() const;
+    JsonObject createNestedObject(const char* key) const;
+    JsonArray createNestedArray() const;
+    JsonArray createNestedArray(const char* key) const;
+    template <typename T> bool add(const T& value) const {
+        JsonNode* item = asContainer(JsonNode::ARRAY) ? node->append() : nullptr;
+        if (!item) return false;
+        JsonVariant(item).set(value);
+        return true;
+    }
+    void remove(const char* key) const;
+    void clear() const { if (node) node->reset(JsonNode::NUL); }
+
+    JsonIterator begin() const { return JsonIterator(isContainer() ? node : nullptr, 0); }
+    JsonIterator end() const { return JsonIterator(isContainer() ? node : nullptr, isContainer() ? node->items.size() : 0); }
+
+    size_t memoryUsage() const { return 0; }
+    bool overflowed() const { return false; }
+
+    JsonNode* raw() const { return node; }
+
+protected:
+    JsonNode* node;
+
+    JsonVariant at(size_t index) const;
+    bool isContainer() const { return node && (node->type == JsonNode::ARRAY || node->type == JsonNode::OBJECT); }
+    bool asContainer(JsonNode::Type type) const;
+
+    template <typename T> void set(const T& value);
+    void setText(const char* text);
+    void setInteger(int64_t value);
+    void setReal(double value);
+    void setBool(bool value);
+};
+
+class JsonObject : public JsonVariant {
+public:
+    JsonObject() {}
+    JsonObject(const JsonVariant& variant) : JsonVariant(variant) {}
+    using JsonVariant::operator=;
+};
+
+class JsonArray : public JsonVariant {
+public:
+    JsonArray() {}
+    JsonArray(const JsonVariant& variant) : JsonVariant(variant) {}
+    using JsonVariant::operator=;
+};
+
+typedef JsonVariant JsonVariantConst;
+typedef JsonObject JsonObjectConst;
+typedef JsonArray JsonArrayConst;
+
+inline JsonVariant JsonIterator::operator*() const {
+    return JsonVariant(node->items[index].get());
+}
+
+// ============================================================================
+// WERTE LESEN & SCHREIBEN
+// ============================================================================
+
+template <typename T>
+T JsonVariant::as() const {
+    if constexpr (std::is_same<T, bool>::value) {
+        if (!node) return false;
+        if (node->type == JsonNode::BOOLEAN) return node->boolean;
+        if (node->type == JsonNode::INTEGER) return node->integer != 0;
+        return false;
+    } else if constexpr (std::is_integral<T>::value) {
+        if (!node) return 0;
+        if (node->type == JsonNode::INTEGER) return (T)node->integer;
+        if (node->type == JsonNode::REAL) return (T)node->real;
+        if (node->type == JsonNode::BOOLEAN) return (T)node->boolean;
+        return 0;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        if (!node) return 0;
+        if (node->type == JsonNode::REAL) return (T)node->real;
+        if (node->type == JsonNode::INTEGER) return (T)node->integer;
+        return 0;
+    } else if constexpr (std::is_same<T, const char*>::value) {
+        return node && node->type == JsonNode::TEXT ? node->text.c_str() : nullptr;
+    } else if constexpr (std::is_same<T, String>::value) {
+        return node && node->type == JsonNode::TEXT ? String(node->text) : String();
+    } else if constexpr (IsJsonHandle<T>::value) {
+        return T(*this);
+    } else {
+        static_assert(sizeof(T) == 0, "Typ wird vom ArduinoJson-Stand-in nicht unterstützt");
+    }
+}
+
+template <typename T>
+bool JsonVariant::is() const {
+    if (!node) return false;
+    if constexpr (std::is_same<T, bool>::value) return node->type == JsonNode::BOOLEAN;
+    else if constexpr (std::is_integral<T>::value) return node->type == JsonNode::INTEGER;
+    else if constexpr (std::is_floating_point<T>::value) return node->type == JsonNode::INTEGER || node->type == JsonNode::REAL;
+    else if constexpr (std::is_same<T, const char*>::value || std::is_same<T, String>::value) return node->type == JsonNode::TEXT;
+    else if constexpr (std::is_same<T, JsonArray>::value) return node->type == JsonNode::ARRAY;
+    else if constexpr (std::is_same<T, JsonObject>::value) return node->type == JsonNode::OBJECT;
+    else return false;
+}
+
+template <typename T>
+T JsonVariant::to() const {
+    if (!node) return T();
+    if constexpr (std::is_same<T, JsonArray>::value) node->reset(JsonNode::ARRAY);
+    else if constexpr (std::is_same<T, JsonObject>::value) node->reset(JsonNode::OBJECT);
+    else node->reset(JsonNode::NUL);
+    node->materialize();
+    return T(*this);
+}
+
+template <typename T>
+void JsonVariant::set(const T& value) {
+    if constexpr (std::is_same<T, bool>::value) setBool(value);
+    else if constexpr (std::is_integral<T>::value) setInteger((int64_t)value);
+    else if constexpr (std::is_floating_point<T>::value) setReal(value);
+    else if constexpr (std::is_convertible<const T&, const char*>::value) setText(value);
+    else if constexpr (std::is_same<T, String>::value) setText(value.c_str());
+    else if constexpr (std::is_same<T, std::string>::value) setText(value.c_str());
+    else static_assert(sizeof(T) == 0, "Typ wird vom ArduinoJson-Stand-in nicht unterstützt");
+}
+
+// ============================================================================
+// DOKUMENTE
+// ============================================================================
+
+class JsonDocument : public JsonVariant {
+public:
+    JsonDocument() : JsonVariant(new JsonNode()), root(node) {}
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+    using JsonVariant::operator=;
+
+private:
+    std::unique_ptr<JsonNode> root;
+};
+
+template <size_t capacity>
+class StaticJsonDocument : public JsonDocument {
+public:
+    using JsonVariant::operator=;
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacity) : bytes(capacity) {}
+    using JsonVariant::operator=;
+    size_t capacity() const { return bytes; }
+
+private:
+    size_t bytes;
+};
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput };
+
+    DeserializationError(Code code = Ok) : code(code) {}
+    explicit operator bool() const { return code != Ok; }
+    const char* c_str() const;
+
+private:
+    Code code;
+};
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length);
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+    return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+inline DeserializationError deserializeJson(JsonDocument& doc, const uint8_t* input, size_t length) {
+    return deserializeJson(doc, (const char*)input, length);
+}
+
+std::string serializeJsonText(const JsonVariant& value);
+
+inline size_t serializeJson(const JsonVariant& value, String& output) {
+    std::string text = serializeJsonText(value);
+    output = String(text);
+    return text.size();
+}
+inline size_t serializeJson(const JsonVariant& value, char* output, size_t size) {
+    std::string text = serializeJsonText(value);
+    if (size == 0) return 0;
+    size_t length = std::min(text.size(), size - 1);
+    memcpy(output, text.data(), length);
+    output[length] = '\0';
+    return length;
+}
+inline size_t serializeJson(const JsonVariant& value, Print& output) {
+    std::string text = serializeJsonText(value);
+    return output.write((const uint8_t*)text.data(), text.size());
+}
+inline size_t measureJson(const JsonVariant& value) {
+    return serializeJsonText(value).size();
+}
+
+#endif // HOST_ARDUINO_JSON_H
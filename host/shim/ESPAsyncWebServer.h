@@ -0,0 +1,148 @@
+#ifndef HOST_ESP_ASYNC_WEB_SERVER_H
+#define HOST_ESP_ASYNC_WEB_SERVER_H
+
+#include <WiFi.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// ASYNC-WEBSERVER-STAND-IN (Host)
+// ============================================================================
+//
+// Virtuelle Zeit: Routen werden angenommen und nie aufgerufen – Simulatoren
+// und Benchmarks steuern die Firmware direkt über die öffentlichen Methoden.
+//
+// Echtzeit (hostUseRealTime()): begin() lauscht auf 127.0.0.1, ein Thread
+// arbeitet die Verbindungen nacheinander ab wie der AsyncTCP-Task.
+// HTTP/1.1 ohne Keep-Alive, Body komplett in einem Stück an den Body-Handler.
+
+enum WebRequestMethod {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_ANY = 0b01111111
+};
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter(const String& name, const String& value) : paramName(name), paramValue(value) {}
+
+    const String& name() const { return paramName; }
+    const String& value() const { return paramValue; }
+
+private:
+    String paramName;
+    String paramValue;
+};
+
+class AsyncWebServerResponse {
+public:
+    AsyncWebServerResponse(int code, const String& type) : code(code), contentType(type) {}
+    virtual ~AsyncWebServerResponse() {}
+    void addHeader(const String&, const String&) {}
+    void setCode(int next) { code = next; }
+
+    int code;
+    String contentType;
+    std::string content;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+    explicit AsyncResponseStream(const String& type) : AsyncWebServerResponse(200, type) {}
+    size_t write(const uint8_t* data, size_t length) override {
+        content.append((const char*)data, length);
+        return length;
+    }
+    using Print::write;
+};
+
+class AsyncClient {
+public:
+    IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+    uint16_t remotePort() { return 0; }
+};
+
+class AsyncWebServerRequest {
+public:
+    void* _tempObject = nullptr;
+
+    ~AsyncWebServerRequest();
+
+    AsyncClient* client() { return &connection; }
+    WebRequestMethod method() const { return requestMethod; }
+    const String& url() const { return requestUrl; }
+    size_t contentLength() const { return bodyLength; }
+
+    bool hasParam(const String& name, bool = false) const;
+    AsyncWebParameter* getParam(const String& name, bool = false) const;
+
+    void send(int code, const String& type = String(), const String& content = String());
+    void send(AsyncWebServerResponse* response);
+    AsyncResponseStream* beginResponseStream(const String& type, size_t = 1460) {
+        return new AsyncResponseStream(type);
+    }
+
+private:
+    friend class AsyncWebServer;
+
+    AsyncClient connection;
+    WebRequestMethod requestMethod = HTTP_GET;
+    String requestUrl;
+    size_t bodyLength = 0;
+    std::vector<AsyncWebParameter> params;
+    AsyncWebServerResponse* response = nullptr;
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+    String path;
+    WebRequestMethod method = HTTP_ANY;
+    ArRequestHandlerFunction onRequest;
+    ArBodyHandlerFunction onBody;
+};
+
+// Server-Sent Events: ohne Verbindungen geht jede Nachricht ins Leere
+class AsyncEventSource : public AsyncWebHandler {
+public:
+    explicit AsyncEventSource(const String&) {}
+    void send(const char*, const char* = nullptr, uint32_t = 0, uint32_t = 0) {}
+    size_t count() const { return 0; }
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t port) : port(port) {}
+    ~AsyncWebServer();
+
+    void begin();
+    void onNotFound(ArRequestHandlerFunction handler) { notFound = handler; }
+    AsyncWebHandler& addHandler(AsyncWebHandler* added) { return *added; }
+
+    AsyncCallbackWebHandler& on(const char* path, WebRequestMethod method, ArRequestHandlerFunction onRequest) {
+        return on(path, method, onRequest, nullptr, nullptr);
+    }
+    AsyncCallbackWebHandler& on(const char* path, WebRequestMethod method, ArRequestHandlerFunction onRequest,
+                                ArUploadHandlerFunction, ArBodyHandlerFunction onBody);
+
+private:
+    uint16_t port;
+    std::vector<AsyncCallbackWebHandler*> handlers;
+    ArRequestHandlerFunction notFound;
+
+    void serve(int listener);
+    void handle(int connection);
+};
+
+#endif // HOST_ESP_ASYNC_WEB_SERVER_H
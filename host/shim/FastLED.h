@@ -0,0 +1,198 @@
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// FASTLED-STAND-IN (Host)
+// ============================================================================
+//
+// Farbmathematik nach den C-Referenzimplementierungen von FastLED 3.6
+// (scale8 mit FASTLED_SCALE8_FIXED, blend8, sin8_C, hsv2rgb_rainbow,
+// 16→256-Paletten mit LINEARBLEND). show() gibt nichts aus, die Frames
+// stehen in den per addLeds() registrierten Arrays: FastLED[i].leds().
+// Globale Helligkeit wie beim echten Treiber erst bei der Ausgabe anwenden.
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : t;
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (a << 8) | b;
+    partial += (b * amountOfB);
+    partial -= (a * amountOfB);
+    return partial >> 8;
+}
+
+uint8_t sin8(uint8_t theta);
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+// ============================================================================
+// FARBEN
+// ============================================================================
+
+struct CHSV {
+    union {
+        struct {
+            uint8_t hue;
+            uint8_t sat;
+            uint8_t val;
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : hue(0), sat(0), val(0) {}
+    CHSV(uint8_t h, uint8_t s, uint8_t v) : hue(h), sat(s), val(v) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+    CRGB(const CHSV& hsv) { hsv2rgb_rainbow(hsv, *this); }
+
+    CRGB& operator=(const CHSV& hsv) {
+        hsv2rgb_rainbow(hsv, *this);
+        return *this;
+    }
+
+    uint8_t& operator[](uint8_t index) { return raw[index]; }
+    const uint8_t& operator[](uint8_t index) const { return raw[index]; }
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+
+    CRGB& operator+=(const CRGB& other) {
+        r = qadd8(r, other.r);
+        g = qadd8(g, other.g);
+        b = qadd8(b, other.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+
+    CRGB& nscale8_video(uint8_t scale) {
+        r = scale8_video(r, scale);
+        g = scale8_video(g, scale);
+        b = scale8_video(b, scale);
+        return *this;
+    }
+
+    CRGB& fadeToBlackBy(uint8_t fadeFactor) { return nscale8(255 - fadeFactor); }
+
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Red = 0xFF0000,
+        White = 0xFFFFFF
+    };
+};
+
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2);
+void fill_solid(CRGB* leds, int numLeds, const CRGB& color);
+
+// ============================================================================
+// PALETTEN
+// ============================================================================
+
+struct CRGBPalette16 {
+    CRGB entries[16];
+
+    CRGB& operator[](uint8_t index) { return entries[index]; }
+    const CRGB& operator[](uint8_t index) const { return entries[index]; }
+};
+
+struct CRGBPalette256 {
+    CRGB entries[256];
+
+    CRGBPalette256() {}
+    CRGBPalette256(const CRGBPalette16& palette) { *this = palette; }
+    CRGBPalette256& operator=(const CRGBPalette16& palette);
+
+    CRGB& operator[](uint8_t index) { return entries[index]; }
+    const CRGB& operator[](uint8_t index) const { return entries[index]; }
+};
+
+// ============================================================================
+// TREIBER
+// ============================================================================
+
+enum ESPIChipsets { WS2812B };
+enum EOrder { RGB, GRB };
+
+class CLEDController {
+public:
+    CLEDController() : data(nullptr), count(0) {}
+    CLEDController(CRGB* leds, int numLeds) : data(leds), count(numLeds) {}
+
+    CRGB* leds() { return data; }
+    int size() const { return count; }
+
+private:
+    CRGB* data;
+    int count;
+};
+
+#define FASTLED_MAX_CONTROLLERS 8
+
+class CFastLED {
+public:
+    CFastLED() : numControllers(0), brightness(255) {}
+
+    template <ESPIChipsets chipset, uint8_t pin, EOrder order>
+    CLEDController& addLeds(CRGB* leds, int numLeds) { return addController(leds, numLeds); }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+
+    void show();
+    void clear(bool writeData = false);
+
+    int count() const { return numControllers; }
+    CLEDController& operator[](int index) { return controllers[index]; }
+
+private:
+    CLEDController controllers[FASTLED_MAX_CONTROLLERS];
+    int numControllers;
+    uint8_t brightness;
+
+    CLEDController& addController(CRGB* leds, int numLeds);
+};
+
+extern CFastLED FastLED;
+
+#endif // HOST_FASTLED_H
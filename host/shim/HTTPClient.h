@@ -0,0 +1,58 @@
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// HTTPCLIENT-STAND-IN (Host)
+// ============================================================================
+//
+// Blockierend wie auf dem ESP32, aber ohne Netzwerk: jeder Request geht an
+// den Transport aus hostSetHttpTransport() (HostRuntime.h).
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTPCLIENT_DEFAULT_TCP_TIMEOUT  5000
+
+// Antwort-Body zum Lesen per getStream()
+class HTTPResponseStream {
+public:
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+
+private:
+    friend class HTTPClient;
+    const std::string* body = nullptr;
+    size_t position = 0;
+};
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    void end();
+    void addHeader(const String&, const String&) {}
+    void setTimeout(uint16_t ms) { timeoutMs = ms; }
+    void setConnectTimeout(int32_t) {}
+
+    int GET();
+    int POST(uint8_t* payload, size_t size);
+    int POST(const String& body);
+    int getSize() { return response.code > 0 ? (int)response.body.size() : -1; }
+    String getString() { return String(response.body); }
+    HTTPResponseStream& getStream();
+
+private:
+    int request(const char* method, const char* body, size_t length);
+
+    std::string host;
+    std::string path;
+    uint32_t timeoutMs = HTTPCLIENT_DEFAULT_TCP_TIMEOUT;
+    HostHttpResponse response = { HTTPC_ERROR_NOT_CONNECTED, std::string(), 0 };
+    HTTPResponseStream stream;
+};
+
+#endif // HOST_HTTP_CLIENT_H
@@ -0,0 +1,148 @@
+#include <Arduino.h>
+#include <stdarg.h>
+#include <chrono>
+#include <new>
+#include <random>
+
+// ============================================================================
+// ZEIT (virtuell: Warten = Task-Wechsel, siehe HostRtos.cpp)
+// ============================================================================
+
+static uint64_t virtualMicros = 0;
+static bool realTime = false;
+
+void hostUseRealTime() {
+    realTime = true;
+}
+
+bool hostRealTime() {
+    return realTime;
+}
+
+uint64_t hostMicros() {
+    if (!realTime) return virtualMicros;
+
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+void hostSetMicros(uint64_t us) {
+    virtualMicros = us;
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(hostMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)hostMicros();
+}
+
+void delay(unsigned long ms) {
+    hostAdvanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostAdvanceMicros(us);
+}
+
+// ============================================================================
+// ZUFALL (fester Seed → reproduzierbare Läufe)
+// ============================================================================
+
+static std::mt19937 randomEngine(1);
+
+long random(long max) {
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max) {
+    if (max <= min) return min;
+    return min + (long)(randomEngine() % (unsigned long)(max - min));
+}
+
+void randomSeed(unsigned long seed) {
+    randomEngine.seed(seed);
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+HardwareSerial Serial;
+static FILE* serialOut = stderr;
+
+void hostSetSerial(FILE* out) {
+    serialOut = out;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write((const uint8_t*)buffer, min((size_t)length, sizeof(buffer) - 1));
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t length) {
+    if (serialOut) fwrite(data, 1, length, serialOut);
+    return length;
+}
+
+void HardwareSerial::flush() {
+    if (serialOut) fflush(serialOut);
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    uint64_t ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    return (uint32_t)(ns * getCpuFreqMHz() / 1000);
+}
+
+// ============================================================================
+// HEAP (new/delete über malloc/free)
+// ============================================================================
+//
+// Wie beim ESP32: new landet in malloc. Die Firmware-Binaries linken mit
+// --wrap=malloc (Makefile), das greift aber nur in unseren Objekten – das
+// new aus der libstdc++.so ginge am Zähler (common/MemoryStats.h) vorbei.
+
+void* operator new(size_t size) {
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+// GCC hält free() hinter operator delete für falsch gepaart
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+#pragma GCC diagnostic pop
+
+void operator delete(void* memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    operator delete[](memory);
+}
@@ -0,0 +1,137 @@
+#include <FastLED.h>
+
+CFastLED FastLED;
+static uint32_t showCount = 0;
+
+uint32_t hostShowCount() {
+    return showCount;
+}
+
+// ============================================================================
+// FARBMATHEMATIK
+// ============================================================================
+
+// Stückweise lineare Sinus-Näherung (sin8_C)
+uint8_t sin8(uint8_t theta) {
+    static const uint8_t interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+    uint8_t offset = theta;
+    if (theta & 0x40) offset = 255 - offset;
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) secoffset++;
+
+    uint8_t section = offset >> 4;
+    uint8_t b = interleave[section * 2];
+    uint8_t m16 = interleave[section * 2 + 1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+
+    int8_t y = mx + b;
+    if (theta & 0x80) y = -y;
+    return y + 128;
+}
+
+// Regenbogen mit gleich breitem Gelb (Voreinstellung von CHSV → CRGB)
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset8 = (hue & 0x1F) << 3;
+    uint8_t third = scale8(offset8, 256 / 3);
+    uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+    uint8_t r, g, b;
+
+    switch (hue >> 5) {
+        case 0: r = 255 - third;     g = third;            b = 0;               break;  // R → O
+        case 1: r = 171;             g = 85 + third;       b = 0;               break;  // O → Y
+        case 2: r = 171 - twothirds; g = 170 + third;      b = 0;               break;  // Y → G
+        case 3: r = 0;               g = 255 - third;      b = third;           break;  // G → A
+        case 4: r = 0;               g = 171 - twothirds;  b = 85 + twothirds;  break;  // A → B
+        case 5: r = third;           g = 0;                b = 255 - third;     break;  // B → P
+        case 6: r = 85 + third;      g = 0;                b = 171 - third;     break;  // P → K
+        default: r = 170 + third;    g = 0;                b = 85 - third;      break;  // K → R
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = g = b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale) + desat;
+            g = scale8(g, satscale) + desat;
+            b = scale8(b, satscale) + desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        r = scale8(r, val);
+        g = scale8(g, val);
+        b = scale8(b, val);
+    }
+
+    rgb = CRGB(r, g, b);
+}
+
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    if (amountOfP2 == 0) return p1;
+    if (amountOfP2 == 255) return p2;
+    return CRGB(blend8(p1.r, p2.r, amountOfP2),
+                blend8(p1.g, p2.g, amountOfP2),
+                blend8(p1.b, p2.b, amountOfP2));
+}
+
+void fill_solid(CRGB* leds, int numLeds, const CRGB& color) {
+    for (int i = 0; i < numLeds; i++) leds[i] = color;
+}
+
+// ============================================================================
+// PALETTEN
+// ============================================================================
+
+// 16 → 256: jeder Eintrag linear zwischen zwei Stützstellen, 15 → 0 wickelt um
+CRGBPalette256& CRGBPalette256::operator=(const CRGBPalette16& palette) {
+    for (int i = 0; i < 256; i++) {
+        uint8_t hi4 = i >> 4;
+        uint8_t lo4 = i & 0x0F;
+        const CRGB& entry = palette[hi4];
+        const CRGB& next = palette[(hi4 + 1) & 0x0F];
+
+        if (lo4 == 0) {
+            entries[i] = entry;
+            continue;
+        }
+
+        uint8_t f2 = lo4 << 4;
+        uint8_t f1 = 255 - f2;
+        entries[i] = CRGB(scale8(entry.r, f1) + scale8(next.r, f2),
+                          scale8(entry.g, f1) + scale8(next.g, f2),
+                          scale8(entry.b, f1) + scale8(next.b, f2));
+    }
+    return *this;
+}
+
+// ============================================================================
+// TREIBER
+// ============================================================================
+
+CLEDController& CFastLED::addController(CRGB* leds, int numLeds) {
+    if (numControllers >= FASTLED_MAX_CONTROLLERS) return controllers[FASTLED_MAX_CONTROLLERS - 1];
+    controllers[numControllers] = CLEDController(leds, numLeds);
+    return controllers[numControllers++];
+}
+
+void CFastLED::show() {
+    showCount++;
+}
+
+void CFastLED::clear(bool writeData) {
+    for (int c = 0; c < numControllers; c++) {
+        fill_solid(controllers[c].leds(), controllers[c].size(), CRGB::Black);
+    }
+    if (writeData) show();
+}
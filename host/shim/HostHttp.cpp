@@ -0,0 +1,204 @@
+#include <HTTPClient.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "HostNet.h"
+
+// ============================================================================
+// TCP (Echtzeit)
+// ============================================================================
+
+// Wartet auf Lesbarkeit bzw. Schreibbarkeit (false = Timeout/Fehler)
+static bool waitFor(int fd, short events, uint32_t timeoutMs) {
+    pollfd entry = { fd, events, 0 };
+    return poll(&entry, 1, (int)timeoutMs) == 1 && !(entry.revents & (POLLERR | POLLNVAL));
+}
+
+static size_t contentLength(const std::string& head, bool& found) {
+    found = false;
+    size_t pos = 0;
+    while ((pos = head.find("\r\n", pos)) != std::string::npos) {
+        pos += 2;
+        if (strncasecmp(head.c_str() + pos, "Content-Length:", 15) == 0) {
+            found = true;
+            return strtoul(head.c_str() + pos + 15, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+bool hostReadHttp(int fd, std::string& head, std::string& body, uint32_t timeoutMs, bool untilClose) {
+    std::string data;
+    char buffer[4096];
+    size_t headEnd = std::string::npos;
+    size_t length = 0;
+    bool known = false;
+
+    while (true) {
+        if (headEnd != std::string::npos && known && data.size() >= headEnd + 4 + length) break;
+        if (headEnd != std::string::npos && !known && !untilClose) break;
+
+        if (!waitFor(fd, POLLIN, timeoutMs)) return false;
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (count <= 0) {
+            // Verbindung zu: ohne Content-Length ist das das Ende des Bodys
+            if (headEnd == std::string::npos || known) return false;
+            break;
+        }
+        data.append(buffer, count);
+
+        if (headEnd == std::string::npos) {
+            headEnd = data.find("\r\n\r\n");
+            if (headEnd != std::string::npos) length = contentLength(data.substr(0, headEnd + 2), known);
+        }
+    }
+
+    head = data.substr(0, headEnd + 2);
+    body = data.substr(headEnd + 4, known ? length : std::string::npos);
+    return true;
+}
+
+bool hostWriteAll(int fd, const std::string& data, uint32_t timeoutMs) {
+    size_t written = 0;
+    while (written < data.size()) {
+        if (!waitFor(fd, POLLOUT, timeoutMs)) return false;
+        ssize_t count = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (count < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (count <= 0) return false;
+        written += count;
+    }
+    return true;
+}
+
+static int connectTo(const std::string& host, uint32_t timeoutMs) {
+    std::string address = host;
+    uint16_t port = 80;
+    size_t colon = host.find(':');
+    if (colon != std::string::npos) {
+        address = host.substr(0, colon);
+        port = atoi(host.c_str() + colon + 1);
+    }
+
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &remote.sin_addr) != 1) return -1;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    int error = 0;
+    socklen_t errorLength = sizeof(error);
+    if (connect(fd, (sockaddr*)&remote, sizeof(remote)) < 0 &&
+        (errno != EINPROGRESS || !waitFor(fd, POLLOUT, timeoutMs) ||
+         getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) < 0 || error != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Echter Request, Fehlercodes wie HTTPClient auf dem ESP32
+static HostHttpResponse sendOverTcp(const HostHttpRequest& request) {
+    int fd = connectTo(request.host, HTTPCLIENT_DEFAULT_TCP_TIMEOUT);
+    if (fd < 0) return { HTTPC_ERROR_CONNECTION_REFUSED, std::string(), 0 };
+
+    std::string message = std::string(request.method) + " " + request.path + " HTTP/1.1\r\n" +
+                          "Host: " + request.host + "\r\n" +
+                          "Content-Type: application/json\r\n" +
+                          "Content-Length: " + std::to_string(request.body.size()) + "\r\n" +
+                          "Connection: close\r\n\r\n" + request.body;
+
+    HostHttpResponse response = { HTTPC_ERROR_SEND_PAYLOAD_FAILED, std::string(), 0 };
+    std::string head;
+    if (hostWriteAll(fd, message, request.timeoutMs)) {
+        if (hostReadHttp(fd, head, response.body, request.timeoutMs, true)) {
+            size_t space = head.find(' ');
+            response.code = space != std::string::npos ? atoi(head.c_str() + space + 1) : HTTPC_ERROR_CONNECTION_LOST;
+        } else {
+            response.code = HTTPC_ERROR_READ_TIMEOUT;
+        }
+    }
+    close(fd);
+    return response;
+}
+
+// ============================================================================
+// TRANSPORT
+// ============================================================================
+
+static HostHttpTransport transport;
+
+void hostSetHttpTransport(HostHttpTransport next) {
+    transport = next;
+}
+
+// ============================================================================
+// HTTPCLIENT
+// ============================================================================
+
+bool HTTPClient::begin(const String& url) {
+    // Nur "http://host[:port]/path" – mehr baut keine der Firmwares
+    std::string text = url.c_str();
+    size_t start = text.find("://");
+    start = start == std::string::npos ? 0 : start + 3;
+    size_t slash = text.find('/', start);
+
+    host = text.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+    path = slash == std::string::npos ? "/" : text.substr(slash);
+    response = { HTTPC_ERROR_NOT_CONNECTED, std::string(), 0 };
+    return !host.empty();
+}
+
+void HTTPClient::end() {
+    host.clear();
+    path.clear();
+}
+
+int HTTPClient::GET() {
+    return request("GET", "", 0);
+}
+
+int HTTPClient::POST(uint8_t* payload, size_t size) {
+    return request("POST", (const char*)payload, size);
+}
+
+int HTTPClient::POST(const String& body) {
+    return request("POST", body.c_str(), body.length());
+}
+
+int HTTPClient::request(const char* method, const char* body, size_t length) {
+    if (host.empty()) return HTTPC_ERROR_NOT_CONNECTED;
+
+    HostHttpRequest request = { method, host, path, std::string(body, length), timeoutMs };
+    if (transport) {
+        response = transport(request);
+    } else if (hostRealTime()) {
+        response = sendOverTcp(request);
+    } else {
+        response = { HTTPC_ERROR_CONNECTION_REFUSED, std::string(), 0 };
+    }
+
+    // Blockierender Client: der Task wartet die Antwort ab (Echtzeit: schon geschehen)
+    if (response.durationUs && !hostRealTime()) hostAdvanceMicros(response.durationUs);
+    return response.code;
+}
+
+HTTPResponseStream& HTTPClient::getStream() {
+    stream.body = &response.body;
+    stream.position = 0;
+    return stream;
+}
+
+size_t HTTPResponseStream::readBytes(uint8_t* buffer, size_t length) {
+    if (!body || position >= body->size()) return 0;
+    size_t count = min(length, body->size() - position);
+    memcpy(buffer, body->data() + position, count);
+    position += count;
+    return count;
+}
@@ -0,0 +1,370 @@
+#include <ArduinoJson.h>
+
+// ============================================================================
+// BAUM
+// ============================================================================
+
+void JsonNode::reset(Type next) {
+    type = next;
+    boolean = false;
+    integer = 0;
+    real = 0;
+    text.clear();
+    keys.clear();
+    items.clear();
+}
+
+JsonNode* JsonNode::child(const char* key, bool create) {
+    if (type == NUL && create) {
+        reset(OBJECT);
+        implicit = implicit || parent != nullptr;
+    }
+    if (type != OBJECT || !key) return nullptr;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) return items[i].get();
+    }
+    if (!create) return nullptr;
+
+    // Unsichtbar bis zur ersten Zuweisung (Lesen legt bei ArduinoJson nichts an)
+    JsonNode* node = new JsonNode();
+    node->implicit = true;
+    node->parent = this;
+    keys.push_back(key);
+    items.emplace_back(node);
+    return node;
+}
+
+JsonNode* JsonNode::append() {
+    JsonNode* node = new JsonNode();
+    node->parent = this;
+    items.emplace_back(node);
+    node->materialize();
+    return node;
+}
+
+void JsonNode::materialize() {
+    for (JsonNode* node = this; node && node->implicit; node = node->parent) node->implicit = false;
+}
+
+size_t JsonNode::visibleSize() const {
+    size_t count = 0;
+    for (const auto& item : items) {
+        if (!item->implicit) count++;
+    }
+    return count;
+}
+
+// ============================================================================
+// VARIANT
+// ============================================================================
+
+JsonVariant JsonVariant::at(size_t index) const {
+    if (!node || node->type != JsonNode::ARRAY || index >= node->items.size()) return JsonVariant();
+    return JsonVariant(node->items[index].get());
+}
+
+bool JsonVariant::asContainer(JsonNode::Type type) const {
+    if (!node) return false;
+    if (node->type == JsonNode::NUL) node->reset(type);
+    return node->type == type;
+}
+
+bool JsonVariant::containsKey(const char* key) const {
+    JsonNode* child = node ? node->child(key, false) : nullptr;
+    return child && !child->implicit;
+}
+
+JsonObject JsonVariant::createNestedObject() const {
+    if (!asContainer(JsonNode::ARRAY)) return JsonObject();
+    JsonNode* item = node->append();
+    item->reset(JsonNode::OBJECT);
+    return JsonObject(JsonVariant(item));
+}
+
+JsonObject JsonVariant::createNestedObject(const char* key) const {
+    if (!asContainer(JsonNode::OBJECT)) return JsonObject();
+    JsonNode* item = node->child(key, true);
+    item->reset(JsonNode::OBJECT);
+    item->materialize();
+    return JsonObject(JsonVariant(item));
+}
+
+JsonArray JsonVariant::createNestedArray() const {
+    if (!asContainer(JsonNode::ARRAY)) return JsonArray();
+    JsonNode* item = node->append();
+    item->reset(JsonNode::ARRAY);
+    return JsonArray(JsonVariant(item));
+}
+
+JsonArray JsonVariant::createNestedArray(const char* key) const {
+    if (!asContainer(JsonNode::OBJECT)) return JsonArray();
+    JsonNode* item = node->child(key, true);
+    item->reset(JsonNode::ARRAY);
+    item->materialize();
+    return JsonArray(JsonVariant(item));
+}
+
+void JsonVariant::remove(const char* key) const {
+    if (!node || node->type != JsonNode::OBJECT) return;
+    for (size_t i = 0; i < node->keys.size(); i++) {
+        if (node->keys[i] == key) {
+            node->keys.erase(node->keys.begin() + i);
+            node->items.erase(node->items.begin() + i);
+            return;
+        }
+    }
+}
+
+void JsonVariant::setText(const char* text) {
+    if (!node) return;
+    node->reset(text ? JsonNode::TEXT : JsonNode::NUL);
+    if (text) node->text = text;
+    node->materialize();
+}
+
+void JsonVariant::setInteger(int64_t value) {
+    if (!node) return;
+    node->reset(JsonNode::INTEGER);
+    node->integer = value;
+    node->materialize();
+}
+
+void JsonVariant::setReal(double value) {
+    if (!node) return;
+    node->reset(JsonNode::REAL);
+    node->real = value;
+    node->materialize();
+}
+
+void JsonVariant::setBool(bool value) {
+    if (!node) return;
+    node->reset(JsonNode::BOOLEAN);
+    node->boolean = value;
+    node->materialize();
+}
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+namespace {
+
+struct Parser {
+    const char* pos;
+    const char* end;
+    int depth;
+
+    void skipSpace() {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) pos++;
+    }
+
+    bool literal(const char* word) {
+        size_t length = strlen(word);
+        if ((size_t)(end - pos) < length || strncmp(pos, word, length) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        if (pos >= end || *pos != '"') return false;
+        pos++;
+        while (pos < end && *pos != '"') {
+            char c = *pos++;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= end) return false;
+            char escaped = *pos++;
+            switch (escaped) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (end - pos < 4) return false;
+                    unsigned code = strtoul(std::string(pos, 4).c_str(), nullptr, 16);
+                    pos += 4;
+                    // UTF-8 (ohne Surrogate-Paare, reicht für IDs und Namen)
+                    if (code < 0x80) {
+                        out += (char)code;
+                    } else if (code < 0x800) {
+                        out += (char)(0xC0 | (code >> 6));
+                        out += (char)(0x80 | (code & 0x3F));
+                    } else {
+                        out += (char)(0xE0 | (code >> 12));
+                        out += (char)(0x80 | ((code >> 6) & 0x3F));
+                        out += (char)(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: out += escaped; break;
+            }
+        }
+        if (pos >= end) return false;
+        pos++;
+        return true;
+    }
+
+    bool value(JsonNode& node) {
+        skipSpace();
+        if (pos >= end || ++depth > 32) return false;
+
+        bool ok = true;
+        if (*pos == '{') {
+            pos++;
+            node.reset(JsonNode::OBJECT);
+            skipSpace();
+            if (pos < end && *pos == '}') {
+                pos++;
+            } else {
+                while (ok) {
+                    skipSpace();
+                    std::string key;
+                    if (!string(key)) return false;
+                    skipSpace();
+                    if (pos >= end || *pos++ != ':') return false;
+                    JsonNode* child = new JsonNode();
+                    child->parent = &node;
+                    node.keys.push_back(key);
+                    node.items.emplace_back(child);
+                    ok = value(*child);
+                    skipSpace();
+                    if (pos < end && *pos == ',') { pos++; continue; }
+                    if (pos < end && *pos == '}') { pos++; break; }
+                    return false;
+                }
+            }
+        } else if (*pos == '[') {
+            pos++;
+            node.reset(JsonNode::ARRAY);
+            skipSpace();
+            if (pos < end && *pos == ']') {
+                pos++;
+            } else {
+                while (ok) {
+                    JsonNode* child = new JsonNode();
+                    child->parent = &node;
+                    node.items.emplace_back(child);
+                    ok = value(*child);
+                    skipSpace();
+                    if (pos < end && *pos == ',') { pos++; continue; }
+                    if (pos < end && *pos == ']') { pos++; break; }
+                    return false;
+                }
+            }
+        } else if (*pos == '"') {
+            node.reset(JsonNode::TEXT);
+            ok = string(node.text);
+        } else if (literal("true") || literal("false")) {
+            node.reset(JsonNode::BOOLEAN);
+            node.boolean = pos[-1] == 'e' && pos[-2] == 'u';
+        } else if (literal("null")) {
+            node.reset(JsonNode::NUL);
+        } else {
+            char* numberEnd;
+            std::string number(pos, std::min<size_t>(end - pos, 64));
+            double real = strtod(number.c_str(), &numberEnd);
+            size_t length = numberEnd - number.c_str();
+            if (length == 0) return false;
+            bool integral = number.find_first_of(".eE") >= length;
+            node.reset(integral ? JsonNode::INTEGER : JsonNode::REAL);
+            if (integral) node.integer = strtoll(number.c_str(), nullptr, 10);
+            else node.real = real;
+            pos += length;
+        }
+        depth--;
+        return ok;
+    }
+};
+
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+    JsonNode* root = doc.raw();
+    root->reset(JsonNode::NUL);
+    if (!input || length == 0) return DeserializationError::EmptyInput;
+
+    Parser parser = { input, input + length, 0 };
+    if (!parser.value(*root)) {
+        root->reset(JsonNode::NUL);
+        return parser.pos >= parser.end ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+    }
+    return DeserializationError::Ok;
+}
+
+const char* DeserializationError::c_str() const {
+    static const char* names[] = { "Ok", "EmptyInput", "IncompleteInput", "InvalidInput" };
+    return names[code];
+}
+
+// ============================================================================
+// SERIALISIERUNG
+// ============================================================================
+
+static void writeString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+static void writeNode(std::string& out, const JsonNode* node) {
+    if (!node) {
+        out += "null";
+        return;
+    }
+    switch (node->type) {
+        case JsonNode::NUL: out += "null"; break;
+        case JsonNode::BOOLEAN: out += node->boolean ? "true" : "false"; break;
+        case JsonNode::INTEGER: out += std::to_string(node->integer); break;
+        case JsonNode::REAL: {
+            char number[32];
+            snprintf(number, sizeof(number), "%.9g", node->real);
+            out += number;
+            break;
+        }
+        case JsonNode::TEXT: writeString(out, node->text); break;
+        case JsonNode::ARRAY:
+        case JsonNode::OBJECT: {
+            bool object = node->type == JsonNode::OBJECT;
+            bool first = true;
+            out += object ? '{' : '[';
+            for (size_t i = 0; i < node->items.size(); i++) {
+                if (node->items[i]->implicit) continue;
+                if (!first) out += ',';
+                first = false;
+                if (object) {
+                    writeString(out, node->keys[i]);
+                    out += ':';
+                }
+                writeNode(out, node->items[i].get());
+            }
+            out += object ? '}' : ']';
+            break;
+        }
+    }
+}
+
+std::string serializeJsonText(const JsonVariant& value) {
+    std::string out;
+    writeNode(out, value.raw());
+    return out;
+}
@@ -0,0 +1,18 @@
+#ifndef HOST_NET_H
+#define HOST_NET_H
+
+#include <stdint.h>
+#include <string>
+
+// ============================================================================
+// TCP-HILFEN (nur Echtzeit, intern für HTTPClient und AsyncWebServer)
+// ============================================================================
+
+// Eine HTTP-Nachricht lesen: Kopf bis zur Leerzeile, Body nach
+// Content-Length (ohne: bis die Gegenseite schließt, falls untilClose)
+bool hostReadHttp(int fd, std::string& head, std::string& body, uint32_t timeoutMs, bool untilClose);
+
+// Alles schreiben (false = Verbindung weg oder Timeout)
+bool hostWriteAll(int fd, const std::string& data, uint32_t timeoutMs);
+
+#endif // HOST_NET_H
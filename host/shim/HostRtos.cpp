@@ -0,0 +1,300 @@
+#include <Arduino.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// SCHEDULER (kooperativ, virtuelle Zeit)
+// ============================================================================
+//
+// Jeder Task ist ein eigener Thread, es läuft aber immer nur einer. Ein Task
+// gibt die CPU nur an Wartestellen ab (delay, vTaskDelay, Queue, Mutex,
+// HTTPClient); dran ist dann der Task mit der frühesten Weckzeit, die Uhr
+// springt auf diese Weckzeit. Rechenzeit kostet also keine virtuelle Zeit,
+// Wartezeiten laufen wie auf zwei Kernen parallel.
+//
+// In Echtzeit (hostUseRealTime()) laufen die Threads frei, gewartet wird
+// mit Condition-Variables und echtem Schlaf.
+
+#define WAIT_FOREVER UINT64_MAX
+
+struct HostTask {
+    const char* name;
+    uint64_t wakeAt;            // Virtuelle µs, WAIT_FOREVER = wartet auf Queue/Mutex
+    uint64_t order;             // Reihenfolge bei gleicher Weckzeit (FIFO)
+    std::condition_variable turn;
+};
+
+// Nie freigegeben: blockierte Task-Threads überleben das Ende von main()
+static std::mutex& schedulerLock = *new std::mutex();
+static std::vector<HostTask*>& tasks = *new std::vector<HostTask*>();
+static HostTask* running = nullptr;
+static uint64_t nextOrder = 0;
+static thread_local HostTask* self = nullptr;
+static thread_local bool adopting = false;      // new HostTask läuft (malloc-Hook)
+static thread_local bool scheduled = false;
+
+// Gibt den adoptierten Task mit dem Thread frei (z.B. Clients eines Benchmarks,
+// die nur über den malloc-Hook hier landen). Steht er in tasks, bleibt er –
+// der Scheduler kennt ihn noch. Danach adoptiert der Thread nicht mehr
+struct AdoptedTask {
+    HostTask* task = nullptr;
+    ~AdoptedTask() {
+        if (!task || self != task || (scheduled && !hostRealTime())) return;
+        adopting = true;
+        self = nullptr;
+        delete task;
+    }
+};
+static thread_local AdoptedTask adopted;
+
+// Threads ohne xTaskCreate (Haupt-Thread, Webserver) bekommen ihren Task
+// beim ersten Bedarf – ohne Lock, damit es auch aus dem malloc-Hook geht
+static void adoptThread() {
+    adopting = true;
+    HostTask* task = new HostTask();
+    task->name = "loop";
+    adopted.task = task;
+    adopting = false;
+    self = task;
+}
+
+// Unter schedulerLock. Der erste Aufrufer ist der Haupt-Thread (Arduino-Loop-Task)
+static HostTask* currentTask() {
+    if (!self) adoptThread();
+    if (!scheduled) {
+        scheduled = true;
+        self->wakeAt = hostMicros();
+        self->order = nextOrder++;
+        if (!hostRealTime()) {
+            running = self;
+            tasks.push_back(self);
+        }
+    }
+    return self;
+}
+
+static void wake(HostTask* task) {
+    if (task->wakeAt <= hostMicros()) return;
+    task->wakeAt = hostMicros();
+    task->order = nextOrder++;
+}
+
+// Früheste Weckzeit bekommt die CPU (bei Gleichstand der älteste Eintrag)
+static void schedule(std::unique_lock<std::mutex>& lock, HostTask* task) {
+    HostTask* next = nullptr;
+    for (HostTask* candidate : tasks) {
+        if (!next || candidate->wakeAt < next->wakeAt ||
+            (candidate->wakeAt == next->wakeAt && candidate->order < next->order)) {
+            next = candidate;
+        }
+    }
+    if (!next || next->wakeAt == WAIT_FOREVER) {
+        fprintf(stderr, "host: alle Tasks blockiert (Deadlock)\n");
+        abort();
+    }
+
+    if (next->wakeAt > hostMicros()) hostSetMicros(next->wakeAt);
+    running = next;
+    if (next == task) return;
+
+    next->turn.notify_one();
+    if (task) task->turn.wait(lock, [task] { return running == task; });
+}
+
+static void yieldUntil(std::unique_lock<std::mutex>& lock, HostTask* task, uint64_t wakeAt) {
+    task->wakeAt = wakeAt;
+    task->order = nextOrder++;
+    schedule(lock, task);
+}
+
+void hostAdvanceMicros(uint64_t us) {
+    if (hostRealTime()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+        return;
+    }
+    std::unique_lock<std::mutex> lock(schedulerLock);
+    HostTask* task = currentTask();
+    yieldUntil(lock, task, hostMicros() + us);
+}
+
+// Tasks, die auf eine Queue oder einen Mutex warten
+struct WaitList {
+    std::vector<HostTask*> waiting;         // Virtuell
+    std::condition_variable changed;        // Echtzeit
+
+    void notify() {
+        if (hostRealTime()) changed.notify_all();
+        else if (!waiting.empty()) wake(waiting.front());
+    }
+
+    // Wartet unter schedulerLock, bis ready() gilt (false = Wartezeit um)
+    template <typename Ready>
+    bool wait(std::unique_lock<std::mutex>& lock, TickType_t ticks, Ready ready) {
+        if (ready()) return true;
+        if (ticks == 0) return false;
+
+        if (hostRealTime()) {
+            if (ticks == portMAX_DELAY) {
+                changed.wait(lock, ready);
+                return true;
+            }
+            return changed.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+        }
+
+        HostTask* task = currentTask();
+        uint64_t deadline = ticks == portMAX_DELAY ? WAIT_FOREVER : hostMicros() + (uint64_t)ticks * 1000;
+        while (!ready()) {
+            if (hostMicros() >= deadline) return false;
+            waiting.push_back(task);
+            yieldUntil(lock, task, deadline);
+            waiting.erase(std::find(waiting.begin(), waiting.end(), task));
+        }
+        return true;
+    }
+};
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+static void runTask(HostTask* task, TaskFunction_t function, void* parameter) {
+    self = task;
+    scheduled = true;
+    if (!hostRealTime()) {
+        std::unique_lock<std::mutex> lock(schedulerLock);
+        task->turn.wait(lock, [task] { return running == task; });
+    }
+
+    function(parameter);
+    if (hostRealTime()) return;
+
+    // Auf dem ESP32 kehren Tasks nie zurück – hier Task austragen und weiter
+    std::unique_lock<std::mutex> lock(schedulerLock);
+    tasks.erase(std::find(tasks.begin(), tasks.end(), task));
+    schedule(lock, nullptr);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t, void* parameter,
+                                   UBaseType_t, TaskHandle_t* handle, int) {
+    std::unique_lock<std::mutex> lock(schedulerLock);
+    currentTask();
+
+    // Virtuell: läuft los, sobald der aufrufende Task wartet
+    HostTask* task = new HostTask();
+    task->name = name;
+    task->wakeAt = hostMicros();
+    task->order = nextOrder++;
+    if (!hostRealTime()) tasks.push_back(task);
+    std::thread(runTask, task, function, parameter).detach();
+
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(task, name, stackDepth, parameter, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    hostAdvanceMicros((uint64_t)ticks * 1000);
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+// Ohne Lock: auch aus dem malloc-Hook (common/MemoryStats.h), der unter
+// schedulerLock laufen kann. Während adoptThread() selbst: nullptr
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!self && !adopting) adoptThread();
+    return self;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+    return 0;
+}
+
+// ============================================================================
+// QUEUES (Elemente werden kopiert wie bei FreeRTOS)
+// ============================================================================
+
+struct HostQueue {
+    std::deque<std::vector<uint8_t>> items;
+    WaitList receivers;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+// Volle Queue: sofort pdFALSE (beide Firmwares senden ohne Wartezeit)
+BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(schedulerLock);
+    if (queue->items.size() >= queue->length) return pdFALSE;
+
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->receivers.notify();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t wait) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::unique_lock<std::mutex> lock(schedulerLock);
+    if (!queue->receivers.wait(lock, wait, [queue] { return !queue->items.empty(); })) return pdFALSE;
+
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(schedulerLock);
+    return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(schedulerLock);
+    return queue->length - queue->items.size();
+}
+
+// ============================================================================
+// MUTEX
+// ============================================================================
+
+struct HostMutex {
+    bool locked = false;
+    WaitList waiters;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostMutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t wait) {
+    HostMutex* mutex = (HostMutex*)handle;
+    std::unique_lock<std::mutex> lock(schedulerLock);
+    if (!mutex->waiters.wait(lock, wait, [mutex] { return !mutex->locked; })) return pdFALSE;
+
+    mutex->locked = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle) {
+    HostMutex* mutex = (HostMutex*)handle;
+    std::lock_guard<std::mutex> guard(schedulerLock);
+    mutex->locked = false;
+    mutex->waiters.notify();
+    return pdTRUE;
+}
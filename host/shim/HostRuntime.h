@@ -0,0 +1,69 @@
+#ifndef HOST_RUNTIME_H
+#define HOST_RUNTIME_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+
+// ============================================================================
+// HOST-LAUFZEIT (Steuerung der Stand-ins für Simulator und Benchmarks)
+// ============================================================================
+//
+// Die Firmware läuft auf dem Host in virtueller Zeit: millis()/micros()
+// bewegen sich nur, wenn ein Task wartet (hostAdvanceMicros(), delay(),
+// Queue, HTTPClient – siehe HostRtos.cpp). Damit ist jeder Lauf
+// deterministisch und unabhängig von der Rechenzeit des Hosts.
+// ESP.getCycleCount() zählt dagegen echte Zeit (Takte bei 240 MHz) – die
+// Frame-Telemetrie misst auf dem Host also die tatsächliche Render-Zeit.
+
+// Virtuelle Uhr (µs seit Start). hostAdvanceMicros() legt den aufrufenden
+// Task schlafen, währenddessen laufen die anderen Tasks.
+uint64_t hostMicros();
+void hostAdvanceMicros(uint64_t us);
+void hostSetMicros(uint64_t us);
+
+// Echtzeit statt virtueller Zeit (Commander an echten Sockets, Lasttest).
+// Vor allen anderen Aufrufen: millis()/micros() folgen der Host-Uhr, Tasks
+// laufen als freie Threads, delay() schläft wirklich, HTTPClient und
+// AsyncWebServer benutzen echte TCP-Verbindungen.
+void hostUseRealTime();
+bool hostRealTime();
+
+// Port für AsyncWebServer::begin() (0 = Port aus der Firmware)
+void hostSetWebServerPort(uint16_t port);
+
+// Ausgabe von Serial (nullptr = verwerfen, Voreinstellung stderr)
+void hostSetSerial(FILE* out);
+
+// FastLED.show()-Aufrufe seit Start
+uint32_t hostShowCount();
+
+// ============================================================================
+// HTTP-TRANSPORT (HTTPClient → Simulation)
+// ============================================================================
+//
+// Jeder Request von HTTPClient geht an den eingestellten Transport. Der
+// sendende Task wartet danach durationUs virtuelle Zeit, wie beim
+// blockierenden HTTPClient auf dem ESP32. Ohne Transport: echte
+// TCP-Verbindung in Echtzeit, sonst Verbindungsfehler.
+
+struct HostHttpRequest {
+    const char* method;     // "GET" / "POST"
+    std::string host;       // Aus der URL, z.B. "10.0.0.3"
+    std::string path;       // "/effect"
+    std::string body;
+    uint32_t timeoutMs;     // HTTPClient::setTimeout()
+};
+
+struct HostHttpResponse {
+    int code;               // HTTP-Status oder HTTPC_ERROR_* (negativ)
+    std::string body;
+    uint64_t durationUs;    // Vom Senden bis zur Antwort bzw. zum Timeout
+};
+
+typedef std::function<HostHttpResponse(const HostHttpRequest&)> HostHttpTransport;
+
+void hostSetHttpTransport(HostHttpTransport transport);
+
+#endif // HOST_RUNTIME_H
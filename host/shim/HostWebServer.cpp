@@ -0,0 +1,186 @@
+#include <ESPAsyncWebServer.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+#include "HostNet.h"
+
+#define SERVER_TIMEOUT_MS     5000    // Lesen/Schreiben einer Verbindung
+#define SERVER_BACKLOG        64
+
+static uint16_t webServerPort = 0;
+
+void hostSetWebServerPort(uint16_t port) {
+    webServerPort = port;
+}
+
+// ============================================================================
+// REQUEST
+// ============================================================================
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    free(_tempObject);      // Wie ESPAsyncWebServer: Body-Puffer gehört dem Request
+    delete response;
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool) const {
+    return getParam(name) != nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool) const {
+    for (const AsyncWebParameter& param : params) {
+        if (param.name() == name) return const_cast<AsyncWebParameter*>(&param);
+    }
+    return nullptr;
+}
+
+void AsyncWebServerRequest::send(int code, const String& type, const String& content) {
+    AsyncWebServerResponse* next = new AsyncWebServerResponse(code, type);
+    next->content = content.c_str();
+    send(next);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* next) {
+    delete response;
+    response = next;
+}
+
+// ============================================================================
+// SERVER (nur Echtzeit)
+// ============================================================================
+
+AsyncWebServer::~AsyncWebServer() {
+    for (AsyncCallbackWebHandler* handler : handlers) delete handler;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* path, WebRequestMethod method,
+                                            ArRequestHandlerFunction onRequest,
+                                            ArUploadHandlerFunction, ArBodyHandlerFunction onBody) {
+    AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler();
+    handler->path = path;
+    handler->method = method;
+    handler->onRequest = onRequest;
+    handler->onBody = onBody;
+    handlers.push_back(handler);
+    return *handler;
+}
+
+void AsyncWebServer::begin() {
+    if (!hostRealTime()) return;
+
+    uint16_t listenPort = webServerPort ? webServerPort : port;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = htons(listenPort);
+    if (bind(listener, (sockaddr*)&local, sizeof(local)) < 0 || listen(listener, SERVER_BACKLOG) < 0) {
+        fprintf(stderr, "host: Webserver-Port %u: %s\n", listenPort, strerror(errno));
+        close(listener);
+        return;
+    }
+
+    std::thread([this, listener] { serve(listener); }).detach();
+}
+
+// Ein Thread, eine Verbindung nach der anderen (wie der AsyncTCP-Task)
+void AsyncWebServer::serve(int listener) {
+    while (true) {
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) continue;
+        handle(connection);
+        close(connection);
+    }
+}
+
+static String decodeUrl(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '%' && i + 2 < text.size()) {
+            out += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += text[i] == '+' ? ' ' : text[i];
+        }
+    }
+    return String(out);
+}
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 503: return "Service Unavailable";
+        default:  return code < 400 ? "OK" : "Error";
+    }
+}
+
+void AsyncWebServer::handle(int connection) {
+    std::string head, body;
+    if (!hostReadHttp(connection, head, body, SERVER_TIMEOUT_MS, false)) return;
+
+    // "METHOD /pfad?query HTTP/1.1"
+    size_t methodEnd = head.find(' ');
+    size_t targetEnd = head.find(' ', methodEnd + 1);
+    if (methodEnd == std::string::npos || targetEnd == std::string::npos) return;
+    std::string methodName = head.substr(0, methodEnd);
+    std::string target = head.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+    AsyncWebServerRequest request;
+    request.bodyLength = body.size();
+    request.requestMethod = methodName == "POST" ? HTTP_POST : methodName == "PUT" ? HTTP_PUT :
+                            methodName == "DELETE" ? HTTP_DELETE : HTTP_GET;
+    size_t query = target.find('?');
+    request.requestUrl = decodeUrl(target.substr(0, query));
+    if (query != std::string::npos) {
+        std::string rest = target.substr(query + 1);
+        size_t start = 0;
+        while (start <= rest.size()) {
+            size_t end = rest.find('&', start);
+            std::string pair = rest.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            size_t equals = pair.find('=');
+            if (!pair.empty()) {
+                request.params.emplace_back(decodeUrl(pair.substr(0, equals)),
+                                            equals == std::string::npos ? String() : decodeUrl(pair.substr(equals + 1)));
+            }
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+    }
+
+    AsyncCallbackWebHandler* match = nullptr;
+    for (AsyncCallbackWebHandler* handler : handlers) {
+        if ((handler->method & request.requestMethod) && handler->path == request.requestUrl) {
+            match = handler;
+            break;
+        }
+    }
+
+    if (match) {
+        if (match->onBody && !body.empty()) {
+            match->onBody(&request, (uint8_t*)&body[0], body.size(), 0, body.size());
+        }
+        match->onRequest(&request);
+    } else if (notFound) {
+        notFound(&request);
+    } else {
+        request.send(404, "text/plain", "Not found");
+    }
+
+    AsyncWebServerResponse* response = request.response;
+    if (!response) return;      // Handler hat nicht geantwortet → Verbindung zu
+
+    std::string message = "HTTP/1.1 " + std::to_string(response->code) + " " + statusText(response->code) + "\r\n" +
+                          "Content-Type: " + response->contentType.c_str() + "\r\n" +
+                          "Content-Length: " + std::to_string(response->content.size()) + "\r\n" +
+                          "Connection: close\r\n\r\n" + response->content;
+    hostWriteAll(connection, message, SERVER_TIMEOUT_MS);
+}
@@ -0,0 +1,119 @@
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+// ============================================================================
+// IP-ADRESSE
+// ============================================================================
+
+bool IPAddress::fromString(const char* text) {
+    in_addr parsed;
+    if (!text || inet_pton(AF_INET, text, &parsed) != 1) return false;
+    address = parsed.s_addr;
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u",
+             (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buffer);
+}
+
+// ============================================================================
+// UDP
+// ============================================================================
+
+bool WiFiUDP::open() {
+    if (fd >= 0) return true;
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    if (!open()) return 0;
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&local, sizeof(local)) < 0) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    packet.clear();
+    readPos = 0;
+}
+
+int WiFiUDP::parsePacket() {
+    packet.clear();
+    readPos = 0;
+    if (fd < 0) return 0;
+
+    uint8_t buffer[1500];
+    sockaddr_in from = {};
+    socklen_t fromLength = sizeof(from);
+    ssize_t length = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromLength);
+    if (length <= 0) return 0;
+
+    packet.assign(buffer, buffer + length);
+    remoteAddress = from.sin_addr.s_addr;
+    remotePortNumber = ntohs(from.sin_port);
+    return length;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t length) {
+    size_t count = std::min(length, packet.size() - readPos);
+    memcpy(buffer, packet.data() + readPos, count);
+    readPos += count;
+    return count;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    outgoing.clear();
+    sendAddress = ip;
+    sendPort = port;
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) {
+        hostent* entry = gethostbyname(host);
+        if (!entry || entry->h_addrtype != AF_INET) return 0;
+        ip = IPAddress(*(uint32_t*)entry->h_addr_list[0]);
+    }
+    return beginPacket(ip, port);
+}
+
+size_t WiFiUDP::write(const uint8_t* data, size_t length) {
+    outgoing.insert(outgoing.end(), data, data + length);
+    return length;
+}
+
+int WiFiUDP::endPacket() {
+    if (!open()) return 0;
+
+    sockaddr_in to = {};
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = sendAddress;
+    to.sin_port = htons(sendPort);
+    ssize_t sent = sendto(fd, outgoing.data(), outgoing.size(), 0, (sockaddr*)&to, sizeof(to));
+    outgoing.clear();
+    return sent >= 0 ? 1 : 0;
+}
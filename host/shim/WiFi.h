@@ -0,0 +1,58 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// WIFI-STAND-IN (Host)
+// ============================================================================
+//
+// Immer verbunden, Adresse 127.0.0.1.
+
+class IPAddress {
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint32_t address) : address(address) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) :
+        address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int index) const { return address >> (index * 8); }
+
+    bool fromString(const char* text);
+    bool fromString(const String& text) { return fromString(text.c_str()); }
+    String toString() const;
+
+private:
+    uint32_t address;       // Erstes Oktett im niedrigsten Byte (wie lwIP)
+};
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+    void mode(wifi_mode_t) {}
+    void setSleep(bool) {}
+    void begin(const char*, const char*) {}
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    bool softAP(const char*, const char* = nullptr) { return true; }
+    IPAddress softAPIP() { return IPAddress(127, 0, 0, 1); }
+    int8_t RSSI() { return -50; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
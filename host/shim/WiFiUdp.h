@@ -0,0 +1,50 @@
+#ifndef HOST_WIFI_UDP_H
+#define HOST_WIFI_UDP_H
+
+#include <WiFi.h>
+#include <vector>
+
+// ============================================================================
+// UDP-STAND-IN (Host, echte Sockets)
+// ============================================================================
+//
+// begin() bindet auf 127.0.0.1 – belegter Port → 0, der Socket bleibt zu
+// und parsePacket() liefert nie etwas. Gesendet wird ohne Puffergrenze.
+
+class WiFiUDP {
+public:
+    WiFiUDP() : fd(-1), readPos(0), remoteAddress(0), remotePortNumber(0), sendAddress(0), sendPort(0) {}
+    ~WiFiUDP() { stop(); }
+
+    uint8_t begin(uint16_t port);
+    void stop();
+
+    // Empfang: nicht blockierend
+    int parsePacket();
+    int available() { return packet.size() - readPos; }
+    int read(uint8_t* buffer, size_t length);
+    IPAddress remoteIP() { return IPAddress(remoteAddress); }
+    uint16_t remotePort() { return remotePortNumber; }
+
+    // Senden
+    int beginPacket(IPAddress ip, uint16_t port);
+    int beginPacket(const char* host, uint16_t port);
+    size_t write(const uint8_t* data, size_t length);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    int endPacket();
+
+private:
+    int fd;
+    std::vector<uint8_t> packet;
+    size_t readPos;
+    uint32_t remoteAddress;
+    uint16_t remotePortNumber;
+
+    std::vector<uint8_t> outgoing;
+    uint32_t sendAddress;
+    uint16_t sendPort;
+
+    bool open();
+};
+
+#endif // HOST_WIFI_UDP_H
@@ -0,0 +1,62 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <atomic>
+
+// ============================================================================
+// FREERTOS-STAND-IN (Host)
+// ============================================================================
+//
+// Tasks laufen als Threads, aber kooperativ in virtueller Zeit: immer nur
+// einer, Wechsel nur an Wartestellen (vTaskDelay, Queue mit Wartezeit,
+// Mutex, delay). Der Haupt-Thread ist der Loop-Task. Details in HostRtos.cpp.
+
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdTRUE                1
+#define pdFALSE               0
+#define pdPASS                1
+#define pdFAIL                0
+#define portMAX_DELAY         0xFFFFFFFF
+#define pdMS_TO_TICKS(ms)     ((TickType_t)(ms))
+#define tskNO_AFFINITY        -1
+
+// Spinlock wie auf dem ESP32 (kritischer Abschnitt zwischen Tasks)
+struct portMUX_TYPE {
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    portMUX_TYPE() {}
+    portMUX_TYPE(int) {}
+};
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) do { while ((mux)->flag.test_and_set(std::memory_order_acquire)) {} } while (0)
+#define portEXIT_CRITICAL(mux)  (mux)->flag.clear(std::memory_order_release)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle, int core);
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,200 @@
+#!/bin/sh
+# ============================================================================
+# REGRESSIONSTESTS (Host-Build, "make test")
+# ============================================================================
+#
+#   tests/run.sh                 alle Tests gegen build/
+#   tests/run.sh --update        erwartete Ausgaben neu schreiben (nach einer
+#                                gewollten Änderung, Diff danach ansehen!)
+#   BUILD=build-asan tests/run.sh
+#
+# Zwei Arten von Tests:
+#   check NAME KOMMANDO…    muss mit Exit-Code 0 enden
+#   expect NAME KOMMANDO…   Ausgabe muss tests/expected/NAME.txt entsprechen
+#
+# Alles außer spotlight-flood und status-load läuft in virtueller Zeit mit
+# festem Seed – gleiche Firmware, gleiche Ausgabe, auf jedem Rechner.
+
+cd "$(dirname "$0")/.." || exit 2
+BUILD=${BUILD:-build}
+EXPECTED=tests/expected
+UPDATE=0
+[ "${1:-}" = "--update" ] && UPDATE=1
+
+passed=0
+failed=0
+
+pass() {
+    passed=$((passed + 1))
+    printf '  ok    %s\n' "$1"
+}
+
+fail() {
+    failed=$((failed + 1))
+    printf '  FAIL  %s\n' "$1"
+}
+
+check() {
+    name=$1
+    shift
+    if output=$("$@" 2>&1); then
+        pass "$name"
+    else
+        fail "$name"
+        printf '%s\n' "$output" | tail -20 | sed 's/^/        /'
+    fi
+}
+
+expect() {
+    name=$1
+    shift
+    output=$("$@" 2>&1)
+    status=$?
+    if [ $UPDATE = 1 ]; then
+        printf '%s\n' "$output" > "$EXPECTED/$name.txt"
+    fi
+    if [ $status != 0 ]; then
+        fail "$name (exit $status)"
+        printf '%s\n' "$output" | tail -20 | sed 's/^/        /'
+    elif printf '%s\n' "$output" | diff -u "$EXPECTED/$name.txt" - > /tmp/host-test-diff.$$ 2>&1; then
+        pass "$name"
+    else
+        fail "$name"
+        head -40 /tmp/host-test-diff.$$ | sed 's/^/        /'
+    fi
+    rm -f /tmp/host-test-diff.$$
+}
+
+# ============================================================================
+# PROTOKOLL
+# ============================================================================
+
+# Was der Commander kodiert, dekodiert der Scheinwerfer Bit für Bit zurück
+echo "protocol"
+check protocol-roundtrip "$BUILD/protocol-test"
+
+# Kaputte Requests aus den README-Beispielen (tests/corpus): nie über den
+# Buffer hinaus lesen, kaputte Struktur immer ablehnen
+check parse-fuzz "$BUILD/parse-fuzz"
+
+# ============================================================================
+# SCHEINWERFER
+# ============================================================================
+
+# Golden Frames: Prüfsumme über 10 s jeder Szene. Schlägt fehl, sobald eine
+# Änderung an der Render-Engine auch nur ein Pixel anders färbt – dann mit
+# --ascii/--ppm ansehen und, wenn gewollt, mit --update übernehmen.
+frames() {
+    for scene in $("$BUILD/spotlight-sim" --list); do
+        "$BUILD/spotlight-sim" --scene "$scene" --hash --frames 600 || return 1
+    done
+}
+
+# Frame-Identität: jede Szene phasengleich mit 60 fps und mit einer zweiten
+# Loop-Rate gerendert, gleiche Show-Zeit → gleicher Frame. 47 fps teilt nur
+# einzelne Zeitpunkte, 1000 fps jeden Frame der 60-fps-Folge.
+identity() {
+    for scene in $("$BUILD/spotlight-sim" --list); do
+        for fps in 47 1000; do
+            "$BUILD/spotlight-sim" --scene "$scene" --frames 600 --identity $fps || return 1
+        done
+    done
+}
+
+# Rendern ohne Heap: jede Szene, in Frames ohne neuen Szenen-Schritt kein malloc
+# (spotlight-sim --memory endet sonst mit Exit-Code 1)
+render_memory() {
+    for scene in $("$BUILD/spotlight-sim" --list); do
+        "$BUILD/spotlight-sim" --scene "$scene" --memory || return 1
+    done
+}
+
+echo
+echo "spotlight"
+
+# Bytecode-Format (led-spotlight/README.md): Listing des Host-Assemblers
+# mit allen Operanden-Arten – Zahl, Parameter, push16, Sprünge
+expect pixel-asm "$BUILD/pixel-asm" --list \
+    -e "i 2 mod jz even  t 4 shr 255 p1 -1000 max jmp out  even: 0 0 p0  out: rgb"
+expect golden-frames frames
+check frame-identity identity
+check render-memory render_memory
+
+# Echtzeit: 4 Clients fluten POST /effect, loop() bleibt trotzdem unter
+# einem Frame, zu große Bodies bekommen 413
+check spotlight-flood "$BUILD/spotlight-bench" --flood --clients 4 --duration 2
+
+# ============================================================================
+# COMMANDER
+# ============================================================================
+
+# Sequenzen aus tests/sequences ohne Latenz und Jitter: jede Ankunft pro
+# Scheinwerfer und die Requests pro Pfad
+show() {
+    sequence=$1
+    shift
+    "$BUILD/commander-sim" --sequence "tests/sequences/$sequence.json" \
+        --latency 0 --jitter 0 --events "$@"
+}
+
+echo
+echo "commander"
+
+# Drei gleiche Strobe-Hits mit duration: der Strobe ist nach 200 ms aus,
+# jeder Hit muss wieder raus (6 Ankünfte), auch wenn der Schatten gleich ist
+expect strobe-hits show strobe-hits --spotlights 2
+
+# Drei Timelines gleichzeitig: Grund-Show (Priorität 0), Hits nur auf den
+# Außenringen von spot-1/2 (5), Akzente (1). Gleicher Zeitpunkt im selben
+# Durchlauf (1000 ms), Gewinner einen Durchlauf früher (Hit 1990 gegen
+# Grund-Show 2000: ringClaims) und später (Akzent 2005); "both" zerfällt,
+# wenn nur ein Ring verloren ist
+expect timelines show timelines-base \
+    --play 1:tests/sequences/timelines-hits.json:5:outer:1+2 \
+    --play 2:tests/sequences/timelines-accent.json:1
+
+# Jeder Makro-Typ (chase, mirror, alternate, random mit pick 2), zum Schluss
+# ein Chase rückwärts, der nach dem letzten Event weiterläuft (draining)
+expect macros show macros
+
+# Pause mitten im Chase: die restlichen Schritte kommen nach der Pause,
+# um die Pause verschoben
+expect chase-pause show chase-pause --pause 1.3:2
+
+# Neun Makros zugleich: das neunte verliert seine restlichen Schritte
+# (MAX_MACRO_EXPANSIONS = 8), das nächste Makro bekommt wieder einen Platz
+expect macro-overflow show macro-overflow
+
+# 48 Scheinwerfer (mehr als 32 Bits): jedes Ziel kommt an, auch der Chase
+# über die Indizes 40–47
+expect wide-targets show wide-targets --spotlights 48
+
+# 48 + 17 weitere IDs passen nicht in MAX_SPOTLIGHTS = 64: die zweite
+# Sequenz wird abgelehnt, statt Ziele stillschweigend wegzulassen
+overflow() {
+    ! show wide-targets --spotlights 48 --play 1:tests/sequences/wide-extra.json > /dev/null 2>&1
+}
+check wide-overflow overflow
+
+# Playback ohne Heap: jede Sequenz aus tests/sequences, nach dem Aufwärmen
+# keine Allokation unter "sequence" und "json" (commander-sim --memory)
+playback_memory() {
+    for sequence in tests/sequences/*.json; do
+        "$BUILD/commander-sim" --sequence "$sequence" --memory || return 1
+    done
+}
+check playback-memory playback_memory
+
+# Echtzeit: 200 Status-Abfragen pro Sekunde während einer Show auf 16
+# Scheinwerfern (sofortige Antwort, damit nur /api/status zählt) – kein
+# Event darf mehr als 20 ms zu spät raus (playback.maxLateness)
+check status-load "$BUILD/commander-load" --spotlights 16 --duration 3 --effect-rate 0 \
+    --status-rate 200 --max-lateness 20 --latency 0 --jitter 0
+
+# ============================================================================
+# ERGEBNIS
+# ============================================================================
+
+echo
+echo "$passed passed, $failed failed"
+[ $failed = 0 ]
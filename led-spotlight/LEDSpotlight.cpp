@@ -1,16 +1,41 @@
 #include "LEDSpotlight.h"
 
+// Allokationszähler (common/MemoryStats.h), Linker-Flags in platformio.ini
+MEMORY_ALLOCATION_HOOKS()
+
 // ============================================================================
 // KONSTRUKTOR & INITIALISIERUNG
 // ============================================================================
 
-LEDSpotlight::LEDSpotlight() : server(80) {
+LEDSpotlight::LEDSpotlight() :
+    server(80),
+    commandQueue(nullptr),
+    stateMutex(nullptr),
+    commandsQueued(0),
+    commandsDropped(0),
+    nextBatchId(0),
+    receivedValid(),
+    scheduledCount(0),
+    batchPartsReserved(0),
+    clockOffset(0),
+    clockSynced(false),
+    clockOffsetUs(0),
+    numSegments(0),
+    telemetryMux(portMUX_INITIALIZER_UNLOCKED),
+    pendingSpanCount(0),
+    tracesSent(0) {
+    resetSegments();
 }
 
 void LEDSpotlight::begin(const char* ssid, const char* password, const char* spotId) {
     Serial.begin(115200);
     Serial.println("\n=== LED Spotlight Starting ===");
     
+    // Log-Records ab hier im Hintergrund auf Serial (siehe common/Log.h)
+    startLogDrain();
+    memoryStats.registerTask("loop");
+    memoryStats.registerTask("log", logDrainHandle);
+    
     wifiSSID = String(ssid);
     wifiPassword = String(password);
     spotlightId = String(spotId);
@@ -53,10 +78,21 @@ void LEDSpotlight::begin(const char* ssid, const char* password, const char* spo
         Serial.println("\n✗ WiFi failed!");
     }
     
-    // REST API Routes
+    // Übergabe Netzwerk-Task → Render-Loop
+    commandQueue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(SpotlightCommand));
+    stateMutex = xSemaphoreCreateMutex();
+    
+    // REST API Routes (Async: Requests laufen im Netzwerk-Task)
     setupRoutes();
     server.begin();
     
+    // Frame-Telemetrie rechnet Takte mit der echten CPU-Frequenz um
+    telemetry.cpuMhz = ESP.getCpuFreqMHz();
+    
+    // Realtime-Pixelstream
+    realtimeUdp.begin(REALTIME_PORT);
+    Serial.printf("✓ Realtime (DDP) on UDP port %d\n", REALTIME_PORT);
+    
     Serial.printf("\n✓ Spotlight '%s' ready!\n", spotId);
     Serial.println("Listening for commands from Light Commander...\n");
     
@@ -71,9 +107,136 @@ void LEDSpotlight::begin(const char* ssid, const char* password, const char* spo
 }
 
 void LEDSpotlight::loop() {
-    server.handleClient();
-    updateEffects();
-    FastLED.show();
+    // Telemetrie aus → nur ein Branch pro Messpunkt, kein Zeitstempel
+    FrameSample* sample = telemetry.enabled ? &frameSample : nullptr;
+    if (sample) {
+        *sample = FrameSample();
+        sample->start = ESP.getCycleCount();
+    }
+    
+    receiveRealtime();
+    
+    // Befehle übernehmen, auch während des Streams (gelten danach)
+    lockState();
+    processCommands();
+    if (sample) sample->network = ESP.getCycleCount() - sample->start;
+    if (!realtime.active) updateEffects(sample);
+    unlockState();
+    
+    // Realtime-Stream hat Vorrang; Effekte laufen zeitbasiert weiter
+    // und sind nach dem Timeout sofort wieder phasengleich
+    unsigned long receivedAt = 0;
+    bool show = !realtime.active || showRealtimeFrame(receivedAt);
+    
+    if (show) {
+        uint32_t showStart = sample ? ESP.getCycleCount() : 0;
+        FastLED.show();
+        if (sample) sample->show = ESP.getCycleCount() - showStart;
+        
+        if (realtime.active) recordRealtimeLatency(receivedAt);
+        else if (pendingSpanCount) sendTraceSpans();
+    }
+    
+    if (sample) recordFrame(*sample);
+}
+
+// ============================================================================
+// BEFEHLS-QUEUE (Netzwerk-Task → Render-Loop)
+// ============================================================================
+
+bool LEDSpotlight::queueCommand(const SpotlightCommand& command) {
+    // Nie warten: volle Queue → 503, der Netzwerk-Task blockiert nicht
+    if (xQueueSend(commandQueue, &command, 0) != pdTRUE) {
+        commandsDropped++;
+        return false;
+    }
+    commandsQueued++;
+    return true;
+}
+
+void LEDSpotlight::processCommands() {
+    SpotlightCommand command;
+    while (xQueueReceive(commandQueue, &command, 0) == pdTRUE) {
+        if (command.batchId) scheduleCommand(command);
+        else applyCommand(command);
+    }
+    
+    if (scheduledCount) applyDueBatches();
+}
+
+void LEDSpotlight::applyCommand(const SpotlightCommand& command) {
+    switch (command.type) {
+        case COMMAND_EFFECT:
+            setEffect(command.effect);
+            if (command.effect.traceId) traceApplied(command);
+            break;
+        case COMMAND_STOP:
+            stopEffect(command.ring, command.segmentMask);
+            break;
+    }
+}
+
+// Platz ist reserviert (handleBatch) – voll wäre ein Fehler in der Buchführung
+void LEDSpotlight::scheduleCommand(const SpotlightCommand& command) {
+    if (scheduledCount >= COMMAND_QUEUE_LENGTH) {
+        commandsDropped++;
+        batchPartsReserved--;
+        LOG_WARN("✗ Batch part dropped (%u waiting)", scheduledCount);
+        return;
+    }
+    scheduled[scheduledCount++] = command;
+}
+
+// Ein Batch gilt erst, wenn alle Teile da sind und die Show-Uhr `applyAt`
+// erreicht hat – dann alle Teile in diesem Frame. Ohne Uhr-Sync gilt er
+// sofort. Fehlen Teile (verworfen), wird der Rest nach BATCH_TIMEOUT_MS
+// verworfen statt halb angewendet.
+void LEDSpotlight::applyDueBatches() {
+    unsigned long now = showClock();
+    uint32_t nowUs = showMicros();
+    
+    uint8_t i = 0;
+    while (i < scheduledCount) {
+        const SpotlightCommand& first = scheduled[i];
+        uint32_t batchId = first.batchId;
+        uint8_t parts = 0;
+        for (uint8_t j = i; j < scheduledCount; j++) {
+            if (scheduled[j].batchId == batchId) parts++;
+        }
+        
+        bool complete = parts >= first.batchSize;
+        bool due = !clockSynced || first.applyAt == 0 || (long)(now - first.applyAt) >= 0;
+        bool expired = due && nowUs - first.receivedAt > BATCH_TIMEOUT_MS * 1000UL;
+        if (!due || (!complete && !expired)) {
+            i++;
+            continue;
+        }
+        
+        if (!complete) {
+            commandsDropped += parts;
+            LOG_WARN("✗ Batch incomplete (%u/%u), dropped", parts, first.batchSize);
+        }
+        
+        // Anwenden bzw. verwerfen und austragen, Reihenfolge der übrigen bleibt
+        uint8_t kept = i;
+        for (uint8_t j = i; j < scheduledCount; j++) {
+            if (scheduled[j].batchId != batchId) {
+                scheduled[kept++] = scheduled[j];
+            } else if (complete) {
+                applyCommand(scheduled[j]);
+            }
+        }
+        batchPartsReserved -= scheduledCount - kept;
+        scheduledCount = kept;
+    }
+}
+
+void LEDSpotlight::lockState() {
+    xSemaphoreTake(stateMutex, portMAX_DELAY);
+}
+
+void LEDSpotlight::unlockState() {
+    xSemaphoreGive(stateMutex);
 }
 
 // ============================================================================
@@ -81,155 +244,635 @@ void LEDSpotlight::loop() {
 // ============================================================================
 
 void LEDSpotlight::setupRoutes() {
-    server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    server.on("/effect", HTTP_POST, [this]() { handleEffect(); });
-    server.on("/stop", HTTP_POST, [this]() { handleStop(); });
-    server.on("/status", HTTP_GET, [this]() { handleStatus(); });
+    onGet("/", &LEDSpotlight::handleRoot);
+    onGet("/status", &LEDSpotlight::handleStatus);
+    onGet("/logs", &LEDSpotlight::handleLogs);
+    onGet("/telemetry", &LEDSpotlight::handleTelemetry);
+    onGet("/memory", &LEDSpotlight::handleMemory);
+    
+    onPost("/effect", &LEDSpotlight::handleEffect);
+    onPost("/effect/delta", &LEDSpotlight::handleEffectDelta);
+    onPost("/batch", &LEDSpotlight::handleBatch);
+    onPost("/stop", &LEDSpotlight::handleStop);
+    onPost("/clock", &LEDSpotlight::handleClock);
+    onPost("/program", &LEDSpotlight::handleProgram);
+    onPost("/palette", &LEDSpotlight::handlePalette);
+    onPost("/segments", &LEDSpotlight::handleSegments);
+    onPost("/realtime", &LEDSpotlight::handleRealtime);
+    onPost("/telemetry", &LEDSpotlight::handleTelemetryConfig);
 }
 
-void LEDSpotlight::handleRoot() {
+// Heap der Handler zählt unter "json". Den Netzwerk-Task startet die
+// Bibliothek → Anmeldung beim ersten Request
+void LEDSpotlight::onGet(const char* path, RequestHandler handler) {
+    server.on(path, HTTP_GET, [this, handler](AsyncWebServerRequest* request) {
+        memoryStats.registerTask("network");
+        MemoryScope scope(MEMORY_JSON);
+        (this->*handler)(request);
+    });
+}
+
+void LEDSpotlight::onPost(const char* path, RequestHandler handler) {
+    server.on(path, HTTP_POST,
+        [this, handler](AsyncWebServerRequest* request) {
+            memoryStats.registerTask("network");
+            // Body hat collectBody() verworfen: 413 statt "No body" im Handler
+            if (request->contentLength() > MAX_REQUEST_BODY) {
+                request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+                return;
+            }
+            MemoryScope scope(MEMORY_JSON);
+            (this->*handler)(request);
+        },
+        nullptr,
+        [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            memoryStats.registerTask("network");
+            MemoryScope scope(MEMORY_JSON);
+            collectBody(request, data, len, index, total);
+        });
+}
+
+// Body kommt in Stücken aus dem TCP-Stack → in _tempObject sammeln
+// (gibt der Server nach dem Request selbst frei). Zu große Bodies gar
+// nicht erst, onPost() antwortet dann 413.
+void LEDSpotlight::collectBody(AsyncWebServerRequest* request, uint8_t* data,
+                               size_t len, size_t index, size_t total) {
+    if (total > MAX_REQUEST_BODY) return;
+    
+    if (index == 0) {
+        request->_tempObject = malloc(total + 1);
+    }
+    
+    char* buffer = (char*)request->_tempObject;
+    if (!buffer) return;
+    
+    memcpy(buffer + index, data, len);
+    if (index + len == total) buffer[total] = '\0';
+}
+
+const char* LEDSpotlight::requestBody(AsyncWebServerRequest* request) {
+    return (const char*)request->_tempObject;
+}
+
+void LEDSpotlight::handleRoot(AsyncWebServerRequest* request) {
     String html = "<!DOCTYPE html><html><head><title>LED Spotlight</title></head><body>";
     html += "<h1>LED Spotlight: " + spotlightId + "</h1>";
     html += "<p>IP: " + WiFi.localIP().toString() + "</p>";
     html += "<h2>Status:</h2>";
     html += "<ul>";
-    html += "<li>Inner Ring: " + String(innerState.active ? "Active" : "Idle") + "</li>";
-    html += "<li>Outer Ring: " + String(outerState.active ? "Active" : "Idle") + "</li>";
+    lockState();
+    for (uint8_t s = 0; s < numSegments; s++) {
+        const Segment& seg = segments[s];
+        html += "<li>Segment " + String(s) + " (" + (seg.ring == RING_INNER ? "inner" : "outer");
+        html += " " + String(seg.start) + "+" + String(seg.length) + "): ";
+        html += String(seg.state.active ? "Active" : "Idle") + "</li>";
+    }
+    unlockState();
     html += "</ul>";
     html += "<h2>API Endpoints:</h2>";
     html += "<ul>";
     html += "<li>POST /effect - Set effect</li>";
+    html += "<li>POST /effect/delta - Change fields of the current effect</li>";
+    html += "<li>POST /batch - Several effects on the same frame</li>";
     html += "<li>POST /stop - Stop effects</li>";
     html += "<li>GET /status - Get status</li>";
+    html += "<li>POST /program - Upload pixel program</li>";
+    html += "<li>POST /palette - Upload palette</li>";
+    html += "<li>POST /segments - Configure segments</li>";
+    html += "<li>POST /realtime - Configure realtime stream</li>";
     html += "</ul>";
     html += "</body></html>";
     
-    server.send(200, "text/html", html);
+    request->send(200, "text/html", html);
 }
 
-void LEDSpotlight::handleEffect() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LEDSpotlight::handleEffect(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
-    String body = server.arg("plain");
-    Serial.println("\n📥 Received command from Commander:");
-    Serial.println(body);
+    LOG_DEBUG("📥 Effect command (%u bytes)", strlen(body));
     
-    StaticJsonDocument<2048> doc;
-    DeserializationError error = deserializeJson(doc, body);
+    // Direkt aus dem Request-Buffer in den Befehl dekodieren (kein JsonDocument, kein Heap)
+    SpotlightCommand command;
+    command.type = COMMAND_EFFECT;
+    Effect& effect = command.effect;
     
-    if (error) {
-        Serial.println("✗ JSON parse error!");
-        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    DecodeResult result = decodeEffect(body, strlen(body), effect);
+    command.receivedAt = showMicros();
+    command.origin = request->client()->remoteIP();
+    if (result == DECODE_UNSUPPORTED_VERSION) {
+        LOG_WARN("✗ Unsupported protocol version");
+        request->send(400, "application/json", "{\"error\":\"Unsupported protocol version\"}");
+        return;
+    }
+    if (result != DECODE_OK) {
+        LOG_WARN("✗ Effect: invalid JSON");
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
     
-    // Effekt parsen
-    Effect effect;
+    queueEffect(request, command);
+}
+
+// Nur geänderte Felder (Commander-Schattenzustand): dekodiert auf den
+// zuletzt angenommenen Effekt des Rings. Ohne Basis (Neustart) → 409, der
+// Commander schickt dann den vollen Effekt.
+void LEDSpotlight::handleEffectDelta(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    size_t length = strlen(body);
+    
+    // Erst den Ring: er bestimmt die Basis
+    Effect probe;
+    DecodeResult result = decodeEffect(body, length, probe);
+    if (result == DECODE_UNSUPPORTED_VERSION) {
+        LOG_WARN("✗ Unsupported protocol version");
+        request->send(400, "application/json", "{\"error\":\"Unsupported protocol version\"}");
+        return;
+    }
+    if (result != DECODE_OK || probe.segments) {
+        LOG_WARN("✗ Effect delta: invalid JSON");
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
     
-    // Ring
-    String ringStr = doc["ring"] | "both";
-    if (ringStr == "inner") effect.ring = RING_INNER;
-    else if (ringStr == "outer") effect.ring = RING_OUTER;
-    else effect.ring = RING_BOTH;
+    bool known = probe.ring == RING_BOTH ? receivedValid[RING_INNER] && receivedValid[RING_OUTER]
+                                         : receivedValid[probe.ring];
+    if (!known) {
+        LOG_DEBUG("✗ Effect delta without base");
+        request->send(409, "application/json", "{\"error\":\"No base effect\"}");
+        return;
+    }
     
-    // Effekt-Typ
-    String effectStr = doc["effect"] | "static";
-    if (effectStr == "static") effect.type = EFFECT_STATIC;
-    else if (effectStr == "fade") effect.type = EFFECT_FADE;
-    else if (effectStr == "strobe") effect.type = EFFECT_STROBE;
-    else if (effectStr == "pulse") effect.type = EFFECT_PULSE;
-    else if (effectStr == "rotation") effect.type = EFFECT_ROTATION;
-    else if (effectStr == "rainbow") effect.type = EFFECT_RAINBOW;
-    else if (effectStr == "chase") effect.type = EFFECT_CHASE;
+    SpotlightCommand command;
+    command.type = COMMAND_EFFECT;
+    command.effect = received[probe.ring == RING_BOTH ? RING_INNER : probe.ring];
+    decodeEffect(body, length, command.effect);
+    command.receivedAt = showMicros();
+    command.origin = request->client()->remoteIP();
     
-    // Farbe
-    if (doc.containsKey("color")) {
-        JsonArray colorArray = doc["color"];
-        effect.color = Color(colorArray[0], colorArray[1], colorArray[2]);
+    queueEffect(request, command);
+}
+
+void LEDSpotlight::queueEffect(AsyncWebServerRequest* request, SpotlightCommand& command) {
+    const Effect& effect = command.effect;
+    
+    // Pixel-Programm muss geladen sein
+    if (effect.type == EFFECT_PROGRAM &&
+        (effect.program >= MAX_PROGRAMS || !programs[effect.program].isValid())) {
+        request->send(400, "application/json", "{\"error\":\"Unknown program\"}");
+        return;
     }
     
-    // Zweite Farbe (für Fade)
-    if (doc.containsKey("color2")) {
-        JsonArray color2Array = doc["color2"];
-        effect.color2 = Color(color2Array[0], color2Array[1], color2Array[2]);
+    // An die Render-Loop übergeben (nicht blockierend)
+    if (!queueCommand(command)) {
+        request->send(503, "application/json", "{\"error\":\"Command queue full\"}");
+        return;
     }
+    rememberEffect(effect);
     
-    // Helligkeit
-    if (doc.containsKey("brightness")) {
-        effect.brightness = doc["brightness"];
+    LOG_DEBUG("✓ Effect queued");
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void LEDSpotlight::rememberEffect(const Effect& effect) {
+    for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+        if (effect.ring != RING_BOTH && effect.ring != ring) continue;
+        // Segment-Effekte decken den Ring nicht ganz ab → keine Basis
+        receivedValid[ring] = effect.segments == 0;
+        if (receivedValid[ring]) received[ring] = effect;
+    }
+}
+
+void LEDSpotlight::handleBatch(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    size_t length = strlen(body);
+    
+    // 1. Durchgang: prüfen und zählen – ein Batch kommt ganz oder gar nicht
+    // in die Queue (kein Effekt-Array auf dem Stack des Netzwerk-Tasks)
+    unsigned long at;
+    uint8_t count = 0;
+    bool programsValid = true;
+    DecodeResult result = decodeBatch(body, length, at, [&](const Effect& effect) {
+        count++;
+        if (effect.type == EFFECT_PROGRAM &&
+            (effect.program >= MAX_PROGRAMS || !programs[effect.program].isValid())) {
+            programsValid = false;
+        }
+    });
+    if (result == DECODE_UNSUPPORTED_VERSION) {
+        LOG_WARN("✗ Unsupported protocol version");
+        request->send(400, "application/json", "{\"error\":\"Unsupported protocol version\"}");
+        return;
+    }
+    if (result != DECODE_OK || count == 0 || count > MAX_BATCH_EFFECTS) {
+        LOG_WARN("✗ Batch: invalid (%u effects)", count);
+        request->send(400, "application/json", "{\"error\":\"Invalid batch\"}");
+        return;
+    }
+    if (!programsValid) {
+        request->send(400, "application/json", "{\"error\":\"Unknown program\"}");
+        return;
     }
     
-    // Speed/Duration
-    if (doc.containsKey("speed")) {
-        effect.speed = doc["speed"];
+    // Nur dieser Task schreibt in die Queue und reserviert: freie Plätze
+    // bleiben frei. Wartende Batches (auch künftige) belegen scheduled[] bis
+    // zum Anwenden – ein weiterer Batch muss daneben passen, sonst 503 statt
+    // 200 und später verworfener Teile.
+    if (uxQueueSpacesAvailable(commandQueue) < count ||
+        batchPartsReserved + count > COMMAND_QUEUE_LENGTH) {
+        commandsDropped += count;
+        request->send(503, "application/json", "{\"error\":\"Command queue full\"}");
+        return;
     }
-    if (doc.containsKey("duration")) {
-        effect.duration = doc["duration"];
+    batchPartsReserved += count;
+    
+    // 2. Durchgang: alle Teile mit derselben Batch-Kennung in die Queue
+    SpotlightCommand command;
+    command.type = COMMAND_EFFECT;
+    command.receivedAt = showMicros();
+    command.origin = request->client()->remoteIP();
+    if (++nextBatchId == 0) nextBatchId = 1;    // 0 = kein Batch
+    command.batchId = nextBatchId;
+    command.batchSize = count;
+    command.applyAt = at;
+    decodeBatch(body, length, at, [&](const Effect& effect) {
+        command.effect = effect;
+        queueCommand(command);
+        rememberEffect(effect);
+    });
+    
+    // Vorlauf bis zur Show-Zeit (negativ = zu spät, gilt im nächsten Frame):
+    // daraus schätzt der Commander den Versatz zwischen den Scheinwerfern
+    String json = "{\"success\":true";
+    if (clockSynced && at != 0) {
+        int32_t leadUs = (int32_t)((uint32_t)(at * 1000UL) - command.receivedAt);
+        json += ",\"leadUs\":" + String(leadUs);
     }
+    json += "}";
     
-    // Rotation-spezifische Parameter
-    if (effect.type == EFFECT_ROTATION && doc.containsKey("rotation")) {
-        JsonObject rot = doc["rotation"];
+    LOG_DEBUG("✓ Batch queued (%u effects)", count);
+    request->send(200, "application/json", json);
+}
+
+void LEDSpotlight::handleStop(AsyncWebServerRequest* request) {
+    LOG_DEBUG("📥 Stop command");
+    
+    SpotlightCommand command;
+    command.type = COMMAND_STOP;
+    command.ring = RING_BOTH;
+    command.segmentMask = 0;
+    
+    const char* body = requestBody(request);
+    if (body) {
+        JsonCursor json(body, strlen(body));
+        const char* key;
+        size_t keyLength;
         
-        if (rot.containsKey("activeColor")) {
-            JsonArray ac = rot["activeColor"];
-            effect.rotation.activeColor = Color(ac[0], ac[1], ac[2]);
-        }
-        if (rot.containsKey("inactiveColor")) {
-            JsonArray ic = rot["inactiveColor"];
-            effect.rotation.inactiveColor = Color(ic[0], ic[1], ic[2]);
+        if (json.enterObject()) {
+            while (json.nextKey(key, keyLength)) {
+                switch (EFFECT_FIELDS.find(key, keyLength)) {
+                    case FIELD_RING:
+                        command.ring = (RingType)readKeyword(json, RING_KEYWORDS, RING_BOTH);
+                        break;
+                    case FIELD_SEGMENTS:
+                        command.segmentMask = readSegmentMask(json);
+                        break;
+                    default:
+                        json.skipValue();
+                        break;
+                }
+            }
         }
-        if (rot.containsKey("speed")) {
-            effect.rotation.speed = rot["speed"];
-        }
-        if (rot.containsKey("direction")) {
-            String dir = rot["direction"] | "clockwise";
-            effect.rotation.direction = (dir == "counterclockwise") ? 
-                DIRECTION_COUNTERCLOCKWISE : DIRECTION_CLOCKWISE;
+    }
+    
+    if (!queueCommand(command)) {
+        request->send(503, "application/json", "{\"error\":\"Command queue full\"}");
+        return;
+    }
+    
+    Effect stopped;
+    stopped.ring = command.ring;
+    stopped.segments = command.segmentMask;
+    rememberEffect(stopped);
+    
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void LEDSpotlight::handleStatus(AsyncWebServerRequest* request) {
+    request->send(200, "application/json", getStatusJson());
+}
+
+// Heap, Stack-Reserven der Tasks und Allokationen pro Subsystem
+// (common/MemoryStats.h). Im Betrieb sollte der Loop-Task bei
+// "allocations" stehen bleiben: Rendern holt keinen Heap.
+void LEDSpotlight::handleMemory(AsyncWebServerRequest* request) {
+    MemorySnapshot snapshot;
+    memoryStats.snapshot(snapshot);
+    
+    char json[MEMORY_JSON_SIZE];
+    if (encodeMemoryStats(snapshot, json, sizeof(json)) == 0) {
+        request->send(500, "application/json", "{\"error\":\"Memory stats too large\"}");
+        return;
+    }
+    request->send(200, "application/json", json);
+}
+
+void LEDSpotlight::handleLogs(AsyncWebServerRequest* request) {
+    // Letzte Records als Text, ?count=N (Standard: ganzer Puffer)
+    uint16_t count = LOG_BUFFER_SIZE;
+    if (request->hasParam("count")) count = request->getParam("count")->value().toInt();
+    
+    String text;
+    logBuffer.recent([&text](const char* line) {
+        text += line;
+        text += '\n';
+    }, count);
+    
+    request->send(200, "text/plain", text);
+}
+
+void LEDSpotlight::handleClock(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<128> doc;
+    if (deserializeJson(doc, body) || !doc.containsKey("time")) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    unsigned long commanderTime = doc["time"];
+    setShowClock(commanderTime);
+    
+    // µs-Uhr fürs Tracing: Sendezeit + geschätzte Laufzeit (halbe RTT der letzten Synchronisation)
+    if (doc.containsKey("timeUs")) {
+        uint32_t commanderMicros = doc["timeUs"];
+        uint32_t rttUs = doc["rttUs"] | 0;
+        setShowMicros(commanderMicros + rttUs / 2);
+    }
+    
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void LEDSpotlight::handleProgram(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<2048> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    uint8_t slot = doc["slot"] | 0;
+    if (slot >= MAX_PROGRAMS) {
+        request->send(400, "application/json", "{\"error\":\"Invalid slot\"}");
+        return;
+    }
+    
+    // Entweder Assembler-Quelltext oder fertiger Bytecode
+    // (außerhalb des Locks übersetzen, nur das Ergebnis übernehmen)
+    PixelProgram program;
+    const char* error;
+    if (doc.containsKey("source")) {
+        const char* source = doc["source"];
+        error = program.assemble(source ? source : "");
+    } else {
+        JsonArray codeArray = doc["code"];
+        uint8_t code[MAX_PROGRAM_LENGTH];
+        uint8_t length = 0;
+        for (JsonVariant v : codeArray) {
+            if (length >= MAX_PROGRAM_LENGTH) {
+                length = 0;
+                break;
+            }
+            code[length++] = v.as<uint8_t>();
         }
-        if (rot.containsKey("pattern")) {
-            String pat = rot["pattern"] | "single";
-            if (pat == "trail") effect.rotation.pattern = PATTERN_TRAIL;
-            else if (pat == "opposite") effect.rotation.pattern = PATTERN_OPPOSITE;
-            else if (pat == "wave") effect.rotation.pattern = PATTERN_WAVE;
-            else if (pat == "rainbow_chase") effect.rotation.pattern = PATTERN_RAINBOW_CHASE;
-            else effect.rotation.pattern = PATTERN_SINGLE;
+        error = program.load(code, length);
+    }
+    
+    if (error) {
+        LOG_WARN_TAG(error, "✗ Program rejected");
+        String response = "{\"error\":\"" + String(error) + "\"}";
+        request->send(400, "application/json", response);
+        return;
+    }
+    
+    lockState();
+    setProgram(slot, program);
+    unlockState();
+    
+    LOG_INFO("✓ Program %u loaded (%u bytes)", slot, program.size());
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void LEDSpotlight::handlePalette(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<2048> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    uint8_t id = doc["id"] | 0;
+    JsonArray colors = doc["colors"];
+    uint8_t numStops = min((size_t)PALETTE_STOPS, colors.size());
+    
+    if (id < 1 || id > MAX_PALETTES || numStops == 0) {
+        request->send(400, "application/json", "{\"error\":\"Invalid palette\"}");
+        return;
+    }
+    
+    CRGB stops[PALETTE_STOPS];
+    for (int i = 0; i < numStops; i++) {
+        JsonArray c = colors[i];
+        stops[i] = CRGB(c[0], c[1], c[2]);
+    }
+    
+    lockState();
+    setPalette(id, stops, numStops, doc["name"] | "");
+    unlockState();
+    
+    LOG_INFO("✓ Palette %u loaded", id);
+    request->send(200, "application/json", "{\"success\":true}");
+}
+
+void LEDSpotlight::handleSegments(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    if (doc["reset"] | false) {
+        lockState();
+        resetSegments();
+        unlockState();
+        request->send(200, "application/json", "{\"success\":true}");
+        return;
+    }
+    
+    JsonArray array = doc["segments"];
+    if (array.size() == 0 || array.size() > MAX_SEGMENTS) {
+        request->send(400, "application/json", "{\"error\":\"Invalid segment count\"}");
+        return;
+    }
+    
+    // Prüfen: innerhalb des Rings, keine Überlappung
+    SegmentLayout layout[MAX_SEGMENTS];
+    uint32_t used[2] = { 0, 0 };
+    uint8_t count = 0;
+    
+    for (JsonObject obj : array) {
+        String ringStr = obj["ring"] | "inner";
+        RingType ring = (ringStr == "outer") ? RING_OUTER : RING_INNER;
+        uint8_t ringSize = (ring == RING_INNER) ? NUM_LEDS_INNER : NUM_LEDS_OUTER;
+        uint8_t start = obj["start"] | 0;
+        uint8_t length = obj["length"] | 0;
+        
+        if (length == 0 || start + length > ringSize) {
+            request->send(400, "application/json", "{\"error\":\"Segment out of range\"}");
+            return;
         }
-        if (rot.containsKey("trailLength")) {
-            effect.rotation.trailLength = rot["trailLength"];
+        
+        uint32_t bits = ((length == 32) ? 0xFFFFFFFF : ((1UL << length) - 1)) << start;
+        uint8_t r = (ring == RING_INNER) ? 0 : 1;
+        if (used[r] & bits) {
+            request->send(400, "application/json", "{\"error\":\"Segments overlap\"}");
+            return;
         }
+        used[r] |= bits;
+        
+        layout[count++] = { ring, start, length };
     }
     
-    // Effekt setzen
-    setEffect(effect);
+    lockState();
+    configureSegments(layout, count);
+    unlockState();
     
-    Serial.println("✓ Effect applied!");
-    server.send(200, "application/json", "{\"success\":true}");
+    LOG_INFO("✓ %u segments configured", count);
+    request->send(200, "application/json", "{\"success\":true}");
 }
 
-void LEDSpotlight::handleStop() {
-    Serial.println("📥 Stop command received");
+void LEDSpotlight::handleRealtime(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
     
-    if (server.hasArg("plain")) {
-        StaticJsonDocument<256> doc;
-        deserializeJson(doc, server.arg("plain"));
-        
-        String ringStr = doc["ring"] | "both";
-        if (ringStr == "inner") stopEffect(RING_INNER);
-        else if (ringStr == "outer") stopEffect(RING_OUTER);
-        else stopAllEffects();
-    } else {
-        stopAllEffects();
+    StaticJsonDocument<128> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
     }
     
-    server.send(200, "application/json", "{\"success\":true}");
+    if (doc.containsKey("jitterMs")) realtime.jitterMs = doc["jitterMs"];
+    if (doc.containsKey("timeoutMs")) realtime.timeoutMs = doc["timeoutMs"];
+    
+    request->send(200, "application/json", "{\"success\":true}");
 }
 
-void LEDSpotlight::handleStatus() {
-    server.send(200, "application/json", getStatusJson());
+void LEDSpotlight::handleTelemetry(AsyncWebServerRequest* request) {
+    // Binär für den Commander: Header + Einträge mit Daten (siehe common/Telemetry.h)
+    TelemetryHeader header;
+    header.version = TELEMETRY_VERSION;
+    header.flags = telemetry.enabled ? TELEMETRY_FLAG_ENABLED : 0;
+    header.cpuMhz = telemetry.cpuMhz;
+    header.windowMs = TELEMETRY_WINDOW_MS;
+    header.entries = 0;
+    header.buckets = HISTOGRAM_BUCKETS;
+    header.uptime = millis();
+    
+    const uint8_t maxEntries = NUM_TELEMETRY_STAGES + NUM_RENDER_RINGS * NUM_EFFECT_TYPES;
+    TelemetryEntry* entries = new TelemetryEntry[maxEntries];
+    
+    auto addEntry = [&](const StageTelemetry& stage, uint8_t id, uint8_t ring, uint8_t effect) {
+        if (stage.total.count == 0) return;
+        TelemetryEntry& entry = entries[header.entries++];
+        entry.stage = id;
+        entry.ring = ring;
+        entry.effect = effect;
+        entry.reserved = 0;
+        entry.window = stage.last;
+        memcpy(entry.buckets, stage.total.buckets, sizeof(entry.buckets));
+    };
+    
+    portENTER_CRITICAL(&telemetryMux);
+    for (uint8_t i = 0; i < NUM_TELEMETRY_STAGES; i++) {
+        addEntry(telemetry.stages[i], i, TELEMETRY_ANY, TELEMETRY_ANY);
+    }
+    for (uint8_t r = 0; r < NUM_RENDER_RINGS; r++) {
+        for (uint8_t t = 0; t < NUM_EFFECT_TYPES; t++) {
+            addEntry(telemetry.render[r][t], STAGE_RENDER, r == 0 ? RING_INNER : RING_OUTER, t);
+        }
+    }
+    portEXIT_CRITICAL(&telemetryMux);
+    
+    AsyncResponseStream* out = request->beginResponseStream("application/octet-stream");
+    out->write((const uint8_t*)&header, sizeof(header));
+    out->write((const uint8_t*)entries, header.entries * sizeof(TelemetryEntry));
+    delete[] entries;
+    
+    request->send(out);
+}
+
+void LEDSpotlight::handleTelemetryConfig(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<128> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    // Reset vor dem Einschalten: neues Fenster, kein Loop-Abstand über die Pause
+    if (doc["reset"] | false) resetTelemetry();
+    if (doc.containsKey("enabled")) {
+        bool enabled = doc["enabled"];
+        if (enabled && !telemetry.enabled) {
+            portENTER_CRITICAL(&telemetryMux);
+            telemetry.windowStart = millis();
+            telemetry.lastLoopStart = 0;
+            portEXIT_CRITICAL(&telemetryMux);
+        }
+        telemetry.enabled = enabled;
+    }
+    
+    LOG_INFO("Telemetry enabled: %u", telemetry.enabled);
+    request->send(200, "application/json", "{\"success\":true}");
 }
 
 // ============================================================================
@@ -237,51 +880,43 @@ void LEDSpotlight::handleStatus() {
 // ============================================================================
 
 void LEDSpotlight::setEffect(const Effect& effect) {
-    unsigned long now = millis();
-    
-    if (effect.ring == RING_INNER || effect.ring == RING_BOTH) {
-        innerState.active = true;
-        innerState.effect = effect;
-        innerState.effect.ring = RING_INNER;
-        innerState.startTime = now;
-        innerState.lastUpdate = now;
-        innerState.phase = 0;
-        innerState.position = 0;
+    unsigned long now = showClock();
+    
+    // Startzeit in der Show-Uhr: vom Commander vorgegeben (phasengleich über
+    // alle Scheinwerfer) oder jetzt. Ohne Uhr-Sync ist eine fremde Startzeit
+    // bedeutungslos → ignorieren.
+    unsigned long startTime = (clockSynced && effect.startTime != 0) ? effect.startTime : now;
+    
+    uint8_t applied = 0;
+    for (uint8_t s = 0; s < numSegments; s++) {
+        Segment& seg = segments[s];
+        if (!segmentMatches(s, effect.ring, effect.segments)) continue;
         
-        Serial.printf("✓ Inner ring: %s\n", 
-            effect.type == EFFECT_ROTATION ? "ROTATION" :
-            effect.type == EFFECT_PULSE ? "PULSE" :
-            effect.type == EFFECT_STROBE ? "STROBE" : "OTHER");
-    }
-    
-    if (effect.ring == RING_OUTER || effect.ring == RING_BOTH) {
-        outerState.active = true;
-        outerState.effect = effect;
-        outerState.effect.ring = RING_OUTER;
-        outerState.startTime = now;
-        outerState.lastUpdate = now;
-        outerState.phase = 0;
-        outerState.position = 0;
+        beginTransition(seg, effect.transitionMs, startTime);
         
-        Serial.printf("✓ Outer ring: %s\n",
-            effect.type == EFFECT_ROTATION ? "ROTATION" :
-            effect.type == EFFECT_PULSE ? "PULSE" :
-            effect.type == EFFECT_STROBE ? "STROBE" : "OTHER");
+        seg.state.active = true;
+        seg.state.effect = effect;
+        seg.state.effect.ring = seg.ring;
+        seg.state.startTime = startTime;
+        seg.state.phase = 0;
+        seg.state.position = 0;
+        applied++;
     }
+    
+    LOG_DEBUG_TAG(EFFECT_NAMES[effect.type], "✓ %u segment(s)", applied);
 }
 
-void LEDSpotlight::stopEffect(RingType ring) {
-    if (ring == RING_INNER || ring == RING_BOTH) {
-        innerState.active = false;
-        for (int i = 0; i < NUM_LEDS_INNER; i++) {
-            innerRing[i] = CRGB::Black;
-        }
-    }
-    
-    if (ring == RING_OUTER || ring == RING_BOTH) {
-        outerState.active = false;
-        for (int i = 0; i < NUM_LEDS_OUTER; i++) {
-            outerRing[i] = CRGB::Black;
+void LEDSpotlight::stopEffect(RingType ring, uint8_t segmentMask) {
+    for (uint8_t s = 0; s < numSegments; s++) {
+        Segment& seg = segments[s];
+        if (!segmentMatches(s, ring, segmentMask)) continue;
+        
+        seg.state.active = false;
+        seg.transition.active = false;
+        
+        CRGB* leds = segmentLeds(seg);
+        for (int i = 0; i < seg.length; i++) {
+            leds[i] = CRGB::Black;
         }
     }
 }
@@ -291,7 +926,7 @@ void LEDSpotlight::stopAllEffects() {
 }
 
 void LEDSpotlight::setColor(RingType ring, const Color& color, uint8_t brightness) {
-    CRGB crgb = color.toCRGB();
+    CRGB crgb = toCRGB(color);
     
     if (ring == RING_INNER || ring == RING_BOTH) {
         for (int i = 0; i < NUM_LEDS_INNER; i++) {
@@ -316,42 +951,444 @@ void LEDSpotlight::setBrightness(uint8_t brightness) {
     FastLED.setBrightness(brightness);
 }
 
+// ============================================================================
+// REALTIME (DDP über UDP)
+// ============================================================================
+
+void LEDSpotlight::receiveRealtime() {
+    // Alle wartenden Pakete abholen, damit sich im Socket nichts staut
+    uint8_t packet[DDP_HEADER_LEN + 4 + REALTIME_FRAME_BYTES];
+    
+    while (realtimeUdp.parsePacket() > 0) {
+        int length = realtimeUdp.read(packet, sizeof(packet));
+        handleRealtimePacket(packet, length);
+    }
+    
+    // Timeout → zurück zu den parametrischen Effekten
+    if (realtime.active && millis() - realtime.lastPacket > realtime.timeoutMs) {
+        realtime.active = false;
+        realtime.count = 0;
+        realtime.lastSequence = 0;
+        LOG_INFO("⏹ Realtime timeout, resuming effects");
+    }
+}
+
+void LEDSpotlight::handleRealtimePacket(const uint8_t* packet, int length) {
+    if (length < DDP_HEADER_LEN ||
+        (packet[0] & DDP_FLAG_VERSION_MASK) != DDP_FLAG_VERSION_1) {
+        realtime.packetsRejected++;
+        return;
+    }
+    
+    // Mit Timecode ist der Header 4 Bytes länger – kürzere Pakete sind kaputt
+    // (die Datenlänge liefe sonst unter null)
+    uint8_t headerLength = (packet[0] & DDP_FLAG_TIMECODE) ? DDP_HEADER_LEN + 4 : DDP_HEADER_LEN;
+    if (length < headerLength) {
+        realtime.packetsRejected++;
+        return;
+    }
+    
+    // Sequenz (4 Bit, 1..15): doppelte und veraltete Pakete verwerfen
+    uint8_t sequence = packet[1] & 0x0F;
+    if (sequence && realtime.lastSequence) {
+        uint8_t ahead = (sequence - realtime.lastSequence + 15) % 15;
+        if (ahead == 0 || ahead > 7) {
+            realtime.packetsRejected++;
+            return;
+        }
+    }
+    if (sequence) realtime.lastSequence = sequence;
+    
+    uint32_t offset = ((uint32_t)packet[4] << 24) | ((uint32_t)packet[5] << 16) |
+                      ((uint32_t)packet[6] << 8) | packet[7];
+    uint16_t dataLength = ((uint16_t)packet[8] << 8) | packet[9];
+    
+    if (length < headerLength + dataLength) dataLength = length - headerLength;
+    if (offset >= REALTIME_FRAME_BYTES) dataLength = 0;
+    else if (offset + dataLength > REALTIME_FRAME_BYTES) dataLength = REALTIME_FRAME_BYTES - offset;
+    
+    memcpy(realtime.assembly + offset, packet + headerLength, dataLength);
+    
+    if (!realtime.active) {
+        realtime.active = true;
+        LOG_INFO("▶ Realtime stream started");
+    }
+    realtime.lastPacket = millis();
+    
+    // PUSH = Frame komplett → in den Jitter-Buffer
+    if (!(packet[0] & DDP_FLAG_PUSH)) return;
+    
+    if (realtime.count == REALTIME_FRAMES) {
+        realtime.head = (realtime.head + 1) % REALTIME_FRAMES;
+        realtime.count--;
+        realtime.framesDropped++;
+    }
+    
+    RealtimeFrame& frame = realtime.frames[(realtime.head + realtime.count) % REALTIME_FRAMES];
+    memcpy(frame.data, realtime.assembly, REALTIME_FRAME_BYTES);
+    frame.receivedAt = micros();
+    realtime.count++;
+    realtime.framesReceived++;
+}
+
+bool LEDSpotlight::showRealtimeFrame(unsigned long& receivedAt) {
+    unsigned long now = micros();
+    unsigned long holdUs = (unsigned long)realtime.jitterMs * 1000;
+    
+    // Neuesten fälligen Frame suchen, ältere fällige überspringen
+    int due = -1;
+    for (uint8_t i = 0; i < realtime.count; i++) {
+        const RealtimeFrame& frame = realtime.frames[(realtime.head + i) % REALTIME_FRAMES];
+        if (now - frame.receivedAt < holdUs) break;
+        due = i;
+    }
+    if (due < 0) return false;
+    
+    const RealtimeFrame& frame = realtime.frames[(realtime.head + due) % REALTIME_FRAMES];
+    const uint8_t* data = frame.data;
+    for (int i = 0; i < NUM_LEDS_INNER; i++, data += 3) {
+        innerRing[i] = CRGB(data[0], data[1], data[2]);
+    }
+    for (int i = 0; i < NUM_LEDS_OUTER; i++, data += 3) {
+        outerRing[i] = CRGB(data[0], data[1], data[2]);
+    }
+    receivedAt = frame.receivedAt;
+    
+    realtime.framesDropped += due;
+    realtime.framesShown++;
+    realtime.head = (realtime.head + due + 1) % REALTIME_FRAMES;
+    realtime.count -= due + 1;
+    return true;
+}
+
+void LEDSpotlight::recordRealtimeLatency(unsigned long receivedAt) {
+    uint32_t latency = micros() - receivedAt;
+    
+    // Gleitender Mittelwert (1/16)
+    realtime.latencyAvgUs = realtime.framesShown == 1 ? latency :
+        (realtime.latencyAvgUs * 15 + latency) / 16;
+    if (latency > realtime.latencyMaxUs) realtime.latencyMaxUs = latency;
+}
+
+// ============================================================================
+// FRAME-TELEMETRIE
+// ============================================================================
+
+void LEDSpotlight::recordFrame(const FrameSample& sample) {
+    portENTER_CRITICAL(&telemetryMux);
+    
+    telemetry.stages[STAGE_NETWORK].record(sample.network);
+    if (sample.render) telemetry.stages[STAGE_RENDER].record(sample.render);
+    if (sample.show) telemetry.stages[STAGE_SHOW].record(sample.show);
+    if (telemetry.lastLoopStart) {
+        telemetry.stages[STAGE_PERIOD].record(sample.start - telemetry.lastLoopStart);
+    }
+    telemetry.lastLoopStart = sample.start;
+    
+    for (uint8_t r = 0; r < NUM_RENDER_RINGS; r++) {
+        for (uint8_t t = 0; t < NUM_EFFECT_TYPES; t++) {
+            if (sample.ringRender[r][t]) telemetry.render[r][t].record(sample.ringRender[r][t]);
+        }
+    }
+    
+    if (millis() - telemetry.windowStart >= TELEMETRY_WINDOW_MS) {
+        closeTelemetryWindow();
+    }
+    
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+// Fenster abschließen: Zusammenfassung merken, neues Fenster beginnen
+// (nur unter telemetryMux aufrufen)
+void LEDSpotlight::closeTelemetryWindow() {
+    for (StageTelemetry& stage : telemetry.stages) {
+        summarize(stage.window, telemetry.cpuMhz, stage.last);
+        stage.window.reset();
+    }
+    for (auto& ring : telemetry.render) {
+        for (StageTelemetry& stage : ring) {
+            summarize(stage.window, telemetry.cpuMhz, stage.last);
+            stage.window.reset();
+        }
+    }
+    telemetry.windowStart = millis();
+}
+
+void LEDSpotlight::resetTelemetry() {
+    portENTER_CRITICAL(&telemetryMux);
+    for (StageTelemetry& stage : telemetry.stages) stage = StageTelemetry();
+    for (auto& ring : telemetry.render) {
+        for (StageTelemetry& stage : ring) stage = StageTelemetry();
+    }
+    telemetry.windowStart = millis();
+    telemetry.lastLoopStart = 0;
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+// Letztes Fenster pro Messstelle (für /status)
+void LEDSpotlight::copyTelemetryStatus(StatusSnapshot& status) {
+    portENTER_CRITICAL(&telemetryMux);
+    status.telemetryEnabled = telemetry.enabled;
+    for (uint8_t i = 0; i < NUM_TELEMETRY_STAGES; i++) status.stages[i] = telemetry.stages[i].last;
+    for (uint8_t r = 0; r < NUM_RENDER_RINGS; r++) {
+        for (uint8_t t = 0; t < NUM_EFFECT_TYPES; t++) status.render[r][t] = telemetry.render[r][t].last;
+    }
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+// Letztes Fenster pro Messstelle in µs
+void LEDSpotlight::writeTelemetryStatus(JsonObject obj, const StatusSnapshot& status) {
+    auto writeSummary = [](JsonObject out, const TelemetrySummary& summary) {
+        out["count"] = summary.count;
+        out["minUs"] = summary.minNs / 1000.0f;
+        out["avgUs"] = summary.avgNs / 1000.0f;
+        out["p99Us"] = summary.p99Ns / 1000.0f;
+        out["maxUs"] = summary.maxNs / 1000.0f;
+    };
+    
+    obj["enabled"] = status.telemetryEnabled;
+    obj["windowMs"] = TELEMETRY_WINDOW_MS;
+    for (uint8_t i = 0; i < NUM_TELEMETRY_STAGES; i++) {
+        writeSummary(obj.createNestedObject(TELEMETRY_STAGE_NAMES[i]), status.stages[i]);
+    }
+    
+    // Render-Zeit pro Ring und Effekt-Typ, nur was im Fenster lief
+    JsonArray rings = obj.createNestedArray("renderByEffect");
+    for (uint8_t r = 0; r < NUM_RENDER_RINGS; r++) {
+        for (uint8_t t = 0; t < NUM_EFFECT_TYPES; t++) {
+            if (status.render[r][t].count == 0) continue;
+            JsonObject entry = rings.createNestedObject();
+            entry["ring"] = RING_NAMES[r == 0 ? RING_INNER : RING_OUTER];
+            entry["effect"] = EFFECT_NAMES[t];
+            writeSummary(entry, status.render[r][t]);
+        }
+    }
+}
+
+// ============================================================================
+// LATENZ-TRACING (siehe common/Trace.h)
+// ============================================================================
+
+void LEDSpotlight::traceApplied(const SpotlightCommand& command) {
+    // Mehr Befehle pro Frame als die Queue fasst gibt es nicht; sonst verwerfen
+    if (pendingSpanCount >= COMMAND_QUEUE_LENGTH) return;
+    
+    PendingSpan& pending = pendingSpans[pendingSpanCount++];
+    TraceSpan& span = pending.span;
+    memset(&span, 0, sizeof(span));
+    span.version = TRACE_VERSION;
+    span.traceId = command.effect.traceId;
+    span.received = command.receivedAt;
+    span.applied = showMicros();
+    strncpy(span.spotlight, spotlightId.c_str(), sizeof(span.spotlight) - 1);
+    pending.origin = command.origin;
+}
+
+// Nach dem ersten Frame mit den neuen Effekten: Spans an die Absender
+void LEDSpotlight::sendTraceSpans() {
+    uint32_t shown = showMicros();
+    
+    for (uint8_t i = 0; i < pendingSpanCount; i++) {
+        PendingSpan& pending = pendingSpans[i];
+        pending.span.shown = shown;
+        
+        traceUdp.beginPacket(IPAddress(pending.origin), TRACE_PORT);
+        traceUdp.write((const uint8_t*)&pending.span, sizeof(pending.span));
+        if (traceUdp.endPacket()) tracesSent++;
+    }
+    pendingSpanCount = 0;
+}
+
+// ============================================================================
+// SHOW-UHR
+// ============================================================================
+
+unsigned long LEDSpotlight::showClock() const {
+    return millis() + clockOffset;
+}
+
+void LEDSpotlight::setShowClock(unsigned long showTime) {
+    clockOffset = (long)(showTime - millis());
+    clockSynced = true;
+}
+
+uint32_t LEDSpotlight::showMicros() const {
+    return micros() + clockOffsetUs;
+}
+
+void LEDSpotlight::setShowMicros(uint32_t showTime) {
+    clockOffsetUs = (int32_t)(showTime - micros());
+}
+
+// ============================================================================
+// SEGMENTE
+// ============================================================================
+
+void LEDSpotlight::resetSegments() {
+    // Standard: je Ring ein Segment über alle LEDs
+    SegmentLayout layout[2] = {
+        { RING_INNER, 0, NUM_LEDS_INNER },
+        { RING_OUTER, 0, NUM_LEDS_OUTER }
+    };
+    configureSegments(layout, 2);
+}
+
+void LEDSpotlight::configureSegments(const SegmentLayout* layout, uint8_t count) {
+    numSegments = count;
+    for (uint8_t s = 0; s < count; s++) {
+        segments[s] = Segment();
+        segments[s].ring = layout[s].ring;
+        segments[s].start = layout[s].start;
+        segments[s].length = layout[s].length;
+    }
+    
+    // Neue Aufteilung startet dunkel (auch LEDs ohne Segment)
+    fill_solid(innerRing, NUM_LEDS_INNER, CRGB::Black);
+    fill_solid(outerRing, NUM_LEDS_OUTER, CRGB::Black);
+}
+
+bool LEDSpotlight::segmentMatches(uint8_t index, RingType ring, uint8_t segmentMask) {
+    // Segment-Maske hat Vorrang, sonst alle Segmente des Rings
+    if (segmentMask != 0) {
+        return (segmentMask & (1 << index)) != 0;
+    }
+    return ring == RING_BOTH || segments[index].ring == ring;
+}
+
+CRGB* LEDSpotlight::segmentLeds(const Segment& seg) {
+    return (seg.ring == RING_INNER ? innerRing : outerRing) + seg.start;
+}
+
+CRGB* LEDSpotlight::segmentFrom(const Segment& seg) {
+    return (seg.ring == RING_INNER ? innerFrom : outerFrom) + seg.start;
+}
+
 // ============================================================================
 // EFFEKT-UPDATE ENGINE
 // ============================================================================
 
-void LEDSpotlight::updateEffects() {
-    if (innerState.active) {
-        updateEffect(innerState, innerRing, NUM_LEDS_INNER);
+void LEDSpotlight::updateEffects(FrameSample* sample) {
+    // Eine Frame-Zeit für alle Segmente
+    unsigned long now = showClock();
+    
+    if (!sample) {
+        for (uint8_t s = 0; s < numSegments; s++) {
+            updateSegment(segments[s], now);
+        }
+        return;
+    }
+    
+    // Mit Telemetrie: Takte pro Segment, summiert nach Ring und Effekt-Typ
+    // (Typ vor dem Update merken – ein abgelaufener Effekt wird dabei inaktiv)
+    uint32_t renderStart = ESP.getCycleCount();
+    for (uint8_t s = 0; s < numSegments; s++) {
+        Segment& seg = segments[s];
+        uint8_t ring = seg.ring == RING_INNER ? 0 : 1;
+        uint8_t type = seg.state.active ? seg.state.effect.type : EFFECT_OFF;
+        
+        uint32_t start = ESP.getCycleCount();
+        updateSegment(seg, now);
+        sample->ringRender[ring][type] += ESP.getCycleCount() - start;
+    }
+    sample->render = ESP.getCycleCount() - renderStart;
+}
+
+void LEDSpotlight::updateSegment(Segment& seg, unsigned long now) {
+    // Effekte rendern direkt in den Ausschnitt des Rings: ein Dispatch pro
+    // Segment, keiner pro Pixel
+    EffectState& state = seg.state;
+    TransitionState& transition = seg.transition;
+    CRGB* leds = segmentLeds(seg);
+    CRGB* fromLeds = segmentFrom(seg);
+    uint8_t numLeds = seg.length;
+    
+    if (!transition.active) {
+        if (state.active) {
+            updateEffect(state, leds, numLeds, now);
+        }
+        return;
+    }
+    
+    // Auslaufenden Effekt weiterlaufen lassen (inaktiv = eingefrorener Frame)
+    if (transition.from.active) {
+        updateEffect(transition.from, fromLeds, numLeds, now);
+    }
+    
+    if (state.active) {
+        updateEffect(state, leds, numLeds, now);
+    }
+    
+    // Übergang fertig (oder neuer Effekt schon beendet) → nur noch neuer Effekt
+    long delta = (long)(now - transition.startTime);
+    unsigned long elapsed = delta > 0 ? (unsigned long)delta : 0;
+    if (!state.active || elapsed >= transition.duration) {
+        transition.active = false;
+        return;
+    }
+    
+    // Crossfade: 0 = alter Frame, 255 = neuer Frame
+    fract8 amount = (elapsed * 255) / transition.duration;
+    for (int i = 0; i < numLeds; i++) {
+        leds[i] = blend(fromLeds[i], leds[i], amount);
+    }
+}
+
+void LEDSpotlight::beginTransition(Segment& seg, uint16_t duration, unsigned long startTime) {
+    TransitionState& transition = seg.transition;
+    
+    if (duration == 0) {
+        transition.active = false;
+        return;
     }
     
-    if (outerState.active) {
-        updateEffect(outerState, outerRing, NUM_LEDS_OUTER);
+    // Aktuellen Frame übernehmen: Startbild des Übergangs, und Standbild,
+    // falls der alte Effekt bereits beendet ist
+    const CRGB* leds = segmentLeds(seg);
+    CRGB* fromLeds = segmentFrom(seg);
+    for (int i = 0; i < seg.length; i++) {
+        fromLeds[i] = leds[i];
     }
+    
+    transition.active = true;
+    transition.from = seg.state;
+    transition.startTime = startTime;
+    transition.duration = duration;
 }
 
-void LEDSpotlight::updateEffect(EffectState& state, CRGB* leds, uint8_t numLeds) {
+void LEDSpotlight::updateEffect(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                unsigned long now) {
+    // Effekte sind reine Funktionen der Zeit seit Start: gleiche Startzeit
+    // ergibt auf allen Scheinwerfern denselben Frame, unabhängig von der Loop-Rate.
+    // Geplanter Start in der Zukunft → Effekt steht auf t = 0.
+    long delta = (long)(now - state.startTime);
+    unsigned long elapsed = delta > 0 ? (unsigned long)delta : 0;
+    
+    applyAutomation(state, elapsed);
+    
     switch (state.effect.type) {
         case EFFECT_STATIC:
-            updateStatic(state, leds, numLeds);
+            updateStatic(state, leds, numLeds, elapsed);
             break;
         case EFFECT_FADE:
-            updateFade(state, leds, numLeds);
+            updateFade(state, leds, numLeds, elapsed);
             break;
         case EFFECT_STROBE:
-            updateStrobe(state, leds, numLeds);
+            updateStrobe(state, leds, numLeds, elapsed);
             break;
         case EFFECT_PULSE:
-            updatePulse(state, leds, numLeds);
+            updatePulse(state, leds, numLeds, elapsed);
             break;
         case EFFECT_ROTATION:
-            updateRotation(state, leds, numLeds);
+            updateRotation(state, leds, numLeds, elapsed);
             break;
         case EFFECT_RAINBOW:
-            updateRainbow(state, leds, numLeds);
+            updateRainbow(state, leds, numLeds, elapsed);
             break;
         case EFFECT_CHASE:
-            updateChase(state, leds, numLeds);
+            updateChase(state, leds, numLeds, elapsed);
+            break;
+        case EFFECT_PROGRAM:
+            updateProgram(state, leds, numLeds, elapsed);
             break;
         default:
             break;
@@ -362,8 +1399,9 @@ void LEDSpotlight::updateEffect(EffectState& state, CRGB* leds, uint8_t numLeds)
 // EINZELNE EFFEKTE
 // ============================================================================
 
-void LEDSpotlight::updateStatic(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    CRGB color = state.effect.color.toCRGB();
+void LEDSpotlight::updateStatic(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                unsigned long elapsed) {
+    CRGB color = toCRGB(state.effect.color);
     
     for (int i = 0; i < numLeds; i++) {
         leds[i] = color;
@@ -372,12 +1410,11 @@ void LEDSpotlight::updateStatic(EffectState& state, CRGB* leds, uint8_t numLeds)
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updateFade(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long elapsed = millis() - state.startTime;
-    
+void LEDSpotlight::updateFade(EffectState& state, CRGB* leds, uint8_t numLeds,
+                              unsigned long elapsed) {
     if (state.effect.duration > 0 && elapsed >= state.effect.duration) {
         // Fade fertig → Zielfarbe setzen
-        CRGB color = state.effect.color2.toCRGB();
+        CRGB color = toCRGB(state.effect.color2);
         for (int i = 0; i < numLeds; i++) {
             leds[i] = color;
         }
@@ -392,7 +1429,7 @@ void LEDSpotlight::updateFade(EffectState& state, CRGB* leds, uint8_t numLeds) {
     
     // Farben mischen
     Color blended = blendColor(state.effect.color, state.effect.color2, 1.0 - progress);
-    CRGB crgb = blended.toCRGB();
+    CRGB crgb = toCRGB(blended);
     
     for (int i = 0; i < numLeds; i++) {
         leds[i] = crgb;
@@ -401,10 +1438,8 @@ void LEDSpotlight::updateFade(EffectState& state, CRGB* leds, uint8_t numLeds) {
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long now = millis();
-    unsigned long elapsed = now - state.startTime;
-    
+void LEDSpotlight::updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                unsigned long elapsed) {
     // Duration prüfen
     if (state.effect.duration > 0 && elapsed >= state.effect.duration) {
         state.active = false;
@@ -415,13 +1450,22 @@ void LEDSpotlight::updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds)
     }
     
     // Strobe-Frequenz (in Hz)
-    uint16_t intervalMs = 1000 / state.effect.speed;  // speed = Hz
+    unsigned long toggles;
+    if (state.effect.automation.speed.count > 0) {
+        // Automatisierte Frequenz → Phase ist das Integral der Frequenz
+        toggles = integrateAutomation(state.effect.automation.speed, elapsed, false);
+    } else {
+        uint16_t hz = state.effect.speed > 0 ? state.effect.speed : 1;  // speed = Hz
+        uint16_t intervalMs = 1000 / hz;
+        if (intervalMs == 0) intervalMs = 1;
+        toggles = elapsed / intervalMs;
+    }
     
     // Toggle zwischen an/aus
-    bool on = ((now / intervalMs) % 2) == 0;
+    bool on = (toggles % 2) == 0;
     
     if (on) {
-        CRGB color = state.effect.color.toCRGB();
+        CRGB color = toCRGB(state.effect.color);
         for (int i = 0; i < numLeds; i++) {
             leds[i] = color;
         }
@@ -434,40 +1478,44 @@ void LEDSpotlight::updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds)
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updatePulse(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long now = millis();
-    
+void LEDSpotlight::updatePulse(EffectState& state, CRGB* leds, uint8_t numLeds,
+                               unsigned long elapsed) {
     // Puls-Zyklus (duration = Länge eines kompletten Zyklus)
     uint16_t cycleDuration = state.effect.duration > 0 ? state.effect.duration : 2000;
-    unsigned long cyclePosition = (now - state.startTime) % cycleDuration;
+    unsigned long cyclePosition = elapsed % cycleDuration;
     
     // Sinus-Welle für Breathing-Effekt
     float phase = (float)cyclePosition / cycleDuration * 2.0 * PI;
     float brightness = (sin(phase) + 1.0) / 2.0;  // 0.0 - 1.0
     
-    CRGB color = state.effect.color.toCRGB();
+    CRGB color = toCRGB(state.effect.color);
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
-        leds[i] = color;
+        leds[i] = palette ? (*palette)[i * 256 / numLeds] : color;
         leds[i].fadeToBlackBy(255 * (1.0 - brightness));
     }
     
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updateRotation(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long now = millis();
+void LEDSpotlight::updateRotation(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                  unsigned long elapsed) {
+    // Position direkt aus der Zeit (kein Aufsummieren von Steps → kein Drift)
+    unsigned long steps;
+    if (state.effect.automation.speed.count > 0) {
+        // Automatisierte Geschwindigkeit → Steps über die Kurve integrieren
+        steps = integrateAutomation(state.effect.automation.speed, elapsed, true);
+    } else {
+        uint16_t stepMs = state.effect.rotation.speed > 0 ? state.effect.rotation.speed : 1;
+        steps = elapsed / stepMs;
+    }
+    steps %= numLeds;
     
-    // Zeit für nächsten Step?
-    if (now - state.lastUpdate >= state.effect.rotation.speed) {
-        state.lastUpdate = now;
-        
-        // Position aktualisieren
-        if (state.effect.rotation.direction == DIRECTION_CLOCKWISE) {
-            state.position = (state.position + 1) % numLeds;
-        } else {
-            state.position = (state.position - 1 + numLeds) % numLeds;
-        }
+    if (state.effect.rotation.direction == DIRECTION_CLOCKWISE) {
+        state.position = steps;
+    } else {
+        state.position = (numLeds - steps) % numLeds;
     }
     
     // Pattern rendern
@@ -492,24 +1540,33 @@ void LEDSpotlight::updateRotation(EffectState& state, CRGB* leds, uint8_t numLed
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updateRainbow(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long now = millis();
-    uint8_t hue = (now / 10) % 256;  // Langsame Rotation durch Farbraum
+void LEDSpotlight::updateRainbow(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                 unsigned long elapsed) {
+    uint8_t hue = (elapsed / 10) % 256;  // Langsame Rotation durch Farbraum
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
-        leds[i] = CHSV(hue + (i * 256 / numLeds), 255, 255);
+        uint8_t index = hue + (i * 256 / numLeds);
+        if (palette) {
+            leds[i] = (*palette)[index];
+        } else {
+            leds[i] = CHSV(index, 255, 255);
+        }
     }
     
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
 
-void LEDSpotlight::updateChase(EffectState& state, CRGB* leds, uint8_t numLeds) {
-    unsigned long now = millis();
-    
-    if (now - state.lastUpdate >= state.effect.speed) {
-        state.lastUpdate = now;
-        state.position = (state.position + 1) % numLeds;
+void LEDSpotlight::updateChase(EffectState& state, CRGB* leds, uint8_t numLeds,
+                               unsigned long elapsed) {
+    unsigned long steps;
+    if (state.effect.automation.speed.count > 0) {
+        steps = integrateAutomation(state.effect.automation.speed, elapsed, true);
+    } else {
+        uint16_t stepMs = state.effect.speed > 0 ? state.effect.speed : 1;
+        steps = elapsed / stepMs;
     }
+    state.position = steps % numLeds;
     
     // Alle auf inaktiv
     for (int i = 0; i < numLeds; i++) {
@@ -517,7 +1574,19 @@ void LEDSpotlight::updateChase(EffectState& state, CRGB* leds, uint8_t numLeds)
     }
     
     // Aktive Position
-    leds[state.position] = state.effect.color.toCRGB();
+    const CRGBPalette256* palette = effectPalette(state);
+    leds[state.position] = palette ?
+        (*palette)[state.position * 256 / numLeds] : toCRGB(state.effect.color);
+    
+    applyBrightness(leds, numLeds, state.effect.brightness);
+}
+
+void LEDSpotlight::updateProgram(EffectState& state, CRGB* leds, uint8_t numLeds,
+                                 unsigned long elapsed) {
+    uint8_t ring = (state.effect.ring == RING_OUTER) ? 1 : 0;
+    
+    programs[state.effect.program].render(leds, numLeds, ring, elapsed,
+                                          state.effect.programParams);
     
     applyBrightness(leds, numLeds, state.effect.brightness);
 }
@@ -527,12 +1596,13 @@ void LEDSpotlight::updateChase(EffectState& state, CRGB* leds, uint8_t numLeds)
 // ============================================================================
 
 void LEDSpotlight::renderRotationSingle(CRGB* leds, uint8_t numLeds, const EffectState& state) {
-    CRGB activeColor = state.effect.rotation.activeColor.toCRGB();
-    CRGB inactiveColor = state.effect.rotation.inactiveColor.toCRGB();
+    CRGB activeColor = toCRGB(state.effect.rotation.activeColor);
+    CRGB inactiveColor = toCRGB(state.effect.rotation.inactiveColor);
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
         if (i == state.position) {
-            leds[i] = activeColor;
+            leds[i] = palette ? (*palette)[i * 256 / numLeds] : activeColor;
         } else {
             leds[i] = inactiveColor;
         }
@@ -540,21 +1610,23 @@ void LEDSpotlight::renderRotationSingle(CRGB* leds, uint8_t numLeds, const Effec
 }
 
 void LEDSpotlight::renderRotationTrail(CRGB* leds, uint8_t numLeds, const EffectState& state) {
-    CRGB activeColor = state.effect.rotation.activeColor.toCRGB();
-    CRGB inactiveColor = state.effect.rotation.inactiveColor.toCRGB();
+    CRGB activeColor = toCRGB(state.effect.rotation.activeColor);
+    CRGB inactiveColor = toCRGB(state.effect.rotation.inactiveColor);
     uint8_t trailLength = state.effect.rotation.trailLength;
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
         // Distanz von aktueller Position berechnen
         int distance = (state.position - i + numLeds) % numLeds;
+        CRGB color = palette ? (*palette)[i * 256 / numLeds] : activeColor;
         
         if (distance == 0) {
             // Hauptpunkt: Volle Helligkeit
-            leds[i] = activeColor;
+            leds[i] = color;
         } else if (distance <= trailLength) {
             // Schweif: Fade
             float fade = 1.0 - ((float)distance / trailLength);
-            leds[i] = blendCRGB(activeColor, inactiveColor, fade);
+            leds[i] = blendCRGB(color, inactiveColor, fade);
         } else {
             leds[i] = inactiveColor;
         }
@@ -562,14 +1634,15 @@ void LEDSpotlight::renderRotationTrail(CRGB* leds, uint8_t numLeds, const Effect
 }
 
 void LEDSpotlight::renderRotationOpposite(CRGB* leds, uint8_t numLeds, const EffectState& state) {
-    CRGB activeColor = state.effect.rotation.activeColor.toCRGB();
-    CRGB inactiveColor = state.effect.rotation.inactiveColor.toCRGB();
+    CRGB activeColor = toCRGB(state.effect.rotation.activeColor);
+    CRGB inactiveColor = toCRGB(state.effect.rotation.inactiveColor);
     
     uint8_t oppositePos = (state.position + numLeds / 2) % numLeds;
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
         if (i == state.position || i == oppositePos) {
-            leds[i] = activeColor;
+            leds[i] = palette ? (*palette)[i * 256 / numLeds] : activeColor;
         } else {
             leds[i] = inactiveColor;
         }
@@ -577,21 +1650,184 @@ void LEDSpotlight::renderRotationOpposite(CRGB* leds, uint8_t numLeds, const Eff
 }
 
 void LEDSpotlight::renderRotationWave(CRGB* leds, uint8_t numLeds, const EffectState& state) {
-    CRGB activeColor = state.effect.rotation.activeColor.toCRGB();
-    CRGB inactiveColor = state.effect.rotation.inactiveColor.toCRGB();
+    CRGB activeColor = toCRGB(state.effect.rotation.activeColor);
+    CRGB inactiveColor = toCRGB(state.effect.rotation.inactiveColor);
     uint8_t waveLength = 3;  // Anzahl aktiver LEDs
+    const CRGBPalette256* palette = effectPalette(state);
     
     for (int i = 0; i < numLeds; i++) {
         int distance = (i - state.position + numLeds) % numLeds;
         
         if (distance < waveLength) {
-            leds[i] = activeColor;
+            leds[i] = palette ? (*palette)[i * 256 / numLeds] : activeColor;
         } else {
             leds[i] = inactiveColor;
         }
     }
 }
 
+// ============================================================================
+// AUTOMATION
+// ============================================================================
+
+void LEDSpotlight::applyAutomation(EffectState& state, unsigned long elapsed) {
+    EffectAutomation& autom = state.effect.automation;
+    
+    if (autom.brightness.count > 0) {
+        state.effect.brightness = evaluateAutomation(autom.brightness, elapsed, false);
+    }
+    if (autom.color.count > 0) {
+        uint32_t rgb = evaluateAutomation(autom.color, elapsed, true);
+        Color color(rgb >> 16, rgb >> 8, rgb);
+        state.effect.color = color;
+        state.effect.rotation.activeColor = color;
+    }
+    if (autom.speed.count > 0) {
+        uint16_t speed = evaluateAutomation(autom.speed, elapsed, false);
+        state.effect.speed = speed;
+        state.effect.rotation.speed = speed;
+    }
+    if (autom.trailLength.count > 0) {
+        state.effect.rotation.trailLength = evaluateAutomation(autom.trailLength, elapsed, false);
+    }
+}
+
+uint32_t LEDSpotlight::evaluateAutomation(const Automation& curve, unsigned long elapsed, bool isColor) {
+    const Keyframe* keys = curve.keys;
+    uint32_t period = keys[curve.count - 1].time;
+    unsigned long t = (curve.loop && period > 0) ? elapsed % period : elapsed;
+    
+    if (t <= keys[0].time) return keys[0].value;
+    
+    for (uint8_t i = 1; i < curve.count; i++) {
+        if (t >= keys[i].time) continue;
+        
+        float p = interpolateKeyframe(keys[i - 1], keys[i], t);
+        uint32_t a = keys[i - 1].value;
+        uint32_t b = keys[i].value;
+        
+        if (!isColor) {
+            return a + ((float)b - (float)a) * p;
+        }
+        
+        // Farbe kanalweise mischen
+        uint32_t result = 0;
+        for (int shift = 16; shift >= 0; shift -= 8) {
+            float ca = (a >> shift) & 0xFF;
+            float cb = (b >> shift) & 0xFF;
+            result |= (uint32_t)(ca + (cb - ca) * p) << shift;
+        }
+        return result;
+    }
+    
+    return keys[curve.count - 1].value;
+}
+
+float LEDSpotlight::interpolateKeyframe(const Keyframe& from, const Keyframe& to, unsigned long t) {
+    if (to.easing == EASING_STEP) return 0.0;
+    
+    float p = (float)(t - from.time) / (to.time - from.time);
+    
+    if (to.easing == EASING_IN_OUT) {
+        p = (p < 0.5) ? 2.0 * p * p : 1.0 - 2.0 * (1.0 - p) * (1.0 - p);
+    }
+    
+    return p;
+}
+
+// Anzahl Steps/Toggles von 0 bis elapsed, wenn der Parameter der Kurve folgt.
+// periodMs = true: Wert ist ms pro Step (Rotation, Chase) → Rate 1/Wert
+// periodMs = false: Wert ist Frequenz in Hz (Strobe) → Rate Wert/1000
+// Stetig und zeitdeterministisch: kein Phasensprung bei Geschwindigkeitsänderung.
+float LEDSpotlight::integrateAutomation(const Automation& curve, unsigned long elapsed, bool periodMs) {
+    uint32_t period = curve.keys[curve.count - 1].time;
+    
+    if (curve.loop && period > 0) {
+        unsigned long cycles = elapsed / period;
+        return cycles * integrateSpan(curve, period, periodMs) +
+               integrateSpan(curve, elapsed % period, periodMs);
+    }
+    
+    return integrateSpan(curve, elapsed, periodMs);
+}
+
+float LEDSpotlight::integrateSpan(const Automation& curve, unsigned long t, bool periodMs) {
+    float sum = 0.0;
+    unsigned long segStart = 0;
+    float v0 = curve.keys[0].value;
+    
+    for (uint8_t i = 0; i <= curve.count; i++) {
+        // Nach dem letzten Keyframe: Wert bleibt konstant
+        bool last = (i == curve.count);
+        unsigned long segEnd = last ? t : min(t, (unsigned long)curve.keys[i].time);
+        
+        float v1 = v0;
+        if (!last && i > 0 && segEnd > segStart) {
+            float p = interpolateKeyframe(curve.keys[i - 1], curve.keys[i], segEnd);
+            v1 = curve.keys[i - 1].value + ((float)curve.keys[i].value - curve.keys[i - 1].value) * p;
+        }
+        
+        // Segment [segStart, segEnd] linear von v0 nach v1 integrieren
+        // (In-Out-Easing wird dabei linear angenähert)
+        float span = segEnd - segStart;
+        if (span > 0) {
+            if (periodMs) {
+                float a = max(v0, 1.0f);
+                float b = max(v1, 1.0f);
+                sum += (fabs(b - a) < 0.5) ? span / a : span * log(b / a) / (b - a);
+            } else {
+                sum += span * (v0 + v1) / 2000.0;
+            }
+        }
+        
+        if (last || segEnd >= t) break;
+        
+        segStart = segEnd;
+        v0 = curve.keys[i].value;
+    }
+    
+    return sum;
+}
+
+// ============================================================================
+// PROGRAMME & PALETTEN
+// ============================================================================
+
+// Aufrufer hält den State-Lock (wie bei configureSegments)
+void LEDSpotlight::setProgram(uint8_t slot, const PixelProgram& program) {
+    if (slot >= MAX_PROGRAMS) return;
+    programs[slot] = program;
+}
+
+void LEDSpotlight::setPalette(uint8_t id, const CRGB* stops, uint8_t numStops, const char* name) {
+    if (id < 1 || id > MAX_PALETTES || numStops == 0) return;
+    numStops = min(numStops, (uint8_t)PALETTE_STOPS);
+    
+    // Weniger als 16 Farben → gleichmäßig auf 16 Stützstellen verteilen
+    CRGBPalette16 palette16;
+    for (int k = 0; k < PALETTE_STOPS; k++) {
+        uint16_t pos = k * (numStops - 1) * 256 / (PALETTE_STOPS - 1);
+        uint8_t index = pos >> 8;
+        uint8_t frac = pos & 0xFF;
+        palette16[k] = (index + 1 < numStops) ?
+            blend(stops[index], stops[index + 1], frac) : stops[numStops - 1];
+    }
+    
+    // 256er-Tabelle einmalig vorberechnen
+    Palette& palette = palettes[id - 1];
+    palette.table = palette16;
+    palette.name = name ? name : "";
+    palette.loaded = true;
+}
+
+const CRGBPalette256* LEDSpotlight::effectPalette(const EffectState& state) {
+    uint8_t id = state.effect.palette;
+    if (id < 1 || id > MAX_PALETTES || !palettes[id - 1].loaded) {
+        return nullptr;
+    }
+    return &palettes[id - 1].table;
+}
+
 // ============================================================================
 // HILFSFUNKTIONEN
 // ============================================================================
@@ -622,23 +1858,127 @@ void LEDSpotlight::applyBrightness(CRGB* leds, uint8_t numLeds, uint8_t brightne
     }
 }
 
+// Alles, was Loop-Task und Handler unter dem State-Lock ändern
+void LEDSpotlight::copyStatus(StatusSnapshot& status) {
+    status.showClock = showClock();
+    status.clockSynced = clockSynced;
+    
+    // Zusammenfassung pro Ring (aktiv, wenn ein Segment aktiv ist)
+    for (int r = 0; r < 2; r++) {
+        RingType ring = (r == 0) ? RING_INNER : RING_OUTER;
+        const EffectState* activeState = nullptr;
+        bool transition = false;
+        
+        for (uint8_t s = 0; s < numSegments; s++) {
+            if (segments[s].ring != ring) continue;
+            if (segments[s].state.active && !activeState) activeState = &segments[s].state;
+            transition |= segments[s].transition.active;
+        }
+        
+        status.ringActive[r] = activeState != nullptr;
+        status.ringTransition[r] = transition;
+        status.ringEffect[r] = activeState ? activeState->effect.type : EFFECT_OFF;
+    }
+    
+    status.numSegments = numSegments;
+    for (uint8_t s = 0; s < numSegments; s++) {
+        status.segments[s] = { segments[s].ring, segments[s].start, segments[s].length,
+                               segments[s].state.active };
+    }
+    
+    status.commandsQueued = commandsQueued;
+    status.commandsDropped = commandsDropped;
+    status.tracesSent = tracesSent;
+    
+    status.realtimeActive = realtime.active;
+    status.realtimeJitterMs = realtime.jitterMs;
+    status.framesReceived = realtime.framesReceived;
+    status.framesShown = realtime.framesShown;
+    status.framesDropped = realtime.framesDropped;
+    status.packetsRejected = realtime.packetsRejected;
+    status.latencyAvgUs = realtime.latencyAvgUs;
+    status.latencyMaxUs = realtime.latencyMaxUs;
+    
+    for (int i = 0; i < MAX_PALETTES; i++) {
+        status.paletteLoaded[i] = palettes[i].loaded;
+        if (palettes[i].loaded) status.paletteNames[i] = palettes[i].name;
+    }
+}
+
 String LEDSpotlight::getStatusJson() {
-    StaticJsonDocument<512> doc;
+    // Kopie unter Lock (mit Telemetrie ~1 KB, daher Heap statt Stack),
+    // das Dokument wird ohne Lock gebaut
+    StatusSnapshot* status = new StatusSnapshot();
+    lockState();
+    copyStatus(*status);
+    unlockState();
+    copyTelemetryStatus(*status);
+    
+    // Heap statt Stack: mit Telemetrie zu groß für den Netzwerk-Task
+    DynamicJsonDocument doc(4096);
     
     doc["id"] = spotlightId;
     doc["ip"] = WiFi.localIP().toString();
     doc["rssi"] = WiFi.RSSI();
     doc["uptime"] = millis();
+    doc["freeHeap"] = ESP.getFreeHeap();
+    doc["minFreeHeap"] = ESP.getMinFreeHeap();
+    doc["largestFreeBlock"] = ESP.getMaxAllocHeap();
+    doc["showClock"] = status->showClock;
+    doc["clockSynced"] = status->clockSynced;
+    
+    const char* ringNames[2] = { "innerRing", "outerRing" };
+    for (int r = 0; r < 2; r++) {
+        JsonObject obj = doc.createNestedObject(ringNames[r]);
+        obj["active"] = status->ringActive[r];
+        obj["transition"] = status->ringTransition[r];
+        obj["effect"] = status->ringActive[r] ? EFFECT_NAMES[status->ringEffect[r]] : "off";
+    }
     
-    JsonObject inner = doc.createNestedObject("innerRing");
-    inner["active"] = innerState.active;
-    inner["effect"] = innerState.active ? 
-        (innerState.effect.type == EFFECT_ROTATION ? "rotation" : "other") : "off";
+    // Segmente
+    JsonArray segs = doc.createNestedArray("segments");
+    for (uint8_t s = 0; s < status->numSegments; s++) {
+        JsonObject seg = segs.createNestedObject();
+        seg["ring"] = RING_NAMES[status->segments[s].ring];
+        seg["start"] = status->segments[s].start;
+        seg["length"] = status->segments[s].length;
+        seg["active"] = status->segments[s].active;
+    }
     
-    JsonObject outer = doc.createNestedObject("outerRing");
-    outer["active"] = outerState.active;
-    outer["effect"] = outerState.active ? 
-        (outerState.effect.type == EFFECT_ROTATION ? "rotation" : "other") : "off";
+    // Befehls-Queue
+    doc["commandsQueued"] = status->commandsQueued;
+    doc["commandsDropped"] = status->commandsDropped;
+    
+    // Latenz-Tracing
+    doc["tracesSent"] = status->tracesSent;
+    
+    // Log-Puffer
+    doc["logsWritten"] = logBuffer.written();
+    doc["logsLost"] = logBuffer.lostRecords();
+    
+    // Frame-Telemetrie (letztes Fenster)
+    writeTelemetryStatus(doc.createNestedObject("telemetry"), *status);
+    
+    // Realtime-Stream
+    JsonObject rt = doc.createNestedObject("realtime");
+    rt["active"] = status->realtimeActive;
+    rt["jitterMs"] = status->realtimeJitterMs;
+    rt["framesReceived"] = status->framesReceived;
+    rt["framesShown"] = status->framesShown;
+    rt["framesDropped"] = status->framesDropped;
+    rt["packetsRejected"] = status->packetsRejected;
+    rt["latencyAvgUs"] = status->latencyAvgUs;
+    rt["latencyMaxUs"] = status->latencyMaxUs;
+    
+    // Geladene Paletten
+    JsonArray pals = doc.createNestedArray("palettes");
+    for (int i = 0; i < MAX_PALETTES; i++) {
+        if (!status->paletteLoaded[i]) continue;
+        JsonObject pal = pals.createNestedObject();
+        pal["id"] = i + 1;
+        pal["name"] = status->paletteNames[i];
+    }
+    delete status;
     
     String output;
     serializeJson(doc, output);
@@ -2,10 +2,19 @@
 #define LED_SPOTLIGHT_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <WiFiUdp.h>
+#include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include "PixelProgram.h"
+#include "Protocol.h"
+#include "Log.h"
+#include "EffectParser.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include "MemoryStats.h"
 
 // ============================================================================
 // PIN KONFIGURATION
@@ -17,112 +26,271 @@
 #define NUM_LEDS_INNER    8       // 8 LEDs im inneren Ring
 #define NUM_LEDS_OUTER    24      // 26 LEDs im äußeren Ring
 
+// ============================================================================
+// PALETTEN
+// ============================================================================
+
+#define MAX_PALETTES      8       // Paletten-IDs 1..8 (0 = keine Palette)
+#define PALETTE_STOPS     16      // Stützstellen pro Palette
+
+// ============================================================================
+// HTTP (Async-Server)
+// ============================================================================
+
+#define MAX_REQUEST_BODY      BATCH_JSON_SIZE   // Größere Bodies: 413
+#define COMMAND_QUEUE_LENGTH  8       // Effekt-/Stop-Befehle zwischen Netzwerk und Render-Loop
+#define BATCH_TIMEOUT_MS      1000    // Unvollständiger Batch wird danach verworfen
+
+// ============================================================================
+// REALTIME (UDP-Pixelstream im DDP-Format)
+// ============================================================================
+
+#define REALTIME_PORT         4048    // DDP-Standardport
+#define REALTIME_FRAMES       4       // Tiefe des Jitter-Buffers
+#define REALTIME_TIMEOUT_MS   2500    // Ohne Frames → zurück zum letzten Effekt
+#define REALTIME_FRAME_BYTES  ((NUM_LEDS_INNER + NUM_LEDS_OUTER) * 3)   // innen, dann außen
+
+#define DDP_HEADER_LEN        10
+#define DDP_FLAG_VERSION_MASK 0xC0
+#define DDP_FLAG_VERSION_1    0x40
+#define DDP_FLAG_TIMECODE     0x10
+#define DDP_FLAG_PUSH         0x01
+
 // ============================================================================
 // STRUKTUREN & ENUMS
 // ============================================================================
 
-// Ring-Typ
-enum RingType {
-    RING_INNER,
-    RING_OUTER,
-    RING_BOTH
+// Effekt-Typen, Color, RotationParams, Automation und Effect: siehe
+// common/Protocol.h (gemeinsam mit dem Commander)
+
+inline CRGB toCRGB(const Color& color) {
+    return CRGB(color.r, color.g, color.b);
+}
+
+// Farbpalette: 16 Stützstellen, beim Upload einmal auf 256 Einträge
+// vorberechnet → pro Pixel nur ein Tabellenzugriff
+struct Palette {
+    bool loaded;
+    String name;
+    CRGBPalette256 table;
+    
+    Palette() : loaded(false) {}
 };
 
-// Effekt-Typen
-enum EffectType {
-    EFFECT_STATIC,
-    EFFECT_FADE,
-    EFFECT_STROBE,
-    EFFECT_PULSE,
-    EFFECT_ROTATION,
-    EFFECT_RAINBOW,
-    EFFECT_CHASE,
-    EFFECT_OFF
+// Effekt-State (für laufende Effekte)
+struct EffectState {
+    bool active;
+    Effect effect;
+    unsigned long startTime; // Show-Uhr; alle Effekte rechnen mit (jetzt - startTime)
+    uint8_t phase;          // Für verschiedene Effekt-Phasen
+    uint8_t position;       // Für Rotation (aus der Zeit abgeleitet)
+    
+    EffectState() :
+        active(false),
+        startTime(0),
+        phase(0),
+        position(0) {}
+};
+
+// Überblend-State (auslaufender Effekt während eines Übergangs)
+struct TransitionState {
+    bool active;
+    EffectState from;       // Auslaufender Effekt, wird weiter gerendert
+    unsigned long startTime;
+    uint16_t duration;
+    
+    TransitionState() :
+        active(false),
+        startTime(0),
+        duration(0) {}
+};
+
+// Segment-Aufteilung (Bereich eines Rings)
+struct SegmentLayout {
+    RingType ring;          // RING_INNER oder RING_OUTER
+    uint8_t start;
+    uint8_t length;
+};
+
+// Segment: zusammenhängender Bereich eines Rings mit eigenem Effekt
+struct Segment {
+    RingType ring;
+    uint8_t start;
+    uint8_t length;
+    EffectState state;
+    TransitionState transition;
+    
+    Segment() : ring(RING_INNER), start(0), length(0) {}
 };
 
-// Rotations-Pattern
-enum RotationPattern {
-    PATTERN_SINGLE,
-    PATTERN_TRAIL,
-    PATTERN_OPPOSITE,
-    PATTERN_WAVE,
-    PATTERN_RAINBOW_CHASE
+// Realtime-Frame im Jitter-Buffer
+struct RealtimeFrame {
+    uint8_t data[REALTIME_FRAME_BYTES];
+    unsigned long receivedAt;   // micros() beim letzten Paket des Frames
 };
 
-// Rotations-Richtung
-enum RotationDirection {
-    DIRECTION_CLOCKWISE,
-    DIRECTION_COUNTERCLOCKWISE
+// Realtime-State: Empfang, Jitter-Buffer, Statistik
+struct RealtimeState {
+    bool active;
+    uint8_t lastSequence;       // DDP-Sequenz 1..15 (0 = keine)
+    unsigned long lastPacket;   // millis()
+    uint16_t jitterMs;          // Verzögerung vor der Ausgabe (glättet Netz-Jitter)
+    uint16_t timeoutMs;
+    
+    // Jitter-Buffer (Ringpuffer, ältester Frame bei head)
+    RealtimeFrame frames[REALTIME_FRAMES];
+    uint8_t head;
+    uint8_t count;
+    uint8_t assembly[REALTIME_FRAME_BYTES];   // Frame im Aufbau (Pakete mit Offset)
+    
+    // Statistik
+    uint32_t framesReceived;
+    uint32_t framesShown;
+    uint32_t framesDropped;     // Buffer voll oder beim Aufholen übersprungen
+    uint32_t packetsRejected;   // Doppelt, veraltet oder fehlerhaft
+    uint32_t latencyAvgUs;      // Empfang → FastLED.show()
+    uint32_t latencyMaxUs;
+    
+    RealtimeState() :
+        active(false),
+        lastSequence(0),
+        lastPacket(0),
+        jitterMs(0),
+        timeoutMs(REALTIME_TIMEOUT_MS),
+        head(0),
+        count(0),
+        assembly(),
+        framesReceived(0),
+        framesShown(0),
+        framesDropped(0),
+        packetsRejected(0),
+        latencyAvgUs(0),
+        latencyMaxUs(0) {}
 };
 
-// Farb-Struktur
-struct Color {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
+// Frame-Telemetrie einer Messstelle (Werte in CPU-Takten)
+struct StageTelemetry {
+    Histogram window;           // Laufendes Fenster
+    Histogram total;            // Seit Einschalten/Reset
+    TelemetrySummary last;      // Letztes abgeschlossenes Fenster
     
-    Color() : r(0), g(0), b(0) {}
-    Color(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    StageTelemetry() : last() {}
     
-    CRGB toCRGB() const {
-        return CRGB(r, g, b);
+    void record(uint32_t cycles) {
+        window.record(cycles);
+        total.record(cycles);
     }
 };
 
-// Rotation-Parameter
-struct RotationParams {
-    Color activeColor;
-    Color inactiveColor;
-    uint16_t speed;
-    RotationDirection direction;
-    RotationPattern pattern;
-    uint8_t trailLength;
+// Frame-Telemetrie der Render-Loop (siehe common/Telemetry.h)
+struct FrameTelemetry {
+    bool enabled;               // Aus = pro Messpunkt nur ein Branch
+    uint16_t cpuMhz;
+    unsigned long windowStart;  // millis()
+    uint32_t lastLoopStart;     // CPU-Takte, 0 = noch kein Durchlauf
+    StageTelemetry stages[NUM_TELEMETRY_STAGES];
+    StageTelemetry render[NUM_RENDER_RINGS][NUM_EFFECT_TYPES];
     
-    RotationParams() :
-        activeColor(255, 0, 0),
-        inactiveColor(0, 0, 0),
-        speed(100),
-        direction(DIRECTION_CLOCKWISE),
-        pattern(PATTERN_SINGLE),
-        trailLength(3) {}
+    FrameTelemetry() :
+        enabled(false),
+        cpuMhz(240),
+        windowStart(0),
+        lastLoopStart(0) {}
 };
 
-// Basis-Effekt
-struct Effect {
-    EffectType type;
-    RingType ring;
-    Color color;
-    Color color2;
-    uint8_t brightness;
-    uint16_t speed;
-    uint16_t duration;
-    RotationParams rotation;
+// Messwerte eines Loop-Durchlaufs (CPU-Takte, 0 = nicht gemessen)
+struct FrameSample {
+    uint32_t start;
+    uint32_t network;
+    uint32_t render;
+    uint32_t show;
+    uint32_t ringRender[NUM_RENDER_RINGS][NUM_EFFECT_TYPES];
     
-    Effect() :
-        type(EFFECT_OFF),
-        ring(RING_BOTH),
-        color(0, 0, 0),
-        color2(0, 0, 0),
-        brightness(255),
-        speed(100),
-        duration(0) {}
+    FrameSample() :
+        start(0),
+        network(0),
+        render(0),
+        show(0),
+        ringRender() {}
 };
 
-// Effekt-State (für laufende Effekte)
-struct EffectState {
+// Segment-Auszug für /status
+struct SegmentStatus {
+    RingType ring;
+    uint8_t start;
+    uint8_t length;
     bool active;
-    Effect effect;
-    unsigned long startTime;
-    unsigned long lastUpdate;
-    uint8_t phase;          // Für verschiedene Effekt-Phasen
-    uint8_t position;       // Für Rotation
+};
+
+// Kopie des Zustands für /status: unter Lock kopiert, das JSON wird erst
+// danach gebaut (Render-Loop wartet nicht auf die Serialisierung)
+struct StatusSnapshot {
+    unsigned long showClock;
+    bool clockSynced;
     
-    EffectState() :
-        active(false),
-        startTime(0),
-        lastUpdate(0),
-        phase(0),
-        position(0) {}
+    // Pro Ring (Index 0 = innen): aktiv, wenn ein Segment aktiv ist
+    bool ringActive[2];
+    bool ringTransition[2];
+    EffectType ringEffect[2];
+    
+    SegmentStatus segments[MAX_SEGMENTS];
+    uint8_t numSegments;
+    
+    uint32_t commandsQueued;
+    uint32_t commandsDropped;
+    uint32_t tracesSent;
+    
+    // Frame-Telemetrie, letztes Fenster
+    bool telemetryEnabled;
+    TelemetrySummary stages[NUM_TELEMETRY_STAGES];
+    TelemetrySummary render[NUM_RENDER_RINGS][NUM_EFFECT_TYPES];
+    
+    // Realtime-Stream (ohne Frames)
+    bool realtimeActive;
+    uint16_t realtimeJitterMs;
+    uint32_t framesReceived;
+    uint32_t framesShown;
+    uint32_t framesDropped;
+    uint32_t packetsRejected;
+    uint32_t latencyAvgUs;
+    uint32_t latencyMaxUs;
+    
+    String paletteNames[MAX_PALETTES];  // Leer = nicht geladen
+    bool paletteLoaded[MAX_PALETTES];
+};
+
+// Befehl vom Netzwerk-Task an die Render-Loop
+enum CommandType {
+    COMMAND_EFFECT,
+    COMMAND_STOP
+};
+
+struct SpotlightCommand {
+    CommandType type;
+    Effect effect;          // COMMAND_EFFECT
+    RingType ring;          // COMMAND_STOP
+    uint8_t segmentMask;    // COMMAND_STOP
+    uint32_t receivedAt;    // Tracing: µs Show-Uhr beim Dekodieren
+    uint32_t origin;        // Tracing: IPv4 des Absenders (Empfänger des Spans)
+    uint32_t batchId;       // Teil eines Batches (POST /batch), 0 = einzeln
+    uint8_t batchSize;      // Teile dieses Batches
+    unsigned long applyAt;  // Batch: Show-Uhr, ab der alle Teile gelten (0 = sofort)
+    
+    SpotlightCommand() :
+        type(COMMAND_EFFECT),
+        ring(RING_BOTH),
+        segmentMask(0),
+        receivedAt(0),
+        origin(0),
+        batchId(0),
+        batchSize(0),
+        applyAt(0) {}
+};
+
+// Span, der nach dem nächsten Frame an den Commander geht
+struct PendingSpan {
+    TraceSpan span;
+    uint32_t origin;
 };
 
 // ============================================================================
@@ -139,7 +307,7 @@ public:
     
     // Effekt-Steuerung
     void setEffect(const Effect& effect);
-    void stopEffect(RingType ring = RING_BOTH);
+    void stopEffect(RingType ring = RING_BOTH, uint8_t segmentMask = 0);
     void stopAllEffects();
     
     // LED-Steuerung
@@ -147,12 +315,46 @@ public:
     void clear(RingType ring = RING_BOTH);
     void setBrightness(uint8_t brightness);
     
-    // Status
+    // Segmente
+    void resetSegments();
+    void configureSegments(const SegmentLayout* layout, uint8_t count);
+    
+    // Programme & Paletten (geprüft bzw. 1..PALETTE_STOPS Farben)
+    void setProgram(uint8_t slot, const PixelProgram& program);
+    void setPalette(uint8_t id, const CRGB* stops, uint8_t numStops, const char* name);
+    
+    // Show-Uhr (mit dem Commander synchronisiert)
+    unsigned long showClock() const;
+    void setShowClock(unsigned long showTime);
+    uint32_t showMicros() const;    // µs, für Tracing (Commander-micros())
+    void setShowMicros(uint32_t showTime);
+    
+    // Status (nimmt den State-Lock selbst)
     String getStatusJson();
     
 private:
     // Netzwerk
-    WebServer server;
+    AsyncWebServer server;
+    WiFiUDP realtimeUdp;
+    
+    // Übergabe Netzwerk-Task → Render-Loop
+    QueueHandle_t commandQueue;     // Effekt-/Stop-Befehle
+    SemaphoreHandle_t stateMutex;   // Segmente, Paletten, Programme
+    uint32_t commandsQueued;
+    std::atomic<uint32_t> commandsDropped;     // Netzwerk-Task und Render-Loop
+    uint32_t nextBatchId;           // Nur Netzwerk-Task
+    
+    // Zuletzt angenommener Effekt pro Ring: Basis für /effect/delta (nur
+    // Netzwerk-Task). Ungültig nach dem Start und nach Segment-Effekten.
+    Effect received[2];
+    bool receivedValid[2];
+    
+    // Batch-Teile warten hier auf Vollständigkeit und Show-Zeit (nur in loop())
+    SpotlightCommand scheduled[COMMAND_QUEUE_LENGTH];
+    uint8_t scheduledCount;
+    // Plätze in scheduled[], die angenommene Batches belegen – ab der Annahme
+    // (Netzwerk-Task) bis zum Anwenden oder Verwerfen (Render-Loop)
+    std::atomic<uint8_t> batchPartsReserved;
     String wifiSSID;
     String wifiPassword;
     String spotlightId;
@@ -161,29 +363,112 @@ private:
     CRGB innerRing[NUM_LEDS_INNER];
     CRGB outerRing[NUM_LEDS_OUTER];
     
-    // Effekt-States
-    EffectState innerState;
-    EffectState outerState;
+    // Show-Uhr: millis() + Offset zur Commander-Zeit
+    long clockOffset;
+    bool clockSynced;
+    int32_t clockOffsetUs;          // Zu Commander-micros(), Genauigkeit ~ halbe RTT
+    
+    // Segmente mit eigenen Effekt-States
+    Segment segments[MAX_SEGMENTS];
+    uint8_t numSegments;
+    
+    // Frames der auslaufenden Effekte (Crossfade), gleiche Aufteilung wie die Ringe
+    CRGB innerFrom[NUM_LEDS_INNER];
+    CRGB outerFrom[NUM_LEDS_OUTER];
     
-    // REST-API Handlers
+    // Hochgeladene Pixel-Programme
+    PixelProgram programs[MAX_PROGRAMS];
+    
+    // Hochgeladene Paletten (Index = ID - 1)
+    Palette palettes[MAX_PALETTES];
+    
+    // Realtime-Pixelstream
+    RealtimeState realtime;
+    
+    // Frame-Telemetrie (schreibt die Render-Loop, liest der Netzwerk-Task)
+    FrameTelemetry telemetry;
+    FrameSample frameSample;        // Nur in loop()
+    portMUX_TYPE telemetryMux;
+    
+    // Latenz-Tracing: Spans warten auf das nächste FastLED.show() (nur in loop())
+    WiFiUDP traceUdp;
+    PendingSpan pendingSpans[COMMAND_QUEUE_LENGTH];
+    uint8_t pendingSpanCount;
+    uint32_t tracesSent;
+    
+    // REST-API Handlers (laufen im Netzwerk-Task)
+    typedef void (LEDSpotlight::*RequestHandler)(AsyncWebServerRequest*);
     void setupRoutes();
-    void handleRoot();
-    void handleEffect();
-    void handleStop();
-    void handleStatus();
+    void onGet(const char* path, RequestHandler handler);
+    void onPost(const char* path, RequestHandler handler);
+    static void collectBody(AsyncWebServerRequest* request, uint8_t* data,
+                            size_t len, size_t index, size_t total);
+    const char* requestBody(AsyncWebServerRequest* request);
+    void handleRoot(AsyncWebServerRequest* request);
+    void handleEffect(AsyncWebServerRequest* request);
+    void handleEffectDelta(AsyncWebServerRequest* request);
+    void handleBatch(AsyncWebServerRequest* request);
+    void handleStop(AsyncWebServerRequest* request);
+    void handleStatus(AsyncWebServerRequest* request);
+    void handleLogs(AsyncWebServerRequest* request);
+    void handleClock(AsyncWebServerRequest* request);
+    void handleProgram(AsyncWebServerRequest* request);
+    void handlePalette(AsyncWebServerRequest* request);
+    void handleSegments(AsyncWebServerRequest* request);
+    void handleRealtime(AsyncWebServerRequest* request);
+    void handleTelemetry(AsyncWebServerRequest* request);
+    void handleTelemetryConfig(AsyncWebServerRequest* request);
+    void handleMemory(AsyncWebServerRequest* request);
+    
+    // Befehls-Queue & Lock
+    bool queueCommand(const SpotlightCommand& command);
+    void processCommands();
+    void queueEffect(AsyncWebServerRequest* request, SpotlightCommand& command);
+    void rememberEffect(const Effect& effect);
+    void applyCommand(const SpotlightCommand& command);
+    void scheduleCommand(const SpotlightCommand& command);
+    void applyDueBatches();
+    void lockState();
+    void unlockState();
+    
+    // Realtime
+    void receiveRealtime();
+    void handleRealtimePacket(const uint8_t* packet, int length);
+    bool showRealtimeFrame(unsigned long& receivedAt);
+    void recordRealtimeLatency(unsigned long receivedAt);
+    
+    // Latenz-Tracing
+    void traceApplied(const SpotlightCommand& command);
+    void sendTraceSpans();
+    
+    // Frame-Telemetrie
+    void recordFrame(const FrameSample& sample);
+    void closeTelemetryWindow();
+    void resetTelemetry();
+    void copyStatus(StatusSnapshot& status);
+    void copyTelemetryStatus(StatusSnapshot& status);
+    void writeTelemetryStatus(JsonObject obj, const StatusSnapshot& status);
     
     // Effekt-Updates
-    void updateEffects();
-    void updateEffect(EffectState& state, CRGB* leds, uint8_t numLeds);
+    void updateEffects(FrameSample* sample = nullptr);
+    void updateEffect(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long now);
+    void updateSegment(Segment& seg, unsigned long now);
+    void beginTransition(Segment& seg, uint16_t duration, unsigned long startTime);
+    
+    // Segment-Helpers
+    bool segmentMatches(uint8_t index, RingType ring, uint8_t segmentMask);
+    CRGB* segmentLeds(const Segment& seg);
+    CRGB* segmentFrom(const Segment& seg);
     
     // Einzelne Effekte
-    void updateStatic(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updateFade(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updatePulse(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updateRotation(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updateRainbow(EffectState& state, CRGB* leds, uint8_t numLeds);
-    void updateChase(EffectState& state, CRGB* leds, uint8_t numLeds);
+    void updateStatic(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateFade(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateStrobe(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updatePulse(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateRotation(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateRainbow(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateChase(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
+    void updateProgram(EffectState& state, CRGB* leds, uint8_t numLeds, unsigned long elapsed);
     
     // Rotation-Helpers
     void renderRotationSingle(CRGB* leds, uint8_t numLeds, const EffectState& state);
@@ -191,6 +476,16 @@ private:
     void renderRotationOpposite(CRGB* leds, uint8_t numLeds, const EffectState& state);
     void renderRotationWave(CRGB* leds, uint8_t numLeds, const EffectState& state);
     
+    // Automation
+    void applyAutomation(EffectState& state, unsigned long elapsed);
+    uint32_t evaluateAutomation(const Automation& curve, unsigned long elapsed, bool isColor);
+    float interpolateKeyframe(const Keyframe& from, const Keyframe& to, unsigned long t);
+    float integrateAutomation(const Automation& curve, unsigned long elapsed, bool periodMs);
+    float integrateSpan(const Automation& curve, unsigned long t, bool periodMs);
+    
+    // Paletten
+    const CRGBPalette256* effectPalette(const EffectState& state);
+    
     // Hilfsfunktionen
     Color blendColor(const Color& c1, const Color& c2, float factor);
     CRGB blendCRGB(const CRGB& c1, const CRGB& c2, float factor);
@@ -0,0 +1,366 @@
+#include "PixelProgram.h"
+
+// ============================================================================
+// MNEMONICS (Assembler)
+// ============================================================================
+
+struct Mnemonic {
+    const char* name;
+    uint8_t op;
+};
+
+static const Mnemonic MNEMONICS[] = {
+    { "t", OP_T },          { "i", OP_I },          { "n", OP_N },
+    { "ring", OP_RING },    { "dup", OP_DUP },      { "swap", OP_SWAP },
+    { "drop", OP_DROP },    { "add", OP_ADD },      { "sub", OP_SUB },
+    { "mul", OP_MUL },      { "div", OP_DIV },      { "mod", OP_MOD },
+    { "and", OP_AND },      { "or", OP_OR },        { "xor", OP_XOR },
+    { "shl", OP_SHL },      { "shr", OP_SHR },      { "min", OP_MIN },
+    { "max", OP_MAX },      { "lt", OP_LT },        { "gt", OP_GT },
+    { "eq", OP_EQ },        { "sin8", OP_SIN8 },    { "tri8", OP_TRI8 },
+    { "scale8", OP_SCALE8 },{ "jz", OP_JZ },        { "jmp", OP_JMP },
+    { "rgb", OP_RGB },      { "hsv", OP_HSV }
+};
+
+#define MAX_LABELS  8
+
+struct Label {
+    const char* name;
+    uint8_t len;
+    uint8_t addr;
+};
+
+static inline uint8_t clamp8(int32_t v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// ============================================================================
+// KONSTRUKTOR & LADEN
+// ============================================================================
+
+PixelProgram::PixelProgram() : length(0), valid(false) {
+}
+
+void PixelProgram::clear() {
+    length = 0;
+    valid = false;
+}
+
+const char* PixelProgram::load(const uint8_t* bytecode, uint8_t codeLength) {
+    const char* error = verify(bytecode, codeLength);
+    if (error) return error;
+
+    memcpy(code, bytecode, codeLength);
+    length = codeLength;
+    valid = true;
+    return nullptr;
+}
+
+// ============================================================================
+// VERIFIER
+// ============================================================================
+
+// Prüft einmalig beim Upload, damit render() ohne Checks laufen kann:
+// - nur bekannte Opcodes, keine abgeschnittenen Befehle
+// - Sprünge nur vorwärts und auf Befehlsanfänge
+// - Stack-Tiefe an jeder Stelle eindeutig, kein Über-/Unterlauf
+// - jeder Pfad endet mit rgb/hsv
+// Da Sprünge nur vorwärts gehen, führt jeder Pixel höchstens
+// `codeLength` Befehle aus.
+const char* PixelProgram::verify(const uint8_t* bytecode, uint8_t codeLength) {
+    if (codeLength == 0) return "Empty program";
+    if (codeLength > MAX_PROGRAM_LENGTH) return "Program too long";
+
+    int8_t depth[MAX_PROGRAM_LENGTH + 1];
+    bool isStart[MAX_PROGRAM_LENGTH + 1];
+    for (int i = 0; i <= codeLength; i++) {
+        depth[i] = -1;
+        isStart[i] = false;
+    }
+    depth[0] = 0;
+
+    uint8_t pc = 0;
+    while (pc < codeLength) {
+        uint8_t op = bytecode[pc];
+        if (op >= OP_COUNT) return "Unknown opcode";
+
+        uint16_t next = pc + 1 + immediateSize(op);
+        if (next > codeLength) return "Truncated instruction";
+        isStart[pc] = true;
+
+        if (depth[pc] >= 0) {
+            uint8_t pops;
+            int8_t pushes = stackEffect(op, pops);
+
+            if (depth[pc] < pops) return "Stack underflow";
+            int8_t nextDepth = depth[pc] - pops + pushes;
+            if (nextDepth > MAX_PROGRAM_STACK) return "Stack overflow";
+
+            if (op == OP_PARAM && bytecode[pc + 1] >= NUM_PROGRAM_PARAMS) {
+                return "Invalid parameter index";
+            }
+
+            // Nachfolger bestimmen
+            uint16_t targets[2];
+            uint8_t numTargets = 0;
+            if (op == OP_JMP) {
+                targets[numTargets++] = next + bytecode[pc + 1];
+            } else if (op != OP_RGB && op != OP_HSV) {
+                targets[numTargets++] = next;
+                if (op == OP_JZ) targets[numTargets++] = next + bytecode[pc + 1];
+            }
+
+            for (uint8_t t = 0; t < numTargets; t++) {
+                if (targets[t] >= codeLength) return "Missing rgb/hsv at end";
+                if (depth[targets[t]] == -1) {
+                    depth[targets[t]] = nextDepth;
+                } else if (depth[targets[t]] != nextDepth) {
+                    return "Stack mismatch at jump target";
+                }
+            }
+        }
+
+        pc = next;
+    }
+
+    for (int i = 0; i < codeLength; i++) {
+        if (depth[i] >= 0 && !isStart[i]) return "Jump into instruction";
+    }
+
+    return nullptr;
+}
+
+uint8_t PixelProgram::immediateSize(uint8_t op) {
+    switch (op) {
+        case OP_PUSH8:
+        case OP_PARAM:
+        case OP_JZ:
+        case OP_JMP:
+            return 1;
+        case OP_PUSH16:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+int8_t PixelProgram::stackEffect(uint8_t op, uint8_t& pops) {
+    switch (op) {
+        case OP_PUSH8: case OP_PUSH16: case OP_T: case OP_I:
+        case OP_N: case OP_RING: case OP_PARAM:
+            pops = 0; return 1;
+        case OP_DUP:
+            pops = 1; return 2;
+        case OP_SWAP:
+            pops = 2; return 2;
+        case OP_DROP: case OP_JZ:
+            pops = 1; return 0;
+        case OP_SIN8: case OP_TRI8:
+            pops = 1; return 1;
+        case OP_JMP:
+            pops = 0; return 0;
+        case OP_RGB: case OP_HSV:
+            pops = 3; return 0;
+        default:
+            // Binäre Operatoren
+            pops = 2; return 1;
+    }
+}
+
+// ============================================================================
+// ASSEMBLER
+// ============================================================================
+
+// Gegenstück zu lookupMnemonic(); push8/push16/param schreibt der
+// Assembler als Zahl bzw. p0..p3
+const char* PixelProgram::opcodeName(uint8_t op) {
+    switch (op) {
+        case OP_PUSH8:  return "push8";
+        case OP_PUSH16: return "push16";
+        case OP_PARAM:  return "param";
+    }
+    for (const Mnemonic& m : MNEMONICS) {
+        if (m.op == op) return m.name;
+    }
+    return nullptr;
+}
+
+int8_t PixelProgram::lookupMnemonic(const char* token, uint8_t len) {
+    for (const Mnemonic& m : MNEMONICS) {
+        if (strlen(m.name) == len && strncmp(m.name, token, len) == 0) {
+            return m.op;
+        }
+    }
+    return -1;
+}
+
+// Quelltext: Tokens durch Leerzeichen getrennt, Kommentare mit ';'
+//   Zahlen      → push8/push16
+//   p0..p3      → Effekt-Parameter
+//   name:       → Sprungmarke
+//   jz/jmp name → Vorwärtssprung zur Marke
+const char* PixelProgram::assemble(const char* source) {
+    uint8_t buffer[MAX_PROGRAM_LENGTH];
+    Label labels[MAX_LABELS];
+    uint8_t numLabels = 0;
+    uint8_t pc = 0;
+
+    // Pass 0: Adressen der Marken bestimmen, Pass 1: Code erzeugen
+    for (int pass = 0; pass < 2; pass++) {
+        const char* p = source;
+        pc = 0;
+
+        while (*p) {
+            // Leerzeichen & Kommentare überspringen
+            if (isspace((unsigned char)*p)) { p++; continue; }
+            if (*p == ';') {
+                while (*p && *p != '\n') p++;
+                continue;
+            }
+
+            const char* token = p;
+            while (*p && !isspace((unsigned char)*p) && *p != ';') p++;
+            size_t tokenLen = p - token;
+            uint8_t len = tokenLen > 255 ? 255 : tokenLen;
+
+            uint8_t emit[3];
+            uint8_t emitLen = 0;
+
+            if (token[len - 1] == ':') {
+                // Sprungmarke
+                if (pass == 0) {
+                    if (numLabels >= MAX_LABELS) return "Too many labels";
+                    labels[numLabels++] = { token, (uint8_t)(len - 1), pc };
+                }
+                continue;
+            } else if (isdigit((unsigned char)token[0]) || token[0] == '-') {
+                long value = strtol(token, nullptr, 10);
+                if (value >= 0 && value <= 255) {
+                    emit[emitLen++] = OP_PUSH8;
+                    emit[emitLen++] = value;
+                } else if (value >= -32768 && value <= 32767) {
+                    emit[emitLen++] = OP_PUSH16;
+                    emit[emitLen++] = value & 0xFF;
+                    emit[emitLen++] = (value >> 8) & 0xFF;
+                } else {
+                    return "Number out of range";
+                }
+            } else if (len == 2 && token[0] == 'p' && isdigit((unsigned char)token[1])) {
+                emit[emitLen++] = OP_PARAM;
+                emit[emitLen++] = token[1] - '0';
+            } else {
+                int8_t op = lookupMnemonic(token, len);
+                if (op < 0) return "Unknown mnemonic";
+                emit[emitLen++] = op;
+
+                if (op == OP_JZ || op == OP_JMP) {
+                    // Marke lesen
+                    while (*p && isspace((unsigned char)*p)) p++;
+                    const char* name = p;
+                    while (*p && !isspace((unsigned char)*p) && *p != ';') p++;
+                    uint8_t nameLen = p - name;
+                    if (nameLen == 0) return "Missing jump label";
+
+                    uint8_t offset = 0;
+                    if (pass == 1) {
+                        int target = -1;
+                        for (uint8_t l = 0; l < numLabels; l++) {
+                            if (labels[l].len == nameLen &&
+                                strncmp(labels[l].name, name, nameLen) == 0) {
+                                target = labels[l].addr;
+                            }
+                        }
+                        if (target < 0) return "Unknown jump label";
+                        int delta = target - (pc + 2);
+                        if (delta < 0) return "Backward jumps not allowed";
+                        offset = delta;
+                    }
+                    emit[emitLen++] = offset;
+                }
+            }
+
+            if (pc + emitLen > MAX_PROGRAM_LENGTH) return "Program too long";
+            if (pass == 1) memcpy(buffer + pc, emit, emitLen);
+            pc += emitLen;
+        }
+    }
+
+    return load(buffer, pc);
+}
+
+// ============================================================================
+// INTERPRETER
+// ============================================================================
+
+void PixelProgram::render(CRGB* leds, uint8_t numLeds, uint8_t ring,
+                          unsigned long elapsed, const int16_t* params) const {
+    if (!valid) {
+        for (int i = 0; i < numLeds; i++) {
+            leds[i] = CRGB::Black;
+        }
+        return;
+    }
+
+    // Bytecode ist verifiziert → keine Bounds-/Stack-Checks im Hot Path
+    for (uint8_t i = 0; i < numLeds; i++) {
+        int32_t stack[MAX_PROGRAM_STACK];
+        int32_t* sp = stack;
+        const uint8_t* pc = code;
+        bool done = false;
+
+        while (!done) {
+            switch (*pc++) {
+                case OP_PUSH8:  *sp++ = *pc++; break;
+                case OP_PUSH16: *sp++ = (int16_t)(pc[0] | (pc[1] << 8)); pc += 2; break;
+                case OP_T:      *sp++ = (int32_t)elapsed; break;
+                case OP_I:      *sp++ = i; break;
+                case OP_N:      *sp++ = numLeds; break;
+                case OP_RING:   *sp++ = ring; break;
+                case OP_PARAM:  *sp++ = params[*pc++]; break;
+
+                case OP_DUP:    sp[0] = sp[-1]; sp++; break;
+                case OP_SWAP:   { int32_t t = sp[-1]; sp[-1] = sp[-2]; sp[-2] = t; break; }
+                case OP_DROP:   sp--; break;
+
+                // Überlauf wie uint32 (definiert), Division durch 0 → 0
+                case OP_ADD:    sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] + (uint32_t)sp[0]); break;
+                case OP_SUB:    sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] - (uint32_t)sp[0]); break;
+                case OP_MUL:    sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] * (uint32_t)sp[0]); break;
+                case OP_DIV:    sp--; sp[-1] = (sp[0] == 0 || sp[0] == -1) ?
+                                    (sp[0] == 0 ? 0 : (int32_t)(0u - (uint32_t)sp[-1])) : sp[-1] / sp[0];
+                                break;
+                case OP_MOD:    sp--; sp[-1] = (sp[0] == 0 || sp[0] == -1) ? 0 : sp[-1] % sp[0]; break;
+                case OP_AND:    sp--; sp[-1] &= sp[0]; break;
+                case OP_OR:     sp--; sp[-1] |= sp[0]; break;
+                case OP_XOR:    sp--; sp[-1] ^= sp[0]; break;
+                case OP_SHL:    sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] << (sp[0] & 31)); break;
+                case OP_SHR:    sp--; sp[-1] = (int32_t)((uint32_t)sp[-1] >> (sp[0] & 31)); break;
+                case OP_MIN:    sp--; if (sp[0] < sp[-1]) sp[-1] = sp[0]; break;
+                case OP_MAX:    sp--; if (sp[0] > sp[-1]) sp[-1] = sp[0]; break;
+                case OP_LT:     sp--; sp[-1] = sp[-1] < sp[0]; break;
+                case OP_GT:     sp--; sp[-1] = sp[-1] > sp[0]; break;
+                case OP_EQ:     sp--; sp[-1] = sp[-1] == sp[0]; break;
+
+                case OP_SIN8:   sp[-1] = sin8((uint8_t)sp[-1]); break;
+                case OP_TRI8:   { uint8_t x = sp[-1]; sp[-1] = (x < 128) ? x * 2 : (255 - x) * 2; break; }
+                case OP_SCALE8: sp--; sp[-1] = scale8((uint8_t)sp[-1], (uint8_t)sp[0]); break;
+
+                case OP_JZ:     { uint8_t off = *pc++; if (*--sp == 0) pc += off; break; }
+                case OP_JMP:    { uint8_t off = *pc++; pc += off; break; }
+
+                case OP_RGB:
+                    leds[i] = CRGB(clamp8(sp[-3]), clamp8(sp[-2]), clamp8(sp[-1]));
+                    done = true;
+                    break;
+                case OP_HSV:
+                    leds[i] = CHSV((uint8_t)sp[-3], clamp8(sp[-2]), clamp8(sp[-1]));
+                    done = true;
+                    break;
+
+                default:
+                    done = true;
+                    break;
+            }
+        }
+    }
+}
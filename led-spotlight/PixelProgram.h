@@ -0,0 +1,106 @@
+#ifndef PIXEL_PROGRAM_H
+#define PIXEL_PROGRAM_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Protocol.h"
+
+// ============================================================================
+// KONFIGURATION
+// ============================================================================
+
+#define MAX_PROGRAMS          4       // Programm-Slots auf dem Scheinwerfer
+#define MAX_PROGRAM_LENGTH    64      // Bytes Bytecode pro Programm
+#define MAX_PROGRAM_STACK     8       // Stack-Tiefe der VM
+
+// ============================================================================
+// BYTECODE
+// ============================================================================
+
+// Opcodes der Pixel-VM (Stack-Maschine, int32-Werte)
+// Sprünge gehen nur vorwärts → Laufzeit ist durch die Programmlänge begrenzt.
+enum PixelOpcode : uint8_t {
+    // Konstanten & Eingänge
+    OP_PUSH8,       // imm8  → Wert 0..255
+    OP_PUSH16,      // imm16 → Wert -32768..32767 (little endian)
+    OP_T,           // Zeit seit Effektstart in ms
+    OP_I,           // Pixel-Index
+    OP_N,           // Anzahl LEDs im Ring
+    OP_RING,        // 0 = innen, 1 = außen
+    OP_PARAM,       // imm8  → Effekt-Parameter p0..p3
+
+    // Stack
+    OP_DUP,
+    OP_SWAP,
+    OP_DROP,
+
+    // Arithmetik (a b → a op b)
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,         // Division durch 0 → 0
+    OP_MOD,         // Modulo durch 0 → 0
+    OP_AND,
+    OP_OR,
+    OP_XOR,
+    OP_SHL,
+    OP_SHR,
+    OP_MIN,
+    OP_MAX,
+    OP_LT,
+    OP_GT,
+    OP_EQ,
+
+    // Wellenformen (8 Bit)
+    OP_SIN8,        // a → sin8(a)
+    OP_TRI8,        // a → Dreieck 0..255..0
+    OP_SCALE8,      // a b → a * b / 256
+
+    // Sprünge (Offset relativ zum nächsten Befehl, nur vorwärts)
+    OP_JZ,          // imm8, springt wenn a == 0
+    OP_JMP,         // imm8
+
+    // Ausgabe (beendet das Programm für diesen Pixel)
+    OP_RGB,         // r g b → Pixel
+    OP_HSV,         // h s v → Pixel
+
+    OP_COUNT
+};
+
+// ============================================================================
+// PIXEL PROGRAM KLASSE
+// ============================================================================
+
+class PixelProgram {
+public:
+    PixelProgram();
+
+    // Laden (prüft Bytecode), nullptr = OK, sonst Fehlermeldung
+    const char* load(const uint8_t* bytecode, uint8_t codeLength);
+    const char* assemble(const char* source);
+    void clear();
+
+    bool isValid() const { return valid; }
+    uint8_t size() const { return length; }
+    const uint8_t* bytecode() const { return code; }
+
+    // Bytecode-Format (Disassembler im Host-Assembler)
+    static uint8_t immediateSize(uint8_t op);
+    static const char* opcodeName(uint8_t op);
+
+    // Rendert einen Ring: Programm läuft einmal pro Pixel
+    void render(CRGB* leds, uint8_t numLeds, uint8_t ring,
+                unsigned long elapsed, const int16_t* params) const;
+
+private:
+    uint8_t code[MAX_PROGRAM_LENGTH];
+    uint8_t length;
+    bool valid;
+
+    const char* verify(const uint8_t* bytecode, uint8_t codeLength);
+
+    static int8_t stackEffect(uint8_t op, uint8_t& pops);
+    static int8_t lookupMnemonic(const char* token, uint8_t len);
+};
+
+#endif // PIXEL_PROGRAM_H
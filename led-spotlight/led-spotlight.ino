@@ -10,9 +10,10 @@
  * - Outer Ring: 26x WS2812B auf GPIO17
  * 
  * Features:
- * - REST API für Effekt-Befehle
+ * - REST API für Effekt-Befehle (Async, blockiert die Animation nicht)
  * - Rotation-Effekte (Single, Trail, Opposite, Wave)
  * - Static, Fade, Strobe, Pulse, Rainbow, Chase
+ * - Pixel-Programme (Bytecode, per API hochladbar)
  * - Unabhängige Steuerung beider Ringe
  */
 
@@ -1,14 +1,26 @@
 #include "LightCommander.h"
 
+// Allokationszähler (common/MemoryStats.h), Linker-Flags in platformio.ini
+MEMORY_ALLOCATION_HOOKS()
+
 // ============================================================================
 // KONSTRUKTOR & INITIALISIERUNG
 // ============================================================================
 
 LightCommander::LightCommander() : 
     server(80),
+    events("/api/events"),
     isAPMode(false),
-    currentSequence(nullptr),
-    currentEventIndex(0) {
+    spotlightSlots(),
+    spotlightIdCount(0),
+    nextJobId(1),
+    jobQueue(nullptr),
+    stateMutex(nullptr),
+    lastHealthCheck(0),
+    metricsMux(portMUX_INITIALIZER_UNLOCKED),
+    nextTraceId(1),
+    spansReceived(0),
+    spansUnmatched(0) {
 }
 
 void LightCommander::begin(const char* ssid, const char* password, bool apMode) {
@@ -18,6 +30,11 @@ void LightCommander::begin(const char* ssid, const char* password, bool apMode)
     Serial.println("║     Master-Controller für Scheinwerfer ║");
     Serial.println("╚════════════════════════════════════════╝\n");
     
+    // Log-Records ab hier im Hintergrund auf Serial (siehe common/Log.h)
+    startLogDrain();
+    memoryStats.registerTask("loop");
+    memoryStats.registerTask("log", logDrainHandle);
+    
     wifiSSID = String(ssid);
     wifiPassword = String(password);
     isAPMode = apMode;
@@ -62,28 +79,30 @@ void LightCommander::begin(const char* ssid, const char* password, bool apMode)
         }
     }
     
-    // REST API Setup
+    // Jobs: Fan-out, Uploads und Health-Checks laufen im Worker-Task,
+    // weder API noch Playback warten darauf
+    jobQueue = xQueueCreate(JOB_QUEUE_LENGTH, sizeof(uint32_t));
+    stateMutex = xSemaphoreCreateMutex();
+    measureMetricsOverhead();
+    TaskHandle_t worker = nullptr;
+    xTaskCreatePinnedToCore(jobWorker, "jobs", 8192, this, 1, &worker, 0);
+    memoryStats.registerTask("jobs", worker);
+    
+    // REST API Setup (Async: Requests laufen im Netzwerk-Task)
     setupRoutes();
     server.begin();
     
+    // Spans der Scheinwerfer (Latenz-Tracing)
+    traceUdp.begin(TRACE_PORT);
+    
     Serial.println("\n✓ Light Commander ready!");
     Serial.println("Waiting for spotlight connections...\n");
 }
 
 void LightCommander::loop() {
-    server.handleClient();
-    
-    // Sequenz-Playback
-    if (playback.active && !playback.paused) {
-        updateSequencePlayback();
-    }
-    
-    // Periodischer Health-Check (alle 30 Sekunden)
-    static unsigned long lastCheck = 0;
-    if (millis() - lastCheck > 30000) {
-        checkSpotlightStatus();
-        lastCheck = millis();
-    }
+    // Nur noch Playback und Trace-Spans: API-Requests und Jobs laufen in eigenen Tasks
+    updateSequencePlayback();
+    receiveTraceSpans();
 }
 
 // ============================================================================
@@ -91,24 +110,100 @@ void LightCommander::loop() {
 // ============================================================================
 
 void LightCommander::setupRoutes() {
-    server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    server.on("/api/status", HTTP_GET, [this]() { handleStatus(); });
+    onGet("/", &LightCommander::handleRoot);
+    onGet("/api/status", &LightCommander::handleStatus);
+    onGet("/api/job", &LightCommander::handleJobStatus);
+    onGet("/api/logs", &LightCommander::handleLogs);
+    onGet("/metrics", &LightCommander::handleMetrics);
+    onGet("/api/traces", &LightCommander::handleTraces);
+    onGet("/api/memory", &LightCommander::handleMemory);
+    onGet("/api/spotlight/list", &LightCommander::handleListSpotlights);
+    onGet("/api/sequence/list", &LightCommander::handleListSequences);
+    server.addHandler(&events);
+    
+    onPost("/api/spotlight/add", &LightCommander::handleAddSpotlight);
+    
+    onPost("/api/effect/send", &LightCommander::handleSendEffect);
+    onPost("/api/effect/batch", &LightCommander::handleBatchEffect);
+    onPost("/api/effect/stop", &LightCommander::handleStopEffect);
+    onPost("/api/program/upload", &LightCommander::handleUploadProgram);
+    onPost("/api/palette/upload", &LightCommander::handleUploadPalette);
+    onPost("/api/segments", &LightCommander::handleConfigureSegments);
+    
+    onPost("/api/sequence/load", &LightCommander::handleLoadSequence);
+    onPost("/api/sequence/play", &LightCommander::handlePlaySequence);
+    onPost("/api/sequence/pause", &LightCommander::handlePauseSequence);
+    onPost("/api/sequence/resume", &LightCommander::handleResumeSequence);
+    onPost("/api/sequence/stop", &LightCommander::handleStopSequence);
+}
+
+// Handler-Laufzeit landet in metrics.apiRequest, ihr Heap unter "json".
+// Den Netzwerk-Task startet die Bibliothek → Anmeldung beim ersten Request
+void LightCommander::onGet(const char* path, RequestHandler handler) {
+    server.on(path, HTTP_GET, [this, handler](AsyncWebServerRequest* request) {
+        memoryStats.registerTask("network");
+        MemoryScope scope(MEMORY_JSON);
+        unsigned long start = micros();
+        (this->*handler)(request);
+        recordMetric(metrics.apiRequest, micros() - start);
+    });
+}
+
+void LightCommander::onPost(const char* path, RequestHandler handler) {
+    server.on(path, HTTP_POST,
+        [this, handler](AsyncWebServerRequest* request) {
+            memoryStats.registerTask("network");
+            // Body hat collectBody() verworfen: 413 statt "No body" im Handler
+            if (request->contentLength() > MAX_REQUEST_BODY) {
+                request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+                return;
+            }
+            MemoryScope scope(MEMORY_JSON);
+            unsigned long start = micros();
+            (this->*handler)(request);
+            recordMetric(metrics.apiRequest, micros() - start);
+        },
+        nullptr,
+        [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            memoryStats.registerTask("network");
+            MemoryScope scope(MEMORY_JSON);
+            collectBody(request, data, len, index, total);
+        });
+}
+
+// Body kommt in Stücken aus dem TCP-Stack → in _tempObject sammeln
+// (gibt der Server nach dem Request selbst frei). Zu große Bodies gar
+// nicht erst, onPost() antwortet dann 413.
+void LightCommander::collectBody(AsyncWebServerRequest* request, uint8_t* data,
+                                 size_t len, size_t index, size_t total) {
+    if (total > MAX_REQUEST_BODY) return;
+    
+    if (index == 0) {
+        request->_tempObject = malloc(total + 1);
+    }
     
-    server.on("/api/spotlight/add", HTTP_POST, [this]() { handleAddSpotlight(); });
-    server.on("/api/spotlight/list", HTTP_GET, [this]() { handleListSpotlights(); });
+    char* buffer = (char*)request->_tempObject;
+    if (!buffer) return;
     
-    server.on("/api/effect/send", HTTP_POST, [this]() { handleSendEffect(); });
-    server.on("/api/effect/stop", HTTP_POST, [this]() { handleStopEffect(); });
+    memcpy(buffer + index, data, len);
+    if (index + len == total) buffer[total] = '\0';
+}
+
+const char* LightCommander::requestBody(AsyncWebServerRequest* request) {
+    return (const char*)request->_tempObject;
+}
+
+void LightCommander::sendJobAccepted(AsyncWebServerRequest* request, uint32_t jobId) {
+    if (jobId == 0) {
+        request->send(503, "application/json", "{\"error\":\"Job queue full\"}");
+        return;
+    }
     
-    server.on("/api/sequence/load", HTTP_POST, [this]() { handleLoadSequence(); });
-    server.on("/api/sequence/list", HTTP_GET, [this]() { handleListSequences(); });
-    server.on("/api/sequence/play", HTTP_POST, [this]() { handlePlaySequence(); });
-    server.on("/api/sequence/pause", HTTP_POST, [this]() { handlePauseSequence(); });
-    server.on("/api/sequence/resume", HTTP_POST, [this]() { handleResumeSequence(); });
-    server.on("/api/sequence/stop", HTTP_POST, [this]() { handleStopSequence(); });
+    String json = "{\"success\":true,\"jobId\":" + String(jobId) + "}";
+    request->send(202, "application/json", json);
 }
 
-void LightCommander::handleRoot() {
+void LightCommander::handleRoot(AsyncWebServerRequest* request) {
     String html = "<!DOCTYPE html><html><head><title>Light Commander</title>";
     html += "<meta name='viewport' content='width=device-width,initial-scale=1'>";
     html += "<style>body{font-family:Arial;margin:20px;background:#1a1a1a;color:#fff;}";
@@ -116,6 +211,7 @@ void LightCommander::handleRoot() {
     html += "<h1>🎆 Light Commander</h1>";
     html += "<h2>Connected Spotlights:</h2><ul>";
     
+    lockState();
     for (auto& pair : spotlights) {
         html += "<li>" + pair.second.name + " (" + pair.second.id + ") - ";
         html += pair.second.online ? "🟢 Online" : "🔴 Offline";
@@ -128,7 +224,7 @@ void LightCommander::handleRoot() {
     html += "</ul><h2>Loaded Sequences:</h2><ul>";
     for (auto& pair : sequences) {
         html += "<li>" + pair.second.name + " (" + pair.second.id + ") - ";
-        html += String(pair.second.events.size()) + " events, ";
+        html += String(pair.second.eventCount) + " events, ";
         html += String(pair.second.duration / 1000) + "s</li>";
     }
     if (sequences.empty()) {
@@ -136,38 +232,103 @@ void LightCommander::handleRoot() {
     }
     
     html += "</ul><h2>Playback Status:</h2><p>";
-    if (playback.active) {
-        html += "▶️ Playing: " + playback.currentSequence;
-        if (playback.paused) html += " (PAUSED)";
+    if (playback.active()) {
+        for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+            const Timeline& t = playback.timelines[i];
+            if (!t.active) continue;
+            html += "▶️ Playing: " + t.sequenceId + " (timeline " + String(i) + ", priority " + String(t.priority) + ")";
+            if (t.paused) html += " (PAUSED)";
+            html += "<br>";
+        }
     } else {
         html += "⏹️ Stopped";
     }
+    unlockState();
     
     html += "</p><h2>API Endpoints:</h2><ul>";
     html += "<li>POST /api/spotlight/add - Add spotlight</li>";
     html += "<li>GET /api/spotlight/list - List spotlights</li>";
     html += "<li>POST /api/effect/send - Send effect</li>";
+    html += "<li>POST /api/effect/batch - Several effects on the same frame</li>";
+    html += "<li>POST /api/program/upload - Upload pixel program</li>";
+    html += "<li>POST /api/palette/upload - Upload palette</li>";
+    html += "<li>POST /api/segments - Configure segments</li>";
     html += "<li>POST /api/sequence/load - Load sequence</li>";
     html += "<li>POST /api/sequence/play - Play sequence</li>";
     html += "<li>GET /api/status - Get status</li>";
+    html += "<li>GET /api/job?id=N - Job status</li>";
+    html += "<li>GET /api/events - Job updates (SSE)</li>";
     html += "</ul></body></html>";
     
-    server.send(200, "text/html", html);
+    request->send(200, "text/html", html);
+}
+
+void LightCommander::handleStatus(AsyncWebServerRequest* request) {
+    request->send(200, "application/json", getStatusJson());
+}
+
+// Heap, Stack-Reserven der Tasks und Allokationen pro Subsystem
+// (common/MemoryStats.h) – ohne State-Lock, alles Zähler
+void LightCommander::handleMemory(AsyncWebServerRequest* request) {
+    MemorySnapshot snapshot;
+    memoryStats.snapshot(snapshot);
+    
+    char json[MEMORY_JSON_SIZE];
+    if (encodeMemoryStats(snapshot, json, sizeof(json)) == 0) {
+        request->send(500, "application/json", "{\"error\":\"Memory stats too large\"}");
+        return;
+    }
+    request->send(200, "application/json", json);
+}
+
+void LightCommander::handleLogs(AsyncWebServerRequest* request) {
+    // Letzte Records als Text, ?count=N (Standard: ganzer Puffer)
+    uint16_t count = LOG_BUFFER_SIZE;
+    if (request->hasParam("count")) count = request->getParam("count")->value().toInt();
+    
+    String text;
+    logBuffer.recent([&text](const char* line) {
+        text += line;
+        text += '\n';
+    }, count);
+    
+    request->send(200, "text/plain", text);
 }
 
-void LightCommander::handleStatus() {
-    server.send(200, "application/json", getStatusJson());
+void LightCommander::handleJobStatus(AsyncWebServerRequest* request) {
+    if (!request->hasParam("id")) {
+        request->send(400, "application/json", "{\"error\":\"Missing id\"}");
+        return;
+    }
+    
+    uint32_t id = request->getParam("id")->value().toInt();
+    
+    StaticJsonDocument<256> doc;
+    lockState();
+    Job* job = findJob(id);
+    if (job) addJobJson(doc.to<JsonObject>(), *job);
+    unlockState();
+    
+    if (!job) {
+        request->send(404, "application/json", "{\"error\":\"Unknown job\"}");
+        return;
+    }
+    
+    String output;
+    serializeJson(doc, output);
+    request->send(200, "application/json", output);
 }
 
-void LightCommander::handleAddSpotlight() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LightCommander::handleAddSpotlight(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
     StaticJsonDocument<512> doc;
-    if (deserializeJson(doc, server.arg("plain"))) {
-        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
     
@@ -176,16 +337,17 @@ void LightCommander::handleAddSpotlight() {
     String ip = doc["ip"] | "";
     
     if (addSpotlight(id, name, ip)) {
-        server.send(200, "application/json", "{\"success\":true}");
+        request->send(200, "application/json", "{\"success\":true}");
     } else {
-        server.send(500, "application/json", "{\"error\":\"Failed to add spotlight\"}");
+        request->send(500, "application/json", "{\"error\":\"Failed to add spotlight\"}");
     }
 }
 
-void LightCommander::handleListSpotlights() {
+void LightCommander::handleListSpotlights(AsyncWebServerRequest* request) {
     StaticJsonDocument<2048> doc;
     JsonArray array = doc.to<JsonArray>();
     
+    lockState();
     for (auto& pair : spotlights) {
         JsonObject obj = array.createNestedObject();
         obj["id"] = pair.second.id;
@@ -193,112 +355,129 @@ void LightCommander::handleListSpotlights() {
         obj["ip"] = pair.second.ip;
         obj["online"] = pair.second.online;
     }
+    unlockState();
     
     String output;
     serializeJson(doc, output);
-    server.send(200, "application/json", output);
+    request->send(200, "application/json", output);
 }
 
-void LightCommander::handleSendEffect() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LightCommander::handleSendEffect(AsyncWebServerRequest* request) {
+    uint32_t received = micros();
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
-    String body = server.arg("plain");
-    Serial.println("\n📥 Received effect command:");
-    Serial.println(body);
+    LOG_DEBUG("📥 Effect command (%u bytes)", strlen(body));
     
-    StaticJsonDocument<2048> doc;
-    if (deserializeJson(doc, body)) {
-        Serial.println("✗ JSON parse error!");
-        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    // Direkt aus dem Request-Buffer parsen (kein JsonDocument)
+    std::vector<String> targets;
+    Effect effect;
+    
+    DecodeResult result = parseEffectRequest(body, strlen(body), targets, effect);
+    if (result == DECODE_UNSUPPORTED_VERSION) {
+        LOG_WARN("✗ Unsupported protocol version");
+        request->send(400, "application/json", "{\"error\":\"Unsupported protocol version\"}");
+        return;
+    }
+    if (result != DECODE_OK) {
+        LOG_WARN("✗ Effect: invalid JSON");
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
     
-    // Targets parsen
-    std::vector<String> targets;
-    JsonArray targetsArray = doc["targets"];
-    for (JsonVariant v : targetsArray) {
-        targets.push_back(v.as<String>());
+    // Gemeinsame Startzeit jetzt festlegen → alle Ziele laufen phasengleich,
+    // auch wenn der Worker die HTTP-Requests später nacheinander rausschickt
+    effect.startTime = millis();
+    effect.traceId = beginTrace(TRACE_ORIGIN_API, received);
+    sendJobAccepted(request, submitJob(JOB_EFFECT, targets, "/effect", String(), effect.traceId,
+                                       std::vector<String>(), 0, &effect));
+}
+
+void LightCommander::handleBatchEffect(AsyncWebServerRequest* request) {
+    uint32_t received = micros();
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
     }
     
-    // Ring
-    String ringStr = doc["ring"] | "both";
-    RingType ring = RING_BOTH;
-    if (ringStr == "inner") ring = RING_INNER;
-    else if (ringStr == "outer") ring = RING_OUTER;
-    
-    // Effekt-Typ
-    String effectStr = doc["effect"] | "static";
-    EffectType effect = EFFECT_STATIC;
-    if (effectStr == "fade") effect = EFFECT_FADE;
-    else if (effectStr == "strobe") effect = EFFECT_STROBE;
-    else if (effectStr == "pulse") effect = EFFECT_PULSE;
-    else if (effectStr == "rotation") effect = EFFECT_ROTATION;
-    else if (effectStr == "rainbow") effect = EFFECT_RAINBOW;
-    else if (effectStr == "chase") effect = EFFECT_CHASE;
-    
-    // Parameter
-    EffectParams params;
-    if (doc.containsKey("color")) {
-        JsonArray c = doc["color"];
-        params.color = Color(c[0], c[1], c[2]);
-    }
-    if (doc.containsKey("color2")) {
-        JsonArray c2 = doc["color2"];
-        params.color2 = Color(c2[0], c2[1], c2[2]);
-    }
-    if (doc.containsKey("brightness")) params.brightness = doc["brightness"];
-    if (doc.containsKey("speed")) params.speed = doc["speed"];
-    if (doc.containsKey("duration")) params.duration = doc["duration"];
-    
-    // Rotation params
-    if (effect == EFFECT_ROTATION && doc.containsKey("rotation")) {
-        JsonObject rot = doc["rotation"];
-        if (rot.containsKey("activeColor")) {
-            JsonArray ac = rot["activeColor"];
-            params.rotation.activeColor = Color(ac[0], ac[1], ac[2]);
-        }
-        if (rot.containsKey("inactiveColor")) {
-            JsonArray ic = rot["inactiveColor"];
-            params.rotation.inactiveColor = Color(ic[0], ic[1], ic[2]);
-        }
-        if (rot.containsKey("speed")) params.rotation.speed = rot["speed"];
-        if (rot.containsKey("direction")) {
-            String dir = rot["direction"] | "clockwise";
-            params.rotation.direction = (dir == "counterclockwise") ? 
-                DIRECTION_COUNTERCLOCKWISE : DIRECTION_CLOCKWISE;
-        }
-        if (rot.containsKey("pattern")) {
-            String pat = rot["pattern"] | "single";
-            if (pat == "trail") params.rotation.pattern = PATTERN_TRAIL;
-            else if (pat == "opposite") params.rotation.pattern = PATTERN_OPPOSITE;
-            else if (pat == "wave") params.rotation.pattern = PATTERN_WAVE;
-            else params.rotation.pattern = PATTERN_SINGLE;
-        }
-        if (rot.containsKey("trailLength")) {
-            params.rotation.trailLength = rot["trailLength"];
-        }
-    }
-    
-    // Senden!
-    if (sendEffect(targets, ring, effect, params)) {
-        server.send(200, "application/json", "{\"success\":true}");
-    } else {
-        server.send(500, "application/json", "{\"error\":\"Failed to send effect\"}");
+    LOG_DEBUG("📥 Batch command (%u bytes)", strlen(body));
+    
+    // Einmal parsen, dabei pro Scheinwerfer sammeln
+    unsigned long at;
+    std::vector<BatchPart> parts;
+    DecodeResult result = parseBatchRequest(body, strlen(body), at, parts);
+    if (result == DECODE_UNSUPPORTED_VERSION) {
+        LOG_WARN("✗ Unsupported protocol version");
+        request->send(400, "application/json", "{\"error\":\"Unsupported protocol version\"}");
+        return;
+    }
+    if (result != DECODE_OK) {
+        LOG_WARN("✗ Batch: invalid JSON");
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    if (parts.empty()) {
+        request->send(400, "application/json", "{\"error\":\"No targets\"}");
+        return;
+    }
+    
+    // Gemeinsame Show-Zeit: jeder Scheinwerfer wartet mit seinem Teil darauf,
+    // der Fan-out muss also vorher durch sein (BATCH_LEAD_MS)
+    if (at == 0) at = millis() + BATCH_LEAD_MS;
+    uint32_t traceId = beginTrace(TRACE_ORIGIN_API, received);
+    
+    // Eine Nachricht pro Scheinwerfer
+    std::vector<String> ids;
+    std::vector<String> bodies;
+    char* buffer = (char*)malloc(BATCH_JSON_SIZE);
+    bool encoded = buffer != nullptr;
+    for (BatchPart& part : parts) {
+        for (Effect& effect : part.effects) {
+            effect.startTime = at;
+            effect.traceId = traceId;
+        }
+        encoded = encoded && part.effects.size() <= MAX_BATCH_EFFECTS &&
+                  encodeBatch(at, part.effects.data(), part.effects.size(), buffer, BATCH_JSON_SIZE) > 0;
+        if (!encoded) {
+            LOG_WARN_TAG(part.id.c_str(), "✗ Batch: too many effects (%u)", part.effects.size());
+            break;
+        }
+        ids.push_back(part.id);
+        bodies.push_back(String(buffer));
+    }
+    free(buffer);
+    
+    if (!encoded) {
+        request->send(400, "application/json", "{\"error\":\"Too many effects for one spotlight\"}");
+        return;
+    }
+    
+    uint32_t jobId = submitJob(JOB_BATCH, ids, "/batch", String(), traceId, bodies, at);
+    if (jobId == 0) {
+        request->send(503, "application/json", "{\"error\":\"Job queue full\"}");
+        return;
     }
+    
+    // Versatz steht erst nach dem Fan-out fest: im Job (/api/job, SSE)
+    String json = "{\"success\":true,\"jobId\":" + String(jobId) + ",\"at\":" + String(at) +
+                  ",\"spotlights\":" + String(ids.size()) + "}";
+    request->send(202, "application/json", json);
 }
 
-void LightCommander::handleStopEffect() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LightCommander::handleStopEffect(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
     StaticJsonDocument<512> doc;
-    if (deserializeJson(doc, server.arg("plain"))) {
-        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
     
@@ -308,37 +487,79 @@ void LightCommander::handleStopEffect() {
         targets.push_back(v.as<String>());
     }
     
-    String ringStr = doc["ring"] | "both";
-    RingType ring = RING_BOTH;
-    if (ringStr == "inner") ring = RING_INNER;
-    else if (ringStr == "outer") ring = RING_OUTER;
+    const char* ringStr = doc["ring"] | "both";
+    Effect stopped;     // EFFECT_OFF
+    stopped.ring = (RingType)RING_KEYWORDS.find(ringStr, strlen(ringStr), RING_BOTH);
     
-    if (stopEffect(targets, ring)) {
-        server.send(200, "application/json", "{\"success\":true}");
-    } else {
-        server.send(500, "application/json", "{\"error\":\"Failed to stop\"}");
+    sendJobAccepted(request, submitJob(JOB_STOP, targets, "/stop", String(), 0,
+                                       std::vector<String>(), 0, &stopped));
+}
+
+void LightCommander::handleUploadProgram(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
     }
+    
+    StaticJsonDocument<2048> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    sendJobAccepted(request, forwardToTargets(doc, "/program"));
 }
 
-void LightCommander::handleLoadSequence() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LightCommander::handleUploadPalette(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
-    if (loadSequence(server.arg("plain"))) {
-        server.send(200, "application/json", "{\"success\":true}");
-    } else {
-        server.send(500, "application/json", "{\"error\":\"Failed to load sequence\"}");
+    StaticJsonDocument<2048> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
     }
+    
+    sendJobAccepted(request, forwardToTargets(doc, "/palette"));
 }
 
-void LightCommander::handleListSequences() {
-    std::vector<String> seqList = listSequences();
+void LightCommander::handleConfigureSegments(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+    
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    sendJobAccepted(request, forwardToTargets(doc, "/segments"));
+}
+
+void LightCommander::handleLoadSequence(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
     
+    // Parsen (bis 16 KB JSON) übernimmt der Worker
+    sendJobAccepted(request, submitJob(JOB_LOAD_SEQUENCE, std::vector<String>(), "", body));
+}
+
+void LightCommander::handleListSequences(AsyncWebServerRequest* request) {
     StaticJsonDocument<2048> doc;
     JsonArray array = doc.to<JsonArray>();
     
+    lockState();
+    std::vector<String> seqList = listSequences();
     for (const String& id : seqList) {
         Sequence* seq = getSequence(id);
         if (seq) {
@@ -346,57 +567,105 @@ void LightCommander::handleListSequences() {
             obj["id"] = seq->id;
             obj["name"] = seq->name;
             obj["duration"] = seq->duration;
-            obj["eventCount"] = seq->events.size();
+            obj["eventCount"] = seq->eventCount;
         }
     }
+    unlockState();
     
     String output;
     serializeJson(doc, output);
-    server.send(200, "application/json", output);
+    request->send(200, "application/json", output);
 }
 
-void LightCommander::handlePlaySequence() {
-    if (!server.hasArg("plain")) {
-        server.send(400, "application/json", "{\"error\":\"No body\"}");
+void LightCommander::handlePlaySequence(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) {
+        request->send(400, "application/json", "{\"error\":\"No body\"}");
         return;
     }
     
-    StaticJsonDocument<256> doc;
-    if (deserializeJson(doc, server.arg("plain"))) {
-        server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, body)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
     }
     
     String seqId = doc["sequenceId"] | "";
+    uint8_t timeline = doc["timeline"] | 0;
+    uint8_t priority = doc["priority"] | timeline;      // Höhere Timeline liegt oben
+    const char* ringStr = doc["ring"] | "both";
+    RingType ring = (RingType)RING_KEYWORDS.find(ringStr, strlen(ringStr), RING_BOTH);
+    
+    TargetMask scope = ALL_TARGETS;
+    JsonArray targetsArray = doc["targets"];
+    if (!targetsArray.isNull()) {
+        std::vector<String> targets;
+        for (JsonVariant v : targetsArray) {
+            targets.push_back(v.as<String>());
+        }
+        scope = targetMask(targets);
+    }
+    
+    lockState();
+    bool success = playSequence(seqId, timeline, priority, scope, ring);
+    unlockState();
     
-    if (playSequence(seqId)) {
-        server.send(200, "application/json", "{\"success\":true}");
+    if (success) {
+        request->send(200, "application/json", "{\"success\":true}");
     } else {
-        server.send(500, "application/json", "{\"error\":\"Failed to play sequence\"}");
+        request->send(500, "application/json", "{\"error\":\"Failed to play sequence\"}");
     }
 }
 
-void LightCommander::handlePauseSequence() {
-    if (pauseSequence()) {
-        server.send(200, "application/json", "{\"success\":true}");
+// Optionaler Body {"timeline": 1}, ohne: alle Timelines
+uint8_t LightCommander::requestTimeline(AsyncWebServerRequest* request) {
+    const char* body = requestBody(request);
+    if (!body) return ALL_TIMELINES;
+    
+    StaticJsonDocument<64> doc;
+    if (deserializeJson(doc, body)) return ALL_TIMELINES;
+    return doc["timeline"] | ALL_TIMELINES;
+}
+
+void LightCommander::handlePauseSequence(AsyncWebServerRequest* request) {
+    uint8_t timeline = requestTimeline(request);
+    
+    lockState();
+    bool success = pauseSequence(timeline);
+    unlockState();
+    
+    if (success) {
+        request->send(200, "application/json", "{\"success\":true}");
     } else {
-        server.send(500, "application/json", "{\"error\":\"Not playing\"}");
+        request->send(500, "application/json", "{\"error\":\"Not playing\"}");
     }
 }
 
-void LightCommander::handleResumeSequence() {
-    if (resumeSequence()) {
-        server.send(200, "application/json", "{\"success\":true}");
+void LightCommander::handleResumeSequence(AsyncWebServerRequest* request) {
+    uint8_t timeline = requestTimeline(request);
+    
+    lockState();
+    bool success = resumeSequence(timeline);
+    unlockState();
+    
+    if (success) {
+        request->send(200, "application/json", "{\"success\":true}");
     } else {
-        server.send(500, "application/json", "{\"error\":\"Cannot resume\"}");
+        request->send(500, "application/json", "{\"error\":\"Cannot resume\"}");
     }
 }
 
-void LightCommander::handleStopSequence() {
-    if (stopSequence()) {
-        server.send(200, "application/json", "{\"success\":true}");
+void LightCommander::handleStopSequence(AsyncWebServerRequest* request) {
+    uint8_t timeline = requestTimeline(request);
+    
+    lockState();
+    bool success = stopSequence(timeline);
+    unlockState();
+    
+    if (success) {
+        request->send(200, "application/json", "{\"success\":true}");
     } else {
-        server.send(500, "application/json", "{\"error\":\"Not playing\"}");
+        request->send(500, "application/json", "{\"error\":\"Not playing\"}");
     }
 }
 
@@ -411,18 +680,73 @@ bool LightCommander::addSpotlight(const String& id, const String& name, const St
     spot.ip = ip;
     spot.online = false;
     
-    spotlights[id] = spot;
+    lockState();
+    int index = internSpotlight(id.c_str(), id.length(), sequenceTargets(nullptr));
+    if (index >= 0) {
+        spot.index = index;
+        Spotlight& stored = spotlights[id];
+        stored = spot;
+        spotlightSlots[index] = &stored;
+        resetSpotlightMetrics(index, id.c_str());
+    }
+    unlockState();
     
-    Serial.printf("Added spotlight: %s (%s) at %s\n", id.c_str(), name.c_str(), ip.c_str());
+    if (index < 0) {
+        LOG_WARN_TAG(id.c_str(), "✗ Too many spotlight ids (max %d)", MAX_SPOTLIGHTS);
+        return false;
+    }
+    LOG_INFO_TAG(id.c_str(), "Added spotlight");
     
-    // Sofort checken ob online
-    checkSpotlightStatus();
+    // Sofort checken ob online (im Worker, vor begin() beim nächsten Intervall)
+    if (jobQueue) submitJob(JOB_HEALTH_CHECK, std::vector<String>(), "", "");
     
     return true;
 }
 
 bool LightCommander::removeSpotlight(const String& id) {
-    return spotlights.erase(id) > 0;
+    lockState();
+    auto it = spotlights.find(id);
+    bool removed = it != spotlights.end();
+    if (removed) {
+        // Index bleibt vergeben, solange geladene Sequenzen darauf verweisen
+        spotlightSlots[it->second.index] = nullptr;
+        resetSpotlightMetrics(it->second.index, nullptr);
+        spotlights.erase(it);
+    }
+    unlockState();
+    return removed;
+}
+
+// ID → fester Index (Bit in TargetMask), höchstens MAX_SPOTLIGHTS
+// verschiedene. Ist die Tabelle voll, geht ein Index neu weg, den weder ein
+// registrierter Scheinwerfer noch used (Sequenzen) belegt – Tippfehler in
+// ersetzten Sequenzen halten keinen Platz auf Dauer. -1 = alle belegt.
+// Unter stateMutex.
+int LightCommander::internSpotlight(const char* id, size_t length, TargetMask used) {
+    for (uint8_t i = 0; i < spotlightIdCount; i++) {
+        const String& known = spotlightIds[i];
+        if (known.length() == length && memcmp(known.c_str(), id, length) == 0) return i;
+    }
+    if (spotlightIdCount < MAX_SPOTLIGHTS) {
+        spotlightIds[spotlightIdCount] = String(id, length);
+        return spotlightIdCount++;
+    }
+    
+    for (uint8_t i = 0; i < MAX_SPOTLIGHTS; i++) {
+        if (spotlightSlots[i] || (used & ((TargetMask)1 << i))) continue;
+        spotlightIds[i] = String(id, length);
+        return i;
+    }
+    return -1;
+}
+
+// Indizes der geladenen Sequenzen, ohne die gerade ersetzte. Unter stateMutex.
+TargetMask LightCommander::sequenceTargets(const String* replaced) {
+    TargetMask targets = 0;
+    for (const auto& pair : sequences) {
+        if (!replaced || pair.first != *replaced) targets |= pair.second.targets;
+    }
+    return targets;
 }
 
 Spotlight* LightCommander::getSpotlight(const String& id) {
@@ -441,417 +765,2117 @@ std::vector<Spotlight*> LightCommander::getAllSpotlights() {
     return result;
 }
 
+// "uptime" aus /status (ms seit Start), 0 = unbekannt
+static unsigned long readUptime(const String& status) {
+    JsonCursor json(status.c_str(), status.length());
+    const char* key;
+    size_t keyLength;
+    unsigned long uptime = 0;
+    
+    if (!json.enterObject()) return 0;
+    while (json.nextKey(key, keyLength)) {
+        if (keyLength == 6 && memcmp(key, "uptime", 6) == 0) readValue(json, uptime);
+        else json.skipValue();
+    }
+    return uptime;
+}
+
 void LightCommander::checkSpotlightStatus() {
-    HTTPClient http;
+    MemoryScope scope(MEMORY_HTTP);
+    unsigned long start = micros();
     
+    // Kopie ziehen: HTTP läuft ohne Lock
+    lockState();
+    std::vector<Spotlight> snapshot;
     for (auto& pair : spotlights) {
-        Spotlight& spot = pair.second;
-        
+        snapshot.push_back(pair.second);
+    }
+    unlockState();
+    
+    HTTPClient http;
+    
+    for (Spotlight& spot : snapshot) {
         String url = "http://" + spot.ip + "/status";
         http.begin(url);
         http.setTimeout(3000);
         
         int httpCode = http.GET();
+        bool cameBack = !spot.online && spot.lastSeen != 0;    // Erster Kontakt zählt nicht
+        unsigned long lastUptime = spot.uptime;
         
         if (httpCode == 200) {
             spot.online = true;
             spot.lastSeen = millis();
+            spot.uptime = readUptime(http.getString());
         } else {
             spot.online = false;
         }
         
         http.end();
-    }
-}
-
-// ============================================================================
-// EFFEKT-STEUERUNG
-// ============================================================================
-
-bool LightCommander::sendEffect(const std::vector<String>& targets, RingType ring,
-                                 EffectType effect, const EffectParams& params) {
-    bool allSuccess = true;
-    
-    for (const String& targetId : targets) {
-        Spotlight* spot = getSpotlight(targetId);
-        if (!spot) {
-            Serial.printf("✗ Spotlight '%s' not found\n", targetId.c_str());
-            allSuccess = false;
-            continue;
-        }
+        bool rebooted = spot.uptime < lastUptime;
         
-        Serial.printf("→ Sending to %s (%s)...\n", targetId.c_str(), spot->ip.c_str());
-        
-        String json = buildEffectJson(ring, effect, params);
-        
-        if (!sendToSpotlight(spot->ip, json)) {
-            Serial.printf("✗ Failed to send to %s\n", targetId.c_str());
-            allSuccess = false;
-        } else {
-            Serial.printf("✓ Sent to %s\n", targetId.c_str());
+        if (spot.online) {
+            spot.clockRttUs = syncSpotlightClock(spot);
+            fetchSpotlightTelemetry(spot);
         }
-    }
-    
-    return allSuccess;
-}
-
-bool LightCommander::stopEffect(const std::vector<String>& targets, RingType ring) {
-    bool allSuccess = true;
-    
-    for (const String& targetId : targets) {
-        Spotlight* spot = getSpotlight(targetId);
-        if (!spot) continue;
-        
-        HTTPClient http;
-        String url = "http://" + spot->ip + "/stop";
-        http.begin(url);
-        http.addHeader("Content-Type", "application/json");
-        http.setTimeout(5000);
-        
-        // Ring als JSON senden
-        StaticJsonDocument<128> doc;
-        if (ring == RING_INNER) doc["ring"] = "inner";
-        else if (ring == RING_OUTER) doc["ring"] = "outer";
-        else doc["ring"] = "both";
         
-        String json;
-        serializeJson(doc, json);
-        
-        int httpCode = http.POST(json);
-        if (httpCode != 200) {
-            allSuccess = false;
+        // Wieder da, neu gestartet oder Befehle offen → Soll-Zustand nachschicken
+        bool resync = false;
+        lockState();
+        Spotlight* current = getSpotlight(spot.id);
+        if (current) {
+            current->online = spot.online;
+            current->lastSeen = spot.lastSeen;
+            current->clockRttUs = spot.clockRttUs;
+            current->uptime = spot.uptime;
+            for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+                if ((rebooted || cameBack) && current->shadowState[ring] == SHADOW_CONFIRMED) {
+                    current->shadowState[ring] = SHADOW_PENDING;
+                }
+                if (current->shadowState[ring] == SHADOW_PENDING) resync = true;
+            }
         }
+        unlockState();
         
-        http.end();
+        if (spot.online && resync) {
+            if (rebooted) LOG_WARN_TAG(spot.id.c_str(), "Spotlight restarted");
+            resyncSpotlight({ spot.id, spot.ip });
+        }
     }
     
-    return allSuccess;
+    recordMetric(metrics.healthCheck, micros() - start);
 }
 
-bool LightCommander::sendToSpotlight(const String& ip, const String& json) {
+// Liefert die RTT des Requests in µs (0 = fehlgeschlagen)
+uint32_t LightCommander::syncSpotlightClock(const Spotlight& spot) {
+    // Show-Uhr = Commander-millis(); Scheinwerfer übernimmt den Offset.
+    // Dazu µs fürs Tracing: der Scheinwerfer rechnet die halbe RTT der
+    // letzten Synchronisation als Laufzeit drauf.
     HTTPClient http;
-    String url = "http://" + ip + "/effect";
-    
+    String url = "http://" + spot.ip + "/clock";
     http.begin(url);
     http.addHeader("Content-Type", "application/json");
-    http.setTimeout(5000);
+    http.setTimeout(3000);
     
+    uint32_t start = micros();
+    String json = "{\"time\":" + String(millis()) + ",\"timeUs\":" + String(start) +
+                  ",\"rttUs\":" + String(spot.clockRttUs) + "}";
     int httpCode = http.POST(json);
-    bool success = (httpCode == 200);
-    
-    if (!success) {
-        Serial.printf("HTTP Error: %d (%s)\n", httpCode, http.errorToString(httpCode).c_str());
+    uint32_t rtt = micros() - start;
+    if (httpCode != 200) {
+        LOG_WARN_TAG(spot.id.c_str(), "✗ Clock sync failed (%d)", httpCode);
     }
     
     http.end();
-    return success;
+    return httpCode == 200 ? rtt : 0;
 }
 
-String LightCommander::buildEffectJson(RingType ring, EffectType effect, const EffectParams& params) {
-    StaticJsonDocument<2048> doc;
-    
-    // Ring
-    if (ring == RING_INNER) doc["ring"] = "inner";
-    else if (ring == RING_OUTER) doc["ring"] = "outer";
-    else doc["ring"] = "both";
-    
-    // Effekt
-    if (effect == EFFECT_STATIC) doc["effect"] = "static";
-    else if (effect == EFFECT_FADE) doc["effect"] = "fade";
-    else if (effect == EFFECT_STROBE) doc["effect"] = "strobe";
-    else if (effect == EFFECT_PULSE) doc["effect"] = "pulse";
-    else if (effect == EFFECT_ROTATION) doc["effect"] = "rotation";
-    else if (effect == EFFECT_RAINBOW) doc["effect"] = "rainbow";
-    else if (effect == EFFECT_CHASE) doc["effect"] = "chase";
-    
-    // Farbe
-    JsonArray color = doc.createNestedArray("color");
-    color.add(params.color.r);
-    color.add(params.color.g);
-    color.add(params.color.b);
+void LightCommander::fetchSpotlightTelemetry(const Spotlight& spot) {
+    // Binär (common/Telemetry.h): nur die Fenster der Messstellen ohne Ring-Bezug
+    HTTPClient http;
+    String url = "http://" + spot.ip + "/telemetry";
+    http.begin(url);
+    http.setTimeout(3000);
     
-    // Brightness
-    doc["brightness"] = params.brightness;
+    int httpCode = http.GET();
+    int size = http.getSize();
+    if (httpCode != 200 || size < (int)sizeof(TelemetryHeader) || size > 4096) {
+        http.end();
+        return;
+    }
     
-    // Speed/Duration
-    if (params.speed > 0) doc["speed"] = params.speed;
-    if (params.duration > 0) doc["duration"] = params.duration;
+    uint8_t* data = (uint8_t*)malloc(size);
+    if (!data) {
+        http.end();
+        return;
+    }
+    size_t length = http.getStream().readBytes(data, size);
+    http.end();
     
-    // Rotation
-    if (effect == EFFECT_ROTATION) {
-        JsonObject rot = doc.createNestedObject("rotation");
-        
-        JsonArray activeColor = rot.createNestedArray("activeColor");
-        activeColor.add(params.rotation.activeColor.r);
-        activeColor.add(params.rotation.activeColor.g);
-        activeColor.add(params.rotation.activeColor.b);
-        
-        JsonArray inactiveColor = rot.createNestedArray("inactiveColor");
-        inactiveColor.add(params.rotation.inactiveColor.r);
-        inactiveColor.add(params.rotation.inactiveColor.g);
-        inactiveColor.add(params.rotation.inactiveColor.b);
-        
-        rot["speed"] = params.rotation.speed;
-        rot["direction"] = (params.rotation.direction == DIRECTION_CLOCKWISE) ? 
-            "clockwise" : "counterclockwise";
-        
-        if (params.rotation.pattern == PATTERN_SINGLE) rot["pattern"] = "single";
-        else if (params.rotation.pattern == PATTERN_TRAIL) {
-            rot["pattern"] = "trail";
-            rot["trailLength"] = params.rotation.trailLength;
+    TelemetryHeader header;
+    TelemetrySummary frame[NUM_TELEMETRY_STAGES] = {};
+    bool valid = readTelemetryHeader(data, length, header);
+    if (valid) {
+        TelemetryEntry entry;
+        for (uint8_t i = 0; readTelemetryEntry(data, length, header, i, entry); i++) {
+            if (entry.ring != TELEMETRY_ANY || entry.stage >= NUM_TELEMETRY_STAGES) continue;
+            frame[entry.stage] = entry.window;
         }
-        else if (params.rotation.pattern == PATTERN_OPPOSITE) rot["pattern"] = "opposite";
-        else if (params.rotation.pattern == PATTERN_WAVE) rot["pattern"] = "wave";
     }
+    free(data);
     
-    String output;
-    serializeJson(doc, output);
-    return output;
+    if (!valid) {
+        LOG_WARN_TAG(spot.id.c_str(), "Invalid telemetry (%u bytes)", length);
+        return;
+    }
+    
+    portENTER_CRITICAL(&metricsMux);
+    SpotlightMetrics* m = spotlightMetrics(spot.index);
+    if (m) {
+        m->frameTelemetry = header.flags & TELEMETRY_FLAG_ENABLED;
+        memcpy(m->frame, frame, sizeof(frame));
+    }
+    portEXIT_CRITICAL(&metricsMux);
 }
 
 // ============================================================================
-// SEQUENZ-MANAGEMENT
+// EFFEKT-STEUERUNG
 // ============================================================================
 
-bool LightCommander::loadSequence(const String& json) {
-    DynamicJsonDocument doc(16384);
-    
-    if (deserializeJson(doc, json)) {
-        Serial.println("✗ Failed to parse sequence JSON");
-        return false;
+bool LightCommander::sendEffect(const std::vector<String>& ids, const Effect& effect) {
+    return sendShadowed(targetMask(ids), effect) == ids.size();
+}
+
+// API-Befehle: registrierte Scheinwerfer als Bitmaske, Unbekannte fallen raus
+TargetMask LightCommander::targetMask(const std::vector<String>& ids) {
+    TargetMask targets = 0;
+    
+    lockState();
+    for (const String& id : ids) {
+        Spotlight* spot = getSpotlight(id);
+        if (spot) targets |= (TargetMask)1 << spot->index;
+        else LOG_WARN_TAG(id.c_str(), "✗ Spotlight not found");
     }
+    unlockState();
     
-    Sequence seq;
-    seq.id = doc["id"] | "";
-    seq.name = doc["name"] | "";
-    seq.duration = doc["duration"] | 0;
-    seq.loop = doc["loop"] | false;
-    seq.spotifyUri = doc["spotifyUri"] | "";
-    seq.syncWithSpotify = doc["syncWithSpotify"] | false;
-    
-    // Events parsen
-    JsonArray eventsArray = doc["events"];
-    for (JsonObject eventObj : eventsArray) {
-        SequenceEvent event;
-        event.timestamp = eventObj["timestamp"] | 0;
-        
-        // Targets
-        JsonArray targetsArray = eventObj["targets"];
-        for (JsonVariant v : targetsArray) {
-            event.targets.push_back(v.as<String>());
-        }
-        
-        // Ring
-        String ringStr = eventObj["ring"] | "both";
-        if (ringStr == "inner") event.ring = RING_INNER;
-        else if (ringStr == "outer") event.ring = RING_OUTER;
-        else event.ring = RING_BOTH;
-        
-        // Effect
-        String effectStr = eventObj["effect"] | "static";
-        if (effectStr == "fade") event.effect = EFFECT_FADE;
-        else if (effectStr == "strobe") event.effect = EFFECT_STROBE;
-        else if (effectStr == "pulse") event.effect = EFFECT_PULSE;
-        else if (effectStr == "rotation") event.effect = EFFECT_ROTATION;
-        else if (effectStr == "rainbow") event.effect = EFFECT_RAINBOW;
-        else if (effectStr == "chase") event.effect = EFFECT_CHASE;
-        else event.effect = EFFECT_STATIC;
-        
-        // Params
-        JsonObject params = eventObj["params"];
-        if (params.containsKey("color")) {
-            JsonArray c = params["color"];
-            event.params.color = Color(c[0], c[1], c[2]);
-        }
-        if (params.containsKey("brightness")) {
-            event.params.brightness = params["brightness"];
-        }
-        if (params.containsKey("duration")) {
-            event.params.duration = params["duration"];
-        }
-        if (params.containsKey("speed")) {
-            event.params.speed = params["speed"];
-        }
-        
-        // Rotation params
-        if (params.containsKey("rotation")) {
-            JsonObject rot = params["rotation"];
-            if (rot.containsKey("activeColor")) {
-                JsonArray ac = rot["activeColor"];
-                event.params.rotation.activeColor = Color(ac[0], ac[1], ac[2]);
-            }
-            if (rot.containsKey("inactiveColor")) {
-                JsonArray ic = rot["inactiveColor"];
-                event.params.rotation.inactiveColor = Color(ic[0], ic[1], ic[2]);
-            }
-            if (rot.containsKey("speed")) {
-                event.params.rotation.speed = rot["speed"];
-            }
-            if (rot.containsKey("direction")) {
-                String dir = rot["direction"] | "clockwise";
-                event.params.rotation.direction = (dir == "counterclockwise") ? 
-                    DIRECTION_COUNTERCLOCKWISE : DIRECTION_CLOCKWISE;
-            }
-            if (rot.containsKey("pattern")) {
-                String pat = rot["pattern"] | "single";
-                if (pat == "trail") event.params.rotation.pattern = PATTERN_TRAIL;
-                else if (pat == "opposite") event.params.rotation.pattern = PATTERN_OPPOSITE;
-                else if (pat == "wave") event.params.rotation.pattern = PATTERN_WAVE;
-                else event.params.rotation.pattern = PATTERN_SINGLE;
-            }
-            if (rot.containsKey("trailLength")) {
-                event.params.rotation.trailLength = rot["trailLength"];
-            }
+    return targets;
+}
+
+bool LightCommander::resolveTargets(const std::vector<String>& ids, std::vector<Target>& targets) {
+    bool allFound = true;
+    
+    lockState();
+    for (const String& id : ids) {
+        Spotlight* spot = getSpotlight(id);
+        if (!spot) {
+            LOG_WARN_TAG(id.c_str(), "✗ Spotlight not found");
+            allFound = false;
+            continue;
         }
-        
-        seq.events.push_back(event);
+        targets.push_back({ spot->id, spot->ip, spot->index });
     }
+    unlockState();
     
-    sequences[seq.id] = seq;
-    
-    Serial.printf("✓ Loaded sequence '%s' with %d events\n", seq.name.c_str(), seq.events.size());
-    return true;
+    return allFound;
 }
 
-Sequence* LightCommander::getSequence(const String& id) {
-    auto it = sequences.find(id);
-    if (it != sequences.end()) {
-        return &(it->second);
-    }
-    return nullptr;
+bool LightCommander::stopEffect(const std::vector<String>& ids, RingType ring) {
+    return sendStop(ids, ring) == ids.size();
 }
 
-std::vector<String> LightCommander::listSequences() {
-    std::vector<String> result;
-    for (auto& pair : sequences) {
-        result.push_back(pair.first);
+uint8_t LightCommander::sendToTargets(const std::vector<Target>& targets, const String& json,
+                                      const char* path, uint32_t traceId) {
+    unsigned long start = micros();
+    uint8_t succeeded = 0;
+    
+    for (const Target& target : targets) {
+        if (sendToSpotlight(target, json, path, traceId)) {
+            LOG_DEBUG_TAG(target.id.c_str(), "✓ Sent %u bytes", json.length());
+            succeeded++;
+        }
     }
-    return result;
+    
+    recordMetric(metrics.fanOut, micros() - start);
+    return succeeded;
 }
 
-// ============================================================================
-// SEQUENZ-PLAYBACK
-// ============================================================================
+bool LightCommander::sendToSpotlight(const Target& target, const String& json, const char* path,
+                                     uint32_t traceId, String* response) {
+    return sendToSpotlight(target, json.c_str(), json.length(), path, traceId, response);
+}
 
-bool LightCommander::playSequence(const String& sequenceId) {
-    Sequence* seq = getSequence(sequenceId);
-    if (!seq) {
-        Serial.printf("✗ Sequence '%s' not found\n", sequenceId.c_str());
-        return false;
+bool LightCommander::sendToSpotlight(const Target& target, const char* body, size_t length, const char* path,
+                                     uint32_t traceId, String* response) {
+    int httpCode = postToSpotlight(target, body, length, path, traceId, response);
+    if (httpCode != 200) {
+        LOG_WARN_TAG(target.id.c_str(), "HTTP error %d", httpCode);
     }
-    
-    playback.active = true;
-    playback.currentSequence = sequenceId;
-    playback.startTime = millis();
-    playback.paused = false;
-    currentSequence = seq;
-    currentEventIndex = 0;
-    
-    Serial.printf("▶️ Playing sequence '%s'\n", seq->name.c_str());
-    return true;
+    return httpCode == 200;
 }
 
-bool LightCommander::pauseSequence() {
-    if (!playback.active || playback.paused) return false;
+// HTTP-Code der Antwort (negativ = Verbindungsfehler), ohne Log. Der Body
+// kommt vom Stack des Aufrufers – URL und HTTPClient zählen unter "http"
+int LightCommander::postToSpotlight(const Target& target, const char* body, size_t length, const char* path,
+                                    uint32_t traceId, String* response) {
+    MemoryScope scope(MEMORY_HTTP);
+    HTTPClient http;
+    String url = "http://" + target.ip + path;
     
-    playback.paused = true;
-    playback.pauseTime = millis();
+    unsigned long start = micros();
+    if (traceId) traceSent(traceId, target, start);
+    http.begin(url);
+    http.addHeader("Content-Type", "application/json");
+    http.setTimeout(5000);
     
-    Serial.println("⏸️ Sequence paused");
-    return true;
-}
-
-bool LightCommander::resumeSequence() {
-    if (!playback.active || !playback.paused) return false;
+    int httpCode = http.POST((uint8_t*)body, length);
+    if (httpCode == 200 && response) *response = http.getString();
     
-    // Zeit korrigieren
-    unsigned long pauseDuration = millis() - playback.pauseTime;
-    playback.startTime += pauseDuration;
-    playback.paused = false;
+    http.end();
+    recordSend(target.index, micros() - start, httpCode);
     
-    Serial.println("▶️ Sequence resumed");
-    return true;
+    return httpCode;
 }
 
-bool LightCommander::stopSequence() {
-    if (!playback.active) return false;
-    
-    playback.active = false;
-    playback.paused = false;
-    currentSequence = nullptr;
-    currentEventIndex = 0;
+// Batch-Fan-out: Ziele nacheinander wie sendToTargets, jedes mit eigener
+// Nachricht. Jeder Scheinwerfer meldet seinen Vorlauf bis "at" – wer negativ
+// liegt, wendet seinen Teil entsprechend später an.
+uint8_t LightCommander::sendBatch(const std::vector<String>& ids, const std::vector<String>& bodies,
+                                  uint32_t traceId, BatchSkew& skew) {
+    unsigned long start = micros();
+    uint8_t succeeded = 0;
+    uint32_t earliestUs = UINT32_MAX;
+    uint32_t latestUs = 0;
+    
+    for (size_t i = 0; i < ids.size() && i < bodies.size(); i++) {
+        lockState();
+        Spotlight* spot = getSpotlight(ids[i]);
+        Target target;
+        uint32_t clockRttUs = 0;
+        if (spot) {
+            target = { spot->id, spot->ip, spot->index };
+            clockRttUs = spot->clockRttUs;
+        }
+        unlockState();
+        
+        if (target.id.length() == 0) {
+            LOG_WARN_TAG(ids[i].c_str(), "✗ Spotlight not found");
+            continue;
+        }
+        
+        String response;
+        bool success = sendToSpotlight(target, bodies[i], "/batch", traceId, &response);
+        
+        // Schattenzustand: Teile in Reihenfolge, der letzte pro Ring gilt
+        unsigned long at;
+        lockState();
+        Spotlight* current = getSpotlight(target.id);
+        if (current) {
+            decodeBatch(bodies[i].c_str(), bodies[i].length(), at, [&](const Effect& effect) {
+                rememberShadow(*current, effect, success ? SHADOW_CONFIRMED : SHADOW_PENDING);
+            });
+        }
+        unlockState();
+        
+        if (!success) continue;
+        succeeded++;
+        
+        StaticJsonDocument<64> doc;
+        if (deserializeJson(doc, response) || !doc.containsKey("leadUs")) {
+            skew.unsynced++;
+            continue;
+        }
+        int32_t leadUs = doc["leadUs"];
+        uint32_t lateUs = leadUs < 0 ? (uint32_t)-leadUs : 0;
+        if (leadUs < 0) skew.late++;
+        earliestUs = std::min(earliestUs, lateUs);
+        latestUs = std::max(latestUs, lateUs);
+        skew.clockErrorUs = std::max(skew.clockErrorUs, clockRttUs / 2);
+    }
+    
+    if (latestUs >= earliestUs) skew.skewUs = latestUs - earliestUs;
+    recordMetric(metrics.fanOut, micros() - start);
+    return succeeded;
+}
+
+// Beide in einen Buffer des Aufrufers (EFFECT_JSON_SIZE): Effekte gehen
+// ohne Heap raus, 0 = zu groß
+size_t LightCommander::buildEffectDelta(const Effect& base, const Effect& effect, char* buffer, size_t size) {
+    size_t length = encodeEffectDelta(base, effect, buffer, size);
+    if (length == 0) LOG_ERROR("✗ Effect JSON too large");
+    return length;
+}
+
+size_t LightCommander::buildEffectJson(const Effect& effect, char* buffer, size_t size) {
+    // Gemeinsamer Encoder (common/EffectEncoder.h) → Scheinwerfer dekodiert
+    // mit demselben Protokoll-Code
+    size_t length = encodeEffect(effect, buffer, size);
+    if (length == 0) LOG_ERROR("✗ Effect JSON too large");
+    return length;
+}
+
+uint32_t LightCommander::forwardToTargets(JsonDocument& doc, const char* path) {
+    std::vector<String> targets;
+    JsonArray targetsArray = doc["targets"];
+    for (JsonVariant v : targetsArray) {
+        targets.push_back(v.as<String>());
+    }
+    
+    // Rest des Bodys unverändert weiterreichen, Prüfung macht der Scheinwerfer
+    doc.remove("targets");
+    String json;
+    serializeJson(doc, json);
+    
+    return submitJob(JOB_FORWARD, targets, path, json);
+}
+
+DecodeResult LightCommander::parseEffectRequest(const char* body, size_t length,
+                                                std::vector<String>& targets, Effect& effect) {
+    JsonCursor json(body, length);
+    return parseEffectRequest(json, targets, effect);
+}
+
+DecodeResult LightCommander::parseEffectRequest(JsonCursor& json, std::vector<String>& targets, Effect& effect) {
+    // Commander-Default ist weiß (Scheinwerfer: schwarz)
+    effect.color = Color(255, 255, 255);
+    
+    return decodeEffect(json, effect, [&](JsonCursor& json, int8_t field) {
+        if (field == FIELD_TARGETS) readTargets(json, targets);
+        else json.skipValue();
+    });
+}
+
+// Felder von POST /api/effect/batch ("commands" = Befehle wie /api/effect/send)
+enum BatchRequestField : int8_t {
+    BATCH_REQUEST_AT,
+    BATCH_REQUEST_COMMANDS
+};
+
+constexpr const char* BATCH_REQUEST_FIELD_NAMES[] = { "at", "commands" };
+
+constexpr auto BATCH_REQUEST_FIELDS = makeKeywordTable<4>(BATCH_REQUEST_FIELD_NAMES);
+
+static_assert(BATCH_REQUEST_FIELDS.seed, "Kein perfekter Hash für Batch-Felder");
+
+DecodeResult LightCommander::parseBatchRequest(const char* body, size_t length,
+                                               unsigned long& at, std::vector<BatchPart>& parts) {
+    JsonCursor json(body, length);
+    const char* key;
+    size_t keyLength;
+    DecodeResult result = DECODE_OK;
+    
+    at = 0;
+    if (!json.enterObject()) return DECODE_INVALID_JSON;
+    
+    while (result == DECODE_OK && json.nextKey(key, keyLength)) {
+        switch (BATCH_REQUEST_FIELDS.find(key, keyLength)) {
+            case BATCH_REQUEST_AT:
+                readValue(json, at);
+                break;
+            case BATCH_REQUEST_COMMANDS:
+                if (json.skipNull() || !json.enterArray()) break;
+                while (result == DECODE_OK && json.nextElement()) {
+                    std::vector<String> targets;
+                    Effect effect;
+                    result = parseEffectRequest(json, targets, effect);
+                    
+                    // Pro Scheinwerfer sammeln, Befehlsreihenfolge bleibt erhalten
+                    for (const String& id : targets) {
+                        BatchPart* part = nullptr;
+                        for (BatchPart& existing : parts) {
+                            if (existing.id == id) part = &existing;
+                        }
+                        if (!part) {
+                            parts.push_back({ id, std::vector<Effect>() });
+                            part = &parts.back();
+                        }
+                        part->effects.push_back(effect);
+                    }
+                }
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+    
+    if (result != DECODE_OK) return result;
+    return json.ok() ? DECODE_OK : DECODE_INVALID_JSON;
+}
+
+void LightCommander::readTargets(JsonCursor& json, std::vector<String>& targets) {
+    // Einzige Allokation: IDs werden für den Job gebraucht
+    const char* id;
+    size_t idLength;
+    if (json.skipNull() || !json.enterArray()) return;
+    while (json.nextElement() && json.readString(id, idLength)) {
+        targets.push_back(String(id, idLength));
+    }
+}
+
+// Sequenz-Events: IDs schon beim Laden auf Indizes abbilden – das Event hält
+// nur die Bitmaske, Abspielen ist ein Bit-Scan statt Map-Lookups. Beim Parsen
+// zählen Indizes in ids (pro Sequenz, ohne Lock), internSequenceTargets()
+// bildet sie danach auf einmal ab. Dazu order: Indizes in Listenreihenfolge
+// (Makro-Events), ohne Doppelte. Mehr als MAX_SPOTLIGHTS IDs landen ohne Bit
+// in ids, parseSequenceEvents() lehnt die Sequenz dann ab
+void LightCommander::readTargetMask(JsonCursor& json, std::vector<String>& ids, TargetMask& targets,
+                                    SequenceMacro& order) {
+    const char* id;
+    size_t idLength;
+    if (json.skipNull() || !json.enterArray()) return;
+    while (json.nextElement() && json.readString(id, idLength)) {
+        size_t index = 0;
+        while (index < ids.size() &&
+               (ids[index].length() != idLength || memcmp(ids[index].c_str(), id, idLength) != 0)) {
+            index++;
+        }
+        if (index == ids.size()) {
+            ids.push_back(String(id, idLength));
+        }
+        if (index >= MAX_SPOTLIGHTS) continue;
+        TargetMask bit = (TargetMask)1 << index;
+        if (!(targets & bit)) order.order[order.length++] = index;
+        targets |= bit;
+    }
+}
+
+// Indizes der Sequenz (Position in ids) → feste Indizes, alle unter einem
+// Lock. Noch nicht registrierte IDs bekommen ihren Index hier und gelten,
+// sobald sie dazukommen; ist kein Index mehr frei, false (loadSequence()
+// lehnt die Sequenz ab, statt Ziele stillschweigend wegzulassen).
+// Unter stateMutex, im selben Lock wie das Eintragen der Sequenz – sonst
+// könnte ein anderer Aufruf die frischen Indizes wieder vergeben.
+bool LightCommander::internSequenceTargets(Sequence& seq, const std::vector<String>& ids) {
+    uint8_t mapped[MAX_SPOTLIGHTS];
+    TargetMask others = sequenceTargets(&seq.id);
+    for (size_t i = 0; i < ids.size(); i++) {
+        int index = internSpotlight(ids[i].c_str(), ids[i].length(), others | seq.targets);
+        if (index < 0) {
+            LOG_WARN_TAG(ids[i].c_str(), "✗ Too many spotlight ids (max %d), sequence rejected", MAX_SPOTLIGHTS);
+            return false;
+        }
+        mapped[i] = index;
+        seq.targets |= (TargetMask)1 << index;
+    }
     
-    Serial.println("⏹️ Sequence stopped");
+    for (uint16_t e = 0; e < seq.eventCount; e++) {
+        TargetMask local = seq.events[e].targets;
+        TargetMask targets = 0;
+        for (; local; local &= local - 1) targets |= (TargetMask)1 << mapped[__builtin_ctzll(local)];
+        seq.events[e].targets = targets;
+    }
+    for (uint8_t m = 0; m < seq.macroCount; m++) {
+        SequenceMacro& macro = seq.macros[m];
+        for (uint8_t i = 0; i < macro.length; i++) macro.order[i] = mapped[macro.order[i]];
+    }
     return true;
 }
 
-void LightCommander::updateSequencePlayback() {
-    if (!currentSequence || !playback.active) return;
+// ============================================================================
+// SCHATTENZUSTAND (was jeder Scheinwerfer pro Ring zeigt)
+// ============================================================================
+
+// Einmalige Verläufe und Effekte, die auf dem Scheinwerfer von selbst enden
+// (fade, strobe mit duration), starten beim erneuten Senden bewusst neu – nie
+// unterdrücken, der Schatten zeigt sie sonst noch, wenn sie längst aus sind
+static bool restartsOnResend(const Effect& effect) {
+    const EffectAutomation& a = effect.automation;
+    return effect.type == EFFECT_FADE || (effect.type == EFFECT_STROBE && effect.duration > 0) ||
+           (a.brightness.count && !a.brightness.loop) || (a.color.count && !a.color.loop) ||
+           (a.speed.count && !a.speed.loop) || (a.trailLength.count && !a.trailLength.loop);
+}
+
+// Pro Ziel nur, was sich ändert: nichts (zeigt er schon), ein Delta oder den
+// vollen Effekt. Basis ist der bestätigte Schattenzustand – nach Fehlern,
+// Segment-Effekten oder einem Neustart geht der volle Effekt raus.
+uint8_t LightCommander::sendShadowed(TargetMask targets, const Effect& effect) {
+    unsigned long start = micros();
+    uint8_t succeeded = 0;
+    char body[EFFECT_JSON_SIZE];        // Delta oder voller Effekt, pro Ziel neu
+    
+    for (TargetMask rest = targets; rest; rest &= rest - 1) {
+        uint8_t index = __builtin_ctzll(rest);
+        Target target;
+        Effect base;
+        EffectSend kind = EFFECT_SEND_FULL;
+        
+        lockState();
+        Spotlight* spot = spotlightSlots[index];
+        if (spot) {
+            MemoryScope scope(MEMORY_HTTP);     // Adresse kopieren (IP länger als SSO)
+            target = { spot->id, spot->ip, spot->index };
+            uint8_t ring = effect.ring == RING_BOTH ? RING_INNER : effect.ring;
+            bool confirmed = effect.segments == 0 && spot->shadowState[ring] == SHADOW_CONFIRMED;
+            if (effect.ring == RING_BOTH) {
+                confirmed = confirmed && spot->shadowState[RING_OUTER] == SHADOW_CONFIRMED &&
+                            sameEffectState(spot->shadow[RING_INNER], spot->shadow[RING_OUTER]);
+            }
+            if (confirmed) {
+                base = spot->shadow[ring];
+                bool shown = sameEffectState(base, effect) && !restartsOnResend(effect);
+                kind = shown ? EFFECT_SEND_SUPPRESSED : EFFECT_SEND_DELTA;
+            }
+        }
+        if (!spot) LOG_WARN_TAG(spotlightIds[index].c_str(), "✗ Spotlight not found");
+        unlockState();
+        
+        if (!spot) continue;
+        if (kind == EFFECT_SEND_SUPPRESSED) {
+            countEffectSend(kind);
+            succeeded++;
+            continue;
+        }
+        
+        int httpCode = 0;
+        bool rebooted = false;
+        if (kind == EFFECT_SEND_DELTA) {
+            size_t length = buildEffectDelta(base, effect, body, sizeof(body));
+            httpCode = postToSpotlight(target, body, length, "/effect/delta", effect.traceId);
+            // 409: Basis fehlt (Neustart), 404: Firmware ohne Delta → voller Effekt
+            rebooted = httpCode == 409;
+            if (httpCode == 404 || httpCode == 409) kind = EFFECT_SEND_FULL;
+        }
+        if (rebooted) {
+            // Uhr sofort nachziehen, nicht erst beim Health-Check: sonst läuft
+            // der Effekt nicht phasengleich mit den anderen
+            MemoryScope scope(MEMORY_HTTP);
+            Spotlight clock;
+            clock.id = target.id;
+            clock.ip = target.ip;
+            uint32_t clockRttUs = syncSpotlightClock(clock);
+            
+            lockState();
+            spot = spotlightSlots[index];
+            if (spot) spot->clockRttUs = clockRttUs;
+            for (uint8_t ring = RING_INNER; spot && ring <= RING_OUTER; ring++) {
+                if (spot->shadowState[ring] == SHADOW_CONFIRMED) spot->shadowState[ring] = SHADOW_PENDING;
+            }
+            unlockState();
+        }
+        if (kind == EFFECT_SEND_FULL) {
+            size_t length = buildEffectJson(effect, body, sizeof(body));
+            httpCode = postToSpotlight(target, body, length, "/effect", effect.traceId);
+        }
+        
+        bool success = httpCode == 200;
+        if (success) {
+            LOG_DEBUG_TAG(target.id.c_str(), "✓ Sent effect (%s)", EFFECT_SEND_NAMES[kind]);
+            countEffectSend(kind);
+            succeeded++;
+        } else {
+            LOG_WARN_TAG(target.id.c_str(), "HTTP error %d", httpCode);
+        }
+        
+        lockState();
+        spot = spotlightSlots[index];
+        if (spot) rememberShadow(*spot, effect, success ? SHADOW_CONFIRMED : SHADOW_PENDING);
+        unlockState();
+        
+        // Der andere Ring fehlt nach dem Neustart auch
+        if (rebooted) resyncSpotlight(target);
+    }
+    
+    recordMetric(metrics.fanOut, micros() - start);
+    return succeeded;
+}
+
+uint8_t LightCommander::sendStop(const std::vector<String>& ids, RingType ring) {
+    unsigned long start = micros();
+    std::vector<Target> targets;
+    resolveTargets(ids, targets);
+    
+    // Ring als JSON senden
+    StaticJsonDocument<128> doc;
+    doc["ring"] = RING_NAMES[ring];
+    
+    String json;
+    serializeJson(doc, json);
+    
+    Effect stopped;     // EFFECT_OFF
+    stopped.ring = ring;
+    uint8_t succeeded = 0;
     
-    unsigned long currentTime = millis() - playback.startTime;
+    for (const Target& target : targets) {
+        bool success = sendToSpotlight(target, json, "/stop");
+        if (success) succeeded++;
+        
+        lockState();
+        Spotlight* spot = getSpotlight(target.id);
+        if (spot) rememberShadow(*spot, stopped, success ? SHADOW_CONFIRMED : SHADOW_PENDING);
+        unlockState();
+    }
+    
+    recordMetric(metrics.fanOut, micros() - start);
+    return succeeded;
+}
+
+// Offenen Soll-Zustand nachschicken (wieder online, Neustart, Fehler). Mit
+// der ursprünglichen Startzeit: der Effekt läuft phasengleich mit den
+// anderen Scheinwerfern weiter, als wäre nichts gewesen.
+void LightCommander::resyncSpotlight(const Target& target) {
+    Effect shadow[2];
+    ShadowState state[2];
+    
+    lockState();
+    Spotlight* spot = getSpotlight(target.id);
+    for (uint8_t ring = RING_INNER; spot && ring <= RING_OUTER; ring++) {
+        shadow[ring] = spot->shadow[ring];
+        state[ring] = spot->shadowState[ring];
+    }
+    unlockState();
+    if (!spot) return;
+    
+    // Beide Ringe gleich → ein Befehl für beide
+    bool both = state[RING_INNER] == SHADOW_PENDING && state[RING_OUTER] == SHADOW_PENDING &&
+                sameEffectState(shadow[RING_INNER], shadow[RING_OUTER]) &&
+                shadow[RING_INNER].startTime == shadow[RING_OUTER].startTime;
     
-    // Events abarbeiten
-    while (currentEventIndex < currentSequence->events.size()) {
-        SequenceEvent& event = currentSequence->events[currentEventIndex];
+    for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+        if (state[ring] != SHADOW_PENDING) continue;
         
-        if (currentTime >= event.timestamp) {
-            processSequenceEvent(event);
-            currentEventIndex++;
+        Effect effect = shadow[ring];
+        effect.ring = both ? RING_BOTH : (RingType)ring;
+        effect.traceId = 0;
+        
+        char body[EFFECT_JSON_SIZE];
+        bool success;
+        if (effect.type == EFFECT_OFF) {
+            size_t length = snprintf(body, sizeof(body), "{\"ring\":\"%s\"}", RING_NAMES[effect.ring]);
+            success = sendToSpotlight(target, body, length, "/stop");
         } else {
+            size_t length = buildEffectJson(effect, body, sizeof(body));
+            success = sendToSpotlight(target, body, length, "/effect");
+        }
+        if (success) countEffectSend(EFFECT_SEND_RESYNC);
+        
+        // Inzwischen neuer Soll-Zustand (Loop-Task)? Dann bleibt er offen
+        lockState();
+        spot = getSpotlight(target.id);
+        for (uint8_t r = RING_INNER; spot && r <= RING_OUTER; r++) {
+            if (effect.ring != RING_BOTH && r != ring) continue;
+            bool unchanged = sameEffectState(spot->shadow[r], shadow[r]) &&
+                             spot->shadow[r].startTime == shadow[r].startTime;
+            spot->shadowState[r] = success && unchanged ? SHADOW_CONFIRMED : SHADOW_PENDING;
+        }
+        unlockState();
+        
+        if (both) break;
+    }
+    
+    LOG_INFO_TAG(target.id.c_str(), "↻ Resynced shadow state");
+}
+
+void LightCommander::rememberShadow(Spotlight& spot, const Effect& effect, ShadowState state) {
+    for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+        if (effect.ring != RING_BOTH && effect.ring != ring) continue;
+        // Segment-Effekte bilden den Ring nicht ganz ab
+        spot.shadow[ring] = effect;
+        spot.shadowState[ring] = effect.segments ? SHADOW_UNKNOWN : state;
+    }
+}
+
+void LightCommander::countEffectSend(EffectSend kind) {
+    portENTER_CRITICAL(&metricsMux);
+    metrics.effectSends[kind]++;
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+// ============================================================================
+// SEQUENZ-MANAGEMENT
+// ============================================================================
+
+// Felder des Sequenz-Formats (Commander-API, "params" = Effekt-Felder aus
+// dem gemeinsamen Protokoll, siehe common/EffectKeywords.h)
+enum SequenceField : int8_t {
+    SEQUENCE_ID,
+    SEQUENCE_NAME,
+    SEQUENCE_DURATION,
+    SEQUENCE_LOOP,
+    SEQUENCE_SPOTIFY_URI,
+    SEQUENCE_SYNC_WITH_SPOTIFY,
+    SEQUENCE_EVENTS
+};
+
+constexpr const char* SEQUENCE_FIELD_NAMES[] = {
+    "id", "name", "duration", "loop", "spotifyUri", "syncWithSpotify", "events"
+};
+
+enum EventField : int8_t {
+    EVENT_TIMESTAMP,
+    EVENT_TARGETS,
+    EVENT_RING,
+    EVENT_EFFECT,
+    EVENT_PARAMS,
+    EVENT_MACRO,
+    EVENT_STAGGER,
+    EVENT_PICK
+};
+
+constexpr const char* EVENT_FIELD_NAMES[] = {
+    "timestamp", "targets", "ring", "effect", "params", "macro", "stagger", "pick"
+};
+
+// Reihenfolge = MacroType
+constexpr const char* MACRO_NAMES[] = { "chase", "mirror", "alternate", "random" };
+
+constexpr auto SEQUENCE_FIELDS = makeKeywordTable<16>(SEQUENCE_FIELD_NAMES);
+constexpr auto EVENT_FIELDS = makeKeywordTable<16>(EVENT_FIELD_NAMES);
+constexpr auto MACRO_KEYWORDS = makeKeywordTable<8>(MACRO_NAMES);
+
+static_assert(SEQUENCE_FIELDS.seed && EVENT_FIELDS.seed && MACRO_KEYWORDS.seed,
+              "Kein perfekter Hash für Sequenz-Felder");
+static_assert(sizeof(MACRO_NAMES) / sizeof(MACRO_NAMES[0]) == MACRO_RANDOM + 1, "MACRO_NAMES passt nicht zu MacroType");
+
+static String readText(JsonCursor& json) {
+    const char* str;
+    size_t length;
+    if (!json.readString(str, length)) return String();
+    return String(str, length);
+}
+
+bool LightCommander::loadSequence(const String& json) {
+    MemoryScope scope(MEMORY_SEQUENCE);
+    
+    // Wie Effekt-Befehle direkt aus dem Buffer: kein 16-KB-JsonDocument
+    JsonCursor cursor(json.c_str(), json.length());
+    const char* key;
+    size_t keyLength;
+    
+    Sequence seq;
+    std::vector<String> ids;    // Ziele der Events, Index = Bit bis internSequenceTargets()
+    
+    if (cursor.enterObject()) {
+        while (cursor.nextKey(key, keyLength)) {
+            switch (SEQUENCE_FIELDS.find(key, keyLength)) {
+                case SEQUENCE_ID:
+                    seq.id = readText(cursor);
+                    break;
+                case SEQUENCE_NAME:
+                    seq.name = readText(cursor);
+                    break;
+                case SEQUENCE_DURATION:
+                    readValue(cursor, seq.duration);
+                    break;
+                case SEQUENCE_LOOP:
+                    cursor.readBool(seq.loop);
+                    break;
+                case SEQUENCE_SPOTIFY_URI:
+                    seq.spotifyUri = readText(cursor);
+                    break;
+                case SEQUENCE_SYNC_WITH_SPOTIFY:
+                    cursor.readBool(seq.syncWithSpotify);
+                    break;
+                case SEQUENCE_EVENTS:
+                    if (!parseSequenceEvents(cursor, seq, ids)) {
+                        LOG_WARN("✗ Too many events, effects or spotlight ids in sequence");
+                        return false;
+                    }
+                    break;
+                default:
+                    cursor.skipValue();
+                    break;
+            }
+        }
+    }
+    
+    if (!cursor.ok()) {
+        LOG_WARN("✗ Failed to parse sequence JSON");
+        return false;
+    }
+    
+    String name = seq.name;
+    uint16_t eventCount = seq.eventCount;
+    uint16_t effectCount = seq.effectCount;
+    uint8_t macroCount = seq.macroCount;
+    size_t arenaBytes = seq.arenaBytes();
+    
+    // Verschieben, nicht kopieren: die Arena wechselt nur den Besitzer
+    lockState();
+    if (!internSequenceTargets(seq, ids)) {
+        unlockState();
+        return false;
+    }
+    sequences[seq.id] = std::move(seq);
+    unlockState();
+    
+    LOG_INFO_TAG(name.c_str(), "✓ Loaded sequence (%u events, %u effects, %u macros, %u bytes)",
+                 eventCount, effectCount, macroCount, (unsigned)arenaBytes);
+    return true;
+}
+
+// Gleicher Parameterblock: alles außer startTime/traceId (setzt das Playback)
+static bool sameSequenceEffect(const Effect& a, const Effect& b) {
+    return sameEffectState(a, b) && a.ring == b.ring && a.transitionMs == b.transitionMs;
+}
+
+static bool sameMacro(const SequenceMacro& a, const SequenceMacro& b) {
+    return a.type == b.type && a.length == b.length && a.pick == b.pick && a.stagger == b.stagger &&
+           memcmp(a.order, b.order, a.length) == 0;
+}
+
+// Events direkt in die Arena, gleiche Effekte und Makros nur einmal in den
+// Parameterblock. false nur bei zu vielen Events/Effekten/Makros/Zielen –
+// Syntaxfehler meldet der Cursor.
+bool LightCommander::parseSequenceEvents(JsonCursor& json, Sequence& seq, std::vector<String>& ids) {
+    if (json.skipNull() || !json.enterArray()) return true;
+    
+    // Erst zählen (Kopie des Cursors), damit die Events genau hineinpassen
+    JsonCursor counter = json;
+    size_t count = 0;
+    while (counter.nextElement()) {
+        counter.skipValue();
+        count++;
+    }
+    if (!counter.ok()) {
+        json = counter;         // Syntaxfehler: loadSequence() bricht ab
+        return true;
+    }
+    if (count > UINT16_MAX || !seq.allocateEvents(count)) return false;
+    
+    // Verschiedene Effekte und Makros, bis die Events stehen (danach hinter die Events)
+    std::vector<Effect> unique;
+    std::vector<SequenceMacro> macros;
+    size_t parsed = 0;
+    while (json.nextElement() && parsed < count) {
+        SequenceEvent& event = seq.events[parsed];
+        Effect effect;
+        SequenceMacro macro;
+        bool isMacro = false;
+        if (!parseSequenceEvent(json, event, effect, macro, isMacro, ids)) break;
+        if (ids.size() > MAX_SPOTLIGHTS) return false;
+        
+        size_t index = 0;
+        while (index < unique.size() && !sameSequenceEffect(unique[index], effect)) index++;
+        if (index == unique.size()) {
+            if (index >= UINT16_MAX) return false;
+            unique.push_back(effect);
+        }
+        event.effect = index;
+        
+        if (isMacro) {
+            index = 0;
+            while (index < macros.size() && !sameMacro(macros[index], macro)) index++;
+            if (index == macros.size()) {
+                if (index >= UINT8_MAX) return false;
+                macros.push_back(macro);
+            }
+            event.macro = index + 1;
+        }
+        parsed++;
+    }
+    seq.eventCount = parsed;
+    
+    return seq.attachEffects(unique.data(), unique.size(), macros.data(), macros.size());
+}
+
+// Ohne "macro" bleibt isMacro false, macro.order wird trotzdem gefüllt
+bool LightCommander::parseSequenceEvent(JsonCursor& json, SequenceEvent& event, Effect& effect,
+                                        SequenceMacro& macro, bool& isMacro, std::vector<String>& ids) {
+    const char* key;
+    size_t keyLength;
+    const char* name;
+    size_t nameLength;
+    int8_t type;
+    
+    event = SequenceEvent();
+    effect.type = EFFECT_STATIC;
+    effect.color = Color(255, 255, 255);     // Commander-Default
+    macro = SequenceMacro();
+    macro.pick = 1;
+    
+    if (!json.enterObject()) return false;
+    
+    while (json.nextKey(key, keyLength)) {
+        switch (EVENT_FIELDS.find(key, keyLength)) {
+            case EVENT_TIMESTAMP:
+                readValue(json, event.timestamp);
+                break;
+            case EVENT_TARGETS:
+                readTargetMask(json, ids, event.targets, macro);
+                break;
+            case EVENT_RING:
+                readEffectField(json, FIELD_RING, effect);
+                break;
+            case EVENT_EFFECT:
+                readEffectField(json, FIELD_EFFECT, effect);
+                break;
+            case EVENT_PARAMS:
+                // Alle Effekt-Felder (auch color2, rotation.pattern = rainbow_chase, ...)
+                if (json.skipNull() || !json.enterObject()) break;
+                while (json.nextKey(key, keyLength)) {
+                    if (!readEffectField(json, EFFECT_FIELDS.find(key, keyLength), effect)) {
+                        json.skipValue();
+                    }
+                }
+                break;
+            case EVENT_MACRO:
+                if (!json.readString(name, nameLength)) break;
+                type = MACRO_KEYWORDS.find(name, nameLength);
+                if (type >= 0) {
+                    macro.type = (MacroType)type;
+                    isMacro = true;
+                } else {
+                    LOG_WARN("✗ Unknown macro, played as plain event");
+                }
+                break;
+            case EVENT_STAGGER:
+                readValue(json, macro.stagger);
+                break;
+            case EVENT_PICK:
+                readValue(json, macro.pick);
+                break;
+            default:
+                json.skipValue();
+                break;
+        }
+    }
+    
+    return json.ok();
+}
+
+// ============================================================================
+// SEQUENZ-ARENA
+// ============================================================================
+
+static_assert(std::is_trivially_copyable<Effect>::value && std::is_trivially_copyable<SequenceEvent>::value &&
+              std::is_trivially_copyable<SequenceMacro>::value,
+              "Arena verschiebt Events, Effekte und Makros per realloc");
+
+Sequence& Sequence::operator=(Sequence&& other) {
+    if (this == &other) return *this;
+    free(events);
+    id = std::move(other.id);
+    name = std::move(other.name);
+    duration = other.duration;
+    loop = other.loop;
+    events = other.events;
+    effects = other.effects;
+    macros = other.macros;
+    eventCount = other.eventCount;
+    effectCount = other.effectCount;
+    macroCount = other.macroCount;
+    targets = other.targets;
+    spotifyUri = std::move(other.spotifyUri);
+    syncWithSpotify = other.syncWithSpotify;
+    other.events = nullptr;
+    other.effects = nullptr;
+    other.macros = nullptr;
+    other.eventCount = 0;
+    other.effectCount = 0;
+    other.macroCount = 0;
+    other.targets = 0;
+    return *this;
+}
+
+// Arena für genau count Events (Parameterblock kommt mit attachEffects dazu)
+bool Sequence::allocateEvents(size_t count) {
+    free(events);
+    events = count ? (SequenceEvent*)malloc(count * sizeof(SequenceEvent)) : nullptr;
+    effects = nullptr;
+    macros = nullptr;
+    eventCount = 0;
+    effectCount = 0;
+    macroCount = 0;
+    return events || count == 0;
+}
+
+// Arena auf Endgröße (Events + Parameterblock + Makros) – ein realloc, danach ein Block
+bool Sequence::attachEffects(const Effect* unique, size_t count, const SequenceMacro* uniqueMacros, size_t macroTotal) {
+    static_assert(sizeof(Effect) % alignof(SequenceMacro) == 0, "Makros hinter den Effekten falsch ausgerichtet");
+    size_t eventBytes = effectOffset(eventCount);
+    size_t macroOffset = eventBytes + count * sizeof(Effect);
+    size_t total = macroOffset + macroTotal * sizeof(SequenceMacro);
+    if (total == 0) {
+        free(events);
+        events = nullptr;
+        return true;
+    }
+    
+    uint8_t* arena = (uint8_t*)realloc(events, total);
+    if (!arena) return false;
+    events = (SequenceEvent*)arena;
+    effects = (Effect*)(arena + eventBytes);
+    memcpy((void*)effects, unique, count * sizeof(Effect));
+    effectCount = count;
+    macros = (SequenceMacro*)(arena + macroOffset);
+    if (macroTotal) memcpy((void*)macros, uniqueMacros, macroTotal * sizeof(SequenceMacro));
+    macroCount = macroTotal;
+    return true;
+}
+
+// ============================================================================
+// MAKRO-EVENTS
+// ============================================================================
+
+uint8_t SequenceMacro::steps() const {
+    if (length == 0) return 0;
+    switch (type) {
+        case MACRO_CHASE:     return length;
+        case MACRO_MIRROR:    return (length + 1) / 2;
+        case MACRO_ALTERNATE: return length > 1 ? 2 : 1;
+        default:              return 1;
+    }
+}
+
+TargetMask SequenceMacro::stepTargets(uint8_t step) const {
+    TargetMask targets = 0;
+    switch (type) {
+        case MACRO_CHASE:
+            targets = (TargetMask)1 << order[step];
             break;
+        case MACRO_MIRROR:
+            targets = ((TargetMask)1 << order[step]) | ((TargetMask)1 << order[length - 1 - step]);
+            break;
+        case MACRO_ALTERNATE:
+            for (uint8_t i = step; i < length; i += 2) targets |= (TargetMask)1 << order[i];
+            break;
+        case MACRO_RANDOM: {
+            // Teil-Fisher-Yates über die Positionen
+            uint8_t positions[MAX_SPOTLIGHTS];
+            memcpy(positions, order, length);
+            uint8_t count = pick < length ? pick : length;
+            for (uint8_t i = 0; i < count; i++) {
+                uint8_t j = i + random(length - i);
+                std::swap(positions[i], positions[j]);
+                targets |= (TargetMask)1 << positions[i];
+            }
+            break;
+        }
+    }
+    return targets;
+}
+
+Sequence* LightCommander::getSequence(const String& id) {
+    auto it = sequences.find(id);
+    if (it != sequences.end()) {
+        return &(it->second);
+    }
+    return nullptr;
+}
+
+std::vector<String> LightCommander::listSequences() {
+    std::vector<String> result;
+    for (auto& pair : sequences) {
+        result.push_back(pair.first);
+    }
+    return result;
+}
+
+// ============================================================================
+// SEQUENZ-PLAYBACK
+// ============================================================================
+
+// Bis zu MAX_TIMELINES Sequenzen laufen gleichzeitig, z.B. eine Grund-Show
+// plus Strobe-Hits oder eine eigene Sequenz nur für die Außenringe. Jede
+// Timeline hat eigenen Cursor, eigene Uhr, Priorität und Bereich (Scheinwerfer,
+// Ring). Laufende Timelines stehen in einem Min-Heap nach dem nächsten
+// Soll-Zeitpunkt: ein fälliges Event kostet ein pop und ein push (O(log n)),
+// egal wie viele Sequenzen laufen. play/pause/resume/stop bauen den Heap neu.
+// Makro-Events (Chase über 8 Scheinwerfer usw.) bleiben gespeichert ein Event;
+// ihre weiteren Schritte laufen als eigene Cursor im selben Heap, während die
+// Timeline schon weiterläuft – jeder Schritt auf die Millisekunde.
+
+bool LightCommander::playSequence(const String& sequenceId, uint8_t timeline, uint8_t priority,
+                                  TargetMask scope, RingType ring) {
+    Sequence* seq = getSequence(sequenceId);
+    if (!seq) {
+        LOG_WARN_TAG(sequenceId.c_str(), "✗ Sequence not found");
+        return false;
+    }
+    if (timeline >= MAX_TIMELINES) {
+        LOG_WARN_TAG(sequenceId.c_str(), "✗ Invalid timeline %u", timeline);
+        return false;
+    }
+    
+    if (!playback.active()) playback.maxLateness = 0;
+    
+    // Ersetzt, was auf dieser Timeline lief
+    clearExpansions(timeline);
+    Timeline& t = playback.timelines[timeline];
+    t.active = true;
+    t.paused = false;
+    t.draining = false;
+    t.sequenceId = sequenceId;
+    t.sequence = seq;
+    t.eventIndex = 0;
+    t.startTime = millis();
+    t.priority = priority;
+    t.scope = scope;
+    t.ring = ring;
+    if (advanceTimeline(timeline)) {
+        LOG_INFO_TAG(seq->name.c_str(), "▶️ Playing sequence (timeline %u)", timeline);
+    }
+    scheduleTimelines();
+    return true;
+}
+
+bool LightCommander::pauseSequence(uint8_t timeline) {
+    bool changed = false;
+    unsigned long now = millis();
+    
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        Timeline& t = playback.timelines[i];
+        if ((timeline != ALL_TIMELINES && timeline != i) || !t.active || t.paused) continue;
+        t.paused = true;
+        t.pauseTime = now;
+        changed = true;
+    }
+    if (!changed) return false;
+    
+    scheduleTimelines();
+    LOG_INFO("⏸️ Sequence paused");
+    return true;
+}
+
+bool LightCommander::resumeSequence(uint8_t timeline) {
+    bool changed = false;
+    unsigned long now = millis();
+    
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        Timeline& t = playback.timelines[i];
+        if ((timeline != ALL_TIMELINES && timeline != i) || !t.active || !t.paused) continue;
+        // Zeit korrigieren
+        unsigned long pauseDuration = now - t.pauseTime;
+        t.startTime += pauseDuration;
+        t.nextDue += pauseDuration;
+        t.paused = false;
+        changed = true;
+        
+        for (MacroExpansion& expansion : playback.expansions) {
+            if (!expansion.active || expansion.timeline != i) continue;
+            expansion.startTime += pauseDuration;
+            expansion.nextDue += pauseDuration;
         }
     }
+    if (!changed) return false;
     
-    // Ende erreicht?
-    if (currentEventIndex >= currentSequence->events.size()) {
-        if (currentSequence->loop) {
-            // Loop
-            currentEventIndex = 0;
-            playback.startTime = millis();
-            Serial.println("🔄 Sequence looping...");
+    scheduleTimelines();
+    LOG_INFO("▶️ Sequence resumed");
+    return true;
+}
+
+bool LightCommander::stopSequence(uint8_t timeline) {
+    bool changed = false;
+    
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        Timeline& t = playback.timelines[i];
+        if ((timeline != ALL_TIMELINES && timeline != i) || !t.active) continue;
+        t.active = false;
+        t.paused = false;
+        t.draining = false;
+        t.sequence = nullptr;
+        t.eventIndex = 0;
+        clearExpansions(i);
+        changed = true;
+    }
+    if (!changed) return false;
+    
+    scheduleTimelines();
+    LOG_INFO("⏹️ Sequence stopped");
+    return true;
+}
+
+// Nächsten Soll-Zeitpunkt setzen; am Ende Loop oder Stopp.
+// false = keine Events mehr (nicht mehr in den Heap)
+bool LightCommander::advanceTimeline(uint8_t index) {
+    Timeline& timeline = playback.timelines[index];
+    const Sequence& seq = *timeline.sequence;
+    
+    if (timeline.eventIndex >= seq.eventCount) {
+        if (seq.loop && seq.eventCount > 0) {
+            timeline.eventIndex = 0;
+            timeline.startTime = millis();
+            LOG_INFO("🔄 Sequence looping");
+        } else {
+            // Aktiv (pausier- und stoppbar), bis das letzte Makro durch ist
+            if (hasExpansions(index)) timeline.draining = true;
+            else completeTimeline(index);
+            return false;
+        }
+    }
+    
+    timeline.nextDue = timeline.startTime + seq.events[timeline.eventIndex].timestamp;
+    return true;
+}
+
+void LightCommander::completeTimeline(uint8_t index) {
+    Timeline& timeline = playback.timelines[index];
+    timeline.active = false;
+    timeline.draining = false;
+    timeline.sequence = nullptr;
+    timeline.eventIndex = 0;
+    LOG_INFO("✓ Sequence complete");
+}
+
+// Heap aus allen laufenden, nicht pausierten Timelines und ihren Makros
+// (nur bei Steuerbefehlen)
+void LightCommander::scheduleTimelines() {
+    playback.heapSize = 0;
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        const Timeline& t = playback.timelines[i];
+        if (t.active && !t.paused && !t.draining) playback.heap[playback.heapSize++] = i;
+    }
+    for (uint8_t i = 0; i < MAX_MACRO_EXPANSIONS; i++) {
+        const MacroExpansion& expansion = playback.expansions[i];
+        if (expansion.active && !playback.timelines[expansion.timeline].paused) {
+            playback.heap[playback.heapSize++] = MAX_TIMELINES + i;
+        }
+    }
+    std::make_heap(playback.heap, playback.heap + playback.heapSize,
+                   [this](uint8_t a, uint8_t b) { return dueAfter(a, b); });
+}
+
+// Heap-Ordnung: a ist nach b dran (überlauffest, gleich früh → kleinerer Cursor zuerst)
+bool LightCommander::dueAfter(uint8_t a, uint8_t b) const {
+    long diff = (long)(playback.nextDue(a) - playback.nextDue(b));
+    return diff > 0 || (diff == 0 && a > b);
+}
+
+bool LightCommander::hasExpansions(uint8_t timeline) const {
+    for (const MacroExpansion& expansion : playback.expansions) {
+        if (expansion.active && expansion.timeline == timeline) return true;
+    }
+    return false;
+}
+
+void LightCommander::clearExpansions(uint8_t timeline) {
+    for (MacroExpansion& expansion : playback.expansions) {
+        if (expansion.timeline == timeline) expansion.active = false;
+    }
+}
+
+// Restliche Schritte eines Makros ab Schritt 1 in den Heap
+void LightCommander::startExpansion(uint8_t timeline, const SequenceEvent& event,
+                                    const SequenceMacro& macro, unsigned long startTime) {
+    for (uint8_t i = 0; i < MAX_MACRO_EXPANSIONS; i++) {
+        MacroExpansion& expansion = playback.expansions[i];
+        if (expansion.active) continue;
+        
+        expansion.active = true;
+        expansion.timeline = timeline;
+        expansion.step = 1;
+        expansion.steps = macro.steps();
+        expansion.event = event;
+        expansion.macro = macro;
+        expansion.startTime = startTime;
+        expansion.nextDue = startTime + event.timestamp + macro.stagger;
+        
+        playback.heap[playback.heapSize++] = MAX_TIMELINES + i;
+        std::push_heap(playback.heap, playback.heap + playback.heapSize,
+                       [this](uint8_t a, uint8_t b) { return dueAfter(a, b); });
+        return;
+    }
+    LOG_WARN("✗ Too many macros at once (max %d), rest of macro dropped", MAX_MACRO_EXPANSIONS);
+}
+
+// Event (oder Makro-Schritt) der Timeline kopieren und auf ihren Bereich
+// beschneiden. false = bleibt nichts übrig
+bool LightCommander::takeDueEvent(DueEvent& due, uint8_t index, const SequenceEvent& event, unsigned long startTime) {
+    const Timeline& timeline = playback.timelines[index];
+    const Sequence& seq = *timeline.sequence;
+    if (event.effect >= seq.effectCount) return false;      // Sequenz inzwischen ersetzt
+    
+    due.event = event;
+    due.effect = seq.effects[event.effect];
+    due.startTime = startTime;
+    due.timeline = index;
+    due.priority = timeline.priority;
+    
+    due.event.targets &= timeline.scope;
+    if (timeline.ring != RING_BOTH) {
+        if (due.effect.ring == RING_BOTH) due.effect.ring = timeline.ring;
+        else if (due.effect.ring != timeline.ring) due.event.targets = 0;
+    }
+    return due.event.targets != 0;
+}
+
+void LightCommander::updateSequencePlayback() {
+    // Fällige Events unter Lock kopieren, gesendet wird ohne Lock –
+    // API-Requests warten nie auf HTTP zu den Scheinwerfern. Kopien, weil
+    // die Sequenz ersetzt werden kann – in ein festes Array: das Playback
+    // holt keinen Heap (geprüft: commander-sim --memory). Nach einem Stau
+    // (Scheinwerfer-Timeout) geht der Rückstand in Portionen raus.
+    MemoryScope scope(MEMORY_SEQUENCE);
+    auto later = [this](uint8_t a, uint8_t b) { return dueAfter(a, b); };
+    uint8_t dueCount = 0;
+    
+    lockState();
+    unsigned long now = millis();
+    
+    while (playback.heapSize > 0 && dueCount < SEQUENCE_DUE_BATCH) {
+        uint8_t cursor = playback.heap[0];
+        if ((long)(now - playback.nextDue(cursor)) < 0) break;
+        
+        std::pop_heap(playback.heap, playback.heap + playback.heapSize, later);
+        playback.heapSize--;
+        
+        // Nächster Schritt eines laufenden Makros
+        if (cursor >= MAX_TIMELINES) {
+            MacroExpansion& expansion = playback.expansions[cursor - MAX_TIMELINES];
+            SequenceEvent step = expansion.event;
+            step.targets &= expansion.macro.stepTargets(expansion.step);
+            step.timestamp += expansion.step * expansion.macro.stagger;
+            if (takeDueEvent(dueEvents[dueCount], expansion.timeline, step, expansion.startTime)) dueCount++;
+            
+            if (++expansion.step < expansion.steps) {
+                expansion.nextDue += expansion.macro.stagger;
+                playback.heap[playback.heapSize++] = cursor;
+                std::push_heap(playback.heap, playback.heap + playback.heapSize, later);
+            } else {
+                expansion.active = false;
+                if (playback.timelines[expansion.timeline].draining && !hasExpansions(expansion.timeline)) {
+                    completeTimeline(expansion.timeline);
+                }
+            }
+            continue;
+        }
+        
+        // Neu geladene Sequenz kann kürzer sein
+        Timeline& timeline = playback.timelines[cursor];
+        const Sequence& seq = *timeline.sequence;
+        if (timeline.eventIndex < seq.eventCount) {
+            const SequenceEvent& event = seq.events[timeline.eventIndex++];
+            
+            if (event.macro && event.macro <= seq.macroCount) {
+                // Makro: Schritt 0 sofort, der Rest über den Heap
+                const SequenceMacro& macro = seq.macros[event.macro - 1];
+                SequenceEvent step = event;
+                step.targets &= macro.stepTargets(0);
+                if (takeDueEvent(dueEvents[dueCount], cursor, step, timeline.startTime)) dueCount++;
+                if (macro.steps() > 1) startExpansion(cursor, event, macro, timeline.startTime);
+            } else if (takeDueEvent(dueEvents[dueCount], cursor, event, timeline.startTime)) {
+                dueCount++;
+            }
+        }
+        
+        if (advanceTimeline(cursor)) {
+            playback.heap[playback.heapSize++] = cursor;
+            std::push_heap(playback.heap, playback.heap + playback.heapSize, later);
+        }
+    }
+    unlockState();
+    
+    mergeDueEvents(dueCount);
+}
+
+// Abstand zweier millis()-Zeitpunkte, überlauffest
+static unsigned long timeDistance(unsigned long a, unsigned long b) {
+    return (long)(a - b) < 0 ? b - a : a - b;
+}
+
+// Treffen Events verschiedener Timelines denselben Scheinwerfer und Ring
+// (Soll-Zeitpunkte höchstens SEQUENCE_MERGE_MS auseinander), geht nur eine
+// Nachricht raus: höhere Priorität gewinnt, bei gleicher das spätere Event.
+// Im selben Durchlauf wird paarweise verglichen; kommt der Verlierer erst
+// einen Durchlauf später, hält ringClaims den Gewinner fest. Kommt der
+// Gewinner später, überschreibt er einfach. Segment-Effekte zählen wie der
+// ganze Ring. Events derselben Timeline gehen alle raus, wie geladen.
+void LightCommander::mergeDueEvents(uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        const DueEvent& due = dueEvents[i];
+        unsigned long target = due.startTime + due.event.timestamp;
+        TargetMask targets = due.event.targets;
+        TargetMask lost[2] = { 0, 0 };      // Pro Ring: von Gewinnern belegt
+        bool rings[2] = { due.effect.ring != RING_OUTER, due.effect.ring != RING_INNER };
+        
+        for (uint8_t j = 0; j < count; j++) {
+            const DueEvent& other = dueEvents[j];
+            if (other.timeline == due.timeline) continue;
+            if (timeDistance(other.startTime + other.event.timestamp, target) > SEQUENCE_MERGE_MS) continue;
+            bool wins = other.priority > due.priority || (other.priority == due.priority && j > i);
+            if (!wins) continue;
+            if (other.effect.ring != RING_OUTER) lost[RING_INNER] |= other.event.targets;
+            if (other.effect.ring != RING_INNER) lost[RING_OUTER] |= other.event.targets;
+        }
+        
+        for (TargetMask rest = targets; rest; rest &= rest - 1) {
+            uint8_t index = __builtin_ctzll(rest);
+            for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+                const RingClaim& claim = ringClaims[index][ring];
+                if (rings[ring] && claim.timeline != ALL_TIMELINES && claim.timeline != due.timeline &&
+                    claim.priority > due.priority && timeDistance(claim.at, target) <= SEQUENCE_MERGE_MS) {
+                    lost[ring] |= (TargetMask)1 << index;
+                }
+            }
+        }
+        
+        // Was übrig bleibt, nach Ring; RING_BOTH zerfällt, wenn nur ein Ring verloren ist
+        TargetMask send[RING_BOTH + 1] = { 0, 0, 0 };
+        if (due.effect.ring == RING_BOTH) {
+            send[RING_BOTH] = targets & ~lost[RING_INNER] & ~lost[RING_OUTER];
+            send[RING_INNER] = targets & ~lost[RING_INNER] & lost[RING_OUTER];
+            send[RING_OUTER] = targets & lost[RING_INNER] & ~lost[RING_OUTER];
         } else {
-            // Stoppen
-            stopSequence();
-            Serial.println("✓ Sequence complete");
+            send[due.effect.ring] = targets & ~lost[due.effect.ring];
+        }
+        
+        TargetMask dropped = targets & ~(send[RING_BOTH] | send[RING_INNER] | send[RING_OUTER]);
+        for (uint8_t n = __builtin_popcountll(dropped); n > 0; n--) countEffectSend(EFFECT_SEND_MERGED);
+        
+        for (uint8_t ring = RING_INNER; ring <= RING_OUTER; ring++) {
+            for (TargetMask rest = send[ring] | send[RING_BOTH]; rest; rest &= rest - 1) {
+                RingClaim& claim = ringClaims[__builtin_ctzll(rest)][ring];
+                claim.at = target;
+                claim.timeline = due.timeline;
+                claim.priority = due.priority;
+            }
         }
+        
+        processSequenceEvent(due, send);
     }
 }
 
-void LightCommander::processSequenceEvent(const SequenceEvent& event) {
-    Serial.printf("⚡ Event @ %lums\n", event.timestamp);
-    sendEffect(event.targets, event.ring, event.effect, event.params);
+void LightCommander::processSequenceEvent(const DueEvent& due, const TargetMask send[RING_BOTH + 1]) {
+    LOG_DEBUG("⚡ Event @ %u ms", due.event.timestamp);
+    
+    // Verspätung messen (Nachweis, dass API-Last das Timing nicht verschiebt)
+    unsigned long target = due.startTime + due.event.timestamp;
+    unsigned long lateness = millis() - target;
+    if (lateness > playback.maxLateness) playback.maxLateness = lateness;
+    recordMetric(metrics.eventLateness, lateness * 1000);
+    
+    // Soll-Zeitpunkt statt Sendezeitpunkt: verspätete Events bleiben phasentreu
+    for (uint8_t ring = 0; ring <= RING_BOTH; ring++) {
+        if (!send[ring]) continue;
+        Effect effect = due.effect;
+        effect.ring = (RingType)ring;
+        effect.startTime = target;
+        effect.traceId = beginTrace(TRACE_ORIGIN_SEQUENCE, micros() - lateness * 1000);
+        sendShadowed(send[ring], effect);
+    }
+}
+
+// ============================================================================
+// METRIKEN
+// ============================================================================
+
+void LightCommander::recordMetric(Histogram& histogram, uint32_t value) {
+    portENTER_CRITICAL(&metricsMux);
+    histogram.record(value);
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+void LightCommander::recordSend(uint8_t index, uint32_t latency, int httpCode) {
+    portENTER_CRITICAL(&metricsMux);
+    SpotlightMetrics* m = spotlightMetrics(index);
+    if (m) {
+        m->sendLatency.record(latency);
+        
+        if (httpCode != 200) {
+            ErrorCount* slot = nullptr;
+            for (int i = 0; i < MAX_ERROR_CODES && !slot; i++) {
+                if (m->errors[i].count == 0 || m->errors[i].code == httpCode) slot = &m->errors[i];
+            }
+            if (slot) {
+                slot->code = httpCode;
+                slot->count++;
+            } else {
+                m->otherErrors++;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+// Slot des Scheinwerfers mit diesem Index, nullptr = nicht (mehr)
+// registriert (nur unter metricsMux aufrufen)
+SpotlightMetrics* LightCommander::spotlightMetrics(uint8_t index) {
+    if (index >= MAX_SPOTLIGHTS || spotMetrics[index].id[0] == '\0') return nullptr;
+    return &spotMetrics[index];
+}
+
+// Beim Hinzufügen (id) und Entfernen (nullptr) eines Scheinwerfers: ein
+// Index, den eine andere ID übernimmt, beginnt ohne fremde Werte
+void LightCommander::resetSpotlightMetrics(uint8_t index, const char* id) {
+    portENTER_CRITICAL(&metricsMux);
+    SpotlightMetrics& m = spotMetrics[index];
+    if (!id || strncmp(m.id, id, sizeof(m.id) - 1) != 0) {
+        m = SpotlightMetrics();
+        if (id) {
+            strncpy(m.id, id, sizeof(m.id) - 1);
+            m.id[sizeof(m.id) - 1] = '\0';
+        }
+    }
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+// Einmal beim Start: Kosten eines record() inkl. Lock (Ziel < 1 µs)
+void LightCommander::measureMetricsOverhead() {
+    const uint16_t rounds = 1000;
+    Histogram probe;
+    
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < rounds; i++) {
+        recordMetric(probe, i * 37);
+    }
+    metrics.recordNanos = (micros() - start) * 1000 / rounds;
+    
+    LOG_INFO("Metrics: %u ns per record", metrics.recordNanos);
+}
+
+void LightCommander::writeHistogram(AsyncResponseStream* out, const char* name, const char* labels,
+                                    const Histogram& histogram) {
+    const char* separator = labels[0] ? "," : "";
+    uint32_t cumulative = 0;
+    
+    for (uint8_t b = 0; b < HISTOGRAM_BUCKETS - 1; b++) {
+        cumulative += histogram.buckets[b];
+        out->printf("%s_bucket{%s%sle=\"%.6f\"} %u\n", name, labels, separator,
+                    Histogram::upperBound(b) / 1e6, cumulative);
+    }
+    out->printf("%s_bucket{%s%sle=\"+Inf\"} %u\n", name, labels, separator, histogram.count);
+    out->printf("%s_sum{%s} %.6f\n", name, labels, histogram.sum / 1e6);
+    out->printf("%s_count{%s} %u\n", name, labels, histogram.count);
+}
+
+void LightCommander::handleMetrics(AsyncWebServerRequest* request) {
+    // Kopie unter Lock (Heap statt Stack), formatiert wird ohne. Von den
+    // Scheinwerfer-Slots (~780 Bytes) nur die belegten: erst zählen, dann
+    // ohne Lock reservieren – kommt dazwischen einer dazu, fehlt er bis
+    // zum nächsten Scrape
+    CommanderMetrics* snapshot = new CommanderMetrics();
+    std::vector<SpotlightMetrics> spots;
+    size_t used = 0;
+    portENTER_CRITICAL(&metricsMux);
+    for (const SpotlightMetrics& m : spotMetrics) used += m.id[0] != '\0';
+    portEXIT_CRITICAL(&metricsMux);
+    spots.reserve(used);
+    
+    portENTER_CRITICAL(&metricsMux);
+    *snapshot = metrics;
+    for (const SpotlightMetrics& m : spotMetrics) {
+        if (m.id[0] != '\0' && spots.size() < spots.capacity()) spots.push_back(m);
+    }
+    portEXIT_CRITICAL(&metricsMux);
+    
+    AsyncResponseStream* out = request->beginResponseStream("text/plain; version=0.0.4");
+    
+    out->print("# HELP commander_event_lateness_seconds Versand eines Sequenz-Events nach Soll-Zeitpunkt\n");
+    out->print("# TYPE commander_event_lateness_seconds histogram\n");
+    writeHistogram(out, "commander_event_lateness_seconds", "", snapshot->eventLateness);
+    
+    out->print("# HELP commander_fanout_seconds Ein Befehl an alle Ziele\n");
+    out->print("# TYPE commander_fanout_seconds histogram\n");
+    writeHistogram(out, "commander_fanout_seconds", "", snapshot->fanOut);
+    
+    out->print("# HELP commander_api_request_seconds Laufzeit der Request-Handler\n");
+    out->print("# TYPE commander_api_request_seconds histogram\n");
+    writeHistogram(out, "commander_api_request_seconds", "", snapshot->apiRequest);
+    
+    out->print("# HELP commander_health_check_seconds Health-Check aller Scheinwerfer\n");
+    out->print("# TYPE commander_health_check_seconds histogram\n");
+    writeHistogram(out, "commander_health_check_seconds", "", snapshot->healthCheck);
+    
+    out->print("# HELP commander_send_latency_seconds POST an einen Scheinwerfer\n");
+    out->print("# TYPE commander_send_latency_seconds histogram\n");
+    for (const SpotlightMetrics& m : spots) {
+        String labels = "spotlight=\"" + String(m.id) + "\"";
+        writeHistogram(out, "commander_send_latency_seconds", labels.c_str(), m.sendLatency);
+    }
+    
+    out->print("# HELP commander_send_errors_total Fehlgeschlagene POSTs nach HTTP-Code (negativ = Verbindung)\n");
+    out->print("# TYPE commander_send_errors_total counter\n");
+    for (const SpotlightMetrics& m : spots) {
+        for (const ErrorCount& e : m.errors) {
+            if (e.count == 0) continue;
+            out->printf("commander_send_errors_total{spotlight=\"%s\",code=\"%d\"} %u\n",
+                        m.id, e.code, e.count);
+        }
+        if (m.otherErrors) {
+            out->printf("commander_send_errors_total{spotlight=\"%s\",code=\"other\"} %u\n",
+                        m.id, m.otherErrors);
+        }
+    }
+    
+    out->print("# HELP commander_effect_sends_total Effekte pro Ziel: voll, Delta, unterdrückt, Resync\n");
+    out->print("# TYPE commander_effect_sends_total counter\n");
+    for (uint8_t i = 0; i < NUM_EFFECT_SENDS; i++) {
+        out->printf("commander_effect_sends_total{kind=\"%s\"} %u\n", EFFECT_SEND_NAMES[i], snapshot->effectSends[i]);
+    }
+    
+    out->print("# HELP commander_trace_stage_seconds Abschnitt von API-Aufruf bis erstem Frame\n");
+    out->print("# TYPE commander_trace_stage_seconds histogram\n");
+    for (const SpotlightMetrics& m : spots) {
+        for (uint8_t i = 0; i < NUM_TRACE_STAGES; i++) {
+            String labels = "spotlight=\"" + String(m.id) + "\",stage=\"" + TRACE_STAGE_NAMES[i] + "\"";
+            writeHistogram(out, "commander_trace_stage_seconds", labels.c_str(), m.traceStages[i]);
+        }
+    }
+    
+    out->print("# HELP commander_trace_total_seconds API-Aufruf bzw. Event-Soll-Zeit bis erster Frame\n");
+    out->print("# TYPE commander_trace_total_seconds histogram\n");
+    for (const SpotlightMetrics& m : spots) {
+        String labels = "spotlight=\"" + String(m.id) + "\"";
+        writeHistogram(out, "commander_trace_total_seconds", labels.c_str(), m.traceTotal);
+    }
+    
+    // Frame-Telemetrie der Scheinwerfer (nur wenn dort eingeschaltet)
+    out->print("# HELP spotlight_frame_seconds Render-Loop des Scheinwerfers, letztes Fenster\n");
+    out->print("# TYPE spotlight_frame_seconds gauge\n");
+    for (const SpotlightMetrics& m : spots) {
+        if (!m.frameTelemetry) continue;
+        for (uint8_t i = 0; i < NUM_TELEMETRY_STAGES; i++) {
+            const TelemetrySummary& frame = m.frame[i];
+            const char* stats[] = { "min", "avg", "p99", "max" };
+            uint32_t values[] = { frame.minNs, frame.avgNs, frame.p99Ns, frame.maxNs };
+            for (uint8_t k = 0; k < 4; k++) {
+                out->printf("spotlight_frame_seconds{spotlight=\"%s\",stage=\"%s\",stat=\"%s\"} %.9f\n",
+                            m.id, TELEMETRY_STAGE_NAMES[i], stats[k], values[k] / 1e9);
+            }
+        }
+    }
+    
+    out->print("# HELP commander_metrics_record_nanoseconds Kosten einer Messung (beim Start gemessen)\n");
+    out->print("# TYPE commander_metrics_record_nanoseconds gauge\n");
+    out->printf("commander_metrics_record_nanoseconds %u\n", snapshot->recordNanos);
+    
+    delete snapshot;
+    request->send(out);
+}
+
+// ============================================================================
+// LATENZ-TRACING (siehe common/Trace.h)
+// ============================================================================
+
+uint32_t LightCommander::beginTrace(TraceOrigin origin, uint32_t started) {
+    portENTER_CRITICAL(&metricsMux);
+    
+    // Ringpuffer: ID bestimmt den Slot, der älteste Trace wird überschrieben
+    uint32_t id = nextTraceId++;
+    if (nextTraceId == 0 || nextTraceId > 0x7FFFFFFF) nextTraceId = 1;   // "trace" ist ein long im JSON
+    
+    TraceRecord& trace = traces[id % MAX_TRACES];
+    trace = TraceRecord();
+    trace.id = id;
+    trace.origin = origin;
+    trace.started = started;
+    trace.createdAt = millis();
+    
+    portEXIT_CRITICAL(&metricsMux);
+    return id;
+}
+
+// nullptr = unbekannt oder schon überschrieben (nur unter metricsMux aufrufen)
+TraceRecord* LightCommander::findTrace(uint32_t id) {
+    TraceRecord& trace = traces[id % MAX_TRACES];
+    return trace.id == id ? &trace : nullptr;
+}
+
+void LightCommander::traceSent(uint32_t traceId, const Target& spot, uint32_t sent) {
+    portENTER_CRITICAL(&metricsMux);
+    TraceRecord* trace = findTrace(traceId);
+    if (trace) {
+        for (TraceTarget& target : trace->targets) {
+            if (target.spotlight[0] != '\0') continue;
+            strncpy(target.spotlight, spot.id.c_str(), sizeof(target.spotlight) - 1);
+            target.spotlight[sizeof(target.spotlight) - 1] = '\0';
+            target.index = spot.index;
+            target.sent = sent;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+void LightCommander::receiveTraceSpans() {
+    // Nicht blockierend, pro Loop alle wartenden Pakete
+    while (int size = traceUdp.parsePacket()) {
+        TraceSpan span;
+        if (size != sizeof(span) || traceUdp.read((uint8_t*)&span, sizeof(span)) != sizeof(span) ||
+            span.version != TRACE_VERSION) {
+            continue;
+        }
+        span.spotlight[sizeof(span.spotlight) - 1] = '\0';
+        recordSpan(span);
+    }
+}
+
+void LightCommander::recordSpan(const TraceSpan& span) {
+    portENTER_CRITICAL(&metricsMux);
+    spansReceived++;
+    
+    TraceRecord* trace = findTrace(span.traceId);
+    TraceTarget* target = nullptr;
+    if (trace) {
+        for (TraceTarget& t : trace->targets) {
+            if (!t.complete && strncmp(t.spotlight, span.spotlight, sizeof(t.spotlight)) == 0) {
+                target = &t;
+                break;
+            }
+        }
+    }
+    
+    SpotlightMetrics* m = target ? spotlightMetrics(target->index) : nullptr;
+    if (!target || !m) {
+        spansUnmatched++;
+        portEXIT_CRITICAL(&metricsMux);
+        return;
+    }
+    
+    target->received = span.received;
+    target->applied = span.applied;
+    target->shown = span.shown;
+    target->complete = true;
+    
+    m->traceStages[TRACE_DISPATCH].record(traceSpan(trace->started, target->sent));
+    m->traceStages[TRACE_WIRE].record(traceSpan(target->sent, target->received));
+    m->traceStages[TRACE_QUEUE].record(traceSpan(target->received, target->applied));
+    m->traceStages[TRACE_RENDER].record(traceSpan(target->applied, target->shown));
+    m->traceTotal.record(traceSpan(trace->started, target->shown));
+    
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+void LightCommander::handleTraces(AsyncWebServerRequest* request) {
+    // Langsamste abgeschlossene Ziele der letzten MAX_TRACES Befehle, ?count=N
+    struct Entry {
+        uint32_t id;
+        TraceOrigin origin;
+        unsigned long createdAt;
+        char spotlight[16];
+        uint32_t stages[NUM_TRACE_STAGES];
+        uint32_t total;
+    };
+    
+    uint16_t count = 10;
+    if (request->hasParam("count")) count = request->getParam("count")->value().toInt();
+    
+    Entry* entries = new Entry[MAX_TRACES * MAX_TRACE_TARGETS];
+    uint16_t found = 0;
+    
+    portENTER_CRITICAL(&metricsMux);
+    for (const TraceRecord& trace : traces) {
+        if (trace.id == 0) continue;
+        for (const TraceTarget& target : trace.targets) {
+            if (!target.complete) continue;
+            Entry& entry = entries[found++];
+            entry.id = trace.id;
+            entry.origin = trace.origin;
+            entry.createdAt = trace.createdAt;
+            memcpy(entry.spotlight, target.spotlight, sizeof(entry.spotlight));
+            entry.stages[TRACE_DISPATCH] = traceSpan(trace.started, target.sent);
+            entry.stages[TRACE_WIRE] = traceSpan(target.sent, target.received);
+            entry.stages[TRACE_QUEUE] = traceSpan(target.received, target.applied);
+            entry.stages[TRACE_RENDER] = traceSpan(target.applied, target.shown);
+            entry.total = traceSpan(trace.started, target.shown);
+        }
+    }
+    uint32_t received = spansReceived;
+    uint32_t unmatched = spansUnmatched;
+    portEXIT_CRITICAL(&metricsMux);
+    
+    std::sort(entries, entries + found, [](const Entry& a, const Entry& b) { return a.total > b.total; });
+    if (count > found) count = found;
+    
+    DynamicJsonDocument doc(256 + count * 256);
+    doc["spansReceived"] = received;
+    doc["spansUnmatched"] = unmatched;
+    
+    JsonArray list = doc.createNestedArray("traces");
+    unsigned long now = millis();
+    for (uint16_t i = 0; i < count; i++) {
+        const Entry& entry = entries[i];
+        JsonObject obj = list.createNestedObject();
+        obj["trace"] = entry.id;
+        obj["origin"] = entry.origin == TRACE_ORIGIN_API ? "api" : "sequence";
+        obj["spotlight"] = (const char*)entry.spotlight;
+        obj["ageMs"] = now - entry.createdAt;
+        obj["totalUs"] = entry.total;
+        
+        JsonObject stages = obj.createNestedObject("stagesUs");
+        for (uint8_t s = 0; s < NUM_TRACE_STAGES; s++) {
+            stages[TRACE_STAGE_NAMES[s]] = entry.stages[s];
+        }
+    }
+    delete[] entries;
+    
+    String json;
+    serializeJson(doc, json);
+    request->send(200, "application/json", json);
+}
+
+// ============================================================================
+// JOBS (Worker-Task)
+// ============================================================================
+
+uint32_t LightCommander::submitJob(JobType type, const std::vector<String>& targets,
+                                   const char* path, const String& body, uint32_t traceId,
+                                   const std::vector<String>& bodies, unsigned long applyAt,
+                                   const Effect* effect) {
+    lockState();
+    
+    // Freien Slot suchen, sonst den ältesten fertigen überschreiben
+    Job* slot = nullptr;
+    for (int i = 0; i < MAX_JOBS; i++) {
+        Job& job = jobs[i];
+        if (job.id == 0) {
+            slot = &job;
+            break;
+        }
+        if (job.status == JOB_DONE || job.status == JOB_FAILED) {
+            if (!slot || job.finishedAt < slot->finishedAt) slot = &job;
+        }
+    }
+    
+    if (!slot) {
+        unlockState();
+        return 0;
+    }
+    
+    *slot = Job();
+    slot->id = nextJobId++;
+    slot->type = type;
+    slot->targets = targets;
+    slot->path = path;
+    slot->body = body;
+    slot->bodies = bodies;
+    slot->traceId = traceId;
+    slot->applyAt = applyAt;
+    if (effect) slot->effect = *effect;
+    slot->queuedAt = millis();
+    uint32_t id = slot->id;
+    
+    unlockState();
+    
+    if (xQueueSend(jobQueue, &id, 0) != pdTRUE) {
+        lockState();
+        slot->status = JOB_FAILED;
+        slot->finishedAt = millis();
+        slot->body = String();
+        slot->bodies.clear();
+        unlockState();
+        return 0;
+    }
+    
+    return id;
+}
+
+Job* LightCommander::findJob(uint32_t id) {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].id == id && id != 0) return &jobs[i];
+    }
+    return nullptr;
+}
+
+void LightCommander::jobWorker(void* arg) {
+    static_cast<LightCommander*>(arg)->runJobs();
+}
+
+void LightCommander::runJobs() {
+    while (true) {
+        uint32_t id;
+        if (xQueueReceive(jobQueue, &id, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            runJob(id);
+        }
+        
+        // Periodischer Health-Check
+        if (millis() - lastHealthCheck > HEALTH_CHECK_INTERVAL) {
+            checkSpotlightStatus();
+            lastHealthCheck = millis();
+        }
+    }
+}
+
+void LightCommander::runJob(uint32_t id) {
+    // Auftrag kopieren, Ausführung ohne Lock
+    lockState();
+    Job* job = findJob(id);
+    if (!job) {
+        unlockState();
+        return;
+    }
+    job->status = JOB_RUNNING;
+    JobType type = job->type;
+    std::vector<String> targets = job->targets;
+    String path = job->path;
+    String body = job->body;
+    std::vector<String> bodies;
+    bodies.swap(job->bodies);
+    uint32_t traceId = job->traceId;
+    Effect effect = job->effect;
+    job->body = String();
+    unlockState();
+    
+    uint8_t succeeded = 0;
+    uint8_t failed = 0;
+    
+    switch (type) {
+        case JOB_FORWARD: {
+            std::vector<Target> resolved;
+            resolveTargets(targets, resolved);
+            succeeded = sendToTargets(resolved, body, path.c_str(), traceId);
+            failed = targets.size() - succeeded;
+            break;
+        }
+        case JOB_LOAD_SEQUENCE:
+            if (loadSequence(body)) succeeded++;
+            else failed++;
+            break;
+        case JOB_HEALTH_CHECK:
+            checkSpotlightStatus();
+            lastHealthCheck = millis();
+            succeeded++;
+            break;
+        case JOB_EFFECT:
+            succeeded = sendShadowed(targetMask(targets), effect);
+            failed = targets.size() - succeeded;
+            break;
+        case JOB_STOP:
+            succeeded = sendStop(targets, effect.ring);
+            failed = targets.size() - succeeded;
+            break;
+        case JOB_BATCH: {
+            BatchSkew skew;
+            succeeded = sendBatch(targets, bodies, traceId, skew);
+            failed = targets.size() - succeeded;
+            
+            lockState();
+            Job* done = findJob(id);
+            if (done) done->skew = skew;
+            unlockState();
+            break;
+        }
+    }
+    
+    finishJob(id, succeeded, failed);
+}
+
+void LightCommander::finishJob(uint32_t id, uint8_t succeeded, uint8_t failed) {
+    StaticJsonDocument<256> doc;
+    
+    lockState();
+    Job* job = findJob(id);
+    if (!job) {
+        unlockState();
+        return;
+    }
+    job->succeeded = succeeded;
+    job->failed = failed;
+    job->status = (failed == 0 && (succeeded > 0 || job->targets.empty())) ? JOB_DONE : JOB_FAILED;
+    job->finishedAt = millis();
+    job->body = String();
+    addJobJson(doc.to<JsonObject>(), *job);
+    unlockState();
+    
+    // Abonnenten benachrichtigen
+    String json;
+    serializeJson(doc, json);
+    events.send(json.c_str(), "job", id);
+}
+
+void LightCommander::addJobJson(JsonObject obj, const Job& job) {
+    static const char* typeNames[] = { "forward", "loadSequence", "healthCheck", "batch", "effect", "stop" };
+    static const char* statusNames[] = { "queued", "running", "done", "failed" };
+    
+    obj["id"] = job.id;
+    obj["type"] = typeNames[job.type];
+    obj["status"] = statusNames[job.status];
+    if (job.type == JOB_FORWARD) obj["path"] = job.path;
+    obj["succeeded"] = job.succeeded;
+    obj["failed"] = job.failed;
+    obj["queuedAt"] = job.queuedAt;
+    if (job.finishedAt) obj["finishedAt"] = job.finishedAt;
+    
+    if (job.type == JOB_BATCH) {
+        obj["at"] = job.applyAt;
+        if (job.finishedAt) {
+            obj["skewUs"] = job.skew.skewUs;
+            obj["late"] = job.skew.late;
+            obj["unsynced"] = job.skew.unsynced;
+            obj["clockErrorUs"] = job.skew.clockErrorUs;
+        }
+    }
+}
+
+// Vor begin() gibt es noch keine anderen Tasks → kein Lock nötig
+void LightCommander::lockState() {
+    if (stateMutex) xSemaphoreTake(stateMutex, portMAX_DELAY);
+}
+
+void LightCommander::unlockState() {
+    if (stateMutex) xSemaphoreGive(stateMutex);
 }
 
 // ============================================================================
 // STATUS
 // ============================================================================
 
+// Alles, was Loop-Task, Worker und Handler unter dem State-Lock ändern
+void LightCommander::copyStatus(CommanderStatus& status) {
+    status.active = playback.active();
+    status.maxLateness = playback.maxLateness;
+    
+    status.numTimelines = 0;
+    for (uint8_t i = 0; i < MAX_TIMELINES; i++) {
+        const Timeline& t = playback.timelines[i];
+        if (!t.active) continue;
+        TimelineStatus& copy = status.timelines[status.numTimelines++];
+        copy.timeline = i;
+        copy.sequence = t.sequenceId;
+        copy.priority = t.priority;
+        copy.paused = t.paused;
+        copy.draining = t.draining;
+        copy.position = (t.paused ? t.pauseTime : millis()) - t.startTime;
+        copy.ring = t.ring;
+        copy.scoped = t.scope != ALL_TARGETS;
+        copy.targets = __builtin_popcountll(t.scope);
+    }
+    
+    status.jobsPending = 0;
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].id && (jobs[i].status == JOB_QUEUED || jobs[i].status == JOB_RUNNING)) {
+            status.jobsPending++;
+        }
+    }
+    
+    status.devices.reserve(spotlights.size());
+    for (auto& pair : spotlights) {
+        status.devices.push_back({ pair.second.id, pair.second.name, pair.second.ip, pair.second.online });
+    }
+}
+
 String LightCommander::getStatusJson() {
-    StaticJsonDocument<2048> doc;
+    // Kopie unter Lock, das Dokument wird ohne Lock gebaut
+    CommanderStatus* status = new CommanderStatus();
+    lockState();
+    copyStatus(*status);
+    unlockState();
+    
+    // Größe aus dem Inhalt: jeder Scheinwerfer ein Objekt mit kopierten
+    // Strings – eine feste Größe schnitt ab ~20 Geräten still ab
+    size_t capacity = JSON_OBJECT_SIZE(11) + 16 +                              // Wurzel, IP
+                      JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(status->numTimelines) +
+                      JSON_ARRAY_SIZE(status->devices.size());
+    for (uint8_t i = 0; i < status->numTimelines; i++) {
+        capacity += JSON_OBJECT_SIZE(8) + status->timelines[i].sequence.length() + 1;
+    }
+    for (const DeviceStatus& device : status->devices) {
+        capacity += JSON_OBJECT_SIZE(4) + device.id.length() + device.name.length() + device.ip.length() + 3;
+    }
+    DynamicJsonDocument doc(capacity);
     
     doc["uptime"] = millis();
     doc["freeHeap"] = ESP.getFreeHeap();
+    doc["minFreeHeap"] = ESP.getMinFreeHeap();
+    doc["largestFreeBlock"] = ESP.getMaxAllocHeap();
     doc["wifiConnected"] = (WiFi.status() == WL_CONNECTED);
     doc["ip"] = isAPMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
     
     // Playback
     JsonObject pb = doc.createNestedObject("playback");
-    pb["active"] = playback.active;
-    pb["sequence"] = playback.currentSequence;
-    pb["paused"] = playback.paused;
-    if (playback.active) {
-        pb["position"] = millis() - playback.startTime;
+    pb["active"] = status->active;
+    pb["maxLateness"] = status->maxLateness;
+    JsonArray timelines = pb.createNestedArray("timelines");
+    for (uint8_t i = 0; i < status->numTimelines; i++) {
+        const TimelineStatus& t = status->timelines[i];
+        JsonObject obj = timelines.createNestedObject();
+        obj["timeline"] = t.timeline;
+        obj["sequence"] = t.sequence;
+        obj["priority"] = t.priority;
+        obj["paused"] = t.paused;
+        if (t.draining) obj["draining"] = true;     // Events durch, Makros laufen noch
+        obj["position"] = t.position;
+        obj["ring"] = RING_NAMES[t.ring];
+        if (t.scoped) obj["targets"] = t.targets;
     }
     
+    // Jobs
+    doc["jobsPending"] = status->jobsPending;
+    
+    // Log-Puffer
+    doc["logsWritten"] = logBuffer.written();
+    doc["logsLost"] = logBuffer.lostRecords();
+    
     // Devices
     JsonArray devices = doc.createNestedArray("devices");
-    for (auto& pair : spotlights) {
+    for (const DeviceStatus& device : status->devices) {
         JsonObject dev = devices.createNestedObject();
-        dev["id"] = pair.second.id;
-        dev["name"] = pair.second.name;
-        dev["ip"] = pair.second.ip;
-        dev["online"] = pair.second.online;
+        dev["id"] = device.id;
+        dev["name"] = device.name;
+        dev["ip"] = device.ip;
+        dev["online"] = device.online;
     }
+    delete status;
     
     String output;
     serializeJson(doc, output);
@@ -3,115 +3,144 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <WiFiUdp.h>
+#include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
+#include "Protocol.h"
+#include "Log.h"
+#include "Histogram.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include "EffectParser.h"
+#include "EffectEncoder.h"
+#include "MemoryStats.h"
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 #include <map>
 
 // ============================================================================
-// STRUKTUREN & ENUMS (identisch mit LED-Scheinwerfer!)
+// HTTP (Async-Server) & JOBS
 // ============================================================================
 
-// Farb-Struktur
-struct Color {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-    
-    Color() : r(0), g(0), b(0) {}
-    Color(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
-};
-
-// Ring-Typ
-enum RingType {
-    RING_INNER,
-    RING_OUTER,
-    RING_BOTH
-};
-
-// Effekt-Typen
-enum EffectType {
-    EFFECT_STATIC,
-    EFFECT_FADE,
-    EFFECT_STROBE,
-    EFFECT_PULSE,
-    EFFECT_ROTATION,
-    EFFECT_RAINBOW,
-    EFFECT_CHASE,
-    EFFECT_OFF
-};
-
-// Rotations-Pattern
-enum RotationPattern {
-    PATTERN_SINGLE,
-    PATTERN_TRAIL,
-    PATTERN_OPPOSITE,
-    PATTERN_WAVE,
-    PATTERN_RAINBOW_CHASE
-};
-
-// Rotations-Richtung
-enum RotationDirection {
-    DIRECTION_CLOCKWISE,
-    DIRECTION_COUNTERCLOCKWISE
-};
-
-// Rotation-Parameter
-struct RotationParams {
-    Color activeColor;
-    Color inactiveColor;
-    uint16_t speed;
-    RotationDirection direction;
-    RotationPattern pattern;
-    uint8_t trailLength;
-    
-    RotationParams() :
-        activeColor(255, 0, 0),
-        inactiveColor(0, 0, 0),
-        speed(100),
-        direction(DIRECTION_CLOCKWISE),
-        pattern(PATTERN_SINGLE),
-        trailLength(3) {}
-};
-
-// Effekt-Parameter
-struct EffectParams {
-    Color color;
-    Color color2;
-    uint8_t brightness;
-    uint16_t speed;
-    uint16_t duration;
-    RotationParams rotation;
-    
-    EffectParams() :
-        color(255, 255, 255),
-        color2(0, 0, 0),
-        brightness(255),
-        speed(100),
-        duration(0) {}
-};
-
-// Sequenz-Event
+#define MAX_REQUEST_BODY      16384   // Sequenzen können groß sein, größere Bodies: 413
+#define MAX_JOBS              16      // Job-Tabelle, fertige Jobs werden überschrieben
+#define JOB_QUEUE_LENGTH      16
+#define HEALTH_CHECK_INTERVAL 30000   // ms
+#define BATCH_LEAD_MS         150     // Batch ohne "at": Vorlauf, damit der Fan-out alle Ziele rechtzeitig erreicht
+#define SEQUENCE_DUE_BATCH    8       // Fällige Events pro loop(), der Rest im nächsten Durchlauf
+#define MAX_TIMELINES         4       // Gleichzeitig laufende Sequenzen
+#define SEQUENCE_MERGE_MS     20      // Events verschiedener Timelines so dicht beieinander gelten als gleichzeitig
+#define ALL_TIMELINES         0xFF    // pause/resume/stop ohne "timeline"
+#define MAX_MACRO_EXPANSIONS  8       // Gleichzeitig ablaufende Makro-Events (alle Timelines)
+
+// ============================================================================
+// SCHEINWERFER-INDIZES (Ziele als Bitmaske)
+// ============================================================================
+
+#define MAX_SPOTLIGHTS        64      // Verschiedene IDs, je ein Bit in TargetMask
+
+// ============================================================================
+// METRIKEN (/metrics im Prometheus-Textformat)
+// ============================================================================
+
+#define MAX_ERROR_CODES       6       // Verschiedene HTTP-Fehlercodes pro Scheinwerfer
+
+// ============================================================================
+// LATENZ-TRACING (siehe common/Trace.h)
+// ============================================================================
+
+#define MAX_TRACES            16      // Letzte Effekt-Befehle mit Trace (Ringpuffer)
+#define MAX_TRACE_TARGETS     8       // Verfolgte Ziele pro Befehl
+
+// ============================================================================
+// STRUKTUREN
+// ============================================================================
+
+// Effekt-Typen, Color, RotationParams, Automation und Effect: siehe
+// common/Protocol.h (gemeinsam mit dem LED-Scheinwerfer)
+
+// Ziele als Bitmaske: Bit i = Scheinwerfer mit Index i (internSpotlight)
+typedef uint64_t TargetMask;
+#define ALL_TARGETS           ((TargetMask)~0ull)
+static_assert(MAX_SPOTLIGHTS <= sizeof(TargetMask) * 8, "TargetMask zu schmal für MAX_SPOTLIGHTS");
+
+// Sequenz-Event (16 Bytes). Die Effekt-Parameter liegen einmal pro Variante
+// im Parameterblock der Sequenz – Shows wiederholen wenige Effekte oft.
 struct SequenceEvent {
-    unsigned long timestamp;
-    std::vector<String> targets;
-    RingType ring;
-    EffectType effect;
-    EffectParams params;
+    uint32_t timestamp;
+    TargetMask targets;     // Beim Laden aufgelöst, keine ID-Liste pro Event
+    uint16_t effect;        // Index in Sequence::effects
+    uint8_t macro;          // 0 = einfaches Event, sonst Index + 1 in Sequence::macros
+    
+    SequenceEvent() : timestamp(0), targets(0), effect(0), macro(0) {}
 };
 
-// Sequenz
+// Makro-Event: ein gespeichertes Event, das erst beim Abspielen in Schritte
+// pro Ziel zerfällt (Reihenfolge = "targets" wie geladen)
+enum MacroType : uint8_t {
+    MACRO_CHASE,            // Ziel k bei timestamp + k * stagger
+    MACRO_MIRROR,           // Ziel k und n-1-k zusammen, von außen nach innen
+    MACRO_ALTERNATE,        // Gerade Positionen sofort, ungerade nach stagger
+    MACRO_RANDOM            // pick zufällige Ziele, bei jedem Durchlauf neu
+};
+
+struct SequenceMacro {
+    MacroType type;
+    uint8_t length;                 // Ziele in order
+    uint8_t pick;                   // MACRO_RANDOM
+    uint16_t stagger;               // ms zwischen den Schritten
+    uint8_t order[MAX_SPOTLIGHTS];  // Scheinwerfer-Indizes in Listenreihenfolge
+    
+    uint8_t steps() const;
+    TargetMask stepTargets(uint8_t step) const;
+};
+
+// Sequenz. Events und Parameterblock liegen in einer einzigen Allokation
+// (Arena): Ersetzen gibt genau einen Block frei, nichts bleibt verstreut
+// im Heap. Deshalb nur verschiebbar, nicht kopierbar.
 struct Sequence {
     String id;
     String name;
     unsigned long duration;
     bool loop;
-    std::vector<SequenceEvent> events;
+    SequenceEvent* events;  // eventCount Events, Anfang der Arena
+    Effect* effects;        // effectCount verschiedene Effekte direkt dahinter (startTime beim Abspielen)
+    SequenceMacro* macros;  // macroCount verschiedene Makros am Ende
+    uint16_t eventCount;
+    uint16_t effectCount;
+    uint8_t macroCount;
+    TargetMask targets;     // Alle Indizes der Events – belegt sie gegen Wiederverwendung
     String spotifyUri;
     bool syncWithSpotify;
     
-    Sequence() : duration(0), loop(false), syncWithSpotify(false) {}
+    Sequence() : duration(0), loop(false), events(nullptr), effects(nullptr), macros(nullptr),
+                 eventCount(0), effectCount(0), macroCount(0), targets(0), syncWithSpotify(false) {}
+    Sequence(Sequence&& other) : Sequence() { *this = std::move(other); }
+    Sequence& operator=(Sequence&& other);
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+    ~Sequence() { free(events); }
+    
+    bool allocateEvents(size_t count);
+    bool attachEffects(const Effect* unique, size_t count, const SequenceMacro* macros, size_t macroCount);
+    size_t arenaBytes() const {
+        return effectOffset(eventCount) + effectCount * sizeof(Effect) + macroCount * sizeof(SequenceMacro);
+    }
+    
+    // Parameterblock hinter den Events, auf Effect ausgerichtet
+    static size_t effectOffset(size_t events) {
+        size_t bytes = events * sizeof(SequenceEvent);
+        return (bytes + alignof(Effect) - 1) / alignof(Effect) * alignof(Effect);
+    }
+};
+
+// Schattenzustand eines Rings
+enum ShadowState : uint8_t {
+    SHADOW_UNKNOWN,         // Nie gesendet oder Segment-Effekt
+    SHADOW_PENDING,         // Soll-Zustand, Scheinwerfer hat ihn (noch) nicht bestätigt
+    SHADOW_CONFIRMED        // Scheinwerfer zeigt ihn (200 auf den letzten Befehl)
 };
 
 // Scheinwerfer
@@ -121,19 +150,266 @@ struct Spotlight {
     String ip;
     bool online;
     unsigned long lastSeen;
+    uint32_t clockRttUs;    // RTT der letzten Uhr-Synchronisation
+    unsigned long uptime;   // Letzter Wert aus /status (kleiner → Neustart)
+    uint8_t index;          // Bit in TargetMask
+    
+    // Was der Scheinwerfer pro Ring zeigen soll (RING_INNER, RING_OUTER)
+    Effect shadow[2];
+    ShadowState shadowState[2];
     
-    Spotlight() : online(false), lastSeen(0) {}
+    Spotlight() : online(false), lastSeen(0), clockRttUs(0), uptime(0), index(0), shadowState() {}
 };
 
-// Playback-Status
-struct PlaybackState {
+// Wie ein Effekt an einen Scheinwerfer ging (Metrik)
+enum EffectSend : uint8_t {
+    EFFECT_SEND_FULL,
+    EFFECT_SEND_DELTA,
+    EFFECT_SEND_SUPPRESSED,     // Scheinwerfer zeigt ihn schon
+    EFFECT_SEND_RESYNC,         // Soll-Zustand nach Ausfall/Neustart
+    EFFECT_SEND_MERGED,         // Sequenz-Event, von einer höher priorisierten Timeline überdeckt
+    NUM_EFFECT_SENDS
+};
+
+constexpr const char* EFFECT_SEND_NAMES[NUM_EFFECT_SENDS] = { "full", "delta", "suppressed", "resync", "merged" };
+
+// Aufgelöstes Ziel eines Befehls
+struct Target {
+    String id;
+    String ip;
+    uint8_t index;          // Spotlight::index (Metriken)
+};
+
+// Teil eines Batches: alle Effekte für einen Scheinwerfer, in Befehlsreihenfolge
+struct BatchPart {
+    String id;
+    std::vector<Effect> effects;
+};
+
+// Wie gleichzeitig die Scheinwerfer einen Batch anwenden (aus ihrem Vorlauf)
+struct BatchSkew {
+    uint32_t skewUs;        // Spanne der Verspätungen über alle Ziele
+    uint8_t late;           // Ziele, bei denen die Nachricht nach "at" ankam
+    uint8_t unsynced;       // Ziele ohne Uhr-Sync (kein Vorlauf, wenden sofort an)
+    uint32_t clockErrorUs;  // Unsicherheit der Uhren (größte RTT/2)
+    
+    BatchSkew() : skewUs(0), late(0), unsynced(0), clockErrorUs(0) {}
+};
+
+// Eine laufende Sequenz: eigener Cursor, eigene Uhr, eigener Bereich
+struct Timeline {
     bool active;
-    String currentSequence;
-    unsigned long startTime;
     bool paused;
+    bool draining;              // Alle Events raus, Makros laufen noch zu Ende
+    String sequenceId;
+    Sequence* sequence;
+    size_t eventIndex;          // Nächstes Event
+    unsigned long startTime;
     unsigned long pauseTime;
+    unsigned long nextDue;      // millis() des nächsten Events (Schlüssel im Heap)
+    uint8_t priority;           // Gewinnt pro Scheinwerfer und Ring gegen niedrigere
+    TargetMask scope;           // Nur diese Scheinwerfer
+    RingType ring;              // RING_BOTH = beide Ringe, sonst nur dieser
+    
+    Timeline() : active(false), paused(false), draining(false), sequence(nullptr), eventIndex(0), startTime(0),
+                 pauseTime(0), nextDue(0), priority(0), scope(ALL_TARGETS), ring(RING_BOTH) {}
+};
+
+// Laufendes Makro-Event: die restlichen Schritte (Schritt 0 geht mit dem Event raus)
+struct MacroExpansion {
+    bool active;
+    uint8_t timeline;
+    uint8_t step;               // Nächster Schritt
+    uint8_t steps;
+    SequenceEvent event;
+    SequenceMacro macro;        // Kopie: die Sequenz kann ersetzt werden
+    unsigned long startTime;    // Der Timeline, als das Makro begann
+    unsigned long nextDue;
+    
+    MacroExpansion() : active(false), timeline(0), step(0), steps(0), macro(), startTime(0), nextDue(0) {}
+};
+
+// Playback-Status. Im Heap stehen Cursor: 0..MAX_TIMELINES-1 = Timeline,
+// darüber MAX_TIMELINES + i = expansions[i]
+struct PlaybackState {
+    Timeline timelines[MAX_TIMELINES];
+    MacroExpansion expansions[MAX_MACRO_EXPANSIONS];
+    uint8_t heap[MAX_TIMELINES + MAX_MACRO_EXPANSIONS];    // Min-Heap nach nextDue
+    uint8_t heapSize;
+    unsigned long maxLateness;      // Größte Verspätung eines Events (ms) seit Start
+    
+    PlaybackState() : heap(), heapSize(0), maxLateness(0) {}
+    
+    unsigned long nextDue(uint8_t cursor) const {
+        return cursor < MAX_TIMELINES ? timelines[cursor].nextDue
+                                      : expansions[cursor - MAX_TIMELINES].nextDue;
+    }
+    
+    bool active() const {
+        for (const Timeline& timeline : timelines) {
+            if (timeline.active) return true;
+        }
+        return false;
+    }
+};
+
+// Fälliges Event, unter Lock kopiert (die Sequenz kann ersetzt werden)
+struct DueEvent {
+    SequenceEvent event;        // targets schon auf den Bereich der Timeline beschnitten
+    Effect effect;
+    unsigned long startTime;
+    uint8_t timeline;
+    uint8_t priority;
+};
+
+// Wer einen Ring zuletzt aus einer Sequenz bekommen hat (Merge über Durchläufe)
+struct RingClaim {
+    unsigned long at;           // Soll-Zeitpunkt des Events
+    uint8_t timeline;           // ALL_TIMELINES = frei
+    uint8_t priority;
+    
+    RingClaim() : at(0), timeline(ALL_TIMELINES), priority(0) {}
+};
+
+// Hintergrund-Job (Fan-out, Sequenz-Upload, Health-Check)
+enum JobType {
+    JOB_FORWARD,            // body per POST an path aller targets
+    JOB_LOAD_SEQUENCE,      // body = Sequenz-JSON
+    JOB_HEALTH_CHECK,
+    JOB_BATCH,              // bodies[i] per POST /batch an targets[i]
+    JOB_EFFECT,             // effect an targets, über den Schattenzustand
+    JOB_STOP                // effect.ring an targets stoppen
+};
+
+enum JobStatus {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
+    JOB_FAILED
+};
+
+struct Job {
+    uint32_t id;            // 0 = Slot frei
+    JobType type;
+    JobStatus status;
+    std::vector<String> targets;
+    String path;
+    String body;            // Nach Ausführung freigegeben
+    std::vector<String> bodies;     // JOB_BATCH: eine Nachricht pro Ziel
+    Effect effect;                  // JOB_EFFECT, JOB_STOP
+    uint8_t succeeded;
+    uint8_t failed;
+    unsigned long queuedAt;
+    unsigned long finishedAt;
+    uint32_t traceId;       // Effekt-Befehl mit Trace (0 = keiner)
+    unsigned long applyAt;  // JOB_BATCH: gemeinsame Show-Zeit
+    BatchSkew skew;         // JOB_BATCH: Ergebnis
+    
+    Job() :
+        id(0),
+        type(JOB_FORWARD),
+        status(JOB_QUEUED),
+        succeeded(0),
+        failed(0),
+        queuedAt(0),
+        finishedAt(0),
+        traceId(0),
+        applyAt(0) {}
+};
+
+// Herkunft eines Traces
+enum TraceOrigin : uint8_t {
+    TRACE_ORIGIN_API,
+    TRACE_ORIGIN_SEQUENCE
+};
+
+// Ein Ziel eines verfolgten Befehls (Zeiten in µs, siehe common/Trace.h)
+struct TraceTarget {
+    char spotlight[16];     // "" = Slot frei
+    uint8_t index;          // Spotlight::index (Metriken)
+    uint32_t sent;
+    uint32_t received;
+    uint32_t applied;
+    uint32_t shown;
+    bool complete;          // Span des Scheinwerfers ist angekommen
+};
+
+// Verfolgter Effekt-Befehl
+struct TraceRecord {
+    uint32_t id;            // 0 = Slot frei
+    TraceOrigin origin;
+    uint32_t started;       // µs: Request angenommen bzw. Soll-Zeit des Events
+    unsigned long createdAt;
+    TraceTarget targets[MAX_TRACE_TARGETS];
+    
+    TraceRecord() : id(0), origin(TRACE_ORIGIN_API), started(0), createdAt(0), targets() {}
+};
+
+// HTTP-Fehlercode mit Zähler
+struct ErrorCount {
+    int16_t code;           // HTTPClient: negativ = Verbindungsfehler/Timeout
+    uint32_t count;
+};
+
+// Send-Metriken eines Scheinwerfers, Slot = Spotlight::index
+struct SpotlightMetrics {
+    char id[16];            // "" = kein Scheinwerfer registriert
+    Histogram sendLatency;  // µs pro POST (auch fehlgeschlagene)
+    ErrorCount errors[MAX_ERROR_CODES];
+    uint32_t otherErrors;   // Fehlercodes ohne freien Slot
+    
+    // Frame-Telemetrie des Scheinwerfers (letztes Fenster, beim Health-Check geholt)
+    bool frameTelemetry;
+    TelemetrySummary frame[NUM_TELEMETRY_STAGES];
+    
+    // Latenz-Tracing: Abschnitte und gesamt (API → erster Frame), µs
+    Histogram traceStages[NUM_TRACE_STAGES];
+    Histogram traceTotal;
+    
+    SpotlightMetrics() : errors(), otherErrors(0), frameTelemetry(false), frame() { id[0] = '\0'; }
+};
+
+// Alle Histogramme in µs, geschrieben aus Loop-, Netzwerk- und Worker-Task
+// (unter metricsMux, ein record() dauert deutlich unter 1 µs)
+struct CommanderMetrics {
+    Histogram eventLateness;    // Versand - Soll-Zeitpunkt eines Sequenz-Events
+    Histogram fanOut;           // Ein Befehl an alle Ziele
+    Histogram apiRequest;       // Request-Handler im Netzwerk-Task
+    Histogram healthCheck;      // Health-Check aller Scheinwerfer
+    uint32_t effectSends[NUM_EFFECT_SENDS];     // Pro Ziel, nach Art
+    uint32_t recordNanos;       // Gemessene Kosten eines record() inkl. Lock
     
-    PlaybackState() : active(false), startTime(0), paused(false), pauseTime(0) {}
+    CommanderMetrics() : effectSends(), recordNanos(0) {}
+};
+
+// Kopie des Zustands für /api/status: unter Lock kopiert, das JSON wird
+// erst danach gebaut (Playback wartet nicht auf die Serialisierung)
+struct TimelineStatus {
+    uint8_t timeline;
+    String sequence;
+    uint8_t priority;
+    bool paused;
+    bool draining;
+    unsigned long position;
+    RingType ring;
+    bool scoped;            // Nur ein Teil der Scheinwerfer …
+    uint8_t targets;        // … nämlich so viele
+};
+
+struct DeviceStatus {
+    String id;
+    String name;
+    String ip;
+    bool online;
+};
+
+struct CommanderStatus {
+    bool active;
+    unsigned long maxLateness;
+    TimelineStatus timelines[MAX_TIMELINES];
+    uint8_t numTimelines;
+    uint8_t jobsPending;
+    std::vector<DeviceStatus> devices;
 };
 
 // ============================================================================
@@ -155,8 +431,7 @@ public:
     std::vector<Spotlight*> getAllSpotlights();
     
     // Effekt-Steuerung
-    bool sendEffect(const std::vector<String>& targets, RingType ring, 
-                    EffectType effect, const EffectParams& params);
+    bool sendEffect(const std::vector<String>& targets, const Effect& effect);
     bool stopEffect(const std::vector<String>& targets, RingType ring = RING_BOTH);
     
     // Sequenz-Management
@@ -165,53 +440,169 @@ public:
     std::vector<String> listSequences();
     
     // Sequenz-Playback
-    bool playSequence(const String& sequenceId);
-    bool pauseSequence();
-    bool resumeSequence();
-    bool stopSequence();
+    bool playSequence(const String& sequenceId, uint8_t timeline = 0, uint8_t priority = 0,
+                      TargetMask scope = ALL_TARGETS, RingType ring = RING_BOTH);
+    bool pauseSequence(uint8_t timeline = ALL_TIMELINES);
+    bool resumeSequence(uint8_t timeline = ALL_TIMELINES);
+    bool stopSequence(uint8_t timeline = ALL_TIMELINES);
     
-    // Status
+    // Status (nimmt den State-Lock selbst)
     String getStatusJson();
     
 private:
     // Netzwerk
-    WebServer server;
+    AsyncWebServer server;
+    AsyncEventSource events;        // Job-Updates per Server-Sent Events
     String wifiSSID;
     String wifiPassword;
     bool isAPMode;
     
     // Geräte
     std::map<String, Spotlight> spotlights;
+    String spotlightIds[MAX_SPOTLIGHTS];        // Index → ID, frei erst wenn niemand ihn nutzt
+    Spotlight* spotlightSlots[MAX_SPOTLIGHTS];  // Index → Scheinwerfer (nullptr = nicht registriert)
+    uint8_t spotlightIdCount;
     
     // Sequenzen
     std::map<String, Sequence> sequences;
     
     // Playback
     PlaybackState playback;
-    Sequence* currentSequence;
-    size_t currentEventIndex;
+    DueEvent dueEvents[SEQUENCE_DUE_BATCH];     // Nur Loop-Task
+    RingClaim ringClaims[MAX_SPOTLIGHTS][2];    // Nur Loop-Task, [Index][RING_INNER/RING_OUTER]
+    
+    // Jobs (Netzwerk-Task → Worker-Task)
+    Job jobs[MAX_JOBS];
+    uint32_t nextJobId;
+    QueueHandle_t jobQueue;
+    SemaphoreHandle_t stateMutex;   // Scheinwerfer, Sequenzen, Playback, Jobs
+    unsigned long lastHealthCheck;
     
-    // REST API Handlers
+    // Metriken
+    CommanderMetrics metrics;
+    SpotlightMetrics spotMetrics[MAX_SPOTLIGHTS];   // Index = Spotlight::index
+    portMUX_TYPE metricsMux;
+    
+    // Latenz-Tracing (unter metricsMux)
+    WiFiUDP traceUdp;
+    TraceRecord traces[MAX_TRACES];
+    uint32_t nextTraceId;
+    uint32_t spansReceived;
+    uint32_t spansUnmatched;        // Trace schon überschrieben oder Ziel unbekannt
+    
+    // REST API Handlers (laufen im Netzwerk-Task)
+    typedef void (LightCommander::*RequestHandler)(AsyncWebServerRequest*);
     void setupRoutes();
-    void handleRoot();
-    void handleStatus();
-    void handleAddSpotlight();
-    void handleListSpotlights();
-    void handleSendEffect();
-    void handleStopEffect();
-    void handleLoadSequence();
-    void handleListSequences();
-    void handlePlaySequence();
-    void handlePauseSequence();
-    void handleResumeSequence();
-    void handleStopSequence();
+    void onGet(const char* path, RequestHandler handler);
+    void onPost(const char* path, RequestHandler handler);
+    static void collectBody(AsyncWebServerRequest* request, uint8_t* data,
+                            size_t len, size_t index, size_t total);
+    const char* requestBody(AsyncWebServerRequest* request);
+    uint8_t requestTimeline(AsyncWebServerRequest* request);
+    void sendJobAccepted(AsyncWebServerRequest* request, uint32_t jobId);
+    void handleRoot(AsyncWebServerRequest* request);
+    void handleStatus(AsyncWebServerRequest* request);
+    void handleJobStatus(AsyncWebServerRequest* request);
+    void handleLogs(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
+    void handleTraces(AsyncWebServerRequest* request);
+    void handleMemory(AsyncWebServerRequest* request);
+    void handleAddSpotlight(AsyncWebServerRequest* request);
+    void handleListSpotlights(AsyncWebServerRequest* request);
+    void handleSendEffect(AsyncWebServerRequest* request);
+    void handleBatchEffect(AsyncWebServerRequest* request);
+    void handleStopEffect(AsyncWebServerRequest* request);
+    void handleUploadProgram(AsyncWebServerRequest* request);
+    void handleUploadPalette(AsyncWebServerRequest* request);
+    void handleConfigureSegments(AsyncWebServerRequest* request);
+    void handleLoadSequence(AsyncWebServerRequest* request);
+    void handleListSequences(AsyncWebServerRequest* request);
+    void handlePlaySequence(AsyncWebServerRequest* request);
+    void handlePauseSequence(AsyncWebServerRequest* request);
+    void handleResumeSequence(AsyncWebServerRequest* request);
+    void handleStopSequence(AsyncWebServerRequest* request);
+    
+    // Jobs & Lock
+    uint32_t submitJob(JobType type, const std::vector<String>& targets,
+                       const char* path, const String& body, uint32_t traceId = 0,
+                       const std::vector<String>& bodies = std::vector<String>(), unsigned long applyAt = 0,
+                       const Effect* effect = nullptr);
+    Job* findJob(uint32_t id);
+    static void jobWorker(void* arg);
+    void runJobs();
+    void runJob(uint32_t id);
+    void finishJob(uint32_t id, uint8_t succeeded, uint8_t failed);
+    void addJobJson(JsonObject obj, const Job& job);
+    void lockState();
+    void unlockState();
+    void copyStatus(CommanderStatus& status);
+    
+    // Metriken
+    void recordMetric(Histogram& histogram, uint32_t value);
+    void recordSend(uint8_t index, uint32_t latency, int httpCode);
+    SpotlightMetrics* spotlightMetrics(uint8_t index);
+    void resetSpotlightMetrics(uint8_t index, const char* id);
+    void measureMetricsOverhead();
+    void writeHistogram(AsyncResponseStream* out, const char* name, const char* labels,
+                        const Histogram& histogram);
+    
+    // Latenz-Tracing
+    uint32_t beginTrace(TraceOrigin origin, uint32_t started);
+    TraceRecord* findTrace(uint32_t id);
+    void traceSent(uint32_t traceId, const Target& target, uint32_t sent);
+    void receiveTraceSpans();
+    void recordSpan(const TraceSpan& span);
     
     // Interne Methoden
-    bool sendToSpotlight(const String& ip, const String& json);
-    String buildEffectJson(RingType ring, EffectType effect, const EffectParams& params);
+    bool sendToSpotlight(const Target& target, const String& json, const char* path = "/effect",
+                         uint32_t traceId = 0, String* response = nullptr);
+    bool sendToSpotlight(const Target& target, const char* body, size_t length, const char* path,
+                         uint32_t traceId = 0, String* response = nullptr);
+    int postToSpotlight(const Target& target, const char* body, size_t length, const char* path,
+                        uint32_t traceId = 0, String* response = nullptr);
+    uint8_t sendToTargets(const std::vector<Target>& targets, const String& json,
+                          const char* path = "/effect", uint32_t traceId = 0);
+    uint8_t sendBatch(const std::vector<String>& ids, const std::vector<String>& bodies,
+                      uint32_t traceId, BatchSkew& skew);
+    DecodeResult parseEffectRequest(const char* body, size_t length,
+                                    std::vector<String>& targets, Effect& effect);
+    DecodeResult parseEffectRequest(JsonCursor& json, std::vector<String>& targets, Effect& effect);
+    DecodeResult parseBatchRequest(const char* body, size_t length,
+                                   unsigned long& at, std::vector<BatchPart>& parts);
+    void readTargets(JsonCursor& json, std::vector<String>& targets);
+    void readTargetMask(JsonCursor& json, std::vector<String>& ids, TargetMask& targets, SequenceMacro& order);
+    int internSpotlight(const char* id, size_t length, TargetMask used);
+    TargetMask sequenceTargets(const String* replaced);
+    bool internSequenceTargets(Sequence& seq, const std::vector<String>& ids);
+    TargetMask targetMask(const std::vector<String>& ids);
+    uint32_t forwardToTargets(JsonDocument& doc, const char* path);
+    bool resolveTargets(const std::vector<String>& ids, std::vector<Target>& targets);
+    size_t buildEffectJson(const Effect& effect, char* buffer, size_t size);
+    size_t buildEffectDelta(const Effect& base, const Effect& effect, char* buffer, size_t size);
+    
+    // Schattenzustand (unter stateMutex)
+    uint8_t sendShadowed(TargetMask targets, const Effect& effect);
+    uint8_t sendStop(const std::vector<String>& ids, RingType ring);
+    void resyncSpotlight(const Target& target);
+    void rememberShadow(Spotlight& spot, const Effect& effect, ShadowState state);
+    void countEffectSend(EffectSend kind);
+    bool parseSequenceEvents(JsonCursor& json, Sequence& seq, std::vector<String>& ids);
+    bool parseSequenceEvent(JsonCursor& json, SequenceEvent& event, Effect& effect, SequenceMacro& macro,
+                            bool& isMacro, std::vector<String>& ids);
     void checkSpotlightStatus();
+    uint32_t syncSpotlightClock(const Spotlight& spot);
+    void fetchSpotlightTelemetry(const Spotlight& spot);
     void updateSequencePlayback();
-    void processSequenceEvent(const SequenceEvent& event);
+    bool advanceTimeline(uint8_t index);
+    void completeTimeline(uint8_t index);
+    bool takeDueEvent(DueEvent& due, uint8_t timeline, const SequenceEvent& event, unsigned long startTime);
+    void startExpansion(uint8_t timeline, const SequenceEvent& event, const SequenceMacro& macro, unsigned long startTime);
+    void clearExpansions(uint8_t timeline);
+    bool hasExpansions(uint8_t timeline) const;
+    void scheduleTimelines();
+    bool dueAfter(uint8_t a, uint8_t b) const;
+    void mergeDueEvents(uint8_t count);
+    void processSequenceEvent(const DueEvent& due, const TargetMask send[RING_BOTH + 1]);
 };
 
 #endif // LIGHT_COMMANDER_H